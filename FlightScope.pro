@@ -13,57 +13,10 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-# Include paths
-INCLUDEPATH += $$PWD/third-party
-INCLUDEPATH += $$PWD/src
+include(src/flightscope.pri)
 
-# Source files
 SOURCES += \
-    src/main.cpp \
-    src/ui/mainwindow.cpp \
-    src/ui/connectdialog.cpp \
-    src/ui/missioneditor.cpp \
-    src/ui/commandeditordialog.cpp \
-    src/ui/mapwidget.cpp \
-    src/ui/compasswidget.cpp \
-    src/ui/hudwidget.cpp \
-    src/comm/udplink.cpp \
-    src/comm/linkmanager.cpp \
-    src/comm/mavlinkrouter.cpp \
-    src/comm/commandbus.cpp \
-    src/models/vehiclemodel.cpp \
-    src/models/healthmodel.cpp \
-    src/models/waypoint.cpp \
-    src/models/missionmodel.cpp \
-    src/models/geofencemodel.cpp
-
-# Header files
-HEADERS += \
-    src/ui/mainwindow.h \
-    src/ui/connectdialog.h \
-    src/ui/missioneditor.h \
-    src/ui/commandeditordialog.h \
-    src/ui/mapwidget.h \
-    src/ui/compasswidget.h \
-    src/ui/hudwidget.h \
-    src/comm/linkinterface.h \
-    src/comm/udplink.h \
-    src/comm/linkmanager.h \
-    src/comm/mavlinkrouter.h \
-    src/comm/commandbus.h \
-    src/models/vehiclemodel.h \
-    src/models/healthmodel.h \
-    src/models/waypoint.h \
-    src/models/missionmodel.h \
-    src/models/geofencemodel.h
-
-# Forms
-FORMS += \
-    src/ui/mainwindow.ui
-
-# Resources
-RESOURCES += \
-    resources/resources.qrc
+    src/main.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
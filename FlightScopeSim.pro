@@ -0,0 +1,29 @@
+# flightscope-sim: headless MAVLink vehicle simulator for load testing
+TARGET = flightscope-sim
+TEMPLATE = app
+
+QT = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+# Include paths
+INCLUDEPATH += $$PWD/third-party
+INCLUDEPATH += $$PWD/src
+
+SOURCES += \
+    src/sim/main.cpp \
+    src/sim/simvehicle.cpp \
+    src/sim/vehiclesimulator.cpp
+
+HEADERS += \
+    src/comm/mavlinkmessagetraits.h \
+    src/comm/relaxedcounter.h \
+    src/sim/simvehicle.h \
+    src/sim/vehiclesimulator.h
+
+unix:!android: target.path = /opt/flightscope/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,54 @@
+import QtQuick
+import QtLocation
+import QtPositioning
+
+// Fleet layer - one marker per FleetModel row (every on-screen vehicle but
+// the active one). Delegates bind straight to the model roles; FleetModel
+// culls off-screen vehicles and batches updates once per frame.
+MapItemView {
+    id: fleetLayer
+
+    property real iconSize: 28
+
+    delegate: MapQuickItem {
+        coordinate: QtPositioning.coordinate(model.latitude, model.longitude)
+        anchorPoint.x: fleetLayer.iconSize / 2
+        anchorPoint.y: fleetLayer.iconSize / 2
+        zoomLevel: 0
+
+        sourceItem: Item {
+            width: fleetLayer.iconSize
+            height: fleetLayer.iconSize
+
+            Image {
+                anchors.fill: parent
+                rotation: model.heading
+                opacity: model.armed ? 1.0 : 0.6
+                source: "qrc:/icons/icons/drone.svg"
+                // Rasterized once at icon size and shared by every marker
+                sourceSize.width: fleetLayer.iconSize
+                sourceSize.height: fleetLayer.iconSize
+                fillMode: Image.PreserveAspectFit
+            }
+
+            // System ID badge
+            Rectangle {
+                anchors.horizontalCenter: parent.horizontalCenter
+                anchors.top: parent.bottom
+                width: idText.width + 6
+                height: 14
+                radius: 3
+                color: "#000000"
+                opacity: 0.7
+
+                Text {
+                    id: idText
+                    anchors.centerIn: parent
+                    text: model.systemId
+                    color: "#FFFFFF"
+                    font.pixelSize: 10
+                }
+            }
+        }
+    }
+}
@@ -49,6 +49,14 @@ Item {
         center: QtPositioning.coordinate(vehicleLat, vehicleLon)
         zoomLevel: 15
 
+        // Keep the fleet and trail layers' culling in step with what is on screen
+        onCenterChanged: updateViewport()
+        onZoomLevelChanged: updateViewport()
+        onBearingChanged: updateViewport()
+        onTiltChanged: updateViewport()
+        onWidthChanged: updateViewport()
+        onHeightChanged: updateViewport()
+
         // Map type (Qt 6 uses mapType instead of activeMapType)
         // Default to first available map type (usually street map for OSM)
 
@@ -62,6 +70,13 @@ Item {
             }
         }
 
+        // Other vehicles (drawn below the active vehicle's marker)
+        FleetLayer {
+            id: fleetLayer
+            model: fleetModel
+            iconSize: droneIconSize * 0.75
+        }
+
         // Vehicle marker - Using SVG icon
         MapQuickItem {
             id: vehicleMarker
@@ -108,12 +123,18 @@ Item {
             }
         }
 
-        // Flight path trail - Straight green lines
-        MapPolyline {
+        // Flight path trail - Straight green lines, one polyline per
+        // TrailModel row: only the on-screen part, simplified to the zoom
+        MapItemView {
             id: flightTrail
-            line.width: 1.5
-            line.color: "#4CAF50"
-            opacity: 1.0
+            model: trailModel
+
+            delegate: MapPolyline {
+                line.width: 1.5
+                line.color: "#4CAF50"
+                opacity: 1.0
+                path: model.path
+            }
         }
 
         // Mission path (connecting waypoints)
@@ -550,19 +571,19 @@ Item {
         homeSet = true;
     }
 
-    function centerOnCoordinate(lat, lon) {
-        map.center = QtPositioning.coordinate(lat, lon);
+    function updateViewport() {
+        var bounds = map.visibleRegion.boundingGeoRectangle();
+        if (bounds.isValid) {
+            fleetModel.setViewport(bounds.topLeft.latitude, bounds.topLeft.longitude,
+                                   bounds.bottomRight.latitude, bounds.bottomRight.longitude);
+            trailModel.setViewport(bounds.topLeft.latitude, bounds.topLeft.longitude,
+                                   bounds.bottomRight.latitude, bounds.bottomRight.longitude,
+                                   map.width, map.height);
+        }
     }
 
-    function updateTrail(trailPoints) {
-        var path = [];
-        for (var i = 0; i < trailPoints.length; i++) {
-            path.push(QtPositioning.coordinate(
-                trailPoints[i].latitude,
-                trailPoints[i].longitude
-            ));
-        }
-        flightTrail.path = path;
+    function centerOnCoordinate(lat, lon) {
+        map.center = QtPositioning.coordinate(lat, lon);
     }
 
     function updateWaypoints(waypoints) {
@@ -0,0 +1,98 @@
+#include "bytering.h"
+#include <cstring>
+
+namespace {
+quint64 roundUpToPowerOfTwo(quint64 value) {
+    quint64 result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+}  // namespace
+
+ByteRing::ByteRing(qsizetype capacity)
+    : m_buffer(nullptr),
+      m_capacity(roundUpToPowerOfTwo(static_cast<quint64>(qMax<qsizetype>(capacity, 64)))),
+      m_mask(m_capacity - 1) {
+    m_buffer = new char[m_capacity];
+}
+
+ByteRing::~ByteRing() {
+    delete[] m_buffer;
+}
+
+bool ByteRing::write(const char* data, qsizetype size) {
+    if (size <= 0) {
+        return true;
+    }
+
+    const quint64 bytes = static_cast<quint64>(size);
+    const quint64 head = m_head.load(std::memory_order_relaxed);
+
+    // Refresh the cached consumer index only when the ring looks full
+    if (m_capacity - (head - m_cachedTail) < bytes) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        if (m_capacity - (head - m_cachedTail) < bytes) {
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            m_bytesDropped.fetch_add(bytes, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    const quint64 offset = head & m_mask;
+    const quint64 first = qMin(bytes, m_capacity - offset);
+    memcpy(m_buffer + offset, data, first);
+    if (bytes > first) {
+        memcpy(m_buffer, data + first, bytes - first);
+    }
+
+    m_head.store(head + bytes, std::memory_order_release);
+    m_bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+
+    // The cached tail may be stale, making this an upper bound; refresh it
+    // before raising the mark
+    const quint64 highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+    if (head + bytes - m_cachedTail > highWaterMark) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        const quint64 buffered = head + bytes - m_cachedTail;
+        if (buffered > highWaterMark) {
+            m_highWaterMark.store(buffered, std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+qsizetype ByteRing::writable() const {
+    const quint64 head = m_head.load(std::memory_order_relaxed);
+    const quint64 tail = m_tail.load(std::memory_order_acquire);
+    return static_cast<qsizetype>(m_capacity - (head - tail));
+}
+
+bool ByteRing::requestWake() {
+    // Order the data publication before the flag so a consumer that clears
+    // the flag afterwards is guaranteed to see the new head
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return !m_wakePending.exchange(true, std::memory_order_seq_cst);
+}
+
+void ByteRing::acknowledgeWake() {
+    m_wakePending.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+qsizetype ByteRing::readable() const {
+    const quint64 head = m_head.load(std::memory_order_acquire);
+    const quint64 tail = m_tail.load(std::memory_order_relaxed);
+    return static_cast<qsizetype>(head - tail);
+}
+
+ByteRing::Statistics ByteRing::statistics() const {
+    Statistics stats;
+    stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    stats.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+    stats.overruns = m_overruns.load(std::memory_order_relaxed);
+    stats.bytesDropped = m_bytesDropped.load(std::memory_order_relaxed);
+    stats.highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,134 @@
+#ifndef BYTERING_H
+#define BYTERING_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief Lock-free single-producer/single-consumer byte ring
+ *
+ * Preallocated power-of-two buffer shared between a link's worker thread
+ * (producer) and the MAVLink parser (consumer). The producer copies each
+ * received chunk in with write(); the consumer reads the bytes in place
+ * through consume() without copying them into a QByteArray.
+ *
+ * Wakeups are coalesced: the producer calls requestWake() after a batch
+ * and only notifies the consumer when it returns true, i.e. when no wakeup
+ * is already pending. The consumer calls acknowledgeWake() before draining.
+ *
+ * When the consumer falls behind, chunks that do not fit are dropped whole
+ * and counted as overruns.
+ */
+class ByteRing {
+public:
+    struct Statistics {
+        quint64 bytesWritten{0};
+        quint64 bytesRead{0};
+        quint64 overruns{0};      // chunks dropped because the ring was full
+        quint64 bytesDropped{0};
+        quint64 highWaterMark{0};  // max bytes buffered at once
+    };
+
+    /**
+     * @param capacity Requested size in bytes, rounded up to a power of two
+     */
+    explicit ByteRing(qsizetype capacity);
+    ~ByteRing();
+
+    ByteRing(const ByteRing&) = delete;
+    ByteRing& operator=(const ByteRing&) = delete;
+
+    qsizetype capacity() const { return static_cast<qsizetype>(m_capacity); }
+
+    // Producer side -------------------------------------------------------
+
+    /**
+     * @brief Append a chunk; all-or-nothing
+     * @return false if the chunk did not fit and was dropped
+     */
+    bool write(const char* data, qsizetype size);
+
+    /**
+     * @brief Free space as seen by the producer
+     */
+    qsizetype writable() const;
+
+    /**
+     * @brief Mark the ring readable after a batch
+     * @return true if the consumer must be woken
+     */
+    bool requestWake();
+
+    // Consumer side -------------------------------------------------------
+
+    /**
+     * @brief Clear the pending-wake flag; call before draining
+     */
+    void acknowledgeWake();
+
+    /**
+     * @brief Bytes currently buffered
+     */
+    qsizetype readable() const;
+
+    /**
+     * @brief Absolute stream position of the next byte to be consumed
+     */
+    quint64 readPosition() const { return m_tail.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Hand buffered bytes to @p fn in place and release them
+     *
+     * @p fn is called as fn(const char* data, qsizetype size) once, or twice
+     * when the readable region wraps around the end of the buffer.
+     * @return Number of bytes consumed
+     */
+    template <typename Fn>
+    qsizetype consume(Fn&& fn, qsizetype maxBytes = -1) {
+        const quint64 tail = m_tail.load(std::memory_order_relaxed);
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        quint64 available = head - tail;
+        if (maxBytes >= 0 && available > static_cast<quint64>(maxBytes)) {
+            available = static_cast<quint64>(maxBytes);
+        }
+        if (available == 0) {
+            return 0;
+        }
+
+        const quint64 offset = tail & m_mask;
+        const quint64 first = qMin(available, m_capacity - offset);
+        fn(static_cast<const char*>(m_buffer + offset), static_cast<qsizetype>(first));
+        if (available > first) {
+            fn(static_cast<const char*>(m_buffer), static_cast<qsizetype>(available - first));
+        }
+
+        m_tail.store(tail + available, std::memory_order_release);
+        m_bytesRead.fetch_add(available, std::memory_order_relaxed);
+        return static_cast<qsizetype>(available);
+    }
+
+    /**
+     * @brief Counter snapshot (any thread)
+     */
+    Statistics statistics() const;
+
+private:
+    char* m_buffer;
+    quint64 m_capacity;
+    quint64 m_mask;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<quint64> m_head{0};
+    quint64 m_cachedTail{0};
+    std::atomic<quint64> m_bytesWritten{0};
+    std::atomic<quint64> m_overruns{0};
+    std::atomic<quint64> m_bytesDropped{0};
+    std::atomic<quint64> m_highWaterMark{0};
+
+    alignas(64) std::atomic<quint64> m_tail{0};
+    std::atomic<quint64> m_bytesRead{0};
+
+    alignas(64) std::atomic<bool> m_wakePending{false};
+};
+
+#endif  // BYTERING_H
@@ -30,6 +30,12 @@ public:
      */
     uint8_t lastCommandResult() const { return m_lastCommandResult; }
 
+    /**
+     * @brief Vehicle that commands are addressed to
+     */
+    void setVehicleModel(VehicleModel* vehicleModel) { m_vehicleModel = vehicleModel; }
+    VehicleModel* vehicleModel() const { return m_vehicleModel; }
+
 public slots:
     /**
      * @brief Arm the vehicle
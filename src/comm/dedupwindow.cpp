@@ -0,0 +1,50 @@
+#include "dedupwindow.h"
+
+DedupWindow::DedupWindow() {}
+
+void DedupWindow::reset() {
+    m_entries.fill(Entry());
+    m_statistics = Statistics();
+}
+
+bool DedupWindow::isDuplicate(uint8_t systemId, uint8_t componentId, uint8_t seq,
+                              uint32_t msgId, uint16_t checksum, qint64 nowMs,
+                              qint64* firstSeenMs) {
+    // sysid:8 | compid:8 | seq:8 | msgid:24 | crc:16 fills the key exactly
+    const quint64 key = (static_cast<quint64>(systemId) << 56) |
+                        (static_cast<quint64>(componentId) << 48) |
+                        (static_cast<quint64>(seq) << 40) |
+                        (static_cast<quint64>(msgId & 0xFFFFFF) << 16) | checksum;
+
+    // Fibonacci hash, top bits select the set
+    const quint64 set = (key * 0x9E3779B97F4A7C15ull) >> (64 - SET_BITS);
+    Entry* ways = &m_entries[set * WAYS];
+
+    m_statistics.checked++;
+    Entry* oldest = ways;
+    for (int way = 0; way < WAYS; ++way) {
+        Entry& entry = ways[way];
+        const bool live = entry.timeMs != EMPTY && nowMs - entry.timeMs <= WINDOW_MS;
+        if (live && entry.key == key) {
+            // Keep the first arrival's time so a stream of copies cannot extend the window
+            m_statistics.duplicates++;
+            if (firstSeenMs) {
+                *firstSeenMs = entry.timeMs;
+            }
+            return true;
+        }
+        if (entry.timeMs < oldest->timeMs) {
+            oldest = &entry;
+        }
+    }
+
+    if (oldest->timeMs != EMPTY && nowMs - oldest->timeMs <= WINDOW_MS) {
+        m_statistics.evictions++;
+    }
+    oldest->key = key;
+    oldest->timeMs = nowMs;
+    if (firstSeenMs) {
+        *firstSeenMs = nowMs;
+    }
+    return false;
+}
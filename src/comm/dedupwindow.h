@@ -0,0 +1,60 @@
+#ifndef DEDUPWINDOW_H
+#define DEDUPWINDOW_H
+
+#include <QtGlobal>
+#include <array>
+
+/**
+ * @brief Fixed-memory duplicate filter for messages received on redundant links
+ *
+ * When a vehicle is reachable over two links, every packet arrives twice.
+ * A packet is identified by (sysid, compid, seq, msgid) plus its CRC, which
+ * tells apart different packets that happen to reuse a sequence number after
+ * the 8-bit counter wraps. Keys live in a 4-way set-associative table: a new
+ * key replaces the oldest entry of its set, so memory is bounded and a lookup
+ * touches one cache line. A duplicate is only recognised if its first copy
+ * is still in the table and no older than WINDOW_MS.
+ *
+ * Not thread-safe: owned by the parser thread.
+ */
+class DedupWindow {
+public:
+    static constexpr int WAYS = 4;
+    static constexpr int SET_BITS = 10;
+    static constexpr int SLOTS = WAYS << SET_BITS;
+    static constexpr qint64 WINDOW_MS = 500;  // max arrival skew between links
+
+    struct Statistics {
+        quint64 checked{0};
+        quint64 duplicates{0};
+        quint64 evictions{0};  // live keys overwritten before their window expired
+    };
+
+    DedupWindow();
+
+    /**
+     * @brief Look up a packet and remember it if it is new
+     * @param firstSeenMs If not null, set to the first copy's arrival time
+     * for a duplicate, or to @p nowMs for a new packet
+     * @return true if the same packet was already seen within WINDOW_MS
+     */
+    bool isDuplicate(uint8_t systemId, uint8_t componentId, uint8_t seq, uint32_t msgId,
+                     uint16_t checksum, qint64 nowMs, qint64* firstSeenMs = nullptr);
+
+    const Statistics& statistics() const { return m_statistics; }
+
+    void reset();
+
+private:
+    struct Entry {
+        quint64 key{0};
+        qint64 timeMs{EMPTY};
+    };
+
+    static constexpr qint64 EMPTY = -1;
+
+    alignas(64) std::array<Entry, SLOTS> m_entries;  // one set per cache line
+    Statistics m_statistics;
+};
+
+#endif  // DEDUPWINDOW_H
@@ -0,0 +1,238 @@
+#include "impairedlink.h"
+#include <QTimer>
+#include "mavlinkframing.h"
+#include "relaxedcounter.h"
+
+namespace {
+constexpr qint64 NS_PER_MS = 1000000;
+constexpr qint64 NS_PER_SECOND = 1000000000;
+}  // namespace
+
+ImpairedLink::ImpairedLink(LinkInterface* link, const Configuration& config, QObject* parent)
+    : LinkInterface(parent), m_link(link), m_deliveryTimer(nullptr) {
+    m_link->setParent(this);
+
+    // Independent, reproducible streams per direction
+    m_inbound.impairment = config.inbound;
+    m_inbound.inbound = true;
+    std::seed_seq inboundSeed{config.seed, 0u};
+    m_inbound.random.seed(inboundSeed);
+    m_outbound.impairment = config.outbound;
+    std::seed_seq outboundSeed{config.seed, 1u};
+    m_outbound.random.seed(outboundSeed);
+
+    m_deliveryTimer = new QTimer(this);
+    m_deliveryTimer->setSingleShot(true);
+    m_deliveryTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_deliveryTimer, &QTimer::timeout, this, &ImpairedLink::onDeliveryTimer);
+
+    connect(m_link, &LinkInterface::bytesReceived, this, &ImpairedLink::onWrappedBytesReceived);
+    connect(m_link, &LinkInterface::statusChanged, this, &LinkInterface::statusChanged);
+    connect(m_link, &LinkInterface::errorOccurred, this, &LinkInterface::errorOccurred);
+    connect(m_link, &LinkInterface::bytesWritten, this, &LinkInterface::bytesWritten);
+    connect(m_link, &LinkInterface::backPressureChanged, this,
+            &LinkInterface::backPressureChanged);
+    m_clock.start();
+}
+
+ImpairedLink::~ImpairedLink() {
+    // The wrapped link is deleted as a child, after this object is gone
+    m_link->disconnectLink();
+}
+
+QString ImpairedLink::name() const {
+    return m_link->name();
+}
+
+ImpairedLink::LinkStatus ImpairedLink::status() const {
+    return m_link->status();
+}
+
+bool ImpairedLink::isConnected() const {
+    return m_link->isConnected();
+}
+
+ImpairedLink::Statistics ImpairedLink::statistics() const {
+    Statistics stats;
+    stats.inbound = snapshot(m_inbound.counters);
+    stats.outbound = snapshot(m_outbound.counters);
+    return stats;
+}
+
+void ImpairedLink::connectLink() {
+    m_link->connectLink();
+}
+
+void ImpairedLink::disconnectLink() {
+    // Packets still in flight die with the link
+    m_deliveryTimer->stop();
+    m_schedule.clear();
+    m_inboundPartial.clear();
+    m_link->disconnectLink();
+}
+
+void ImpairedLink::writeBytes(const QByteArray& data) {
+    impair(m_outbound, data);
+}
+
+void ImpairedLink::onWrappedBytesReceived(const QByteArray& data) {
+    m_inboundPartial.append(data);
+    const auto* bytes = reinterpret_cast<const uchar*>(m_inboundPartial.constData());
+    const qsizetype size = m_inboundPartial.size();
+
+    qsizetype offset = 0;
+    while (offset < size) {
+        const qsizetype length = MavlinkFraming::packetLength(bytes + offset, size - offset);
+        if (length == 0) {
+            break;  // rest of the frame comes with the next read
+        }
+        if (length < 0) {
+            // Not MAVLink: pass the bytes up to the next start marker through as one unit
+            qsizetype next = offset + 1;
+            while (next < size && !MavlinkFraming::isStartMarker(bytes[next])) {
+                next++;
+            }
+            impair(m_inbound, m_inboundPartial.mid(offset, next - offset));
+            offset = next;
+            continue;
+        }
+        impair(m_inbound, m_inboundPartial.mid(offset, length));
+        offset += length;
+    }
+    m_inboundPartial.remove(0, offset);
+}
+
+void ImpairedLink::onDeliveryTimer() {
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    bool deliveredInbound = false;
+    while (!m_schedule.empty() && m_schedule.begin()->first <= nowNs) {
+        auto it = m_schedule.begin();
+        deliver(it->second);
+        deliveredInbound |= it->second.inbound;
+        m_schedule.erase(it);
+    }
+    if (deliveredInbound) {
+        flushReceivedBytes();
+    }
+    armTimer();
+}
+
+void ImpairedLink::impair(Direction& direction, const QByteArray& packet) {
+    const Impairment& impairment = direction.impairment;
+    RelaxedCounter::add(direction.counters.packets, 1);
+
+    // Always the same draws per packet, whichever branch is taken
+    const double burstDraw = uniform(direction);
+    const double lossDraw = uniform(direction);
+    const double jitterDraw = uniform(direction);
+    const double reorderDraw = uniform(direction);
+    const double duplicateDraw = uniform(direction);
+
+    if (direction.burst) {
+        direction.burst = burstDraw >= impairment.burstEndRate;
+    } else {
+        direction.burst = burstDraw < impairment.burstStartRate;
+    }
+    if (direction.burst) {
+        RelaxedCounter::add(direction.counters.burstLost, 1);
+        return;
+    }
+    if (lossDraw < impairment.lossRate) {
+        RelaxedCounter::add(direction.counters.lost, 1);
+        return;
+    }
+
+    const bool reorder = reorderDraw < impairment.reorderRate;
+    schedule(direction, packet, jitterDraw, reorder);
+    if (duplicateDraw < impairment.duplicateRate) {
+        RelaxedCounter::add(direction.counters.duplicated, 1);
+        schedule(direction, packet, jitterDraw, reorder);
+    }
+}
+
+void ImpairedLink::schedule(Direction& direction, const QByteArray& packet, double jitterDraw,
+                            bool reorder) {
+    const Impairment& impairment = direction.impairment;
+    const qint64 nowNs = m_clock.nsecsElapsed();
+
+    // Serialization at the capped rate, behind whatever is still queued
+    qint64 departureNs = nowNs;
+    if (impairment.bandwidthBytesPerSec > 0) {
+        const qint64 bandwidth = static_cast<qint64>(impairment.bandwidthBytesPerSec);
+        const qint64 backlogNs = qMax<qint64>(direction.busyUntilNs - nowNs, 0);
+        const quint64 backlogBytes = static_cast<quint64>(backlogNs * bandwidth / NS_PER_SECOND);
+        if (impairment.queueLimitBytes > 0 &&
+            backlogBytes + static_cast<quint64>(packet.size()) > impairment.queueLimitBytes) {
+            RelaxedCounter::add(direction.counters.queueDropped, 1);
+            return;
+        }
+        departureNs = nowNs + backlogNs + packet.size() * NS_PER_SECOND / bandwidth;
+        direction.busyUntilNs = departureNs;
+    }
+
+    qint64 arrivalNs = departureNs + impairment.latencyMs * NS_PER_MS +
+                       static_cast<qint64>(jitterDraw * impairment.jitterMs * NS_PER_MS);
+    if (reorder) {
+        arrivalNs += impairment.reorderDelayMs * NS_PER_MS;
+        RelaxedCounter::add(direction.counters.reordered, 1);
+    } else {
+        arrivalNs = qMax(arrivalNs, direction.lastArrivalNs);
+        direction.lastArrivalNs = arrivalNs;
+    }
+
+    // Unimpaired traffic with nothing ahead of it goes straight through
+    if (arrivalNs <= nowNs && m_schedule.empty()) {
+        deliver(Pending{direction.inbound, packet});
+        if (direction.inbound) {
+            flushReceivedBytes();
+        }
+        return;
+    }
+
+    m_schedule.emplace(arrivalNs, Pending{direction.inbound, packet});
+    armTimer();
+}
+
+void ImpairedLink::deliver(const Pending& pending) {
+    if (pending.inbound) {
+        if (pushReceivedBytes(pending.data.constData(), pending.data.size())) {
+            RelaxedCounter::add(m_inbound.counters.delivered, 1);
+        } else {
+            RelaxedCounter::add(m_inbound.counters.ringDropped, 1);
+        }
+    } else {
+        m_link->writeBytes(pending.data);
+        RelaxedCounter::add(m_outbound.counters.delivered, 1);
+    }
+}
+
+void ImpairedLink::armTimer() {
+    if (m_schedule.empty()) {
+        m_deliveryTimer->stop();
+        return;
+    }
+
+    const qint64 waitNs = m_schedule.begin()->first - m_clock.nsecsElapsed();
+    const int waitMs = static_cast<int>(qMax<qint64>((waitNs + NS_PER_MS - 1) / NS_PER_MS, 0));
+    if (!m_deliveryTimer->isActive() || m_deliveryTimer->remainingTime() > waitMs) {
+        m_deliveryTimer->start(waitMs);
+    }
+}
+
+double ImpairedLink::uniform(Direction& direction) {
+    // mt19937's output is fully specified, unlike the standard distributions
+    return direction.random() * (1.0 / 4294967296.0);
+}
+
+ImpairedLink::DirectionStatistics ImpairedLink::snapshot(const Counters& counters) {
+    DirectionStatistics stats;
+    stats.packets = counters.packets.load(std::memory_order_relaxed);
+    stats.delivered = counters.delivered.load(std::memory_order_relaxed);
+    stats.lost = counters.lost.load(std::memory_order_relaxed);
+    stats.burstLost = counters.burstLost.load(std::memory_order_relaxed);
+    stats.queueDropped = counters.queueDropped.load(std::memory_order_relaxed);
+    stats.ringDropped = counters.ringDropped.load(std::memory_order_relaxed);
+    stats.duplicated = counters.duplicated.load(std::memory_order_relaxed);
+    stats.reordered = counters.reordered.load(std::memory_order_relaxed);
+    return stats;
+}
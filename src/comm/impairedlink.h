@@ -0,0 +1,148 @@
+#ifndef IMPAIREDLINK_H
+#define IMPAIREDLINK_H
+
+#include "linkinterface.h"
+#include <QElapsedTimer>
+#include <atomic>
+#include <map>
+#include <random>
+
+class QTimer;
+
+/**
+ * @brief Network impairment emulator wrapping another link
+ *
+ * Decorates any LinkInterface with the behaviour of a poor radio link, in
+ * both directions independently: latency and jitter, random loss, burst
+ * loss (a two-state Gilbert-Elliott model), reordering, duplication and a
+ * bandwidth cap with a bounded queue. Meant for reproducible tests of
+ * mission uploads and command round trips without flying.
+ *
+ * Every packet consumes the same fixed number of draws from a std::mt19937
+ * seeded from Configuration::seed, so the same seed and the same traffic
+ * always lose, duplicate and reorder the same packets.
+ *
+ * Inbound bytes are split into MAVLink frames, so loss applies to whole
+ * packets even when the wrapped link hands over several at once. Each
+ * outbound writeBytes() call is one packet; MavlinkRouter writes one
+ * message per call.
+ *
+ * The wrapped link is owned by and lives on the same thread as this one;
+ * LinkManager moves both to the link thread together. Its receive ring is
+ * not used: its bytes come through bytesReceived() and leave through this
+ * link's ring once their delay has passed.
+ */
+class ImpairedLink : public LinkInterface {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Conditions applied to one direction (all off by default)
+     */
+    struct Impairment {
+        int latencyMs{0};
+        int jitterMs{0};             // extra delay, uniform in [0, jitterMs]; keeps order
+        double lossRate{0.0};        // independent loss probability per packet
+        double burstStartRate{0.0};  // per packet: good -> bad state; bad loses everything
+        double burstEndRate{1.0};    // per packet: bad -> good; mean burst = 1 / burstEndRate
+        double reorderRate{0.0};     // held back by reorderDelayMs so later packets overtake
+        int reorderDelayMs{20};
+        double duplicateRate{0.0};
+        quint64 bandwidthBytesPerSec{0};  // 0 = unlimited
+        quint64 queueLimitBytes{0};       // waiting for bandwidth; 0 = unbounded
+    };
+
+    struct Configuration {
+        Impairment inbound;   // vehicle -> ground station
+        Impairment outbound;  // ground station -> vehicle
+        quint32 seed{1};
+    };
+
+    /**
+     * @brief Per-direction counters (safe to read from any thread)
+     */
+    struct DirectionStatistics {
+        quint64 packets{0};  // offered
+        quint64 delivered{0};
+        quint64 lost{0};
+        quint64 burstLost{0};
+        quint64 queueDropped{0};  // bandwidth queue full
+        quint64 ringDropped{0};   // inbound only: receive ring full on delivery
+        quint64 duplicated{0};
+        quint64 reordered{0};
+    };
+
+    struct Statistics {
+        DirectionStatistics inbound;
+        DirectionStatistics outbound;
+    };
+
+    /**
+     * @brief Wrap @p link, taking ownership of it
+     */
+    ImpairedLink(LinkInterface* link, const Configuration& config, QObject* parent = nullptr);
+    ~ImpairedLink() override;
+
+    QString name() const override;
+    LinkStatus status() const override;
+    bool isConnected() const override;
+    bool expectsHeartbeat() const override { return m_link->expectsHeartbeat(); }
+
+    LinkInterface* wrappedLink() const { return m_link; }
+    Statistics statistics() const;
+
+public slots:
+    void connectLink() override;
+    void disconnectLink() override;
+    void writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onWrappedBytesReceived(const QByteArray& data);
+    void onDeliveryTimer();
+
+private:
+    struct Counters {
+        std::atomic<quint64> packets{0};
+        std::atomic<quint64> delivered{0};
+        std::atomic<quint64> lost{0};
+        std::atomic<quint64> burstLost{0};
+        std::atomic<quint64> queueDropped{0};
+        std::atomic<quint64> ringDropped{0};
+        std::atomic<quint64> duplicated{0};
+        std::atomic<quint64> reordered{0};
+    };
+
+    struct Direction {
+        Impairment impairment;
+        std::mt19937 random;
+        bool inbound{false};
+        bool burst{false};         // Gilbert-Elliott bad state
+        qint64 busyUntilNs{0};     // when the bandwidth-limited sender is free again
+        qint64 lastArrivalNs{0};   // in-order arrivals never overtake each other
+        Counters counters;
+    };
+
+    struct Pending {
+        bool inbound;
+        QByteArray data;
+    };
+
+    void impair(Direction& direction, const QByteArray& packet);
+    void schedule(Direction& direction, const QByteArray& packet, double jitterDraw,
+                  bool reorder);
+    void deliver(const Pending& pending);
+    void armTimer();
+    static double uniform(Direction& direction);
+    static DirectionStatistics snapshot(const Counters& counters);
+
+    LinkInterface* m_link;
+    Direction m_inbound;
+    Direction m_outbound;
+    QByteArray m_inboundPartial;  // incomplete frame from the wrapped link
+
+    QElapsedTimer m_clock;
+    std::multimap<qint64, Pending> m_schedule;  // by arrival time; FIFO for equal times
+    QTimer* m_deliveryTimer;
+};
+
+#endif  // IMPAIREDLINK_H
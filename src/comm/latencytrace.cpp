@@ -0,0 +1,346 @@
+#include "latencytrace.h"
+#include "mavlinkframing.h"
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QVector>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr quint64 KEY_VALID = quint64(1) << 48;
+constexpr qint64 DUPLICATE_WINDOW_NS = 1000000000;  // redundant copies keep the first receive
+
+int receiveSlotFor(quint64 key) {
+    // Fibonacci hashing spreads consecutive sequence numbers across the table
+    return static_cast<int>((key * 0x9E3779B97F4A7C15ull) >> 52) &
+           (LatencyTrace::RECEIVE_TABLE_SIZE - 1);
+}
+
+}  // namespace
+
+LatencyTrace::LatencyTrace()
+    : m_events(new Event[EVENT_CAPACITY]), m_receiveTable(new ReceiveSlot[RECEIVE_TABLE_SIZE]) {
+    clear();
+}
+
+LatencyTrace::~LatencyTrace() = default;
+
+LatencyTrace& LatencyTrace::instance() {
+    static LatencyTrace trace;
+    return trace;
+}
+
+void LatencyTrace::clear() {
+    for (int i = 0; i < EVENT_CAPACITY; ++i) {
+        m_events[i].stamp.store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < RECEIVE_TABLE_SIZE; ++i) {
+        m_receiveTable[i].key.store(0, std::memory_order_relaxed);
+    }
+    for (auto& buckets : m_buckets) {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (auto& max : m_maxUs) {
+        max.store(0, std::memory_order_relaxed);
+    }
+    m_writeIndex.store(0, std::memory_order_release);
+}
+
+qint64 LatencyTrace::nowNs() {
+    // system_clock is CLOCK_REALTIME, the clock SO_TIMESTAMPNS reports
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+quint64 LatencyTrace::key(uint8_t systemId, uint8_t componentId, uint32_t msgId,
+                          uint8_t sequence) {
+    return KEY_VALID | (quint64(systemId) << 40) | (quint64(componentId) << 32) |
+           (quint64(msgId & 0xFFFFFF) << 8) | sequence;
+}
+
+void LatencyTrace::record(Stage stage, quint64 key, qint64 timestampNs) {
+    if (!isEnabled() || key == 0 || stage >= STAGE_COUNT) {
+        return;
+    }
+    if (timestampNs == 0) {
+        timestampNs = nowNs();
+    }
+
+    ReceiveSlot& slot = m_receiveTable[receiveSlotFor(key)];
+    if (stage == SocketReceive) {
+        const qint64 previous = slot.timestampNs.load(std::memory_order_relaxed);
+        const bool duplicate = slot.key.load(std::memory_order_acquire) == key &&
+                               previous <= timestampNs &&
+                               timestampNs - previous < DUPLICATE_WINDOW_NS;
+        if (!duplicate) {
+            slot.key.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_release);
+        }
+    } else {
+        // Key read before and after the timestamp rejects a slot being rewritten
+        const quint64 before = slot.key.load(std::memory_order_acquire);
+        const qint64 receivedNs = slot.timestampNs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 after = slot.key.load(std::memory_order_relaxed);
+        if (before == key && after == key && timestampNs >= receivedNs) {
+            const quint64 us = static_cast<quint64>(timestampNs - receivedNs) / 1000;
+            m_buckets[stage][bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+            std::atomic<quint64>& max = m_maxUs[stage];
+            quint64 current = max.load(std::memory_order_relaxed);
+            while (us > current &&
+                   !max.compare_exchange_weak(current, us, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    const quint64 index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Event& event = m_events[index & (EVENT_CAPACITY - 1)];
+    event.stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.key.store(key, std::memory_order_relaxed);
+    event.timestampNs.store(timestampNs, std::memory_order_relaxed);
+    event.stage.store(stage, std::memory_order_relaxed);
+    event.stamp.store(index + 1, std::memory_order_release);
+}
+
+void LatencyTrace::recordDatagram(const char* data, qsizetype size, qint64 timestampNs) {
+    if (!isEnabled()) {
+        return;
+    }
+    if (timestampNs == 0) {
+        timestampNs = nowNs();
+    }
+
+    const uchar* bytes = reinterpret_cast<const uchar*>(data);
+    qsizetype offset = 0;
+    while (offset < size) {
+        const qsizetype length = MavlinkFraming::packetLength(bytes + offset, size - offset);
+        if (length == 0) {
+            break;  // truncated frame
+        }
+        if (length < 0) {
+            ++offset;  // resynchronise on the next start marker
+            continue;
+        }
+
+        uint8_t systemId = 0;
+        uint8_t componentId = 0;
+        uint32_t msgId = 0;
+        MavlinkFraming::readHeader(bytes + offset, systemId, componentId, msgId);
+        record(SocketReceive,
+               key(systemId, componentId, msgId, MavlinkFraming::readSequence(bytes + offset)),
+               timestampNs);
+        offset += length;
+    }
+}
+
+LatencyTrace::Histogram LatencyTrace::histogram(Stage stage) const {
+    Histogram result;
+    if (stage == SocketReceive || stage >= STAGE_COUNT) {
+        return result;
+    }
+
+    std::array<quint64, HISTOGRAM_BUCKETS> counts;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        counts[i] = m_buckets[stage][i].load(std::memory_order_relaxed);
+        result.count += counts[i];
+    }
+    result.maxUs = m_maxUs[stage].load(std::memory_order_relaxed);
+    if (result.count == 0) {
+        return result;
+    }
+
+    auto percentile = [&](quint64 perMille) {
+        const quint64 rank = qMax<quint64>(1, (result.count * perMille + 999) / 1000);
+        quint64 seen = 0;
+        for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return qMin(bucketUpperBound(i), result.maxUs);
+            }
+        }
+        return result.maxUs;
+    };
+    result.p50Us = percentile(500);
+    result.p90Us = percentile(900);
+    result.p99Us = percentile(990);
+    return result;
+}
+
+bool LatencyTrace::exportChromeTrace(const QString& fileName, QString* errorString) const {
+    struct Snapshot {
+        quint64 key;
+        qint64 timestampNs;
+        quint8 stage;
+    };
+
+    // Copy out every slot that was not being rewritten while we read it
+    QVector<Snapshot> events;
+    events.reserve(static_cast<int>(qMin<quint64>(eventsRecorded(), EVENT_CAPACITY)));
+    for (int i = 0; i < EVENT_CAPACITY; ++i) {
+        const Event& event = m_events[i];
+        const quint64 stamp = event.stamp.load(std::memory_order_acquire);
+        if (stamp == 0) {
+            continue;
+        }
+        Snapshot snapshot{event.key.load(std::memory_order_relaxed),
+                          event.timestampNs.load(std::memory_order_relaxed),
+                          event.stage.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.stamp.load(std::memory_order_relaxed) == stamp && snapshot.stage < STAGE_COUNT) {
+            events.append(snapshot);
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const Snapshot& a, const Snapshot& b) {
+        return a.timestampNs < b.timestampNs ||
+               (a.timestampNs == b.timestampNs && a.stage < b.stage);
+    });
+
+    QJsonArray traceEvents;
+    traceEvents.append(QJsonObject{{"name", "process_name"},
+                                   {"ph", "M"},
+                                   {"pid", 1},
+                                   {"args", QJsonObject{{"name", "FlightScope"}}}});
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        traceEvents.append(
+            QJsonObject{{"name", "thread_name"},
+                        {"ph", "M"},
+                        {"pid", 1},
+                        {"tid", stage + 1},
+                        {"args", QJsonObject{{"name", componentName(Stage(stage))}}}});
+        traceEvents.append(QJsonObject{{"name", "thread_sort_index"},
+                                       {"ph", "M"},
+                                       {"pid", 1},
+                                       {"tid", stage + 1},
+                                       {"args", QJsonObject{{"sort_index", stage}}}});
+    }
+
+    // Each trace point is a 1 us slice on its component's track; consecutive
+    // points of the same message are joined by a flow arrow
+    struct LastSeen {
+        qint64 timestampNs;
+        qint64 receivedNs;
+        quint8 stage;
+    };
+    QHash<quint64, LastSeen> lastSeen;
+    const qint64 baseNs = events.isEmpty() ? 0 : events.first().timestampNs;
+    auto toUs = [baseNs](qint64 ns) { return (ns - baseNs) / 1000.0; };
+    qint64 flowId = 0;
+
+    for (const Snapshot& event : std::as_const(events)) {
+        const int tid = event.stage + 1;
+        QJsonObject args{{"sysid", int((event.key >> 40) & 0xFF)},
+                         {"compid", int((event.key >> 32) & 0xFF)},
+                         {"msgid", int((event.key >> 8) & 0xFFFFFF)},
+                         {"seq", int(event.key & 0xFF)}};
+
+        auto previous = lastSeen.find(event.key);
+        qint64 receivedNs = event.stage == SocketReceive ? event.timestampNs : -1;
+        if (previous != lastSeen.end() && event.stage != SocketReceive &&
+            previous->stage < event.stage) {
+            receivedNs = previous->receivedNs;
+            const QString id = QString::number(++flowId);
+            traceEvents.append(QJsonObject{{"name", "message"},
+                                           {"cat", "latency"},
+                                           {"ph", "s"},
+                                           {"id", id},
+                                           {"pid", 1},
+                                           {"tid", previous->stage + 1},
+                                           {"ts", toUs(previous->timestampNs)}});
+            traceEvents.append(QJsonObject{{"name", "message"},
+                                           {"cat", "latency"},
+                                           {"ph", "f"},
+                                           {"bp", "e"},
+                                           {"id", id},
+                                           {"pid", 1},
+                                           {"tid", tid},
+                                           {"ts", toUs(event.timestampNs)}});
+        }
+        if (receivedNs >= 0 && event.stage != SocketReceive) {
+            args.insert("latency_us", (event.timestampNs - receivedNs) / 1000.0);
+        }
+
+        traceEvents.append(QJsonObject{{"name", stageName(Stage(event.stage))},
+                                       {"cat", "latency"},
+                                       {"ph", "X"},
+                                       {"ts", toUs(event.timestampNs)},
+                                       {"dur", 1},
+                                       {"pid", 1},
+                                       {"tid", tid},
+                                       {"args", args}});
+        lastSeen.insert(event.key, LastSeen{event.timestampNs, receivedNs, event.stage});
+    }
+
+    QJsonObject root{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+    root.insert("otherData", QJsonObject{{"clock", "CLOCK_REALTIME"},
+                                         {"baseTimestampNs", QString::number(baseNs)}});
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0 || !file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+const char* LatencyTrace::stageName(Stage stage) {
+    switch (stage) {
+        case SocketReceive:
+            return "socket receive";
+        case ParseComplete:
+            return "parse complete";
+        case ModelUpdate:
+            return "model update";
+        case WidgetPaint:
+            return "widget paint";
+        default:
+            return "unknown";
+    }
+}
+
+const char* LatencyTrace::componentName(Stage stage) {
+    switch (stage) {
+        case SocketReceive:
+            return "UdpLink";
+        case ParseComplete:
+            return "MavlinkRouter";
+        case ModelUpdate:
+            return "VehicleModel";
+        case WidgetPaint:
+            return "HudWidget";
+        default:
+            return "unknown";
+    }
+}
+
+int LatencyTrace::bucketFor(quint64 us) {
+    // Values below 4 us get their own bucket, then four buckets per octave
+    if (us < 4) {
+        return static_cast<int>(us);
+    }
+    const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(us));
+    const int sub = static_cast<int>((us >> (msb - 2)) & 3);
+    return qMin(4 * (msb - 1) + sub, HISTOGRAM_BUCKETS - 1);
+}
+
+quint64 LatencyTrace::bucketUpperBound(int bucket) {
+    if (bucket < 4) {
+        return static_cast<quint64>(bucket);
+    }
+    const int msb = bucket / 4 + 1;
+    const quint64 sub = static_cast<quint64>(bucket % 4);
+    return ((4 + sub + 1) << (msb - 2)) - 1;
+}
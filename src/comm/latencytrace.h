@@ -0,0 +1,153 @@
+#ifndef LATENCYTRACE_H
+#define LATENCYTRACE_H
+
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief End-to-end latency tracing from socket to pixels
+ *
+ * Individual MAVLink messages are followed through the pipeline by a key
+ * made of their source, msgid and sequence number. Each component records a
+ * trace point when the message passes through it:
+ *
+ * - SocketReceive: UdpLink, with the kernel receive timestamp (SO_TIMESTAMPNS)
+ *   when the batched socket is in use
+ * - ParseComplete: MavlinkRouter, once the frame is parsed and accepted
+ * - ModelUpdate: VehicleModel, when the telemetry batch is applied
+ * - WidgetPaint: HudWidget, when the value is painted
+ *
+ * Every trace point after SocketReceive adds its latency since the socket
+ * receive of the same key to a per-stage histogram, and all trace points are
+ * kept in a fixed-size event buffer that exportChromeTrace() writes out as a
+ * Chrome/Perfetto trace (chrome://tracing, ui.perfetto.dev).
+ *
+ * Tracing is off by default and costs one relaxed atomic load per trace
+ * point while disabled. When enabled, record() never allocates or locks and
+ * is safe to call from any thread; the oldest events are overwritten once
+ * the buffer wraps. Timestamps are CLOCK_REALTIME nanoseconds so that user
+ * space and kernel timestamps can be compared.
+ */
+class LatencyTrace {
+public:
+    enum Stage : quint8 {
+        SocketReceive = 0,
+        ParseComplete,
+        ModelUpdate,
+        WidgetPaint,
+        STAGE_COUNT
+    };
+
+    /**
+     * @brief Latency since SocketReceive for one stage, in microseconds
+     *
+     * Percentiles are the upper bound of the histogram bucket they fall in
+     * (buckets are a quarter octave wide).
+     */
+    struct Histogram {
+        quint64 count{0};
+        quint64 p50Us{0};
+        quint64 p90Us{0};
+        quint64 p99Us{0};
+        quint64 maxUs{0};
+    };
+
+    static constexpr int EVENT_CAPACITY = 1 << 16;
+    static constexpr int RECEIVE_TABLE_SIZE = 1 << 12;
+    static constexpr int HISTOGRAM_BUCKETS = 128;
+
+    LatencyTrace();
+    ~LatencyTrace();
+
+    LatencyTrace(const LatencyTrace&) = delete;
+    LatencyTrace& operator=(const LatencyTrace&) = delete;
+
+    /**
+     * @brief The process-wide trace shared by all pipeline stages
+     */
+    static LatencyTrace& instance();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Drop all events and reset the histograms
+     *
+     * Only call while no other thread is recording.
+     */
+    void clear();
+
+    /**
+     * @brief Current time on the trace clock (CLOCK_REALTIME, ns)
+     */
+    static qint64 nowNs();
+
+    /**
+     * @brief Trace key identifying one message; never 0
+     */
+    static quint64 key(uint8_t systemId, uint8_t componentId, uint32_t msgId, uint8_t sequence);
+
+    /**
+     * @brief Record that the message @p key reached @p stage
+     * @param timestampNs trace clock time, 0 for now
+     */
+    void record(Stage stage, quint64 key, qint64 timestampNs = 0);
+
+    /**
+     * @brief Record SocketReceive for every MAVLink frame in a datagram
+     */
+    void recordDatagram(const char* data, qsizetype size, qint64 timestampNs = 0);
+
+    /**
+     * @brief Latency histogram of @p stage (empty for SocketReceive)
+     */
+    Histogram histogram(Stage stage) const;
+
+    /**
+     * @brief Events recorded since the last clear(), including overwritten ones
+     */
+    quint64 eventsRecorded() const { return m_writeIndex.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Write the buffered events as Chrome trace event JSON
+     *
+     * One track per component (UdpLink, MavlinkRouter, VehicleModel,
+     * HudWidget) with a flow arrow connecting the trace points of each
+     * message.
+     *
+     * @return false on I/O error, see @p errorString
+     */
+    bool exportChromeTrace(const QString& fileName, QString* errorString = nullptr) const;
+
+    static const char* stageName(Stage stage);
+    static const char* componentName(Stage stage);
+
+private:
+    struct Event {
+        std::atomic<quint64> stamp{0};  // write index + 1, published last
+        std::atomic<quint64> key{0};
+        std::atomic<qint64> timestampNs{0};
+        std::atomic<quint8> stage{0};
+    };
+
+    struct ReceiveSlot {
+        std::atomic<quint64> key{0};
+        std::atomic<qint64> timestampNs{0};
+    };
+
+    static int bucketFor(quint64 us);
+    static quint64 bucketUpperBound(int bucket);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<quint64> m_writeIndex{0};
+    std::unique_ptr<Event[]> m_events;
+    std::unique_ptr<ReceiveSlot[]> m_receiveTable;
+
+    std::array<std::array<std::atomic<quint64>, HISTOGRAM_BUCKETS>, STAGE_COUNT> m_buckets{};
+    std::array<std::atomic<quint64>, STAGE_COUNT> m_maxUs{};
+};
+
+#endif  // LATENCYTRACE_H
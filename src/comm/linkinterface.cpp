@@ -0,0 +1,83 @@
+#include "linkinterface.h"
+
+bool LinkInterface::pushReceivedBytes(const char* data, qsizetype size) {
+    if (m_receiveRing) {
+        return m_receiveRing->write(data, size);
+    }
+
+    m_pendingReceive.append(data, size);
+    return true;
+}
+
+void LinkInterface::flushReceivedBytes() {
+    if (m_receiveRing) {
+        if (m_receiveRing->readable() > 0 && m_receiveRing->requestWake()) {
+            emit receiveRingReadable();
+        }
+        return;
+    }
+
+    if (!m_pendingReceive.isEmpty()) {
+        emit bytesReceived(m_pendingReceive);
+        m_pendingReceive.clear();
+    }
+}
+
+LinkInterface::OutboundStatistics LinkInterface::outboundStatistics() const {
+    OutboundStatistics stats;
+    stats.maxQueuedBytes = m_maxQueuedBytes.load(std::memory_order_relaxed);
+    stats.bounded = stats.maxQueuedBytes > 0;
+    stats.queuedBytes = m_queuedBytes.load(std::memory_order_relaxed);
+    stats.peakQueuedBytes = m_peakQueuedBytes.load(std::memory_order_relaxed);
+    stats.droppedWrites = m_droppedWrites.load(std::memory_order_relaxed);
+    stats.droppedBytes = m_droppedBytes.load(std::memory_order_relaxed);
+    stats.congested = m_congested.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void LinkInterface::setOutboundLimit(quint64 maxQueuedBytes) {
+    m_maxQueuedBytes.store(maxQueuedBytes, std::memory_order_relaxed);
+}
+
+bool LinkInterface::admitOutbound(qint64 queuedBytes, qsizetype size) {
+    const quint64 limit = m_maxQueuedBytes.load(std::memory_order_relaxed);
+    if (limit == 0 || static_cast<quint64>(queuedBytes) + static_cast<quint64>(size) <= limit) {
+        return true;
+    }
+
+    countOutboundDrop(1, static_cast<quint64>(size));
+    setCongested(true);
+    return false;
+}
+
+void LinkInterface::countOutboundDrop(quint64 writes, quint64 bytes) {
+    m_droppedWrites.store(m_droppedWrites.load(std::memory_order_relaxed) + writes,
+                          std::memory_order_relaxed);
+    m_droppedBytes.store(m_droppedBytes.load(std::memory_order_relaxed) + bytes,
+                         std::memory_order_relaxed);
+}
+
+void LinkInterface::updateOutboundQueue(qint64 queuedBytes) {
+    const quint64 queued = static_cast<quint64>(qMax<qint64>(queuedBytes, 0));
+    m_queuedBytes.store(queued, std::memory_order_relaxed);
+    if (queued > m_peakQueuedBytes.load(std::memory_order_relaxed)) {
+        m_peakQueuedBytes.store(queued, std::memory_order_relaxed);
+    }
+
+    const quint64 limit = m_maxQueuedBytes.load(std::memory_order_relaxed);
+    if (limit == 0) {
+        return;
+    }
+    if (queued > limit / 4 * 3) {
+        setCongested(true);
+    } else if (queued < limit / 4) {
+        setCongested(false);
+    }
+}
+
+void LinkInterface::setCongested(bool congested) {
+    if (m_congested.load(std::memory_order_relaxed) != congested) {
+        m_congested.store(congested, std::memory_order_relaxed);
+        emit backPressureChanged(congested);
+    }
+}
@@ -3,7 +3,10 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QSharedPointer>
 #include <QString>
+#include <atomic>
+#include "bytering.h"
 
 /**
  * @brief Abstract base class for all communication links
@@ -11,6 +14,12 @@
  * This class defines the interface for communication links (UDP, Serial, TCP).
  * All implementations run on a separate QThread to prevent blocking the GUI.
  * Uses the worker-object approach for thread safety.
+ *
+ * Received bytes are handed over with pushReceivedBytes() and
+ * flushReceivedBytes(). When a receive ring is attached they are copied
+ * into the preallocated ring and the consumer is woken at most once per
+ * batch via receiveRingReadable(); otherwise each batch is emitted as one
+ * bytesReceived() signal.
  */
 class LinkInterface : public QObject {
     Q_OBJECT
@@ -19,6 +28,31 @@ public:
     enum class LinkStatus { Disconnected, Connecting, Connected, Error };
     Q_ENUM(LinkStatus)
 
+    /**
+     * @brief Maximum number of concurrently active links
+     *
+     * Link IDs are 0..MAX_LINKS-1. Each ID owns one MAVLink parser channel
+     * and one bit in MavlinkRouter's outbound link masks.
+     */
+    static constexpr int MAX_LINKS = 8;
+
+    /**
+     * @brief Outbound queue fill and drops (safe to read from any thread)
+     *
+     * Only stream links that buffer writes (TCP, serial) bound their queue;
+     * datagram links report bounded == false but still count the datagrams
+     * dropped because the socket send buffer was full.
+     */
+    struct OutboundStatistics {
+        bool bounded{false};
+        quint64 queuedBytes{0};
+        quint64 maxQueuedBytes{0};
+        quint64 peakQueuedBytes{0};
+        quint64 droppedWrites{0};  // writes dropped because the queue was full
+        quint64 droppedBytes{0};
+        bool congested{false};
+    };
+
     explicit LinkInterface(QObject* parent = nullptr) : QObject(parent) {}
     virtual ~LinkInterface() = default;
 
@@ -37,6 +71,33 @@ public:
      */
     virtual bool isConnected() const = 0;
 
+    /**
+     * @brief Whether a silent link means the peer is gone
+     *
+     * LinkManager runs its heartbeat watchdog and reconnect backoff only for
+     * links that return true. Sources that may legitimately go quiet (e.g. a
+     * paused or finished log replay) return false.
+     */
+    virtual bool expectsHeartbeat() const { return true; }
+
+    /**
+     * @brief Outbound queue statistics (any thread)
+     */
+    OutboundStatistics outboundStatistics() const;
+
+    /**
+     * @brief Route received bytes into a preallocated SPSC ring
+     *
+     * Must be called before the link is moved to its worker thread.
+     * The link becomes the ring's only producer.
+     */
+    void setReceiveRing(const QSharedPointer<ByteRing>& ring) { m_receiveRing = ring; }
+
+    /**
+     * @brief Get the attached receive ring (null if bytesReceived() is used)
+     */
+    QSharedPointer<ByteRing> receiveRing() const { return m_receiveRing; }
+
 public slots:
     /**
      * @brief Connect the link (non-blocking)
@@ -61,6 +122,12 @@ signals:
      */
     void bytesReceived(QByteArray data);
 
+    /**
+     * @brief Emitted when the receive ring has new data and the consumer
+     * has not been woken yet
+     */
+    void receiveRingReadable();
+
     /**
      * @brief Emitted when the link status changes
      * @param status The new status
@@ -78,6 +145,64 @@ signals:
      * @param byteCount Number of bytes written
      */
     void bytesWritten(qint64 byteCount);
+
+    /**
+     * @brief Emitted when the outbound queue becomes congested or drains again
+     *
+     * While congested, writes may be dropped instead of queued.
+     */
+    void backPressureChanged(bool congested);
+
+protected:
+    /**
+     * @brief Queue one received chunk (e.g. a datagram) for the consumer
+     * @return false if the ring was full and the chunk was dropped
+     */
+    bool pushReceivedBytes(const char* data, qsizetype size);
+
+    /**
+     * @brief Hand everything pushed since the last flush to the consumer
+     */
+    void flushReceivedBytes();
+
+    /**
+     * @brief Bound the outbound queue; 0 leaves it unbounded
+     */
+    void setOutboundLimit(quint64 maxQueuedBytes);
+
+    /**
+     * @brief Decide whether a write of @p size bytes fits behind @p queuedBytes
+     *
+     * Counts a drop and enters the congested state when it does not.
+     */
+    bool admitOutbound(qint64 queuedBytes, qsizetype size);
+
+    /**
+     * @brief Count writes dropped without going through admitOutbound()
+     */
+    void countOutboundDrop(quint64 writes, quint64 bytes);
+
+    /**
+     * @brief Report the current queue fill after writes or drains
+     *
+     * Emits backPressureChanged() with hysteresis: congested above 3/4 of
+     * the limit, clear again below 1/4.
+     */
+    void updateOutboundQueue(qint64 queuedBytes);
+
+private:
+    void setCongested(bool congested);
+
+    QSharedPointer<ByteRing> m_receiveRing;
+    QByteArray m_pendingReceive;  // used when no ring is attached
+
+    // Outbound queue accounting (written on the link thread)
+    std::atomic<quint64> m_maxQueuedBytes{0};
+    std::atomic<quint64> m_queuedBytes{0};
+    std::atomic<quint64> m_peakQueuedBytes{0};
+    std::atomic<quint64> m_droppedWrites{0};
+    std::atomic<quint64> m_droppedBytes{0};
+    std::atomic<bool> m_congested{false};
 };
 
 #endif  // LINKINTERFACE_H
@@ -1,200 +1,279 @@
 #include "linkmanager.h"
 #include <QDebug>
 
-LinkManager::LinkManager(QObject* parent)
-    : QObject(parent), m_activeLink(nullptr), m_linkThread(nullptr), m_heartbeatTimer(nullptr),
-      m_reconnectTimer(nullptr), m_reconnectAttempt(0), m_reconnectDelay(INITIAL_RECONNECT_DELAY_MS) {
-    // Create timers (they run on this object's thread, i.e., main thread)
-    m_heartbeatTimer = new QTimer(this);
-    m_heartbeatTimer->setSingleShot(false);
-    m_heartbeatTimer->setInterval(HEARTBEAT_TIMEOUT_MS);
-    connect(m_heartbeatTimer, &QTimer::timeout, this, &LinkManager::onHeartbeatTimeout);
+LinkManager::LinkManager(QObject* parent) : QObject(parent), m_connected(false) {}
 
-    m_reconnectTimer = new QTimer(this);
-    m_reconnectTimer->setSingleShot(true);
-    connect(m_reconnectTimer, &QTimer::timeout, this, &LinkManager::onReconnectTimeout);
+LinkManager::~LinkManager() {
+    closeAllLinks();
 }
 
-LinkManager::~LinkManager() {
-    closeActiveLink();
+QList<LinkInterface*> LinkManager::links() const {
+    QList<LinkInterface*> result;
+    for (const ManagedLink& managed : m_links) {
+        if (managed.link) {
+            result.append(managed.link);
+        }
+    }
+    return result;
+}
+
+LinkInterface* LinkManager::link(int linkId) const {
+    if (linkId < 0 || linkId >= LinkInterface::MAX_LINKS) {
+        return nullptr;
+    }
+    return m_links[linkId].link;
+}
+
+int LinkManager::linkId(const LinkInterface* link) const {
+    for (int id = 0; id < LinkInterface::MAX_LINKS; ++id) {
+        if (link && m_links[id].link == link) {
+            return id;
+        }
+    }
+    return -1;
 }
 
 bool LinkManager::isConnected() const {
-    return m_activeLink && m_activeLink->isConnected();
+    for (const ManagedLink& managed : m_links) {
+        if (managed.link && managed.connected) {
+            return true;
+        }
+    }
+    return false;
 }
 
-void LinkManager::setActiveLink(LinkInterface* link) {
+int LinkManager::addLink(LinkInterface* link) {
     if (!link) {
-        qWarning() << "LinkManager::setActiveLink() - null link provided";
-        return;
+        qWarning() << "LinkManager::addLink() - null link provided";
+        return -1;
     }
 
-    // Close existing link
-    closeActiveLink();
+    int linkId = -1;
+    for (int id = 0; id < LinkInterface::MAX_LINKS; ++id) {
+        if (!m_links[id].link) {
+            linkId = id;
+            break;
+        }
+    }
+    if (linkId < 0) {
+        qWarning() << "LinkManager::addLink() - all" << LinkInterface::MAX_LINKS
+                   << "link slots in use, rejecting" << link->name();
+        delete link;
+        return -1;
+    }
 
-    m_activeLink = link;
+    ManagedLink& managed = m_links[linkId];
+    managed.link = link;
+    managed.connected = false;
+    resetReconnectBackoff(managed);
+
+    // Timers run on this object's thread, i.e., main thread
+    managed.heartbeatTimer = new QTimer(this);
+    managed.heartbeatTimer->setSingleShot(false);
+    managed.heartbeatTimer->setInterval(HEARTBEAT_TIMEOUT_MS);
+    connect(managed.heartbeatTimer, &QTimer::timeout, this,
+            [this, linkId]() { onHeartbeatTimeout(linkId); });
+
+    managed.reconnectTimer = new QTimer(this);
+    managed.reconnectTimer->setSingleShot(true);
+    connect(managed.reconnectTimer, &QTimer::timeout, this,
+            [this, linkId]() { onReconnectTimeout(linkId); });
 
     // Create worker thread
-    m_linkThread = new QThread(this);
-    m_activeLink->setParent(nullptr);  // Remove parent before moving to thread
-    m_activeLink->moveToThread(m_linkThread);
+    managed.thread = new QThread(this);
+    managed.thread->setObjectName(QString("Link%1").arg(linkId));
+    link->setParent(nullptr);  // Remove parent before moving to thread
+    link->moveToThread(managed.thread);
+
+    // Received bytes bypass this thread: the link writes into the ring and
+    // wakes the consumer directly
+    link->setReceiveRing(QSharedPointer<ByteRing>::create(RECEIVE_RING_BYTES));
+    emit linkAdded(link, linkId);
 
     // Connect signals
-    connect(m_activeLink, &LinkInterface::bytesReceived, this, &LinkManager::bytesReceived);
-    connect(m_activeLink, &LinkInterface::statusChanged, this, &LinkManager::onLinkStatusChanged);
-    connect(m_activeLink, &LinkInterface::errorOccurred, this, &LinkManager::onLinkError);
+    connect(link, &LinkInterface::statusChanged, this,
+            [this, linkId](LinkInterface::LinkStatus status) {
+                onLinkStatusChanged(linkId, status);
+            });
+    connect(link, &LinkInterface::errorOccurred, this, [this, link](QString errorString) {
+        qWarning() << "LinkManager: Link error on" << link->name() << ":" << errorString;
+        emit linkError(link->name(), errorString);
+    });
 
     // Connect link when thread starts
-    connect(m_linkThread, &QThread::started, m_activeLink, &LinkInterface::connectLink);
+    connect(managed.thread, &QThread::started, link, &LinkInterface::connectLink);
 
     // Clean up when thread finishes
-    connect(m_linkThread, &QThread::finished, m_activeLink, &QObject::deleteLater);
+    connect(managed.thread, &QThread::finished, link, &QObject::deleteLater);
 
     // Start the thread
-    m_linkThread->start();
+    managed.thread->start();
 
-    qDebug() << "LinkManager: Activated link" << link->name();
+    qDebug() << "LinkManager: Added link" << link->name() << "as link" << linkId;
+    return linkId;
 }
 
-void LinkManager::closeActiveLink() {
-    stopHeartbeatMonitor();
-    stopReconnectTimer();
-    resetReconnectBackoff();
-
-    if (m_activeLink) {
-        // Disconnect the link (thread-safe via Qt's signal/slot mechanism)
-        QMetaObject::invokeMethod(m_activeLink, "disconnectLink", Qt::QueuedConnection);
+void LinkManager::removeLink(int linkId) {
+    if (linkId < 0 || linkId >= LinkInterface::MAX_LINKS || !m_links[linkId].link) {
+        return;
     }
 
-    if (m_linkThread) {
-        m_linkThread->quit();
-        if (!m_linkThread->wait(3000)) {
-            qWarning() << "LinkManager: Link thread did not finish in time, terminating";
-            m_linkThread->terminate();
-            m_linkThread->wait();
-        }
-        m_linkThread->deleteLater();
-        m_linkThread = nullptr;
+    ManagedLink& managed = m_links[linkId];
+    LinkInterface* link = managed.link;
+    emit linkRemoved(link, linkId);
+
+    delete managed.heartbeatTimer;
+    delete managed.reconnectTimer;
+
+    // Stop delivering status changes for a slot that is about to be reused
+    disconnect(link, nullptr, this, nullptr);
+
+    // Disconnect the link (thread-safe via Qt's signal/slot mechanism)
+    QMetaObject::invokeMethod(link, "disconnectLink", Qt::QueuedConnection);
+
+    managed.thread->quit();
+    if (!managed.thread->wait(3000)) {
+        qWarning() << "LinkManager: Link thread for" << link->name()
+                   << "did not finish in time, terminating";
+        managed.thread->terminate();
+        managed.thread->wait();
     }
+    managed.thread->deleteLater();
+
+    qDebug() << "LinkManager: Removed link" << linkId;
+    managed = ManagedLink{};  // link will be deleted by thread finished signal
+    updateConnectionStatus();
+}
 
-    m_activeLink = nullptr;  // Will be deleted by thread finished signal
-    emit connectionStatusChanged(false);
+void LinkManager::closeAllLinks() {
+    for (int id = 0; id < LinkInterface::MAX_LINKS; ++id) {
+        removeLink(id);
+    }
 }
 
-void LinkManager::reconnect() {
-    if (!m_activeLink) {
-        qWarning() << "LinkManager::reconnect() - No active link to reconnect";
+void LinkManager::reconnect(int linkId) {
+    LinkInterface* target = link(linkId);
+    if (!target) {
+        qWarning() << "LinkManager::reconnect() - No link" << linkId << "to reconnect";
         return;
     }
 
-    qDebug() << "LinkManager: Manual reconnect triggered";
-    m_reconnectAttempt++;
+    qDebug() << "LinkManager: Manual reconnect triggered for" << target->name();
+    m_links[linkId].reconnectAttempt++;
 
     // Disconnect and reconnect
-    QMetaObject::invokeMethod(m_activeLink, "disconnectLink", Qt::QueuedConnection);
-    QMetaObject::invokeMethod(m_activeLink, "connectLink", Qt::QueuedConnection);
+    QMetaObject::invokeMethod(target, "disconnectLink", Qt::QueuedConnection);
+    QMetaObject::invokeMethod(target, "connectLink", Qt::QueuedConnection);
 }
 
-void LinkManager::onLinkStatusChanged(LinkInterface::LinkStatus status) {
+void LinkManager::onLinkStatusChanged(int linkId, LinkInterface::LinkStatus status) {
+    ManagedLink& managed = m_links[linkId];
+    if (!managed.link) {
+        return;
+    }
+
     switch (status) {
         case LinkInterface::LinkStatus::Connected:
-            qDebug() << "LinkManager: Link connected";
-            resetReconnectBackoff();
-            stopReconnectTimer();
-            startHeartbeatMonitor();
-            emit connectionStatusChanged(true);
+            qDebug() << "LinkManager: Link" << linkId << "connected";
+            managed.connected = true;
+            resetReconnectBackoff(managed);
+            managed.reconnectTimer->stop();
+            if (managed.link->expectsHeartbeat()) {
+                managed.heartbeatTimer->start();
+            }
             break;
 
         case LinkInterface::LinkStatus::Disconnected:
-            qDebug() << "LinkManager: Link disconnected";
-            stopHeartbeatMonitor();
-            emit connectionStatusChanged(false);
+            qDebug() << "LinkManager: Link" << linkId << "disconnected";
+            managed.connected = false;
+            managed.heartbeatTimer->stop();
             // Don't auto-reconnect on manual disconnect
             break;
 
         case LinkInterface::LinkStatus::Error:
-            qWarning() << "LinkManager: Link error occurred";
-            stopHeartbeatMonitor();
-            emit connectionStatusChanged(false);
-            startReconnectTimer();
+            qWarning() << "LinkManager: Link" << linkId << "error occurred";
+            managed.connected = false;
+            managed.heartbeatTimer->stop();
+            startReconnectTimer(managed);
             break;
 
         case LinkInterface::LinkStatus::Connecting:
-            qDebug() << "LinkManager: Link connecting...";
+            // An attempt in progress, or a server waiting for its peer: the link
+            // reports Connected or Error on its own, so neither the heartbeat
+            // watchdog nor another attempt is due until then
+            qDebug() << "LinkManager: Link" << linkId << "connecting...";
+            managed.connected = false;
+            managed.heartbeatTimer->stop();
+            managed.reconnectTimer->stop();
             break;
     }
-}
 
-void LinkManager::onLinkError(QString errorString) {
-    qWarning() << "LinkManager: Link error:" << errorString;
-    emit linkError(errorString);
+    emit linkStatusChanged(linkId, status);
+    updateConnectionStatus();
 }
 
-void LinkManager::onHeartbeatTimeout() {
-    qWarning() << "LinkManager: Heartbeat timeout - no messages received for" << HEARTBEAT_TIMEOUT_MS
-               << "ms";
-    stopHeartbeatMonitor();
-    emit connectionStatusChanged(false);
-    startReconnectTimer();
+void LinkManager::onHeartbeatTimeout(int linkId) {
+    ManagedLink& managed = m_links[linkId];
+    qWarning() << "LinkManager: Heartbeat timeout on link" << linkId
+               << "- no messages received for" << HEARTBEAT_TIMEOUT_MS << "ms";
+    managed.heartbeatTimer->stop();
+    managed.connected = false;
+    updateConnectionStatus();
+    startReconnectTimer(managed);
 }
 
-void LinkManager::onReconnectTimeout() {
-    m_reconnectAttempt++;
-    qDebug() << "LinkManager: Reconnection attempt" << m_reconnectAttempt << "after"
-             << m_reconnectDelay << "ms";
+void LinkManager::onReconnectTimeout(int linkId) {
+    ManagedLink& managed = m_links[linkId];
+    if (!managed.link) {
+        return;
+    }
+
+    managed.reconnectAttempt++;
+    qDebug() << "LinkManager: Reconnection attempt" << managed.reconnectAttempt << "for link"
+             << linkId << "after" << managed.reconnectDelay << "ms";
 
-    emit reconnecting(m_reconnectAttempt, m_reconnectDelay);
+    emit reconnecting(managed.link->name(), managed.reconnectAttempt, managed.reconnectDelay);
 
     // Attempt reconnection
-    if (m_activeLink) {
-        QMetaObject::invokeMethod(m_activeLink, "connectLink", Qt::QueuedConnection);
-    }
+    QMetaObject::invokeMethod(managed.link, "connectLink", Qt::QueuedConnection);
 
     // Increase delay with exponential backoff
-    m_reconnectDelay = qMin(m_reconnectDelay * 2, MAX_RECONNECT_DELAY_MS);
+    managed.reconnectDelay = qMin(managed.reconnectDelay * 2, MAX_RECONNECT_DELAY_MS);
 
     // Schedule next attempt
-    startReconnectTimer();
+    startReconnectTimer(managed);
 }
 
-void LinkManager::startHeartbeatMonitor() {
-    if (m_heartbeatTimer && !m_heartbeatTimer->isActive()) {
-        m_heartbeatTimer->start();
-        qDebug() << "LinkManager: Heartbeat monitor started";
-    }
-}
-
-void LinkManager::stopHeartbeatMonitor() {
-    if (m_heartbeatTimer && m_heartbeatTimer->isActive()) {
-        m_heartbeatTimer->stop();
-        qDebug() << "LinkManager: Heartbeat monitor stopped";
+void LinkManager::resetHeartbeatTimeout(int linkId) {
+    if (linkId < 0 || linkId >= LinkInterface::MAX_LINKS) {
+        return;
     }
-}
 
-void LinkManager::resetHeartbeatTimeout() {
     // Restart the timer to reset the timeout countdown
-    if (m_heartbeatTimer && m_heartbeatTimer->isActive()) {
-        m_heartbeatTimer->start();
+    QTimer* timer = m_links[linkId].heartbeatTimer;
+    if (timer && timer->isActive()) {
+        timer->start();
     }
 }
 
-void LinkManager::startReconnectTimer() {
-    if (m_reconnectTimer && !m_reconnectTimer->isActive()) {
-        m_reconnectTimer->setInterval(m_reconnectDelay);
-        m_reconnectTimer->start();
-        qDebug() << "LinkManager: Reconnect timer started with delay" << m_reconnectDelay << "ms";
+void LinkManager::startReconnectTimer(ManagedLink& managed) {
+    if (managed.reconnectTimer && !managed.reconnectTimer->isActive()) {
+        managed.reconnectTimer->setInterval(managed.reconnectDelay);
+        managed.reconnectTimer->start();
+        qDebug() << "LinkManager: Reconnect timer started with delay" << managed.reconnectDelay
+                 << "ms";
     }
 }
 
-void LinkManager::stopReconnectTimer() {
-    if (m_reconnectTimer && m_reconnectTimer->isActive()) {
-        m_reconnectTimer->stop();
-        qDebug() << "LinkManager: Reconnect timer stopped";
-    }
+void LinkManager::resetReconnectBackoff(ManagedLink& managed) {
+    managed.reconnectAttempt = 0;
+    managed.reconnectDelay = INITIAL_RECONNECT_DELAY_MS;
 }
 
-void LinkManager::resetReconnectBackoff() {
-    m_reconnectAttempt = 0;
-    m_reconnectDelay = INITIAL_RECONNECT_DELAY_MS;
-    qDebug() << "LinkManager: Reconnect backoff reset";
+void LinkManager::updateConnectionStatus() {
+    const bool connected = isConnected();
+    if (connected != m_connected) {
+        m_connected = connected;
+        emit connectionStatusChanged(connected);
+    }
 }
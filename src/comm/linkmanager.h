@@ -2,103 +2,149 @@
 #define LINKMANAGER_H
 
 #include <QObject>
+#include <QList>
 #include <QThread>
 #include <QTimer>
+#include <array>
 #include "linkinterface.h"
 
 /**
  * @brief Manages communication links and their lifecycle
  *
  * Handles:
- * - Link creation and destruction
- * - Moving links to worker threads
- * - Reconnection logic with exponential backoff
- * - Heartbeat monitoring
+ * - Up to LinkInterface::MAX_LINKS concurrently active links (e.g. a
+ *   telemetry radio, a UDP SITL port and a TCP companion link)
+ * - Moving each link to its own worker thread
+ * - Attaching a preallocated receive ring to each link
+ * - Per-link reconnection logic with exponential backoff
+ * - Per-link heartbeat monitoring
+ *
+ * Every link is identified by a small integer link ID that stays fixed for
+ * the link's lifetime. The ID selects the link's MAVLink parser channel and
+ * its bit in MavlinkRouter's outbound routing mask.
  */
 class LinkManager : public QObject {
     Q_OBJECT
 
 public:
+    static constexpr int INITIAL_RECONNECT_DELAY_MS = 1000;  // 1 second
+    static constexpr int HEARTBEAT_TIMEOUT_MS = 5000;        // 5 seconds
+
     explicit LinkManager(QObject* parent = nullptr);
     ~LinkManager() override;
 
     /**
-     * @brief Get the currently active link
+     * @brief Get all managed links, in link ID order
+     */
+    QList<LinkInterface*> links() const;
+
+    /**
+     * @brief Get the link with the given ID (null if the slot is free)
      */
-    LinkInterface* activeLink() const { return m_activeLink; }
+    LinkInterface* link(int linkId) const;
 
     /**
-     * @brief Check if we have an active connection
+     * @brief Get the ID of a managed link (-1 if not managed)
+     */
+    int linkId(const LinkInterface* link) const;
+
+    /**
+     * @brief Check if at least one link is connected
      */
     bool isConnected() const;
 
 public slots:
     /**
-     * @brief Set and activate a link
-     * @param link The link to activate (takes ownership)
+     * @brief Add a link, move it to its own thread and connect it
+     * @param link The link to add (takes ownership)
+     * @return The assigned link ID, or -1 if all MAX_LINKS slots are in use
      */
-    void setActiveLink(LinkInterface* link);
+    int addLink(LinkInterface* link);
 
     /**
-     * @brief Close the active link
+     * @brief Disconnect and destroy one link
      */
-    void closeActiveLink();
+    void removeLink(int linkId);
 
     /**
-     * @brief Manually trigger reconnection
+     * @brief Disconnect and destroy all links
      */
-    void reconnect();
+    void closeAllLinks();
 
     /**
-     * @brief Reset heartbeat timeout timer (call when messages received)
+     * @brief Manually trigger reconnection of one link
      */
-    void resetHeartbeatTimeout();
+    void reconnect(int linkId);
+
+    /**
+     * @brief Reset a link's heartbeat timeout (call when a HEARTBEAT arrives on it)
+     */
+    void resetHeartbeatTimeout(int linkId);
 
 signals:
     /**
-     * @brief Emitted when bytes are received from the active link
+     * @brief Emitted synchronously when a link has been set up, before its
+     * worker thread starts
+     *
+     * Consumers connect to LinkInterface::receiveRingReadable() here so no
+     * wakeup can be missed. Use a direct connection.
      */
-    void bytesReceived(QByteArray data);
+    void linkAdded(LinkInterface* link, int linkId);
 
     /**
-     * @brief Emitted when connection status changes
+     * @brief Emitted synchronously before a link's thread is stopped and the
+     * link is destroyed
+     *
+     * The link ID may be reused by the next addLink() once this returns.
+     */
+    void linkRemoved(LinkInterface* link, int linkId);
+
+    /**
+     * @brief Emitted when one link's status changes
+     */
+    void linkStatusChanged(int linkId, LinkInterface::LinkStatus status);
+
+    /**
+     * @brief Emitted when the aggregate status changes (true while any link
+     * is connected)
      */
     void connectionStatusChanged(bool connected);
 
     /**
      * @brief Emitted when a link error occurs
      */
-    void linkError(QString errorString);
+    void linkError(QString linkName, QString errorString);
 
     /**
-     * @brief Emitted when attempting to reconnect
+     * @brief Emitted when attempting to reconnect a link
      */
-    void reconnecting(int attemptNumber, int delayMs);
-
-private slots:
-    void onLinkStatusChanged(LinkInterface::LinkStatus status);
-    void onLinkError(QString errorString);
-    void onHeartbeatTimeout();
-    void onReconnectTimeout();
+    void reconnecting(QString linkName, int attemptNumber, int delayMs);
 
 private:
-    void startHeartbeatMonitor();
-    void stopHeartbeatMonitor();
-    void startReconnectTimer();
-    void stopReconnectTimer();
-    void resetReconnectBackoff();
-
-    LinkInterface* m_activeLink;
-    QThread* m_linkThread;
-    QTimer* m_heartbeatTimer;
-    QTimer* m_reconnectTimer;
-
-    // Reconnection state
-    int m_reconnectAttempt;
-    int m_reconnectDelay;  // in milliseconds
-    static constexpr int INITIAL_RECONNECT_DELAY_MS = 1000;      // 1 second
+    struct ManagedLink {
+        LinkInterface* link{nullptr};
+        QThread* thread{nullptr};
+        QTimer* heartbeatTimer{nullptr};
+        QTimer* reconnectTimer{nullptr};
+        bool connected{false};
+
+        // Reconnection state
+        int reconnectAttempt{0};
+        int reconnectDelay{0};  // in milliseconds
+    };
+
+    void onLinkStatusChanged(int linkId, LinkInterface::LinkStatus status);
+    void onHeartbeatTimeout(int linkId);
+    void onReconnectTimeout(int linkId);
+    void startReconnectTimer(ManagedLink& managed);
+    void resetReconnectBackoff(ManagedLink& managed);
+    void updateConnectionStatus();
+
+    std::array<ManagedLink, LinkInterface::MAX_LINKS> m_links;
+    bool m_connected;  // last aggregate status emitted
+
     static constexpr int MAX_RECONNECT_DELAY_MS = 30000;         // 30 seconds
-    static constexpr int HEARTBEAT_TIMEOUT_MS = 5000;            // 5 seconds
+    static constexpr qsizetype RECEIVE_RING_BYTES = 1 << 20;     // 1 MiB per link
 };
 
 #endif  // LINKMANAGER_H
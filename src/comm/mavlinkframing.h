@@ -0,0 +1,77 @@
+#ifndef MAVLINKFRAMING_H
+#define MAVLINKFRAMING_H
+
+#include <QtGlobal>
+
+/**
+ * @brief MAVLink v1/v2 frame boundaries, without a parser
+ *
+ * Enough of the header layout to split a byte stream into packets and read
+ * their source, msgid and sequence number. Checksums are not verified;
+ * MavlinkRouter does that when the packets are parsed.
+ */
+namespace MavlinkFraming {
+
+constexpr uchar V1_STX = 0xFE;
+constexpr uchar V2_STX = 0xFD;
+constexpr qsizetype V1_OVERHEAD = 8;   // header 6 + checksum 2
+constexpr qsizetype V2_OVERHEAD = 12;  // header 10 + checksum 2
+constexpr qsizetype V2_SIGNATURE = 13;
+constexpr uchar V2_FLAG_SIGNED = 0x01;
+
+inline bool isStartMarker(uchar byte) {
+    return byte == V2_STX || byte == V1_STX;
+}
+
+/**
+ * @brief Length of the frame starting at @p data
+ * @return the frame length, 0 if more than @p available bytes are needed,
+ * or -1 if @p data does not start with a start marker
+ */
+inline qsizetype packetLength(const uchar* data, qsizetype available) {
+    qsizetype length = 0;
+    if (data[0] == V2_STX) {
+        if (available < 3) {
+            return 0;
+        }
+        length = data[1] + V2_OVERHEAD;
+        if (data[2] & V2_FLAG_SIGNED) {
+            length += V2_SIGNATURE;
+        }
+    } else if (data[0] == V1_STX) {
+        if (available < 2) {
+            return 0;
+        }
+        length = data[1] + V1_OVERHEAD;
+    } else {
+        return -1;
+    }
+    return length <= available ? length : 0;
+}
+
+/**
+ * @brief Source and msgid of a complete frame
+ */
+inline void readHeader(const uchar* packet, uint8_t& systemId, uint8_t& componentId,
+                       uint32_t& msgId) {
+    if (packet[0] == V2_STX) {
+        systemId = packet[5];
+        componentId = packet[6];
+        msgId = packet[7] | (packet[8] << 8) | (uint32_t(packet[9]) << 16);
+    } else {
+        systemId = packet[3];
+        componentId = packet[4];
+        msgId = packet[5];
+    }
+}
+
+/**
+ * @brief Sequence number of a complete frame
+ */
+inline uint8_t readSequence(const uchar* packet) {
+    return packet[0] == V2_STX ? packet[4] : packet[2];
+}
+
+}  // namespace MavlinkFraming
+
+#endif  // MAVLINKFRAMING_H
@@ -0,0 +1,64 @@
+#ifndef MAVLINKMESSAGETRAITS_H
+#define MAVLINKMESSAGETRAITS_H
+
+#include "mavlink/ardupilotmega/mavlink.h"
+
+/**
+ * @brief Compile-time description of a decoded MAVLink message struct
+ *
+ * Maps a payload type such as mavlink_attitude_t to its message ID and
+ * decoder. Used by MavlinkRouter::subscribe<T>(). Add a
+ * FLIGHTSCOPE_MAVLINK_MESSAGE() line below to make another message
+ * subscribable.
+ */
+template <typename T>
+struct MavlinkMessageTraits;
+
+#define FLIGHTSCOPE_MAVLINK_MESSAGE(name, NAME)                                        \
+    template <>                                                                       \
+    struct MavlinkMessageTraits<mavlink_##name##_t> {                                 \
+        static constexpr uint32_t MSG_ID = MAVLINK_MSG_ID_##NAME;                     \
+        static constexpr const char* MSG_NAME = #NAME;                                \
+        static void decode(const mavlink_message_t* msg, mavlink_##name##_t* out) {   \
+            mavlink_msg_##name##_decode(msg, out);                                    \
+        }                                                                             \
+    };
+
+// common.xml
+FLIGHTSCOPE_MAVLINK_MESSAGE(heartbeat, HEARTBEAT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(sys_status, SYS_STATUS)
+FLIGHTSCOPE_MAVLINK_MESSAGE(system_time, SYSTEM_TIME)
+FLIGHTSCOPE_MAVLINK_MESSAGE(param_value, PARAM_VALUE)
+FLIGHTSCOPE_MAVLINK_MESSAGE(gps_raw_int, GPS_RAW_INT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(raw_imu, RAW_IMU)
+FLIGHTSCOPE_MAVLINK_MESSAGE(scaled_pressure, SCALED_PRESSURE)
+FLIGHTSCOPE_MAVLINK_MESSAGE(attitude, ATTITUDE)
+FLIGHTSCOPE_MAVLINK_MESSAGE(attitude_quaternion, ATTITUDE_QUATERNION)
+FLIGHTSCOPE_MAVLINK_MESSAGE(local_position_ned, LOCAL_POSITION_NED)
+FLIGHTSCOPE_MAVLINK_MESSAGE(global_position_int, GLOBAL_POSITION_INT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(servo_output_raw, SERVO_OUTPUT_RAW)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_request, MISSION_REQUEST)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_current, MISSION_CURRENT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_count, MISSION_COUNT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_item, MISSION_ITEM)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_ack, MISSION_ACK)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_request_int, MISSION_REQUEST_INT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(nav_controller_output, NAV_CONTROLLER_OUTPUT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(rc_channels, RC_CHANNELS)
+FLIGHTSCOPE_MAVLINK_MESSAGE(mission_item_int, MISSION_ITEM_INT)
+FLIGHTSCOPE_MAVLINK_MESSAGE(vfr_hud, VFR_HUD)
+FLIGHTSCOPE_MAVLINK_MESSAGE(command_long, COMMAND_LONG)
+FLIGHTSCOPE_MAVLINK_MESSAGE(command_ack, COMMAND_ACK)
+FLIGHTSCOPE_MAVLINK_MESSAGE(timesync, TIMESYNC)
+FLIGHTSCOPE_MAVLINK_MESSAGE(power_status, POWER_STATUS)
+FLIGHTSCOPE_MAVLINK_MESSAGE(battery_status, BATTERY_STATUS)
+FLIGHTSCOPE_MAVLINK_MESSAGE(estimator_status, ESTIMATOR_STATUS)
+FLIGHTSCOPE_MAVLINK_MESSAGE(vibration, VIBRATION)
+FLIGHTSCOPE_MAVLINK_MESSAGE(home_position, HOME_POSITION)
+FLIGHTSCOPE_MAVLINK_MESSAGE(extended_sys_state, EXTENDED_SYS_STATE)
+FLIGHTSCOPE_MAVLINK_MESSAGE(statustext, STATUSTEXT)
+
+// ardupilotmega.xml
+FLIGHTSCOPE_MAVLINK_MESSAGE(ahrs2, AHRS2)
+
+#endif  // MAVLINKMESSAGETRAITS_H
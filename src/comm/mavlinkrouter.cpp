@@ -1,117 +1,706 @@
 #include "mavlinkrouter.h"
+#include "latencytrace.h"
+#include "mavlinkframing.h"
+#include "tlogrecorder.h"
 #include <QDebug>
 #include <QDateTime>
-#include <QSet>
+#include <QMetaMethod>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+static_assert(MavlinkRouter::MAX_LINKS <= MAVLINK_COMM_NUM_BUFFERS,
+              "every link needs its own MAVLink parser channel");
+static_assert(MavlinkRouter::MAX_LINKS <= 32, "link masks are 32 bits wide");
 
 MavlinkRouter::MavlinkRouter(QObject* parent)
-    : QObject(parent), m_systemId(255), m_componentId(190), m_lastSeq(0), m_receivedPackets(0),
-      m_droppedPackets(0), m_packetLoss(0.0f), m_roundTripTime(0), m_timesyncTc1(0) {
-    memset(&m_status, 0, sizeof(m_status));
-    m_lastMessageTimer.start();
+    : QObject(parent), m_attachedLinks(0), m_currentLink(0), m_currentTraceKey(0),
+      m_currentSystemId(0), m_currentComponentId(0),
+      m_redundancyEnabled(false),
+      m_failoverTimer(nullptr), m_duplicatesDropped(0), m_dedupEvictions(0),
+      m_duplicateRate(0.0f), m_switchovers(0), m_lastSwitchoverMs(-1), m_tlogRecorder(nullptr),
+      m_systemId(255),
+      m_componentId(190), m_statisticsTimer(nullptr), m_untrackedSourcesReported(false),
+      m_packetLoss(0.0f), m_roundTripTime(0), m_lastMessageTime(0), m_nextHandlerHandle(1),
+      m_handlerGeneration(0), m_batchSignalPending(false), m_timesyncTc1(0) {
+    m_clock.start();
+    for (int linkId = 0; linkId < MAX_LINKS; ++linkId) {
+        resetLinkState(linkId);
+    }
+    for (std::atomic<int>& primary : m_primaryLink) {
+        primary.store(NO_LINK, std::memory_order_relaxed);
+    }
+    m_primaryMissingSince.fill(NEVER);
+    m_pendingBatchIndex.fill(-1);
+    m_failoverCandidate.fill(NO_LINK);
+
+    // Loss is published at a fixed rate rather than per packet. The timer is
+    // a child, so it follows the router to its thread.
+    m_statisticsTimer = new QTimer(this);
+    m_statisticsTimer->setInterval(STATISTICS_INTERVAL_MS);
+    connect(m_statisticsTimer, &QTimer::timeout, this, &MavlinkRouter::publishStatistics);
+    m_statisticsTimer->start();
+
+    // Only runs in redundancy mode
+    m_failoverTimer = new QTimer(this);
+    m_failoverTimer->setInterval(FAILOVER_CHECK_INTERVAL_MS);
+    connect(m_failoverTimer, &QTimer::timeout, this, &MavlinkRouter::checkFailover);
 }
 
 qint64 MavlinkRouter::timeSinceLastMessage() const {
-    return m_lastMessageTimer.elapsed();
+    return m_clock.elapsed() - m_lastMessageTime.load(std::memory_order_relaxed);
+}
+
+QVector<SequenceTracker::SourceStatistics> MavlinkRouter::sourceStatistics() const {
+    QMutexLocker locker(&m_statisticsMutex);
+    return m_publishedSources;
+}
+
+MessageStatistics::Snapshot MavlinkRouter::messageStatistics() const {
+    return m_messageStatistics.snapshot(m_clock.nsecsElapsed());
+}
+
+QVector<MessageStatistics::StreamRate> MavlinkRouter::messageRates() const {
+    QMutexLocker locker(&m_statisticsMutex);
+    return m_publishedRates;
+}
+
+MavlinkRouter::LinkStatistics MavlinkRouter::linkStatistics(int linkId) const {
+    LinkStatistics stats;
+    if (linkId < 0 || linkId >= MAX_LINKS) {
+        return stats;
+    }
+
+    const LinkState& link = m_links[linkId];
+    stats.attached = m_attachedLinks.load(std::memory_order_relaxed) & (1u << linkId);
+    stats.messagesReceived = link.messagesReceived.load(std::memory_order_relaxed);
+    stats.bytesReceived = link.bytesReceived.load(std::memory_order_relaxed);
+    stats.messagesSent = link.messagesSent.load(std::memory_order_relaxed);
+    stats.bytesSent = link.bytesSent.load(std::memory_order_relaxed);
+    stats.messagesPerSecond = link.messagesPerSecond.load(std::memory_order_relaxed);
+    stats.bytesPerSecond = link.bytesPerSecond.load(std::memory_order_relaxed);
+    const qint64 lastMessage = link.lastMessageTime.load(std::memory_order_relaxed);
+    if (lastMessage != NEVER) {
+        stats.timeSinceLastMessage = m_clock.elapsed() - lastMessage;
+    }
+    stats.duplicatesDropped = link.duplicatesDropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+MavlinkRouter::RedundancyStatistics MavlinkRouter::redundancyStatistics() const {
+    RedundancyStatistics stats;
+    stats.enabled = m_redundancyEnabled.load(std::memory_order_relaxed);
+    stats.duplicatesDropped = m_duplicatesDropped.load(std::memory_order_relaxed);
+    stats.duplicateRate = m_duplicateRate.load(std::memory_order_relaxed);
+    stats.dedupEvictions = m_dedupEvictions.load(std::memory_order_relaxed);
+    stats.switchovers = m_switchovers.load(std::memory_order_relaxed);
+    stats.lastSwitchoverMs = m_lastSwitchoverMs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MavlinkRouter::setRedundancyEnabled(bool enabled) {
+    runOnRouterThread([this, enabled]() {
+        m_dedupWindow.reset();
+        m_lastDedupStatistics = DedupWindow::Statistics();
+        for (std::atomic<int>& primary : m_primaryLink) {
+            primary.store(NO_LINK, std::memory_order_relaxed);
+        }
+        m_primaryMissingSince.fill(NEVER);
+        m_failoverCandidate.fill(NO_LINK);
+        m_redundancyEnabled.store(enabled, std::memory_order_relaxed);
+
+        if (enabled) {
+            m_failoverTimer->start();
+        } else {
+            m_failoverTimer->stop();
+        }
+        qInfo() << "MavlinkRouter: Redundancy mode" << (enabled ? "enabled" : "disabled");
+    });
+}
+
+int MavlinkRouter::primaryLink(uint8_t systemId) const {
+    return m_primaryLink[systemId].load(std::memory_order_relaxed);
+}
+
+void MavlinkRouter::attachLink(int linkId) {
+    if (linkId < 0 || linkId >= MAX_LINKS) {
+        qWarning() << "MavlinkRouter::attachLink() - invalid link" << linkId;
+        return;
+    }
+    runOnRouterThread([this, linkId]() {
+        resetLinkState(linkId);
+        m_attachedLinks.fetch_or(1u << linkId, std::memory_order_relaxed);
+    });
+}
+
+void MavlinkRouter::detachLink(int linkId) {
+    if (linkId < 0 || linkId >= MAX_LINKS) {
+        return;
+    }
+    runOnRouterThread([this, linkId]() {
+        m_attachedLinks.fetch_and(~(1u << linkId), std::memory_order_relaxed);
+        resetLinkState(linkId);
+
+        // Systems using this link pick a new primary with their next packet
+        for (int systemId = 0; systemId < 256; ++systemId) {
+            if (m_primaryLink[systemId].load(std::memory_order_relaxed) == linkId) {
+                m_primaryLink[systemId].store(NO_LINK, std::memory_order_relaxed);
+                m_primaryMissingSince[systemId] = NEVER;
+            }
+            if (m_failoverCandidate[systemId] == linkId) {
+                m_failoverCandidate[systemId] = NO_LINK;
+                m_primaryMissingSince[systemId] = NEVER;
+            }
+        }
+    });
+}
+
+void MavlinkRouter::setTlogRecorder(TlogRecorder* recorder) {
+    runOnRouterThread([this, recorder]() { m_tlogRecorder = recorder; });
+}
+
+void MavlinkRouter::resetLinkState(int linkId) {
+    LinkState& link = m_links[linkId];
+    memset(&link.status, 0, sizeof(link.status));
+    mavlink_reset_channel_status(static_cast<uint8_t>(MAVLINK_COMM_0 + linkId));
+    link.reportedOverruns = 0;
+    link.lastMessages = 0;
+    link.lastBytes = 0;
+    link.messagesReceived.store(0, std::memory_order_relaxed);
+    link.bytesReceived.store(0, std::memory_order_relaxed);
+    link.messagesSent.store(0, std::memory_order_relaxed);
+    link.bytesSent.store(0, std::memory_order_relaxed);
+    link.messagesPerSecond.store(0.0f, std::memory_order_relaxed);
+    link.bytesPerSecond.store(0.0f, std::memory_order_relaxed);
+    link.lastMessageTime.store(NEVER, std::memory_order_relaxed);
+    link.duplicatesDropped.store(0, std::memory_order_relaxed);
+    link.tlogCarry.clear();
+
+    for (auto& heardOn : m_systemLastHeard) {
+        heardOn[linkId].store(NEVER, std::memory_order_relaxed);
+    }
+}
+
+quint32 MavlinkRouter::packetLength(const mavlink_message_t& msg) {
+    if (msg.magic == MAVLINK_STX_MAVLINK1) {
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + MAVLINK_NUM_CHECKSUM_BYTES + msg.len;
+    }
+    quint32 length = MAVLINK_NUM_NON_PAYLOAD_BYTES + msg.len;
+    if (msg.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        length += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    return length;
+}
+
+QVector<MavlinkRouter::TelemetryBatch> MavlinkRouter::takeTelemetryBatches() {
+    QMutexLocker locker(&m_batchMutex);
+    QVector<TelemetryBatch> batches;
+    batches.reserve(m_pendingBatches.size());
+    batches.swap(m_pendingBatches);
+    m_pendingBatchIndex.fill(-1);
+    m_batchSignalPending = false;
+    return batches;
+}
+
+template <typename Fn>
+void MavlinkRouter::updateTelemetryBatch(TelemetryBatch::Field field, Fn&& update) {
+    bool notify = false;
+    {
+        QMutexLocker locker(&m_batchMutex);
+
+        // A system's other components can only come after its first batch
+        int index = m_pendingBatchIndex[m_currentSystemId];
+        if (index < 0) {
+            index = m_pendingBatchIndex[m_currentSystemId] = m_pendingBatches.size();
+        }
+        while (index < m_pendingBatches.size() &&
+               (m_pendingBatches[index].systemId != m_currentSystemId ||
+                m_pendingBatches[index].componentId != m_currentComponentId)) {
+            ++index;
+        }
+        if (index == m_pendingBatches.size()) {
+            TelemetryBatch& batch = m_pendingBatches.emplace_back();
+            batch.systemId = m_currentSystemId;
+            batch.componentId = m_currentComponentId;
+        }
+
+        TelemetryBatch& batch = m_pendingBatches[index];
+        update(batch);
+        batch.fields |= field;
+        batch.messages++;
+        if (!m_batchSignalPending) {
+            m_batchSignalPending = true;
+            notify = true;
+        }
+    }
+
+    if (notify) {
+        emit telemetryBatchReady();
+    }
+}
+
+void MavlinkRouter::drainReceiveRing(int linkId, ByteRing& ring) {
+    if (linkId < 0 || linkId >= MAX_LINKS) {
+        return;
+    }
+
+    // Clear the wake flag first so data written while draining triggers a new wakeup
+    ring.acknowledgeWake();
+    ring.consume([this, linkId](const char* data, qsizetype size) {
+        processBytes(linkId, data, size);
+    });
+
+    LinkState& link = m_links[linkId];
+    const ByteRing::Statistics stats = ring.statistics();
+    if (stats.overruns != link.reportedOverruns) {
+        qWarning() << "MavlinkRouter: Receive ring overrun on link" << linkId << "-"
+                   << (stats.overruns - link.reportedOverruns) << "chunks dropped (total"
+                   << stats.overruns << "chunks," << stats.bytesDropped << "bytes)";
+        link.reportedOverruns = stats.overruns;
+    }
 }
 
 void MavlinkRouter::receiveBytes(const QByteArray& data) {
+    processBytes(0, data.constData(), data.size());
+}
+
+void MavlinkRouter::processBytes(int linkId, const char* data, qsizetype size) {
+    LinkState& link = m_links[linkId];
+    const uint8_t channel = static_cast<uint8_t>(MAVLINK_COMM_0 + linkId);
     mavlink_message_t msg;
 
-    for (int i = 0; i < data.size(); ++i) {
+    link.bytesReceived.store(link.bytesReceived.load(std::memory_order_relaxed) + size,
+                             std::memory_order_relaxed);
+    m_currentLink = linkId;
+
+    // Flight log gets the bytes as they came off the wire, before parsing
+    if (m_tlogRecorder && m_tlogRecorder->isRecording()) {
+        recordInbound(linkId, data, size);
+    } else if (!link.tlogCarry.isEmpty()) {
+        link.tlogCarry.clear();
+    }
+
+    for (qsizetype i = 0; i < size; ++i) {
         uint8_t byte = static_cast<uint8_t>(data[i]);
 
-        if (mavlink_parse_char(MAVLINK_COMM_0, byte, &msg, &m_status)) {
+        if (mavlink_parse_char(channel, byte, &msg, &link.status)) {
             // Successfully parsed a message
-            m_lastMessageTimer.restart();
-            m_receivedPackets++;
+            const qint64 nowNs = m_clock.nsecsElapsed();
+            const qint64 nowMs = nowNs / 1000000;
+            m_lastMessageTime.store(nowMs, std::memory_order_relaxed);
+            link.lastMessageTime.store(nowMs, std::memory_order_relaxed);
+            link.messagesReceived.store(link.messagesReceived.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+            m_systemLastHeard[msg.sysid][linkId].store(nowMs, std::memory_order_relaxed);
+
+            // Redundant links: the first copy wins, later copies only feed failover
+            if (m_redundancyEnabled.load(std::memory_order_relaxed)) {
+                qint64 firstSeenMs = nowMs;
+                const bool duplicate = m_dedupWindow.isDuplicate(
+                    msg.sysid, msg.compid, msg.seq, msg.msgid, msg.checksum, nowMs, &firstSeenMs);
+                updateFailover(linkId, msg.sysid, !duplicate, nowMs - firstSeenMs, nowMs);
+                if (duplicate) {
+                    link.duplicatesDropped.store(
+                        link.duplicatesDropped.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+                    continue;
+                }
+            }
+
+            LatencyTrace& trace = LatencyTrace::instance();
+            m_currentTraceKey = 0;
+            if (trace.isEnabled()) {
+                m_currentTraceKey = LatencyTrace::key(msg.sysid, msg.compid, msg.msgid, msg.seq);
+                trace.record(LatencyTrace::ParseComplete, m_currentTraceKey);
+            }
 
-            // Update packet loss statistics
-            updatePacketLoss(msg.seq);
+            // Update per-source loss and per-stream rate statistics
+            m_sequenceTracker.update(msg.sysid, msg.compid, msg.seq);
+            m_messageStatistics.record(msg.sysid, msg.compid, msg.msgid, packetLength(msg), nowNs);
 
             // Parse message
             parseMessage(msg);
 
-            // Emit generic signal
-            emit messageReceived(msg);
+            // Emit generic signal; skip the per-message copy when nobody listens
+            static const QMetaMethod messageReceivedSignal =
+                QMetaMethod::fromSignal(&MavlinkRouter::messageReceived);
+            if (isSignalConnected(messageReceivedSignal)) {
+                emit messageReceived(msg);
+            }
         }
     }
 }
 
 void MavlinkRouter::sendMessage(const mavlink_message_t& msg) {
+    sendOnLinks(msg, routeFor(msg));
+}
+
+void MavlinkRouter::sendOnLinks(const mavlink_message_t& msg, quint32 linkMask) {
+    if (linkMask == 0) {
+        return;
+    }
+
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     uint16_t len = mavlink_msg_to_send_buffer(buffer, &msg);
 
+    for (int linkId = 0; linkId < MAX_LINKS; ++linkId) {
+        if (linkMask & (1u << linkId)) {
+            m_links[linkId].messagesSent.fetch_add(1, std::memory_order_relaxed);
+            m_links[linkId].bytesSent.fetch_add(len, std::memory_order_relaxed);
+        }
+    }
+
     QByteArray data(reinterpret_cast<const char*>(buffer), len);
-    emit bytesToSend(data);
+
+    // The recorder's single producer is the router thread
+    const quint64 nowUs = TlogRecorder::currentTimeUs();
+    QThread* routerThread = thread();
+    if (QThread::currentThread() == routerThread || !routerThread->isRunning()) {
+        recordOutbound(linkMask, data, nowUs);
+    } else {
+        QMetaObject::invokeMethod(
+            this, [this, linkMask, data, nowUs]() { recordOutbound(linkMask, data, nowUs); },
+            Qt::QueuedConnection);
+    }
+
+    emit bytesToSend(linkMask, data);
+}
+
+void MavlinkRouter::recordInbound(int linkId, const char* data, qsizetype size) {
+    // Finish the frame carried over from the previous read first
+    QByteArray& carry = m_links[linkId].tlogCarry;
+    const char* bytes = data;
+    qsizetype available = size;
+    if (!carry.isEmpty()) {
+        carry.append(data, size);
+        bytes = carry.constData();
+        available = carry.size();
+    }
+
+    const quint64 nowUs = TlogRecorder::currentTimeUs();
+    qsizetype offset = 0;
+    while (offset < available) {
+        const uchar* frame = reinterpret_cast<const uchar*>(bytes + offset);
+        const qsizetype length = MavlinkFraming::packetLength(frame, available - offset);
+        if (length < 0) {
+            ++offset;  // line noise between frames is not a .tlog record
+            continue;
+        }
+        if (length == 0) {
+            break;  // the rest of this frame comes with the next read
+        }
+        m_tlogRecorder->record(linkId, TlogRecorder::Direction::Inbound, bytes + offset, length,
+                               nowUs);
+        offset += length;
+    }
+
+    if (carry.isEmpty()) {
+        carry.append(data + offset, size - offset);
+    } else {
+        carry.remove(0, offset);
+    }
+}
+
+void MavlinkRouter::recordOutbound(quint32 linkMask, const QByteArray& packet,
+                                   quint64 timestampUs) {
+    if (!m_tlogRecorder || !m_tlogRecorder->isRecording()) {
+        return;
+    }
+    for (int linkId = 0; linkId < MAX_LINKS; ++linkId) {
+        if (linkMask & (1u << linkId)) {
+            m_tlogRecorder->record(linkId, TlogRecorder::Direction::Outbound, packet.constData(),
+                                   packet.size(), timestampUs);
+        }
+    }
+}
+
+quint32 MavlinkRouter::routeFor(const mavlink_message_t& msg) const {
+    const quint32 attached = m_attachedLinks.load(std::memory_order_relaxed);
+
+    // Messages without a target system (or addressed to all) go everywhere
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msg.msgid);
+    if (!entry || !(entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM)) {
+        return attached;
+    }
+    const uint8_t targetSystem = static_cast<uint8_t>(_MAV_PAYLOAD(&msg)[entry->target_system_ofs]);
+    if (targetSystem == 0) {
+        return attached;
+    }
+
+    // Redundancy mode: only the primary link, so the vehicle gets each command once
+    if (m_redundancyEnabled.load(std::memory_order_relaxed)) {
+        const int primary = m_primaryLink[targetSystem].load(std::memory_order_relaxed);
+        if (primary != NO_LINK && (attached & (1u << primary))) {
+            return 1u << primary;
+        }
+    }
+
+    // Every link the target was heard on recently; failing that, the link it
+    // was heard on last; failing that, all links
+    const qint64 now = m_clock.elapsed();
+    quint32 recent = 0;
+    int latestLink = -1;
+    qint64 latestTime = NEVER;
+    for (int linkId = 0; linkId < MAX_LINKS; ++linkId) {
+        if (!(attached & (1u << linkId))) {
+            continue;
+        }
+        const qint64 heard =
+            m_systemLastHeard[targetSystem][linkId].load(std::memory_order_relaxed);
+        if (heard == NEVER) {
+            continue;
+        }
+        if (now - heard <= ROUTE_TIMEOUT_MS) {
+            recent |= 1u << linkId;
+        }
+        if (heard > latestTime) {
+            latestTime = heard;
+            latestLink = linkId;
+        }
+    }
+
+    if (recent) {
+        return recent;
+    }
+    return latestLink >= 0 ? (1u << latestLink) : attached;
+}
+
+template <typename T, auto Handler>
+void MavlinkRouter::builtinThunk(MavlinkRouter* router, const mavlink_message_t& msg) {
+    T payload;
+    MavlinkMessageTraits<T>::decode(&msg, &payload);
+
+    if constexpr (std::is_invocable_v<decltype(Handler), MavlinkRouter*, const mavlink_message_t&,
+                                      const T&>) {
+        (router->*Handler)(msg, payload);
+    } else {
+        (router->*Handler)(payload);
+    }
+
+    if (router->m_hasSubscriber.test(msg.msgid)) {
+        router->notifySubscribers(msg, &payload);
+    }
+}
+
+constexpr std::array<MavlinkRouter::BuiltinHandler, MavlinkRouter::BUILTIN_TABLE_SIZE>
+MavlinkRouter::builtinHandlers() {
+    std::array<BuiltinHandler, BUILTIN_TABLE_SIZE> table{};
+    table[MAVLINK_MSG_ID_HEARTBEAT] =
+        &builtinThunk<mavlink_heartbeat_t, &MavlinkRouter::handleHeartbeat>;
+    table[MAVLINK_MSG_ID_TIMESYNC] =
+        &builtinThunk<mavlink_timesync_t, &MavlinkRouter::handleTimesync>;
+    table[MAVLINK_MSG_ID_ATTITUDE] =
+        &builtinThunk<mavlink_attitude_t, &MavlinkRouter::handleAttitude>;
+    table[MAVLINK_MSG_ID_GLOBAL_POSITION_INT] =
+        &builtinThunk<mavlink_global_position_int_t, &MavlinkRouter::handleGlobalPosition>;
+    table[MAVLINK_MSG_ID_VFR_HUD] = &builtinThunk<mavlink_vfr_hud_t, &MavlinkRouter::handleVfrHud>;
+    table[MAVLINK_MSG_ID_BATTERY_STATUS] =
+        &builtinThunk<mavlink_battery_status_t, &MavlinkRouter::handleBatteryStatus>;
+    table[MAVLINK_MSG_ID_GPS_RAW_INT] =
+        &builtinThunk<mavlink_gps_raw_int_t, &MavlinkRouter::handleGpsRaw>;
+    table[MAVLINK_MSG_ID_SYS_STATUS] =
+        &builtinThunk<mavlink_sys_status_t, &MavlinkRouter::handleSystemStatus>;
+    table[MAVLINK_MSG_ID_MISSION_COUNT] =
+        &builtinThunk<mavlink_mission_count_t, &MavlinkRouter::handleMissionCount>;
+    table[MAVLINK_MSG_ID_MISSION_REQUEST] =
+        &builtinThunk<mavlink_mission_request_t, &MavlinkRouter::handleMissionRequest>;
+    table[MAVLINK_MSG_ID_MISSION_REQUEST_INT] =
+        &builtinThunk<mavlink_mission_request_int_t, &MavlinkRouter::handleMissionRequestInt>;
+    table[MAVLINK_MSG_ID_MISSION_ITEM] =
+        &builtinThunk<mavlink_mission_item_t, &MavlinkRouter::handleMissionItem>;
+    table[MAVLINK_MSG_ID_MISSION_ITEM_INT] =
+        &builtinThunk<mavlink_mission_item_int_t, &MavlinkRouter::handleMissionItemInt>;
+    table[MAVLINK_MSG_ID_MISSION_ACK] =
+        &builtinThunk<mavlink_mission_ack_t, &MavlinkRouter::handleMissionAck>;
+    table[MAVLINK_MSG_ID_MISSION_CURRENT] =
+        &builtinThunk<mavlink_mission_current_t, &MavlinkRouter::handleMissionCurrent>;
+    table[MAVLINK_MSG_ID_COMMAND_ACK] =
+        &builtinThunk<mavlink_command_ack_t, &MavlinkRouter::handleCommandAck>;
+    return table;
 }
 
 void MavlinkRouter::parseMessage(const mavlink_message_t& msg) {
-    // Log all received message types (can be noisy, but useful for debugging)
-    static QSet<uint32_t> loggedMsgIds;
-    if (!loggedMsgIds.contains(msg.msgid)) {
-        qInfo() << "MavlinkRouter: First occurrence of message ID:" << msg.msgid;
-        loggedMsgIds.insert(msg.msgid);
+    static constexpr std::array<BuiltinHandler, BUILTIN_TABLE_SIZE> handlers = builtinHandlers();
+    m_currentSystemId = msg.sysid;
+    m_currentComponentId = msg.compid;
+
+    // Log each message type the first time it is seen
+    const uint32_t msgId = msg.msgid;
+    bool firstOccurrence = false;
+    if (msgId < MSGID_BITSET_SIZE) {
+        if (!m_seenMsgIds.test(msgId)) {
+            m_seenMsgIds.set(msgId);
+            firstOccurrence = true;
+        }
+    } else if (!m_seenLargeMsgIds.contains(msgId)) {
+        m_seenLargeMsgIds.insert(msgId);
+        firstOccurrence = true;
+    }
+    if (firstOccurrence) {
+        qInfo() << "MavlinkRouter: First occurrence of message ID:" << msgId;
     }
 
-    switch (msg.msgid) {
-        case MAVLINK_MSG_ID_HEARTBEAT:
-            handleHeartbeat(msg);
-            break;
-        case MAVLINK_MSG_ID_TIMESYNC:
-            handleTimesync(msg);
-            break;
-        case MAVLINK_MSG_ID_ATTITUDE:
-            handleAttitude(msg);
-            break;
-        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
-            handleGlobalPosition(msg);
-            break;
-        case MAVLINK_MSG_ID_VFR_HUD:
-            handleVfrHud(msg);
-            break;
-        case MAVLINK_MSG_ID_BATTERY_STATUS:
-            handleBatteryStatus(msg);
-            break;
-        case MAVLINK_MSG_ID_GPS_RAW_INT:
-            handleGpsRaw(msg);
-            break;
-        case MAVLINK_MSG_ID_SYS_STATUS:
-            handleSystemStatus(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_COUNT:
-            handleMissionCount(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_REQUEST:
-            handleMissionRequest(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
-            handleMissionRequestInt(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_ITEM:
-            handleMissionItem(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_ITEM_INT:
-            handleMissionItemInt(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_ACK:
-            handleMissionAck(msg);
-            break;
-        case MAVLINK_MSG_ID_MISSION_CURRENT:
-            handleMissionCurrent(msg);
-            break;
-        case MAVLINK_MSG_ID_COMMAND_ACK:
-            handleCommandAck(msg);
-            break;
-        default:
-            // Other messages are ignored for now
-            break;
+    if (msgId < BUILTIN_TABLE_SIZE && handlers[msgId]) {
+        handlers[msgId](this, msg);
+    } else if (msgId >= MSGID_BITSET_SIZE || m_hasSubscriber.test(msgId)) {
+        // Not decoded by a built-in handler; decode here only if subscribed
+        auto it = m_subscribers.constFind(msgId);
+        if (it != m_subscribers.constEnd()) {
+            it->decodeAndNotify(this, msg);
+        }
+    }
+
+    if (msgId >= MSGID_BITSET_SIZE || m_hasRegisteredHandler.test(msgId)) {
+        dispatchRegistered(msg);
+    }
+}
+
+void MavlinkRouter::dispatchRegistered(const mavlink_message_t& msg) {
+    auto it = m_registeredHandlers.constFind(msg.msgid);
+    if (it == m_registeredHandlers.constEnd()) {
+        return;
+    }
+
+    // Copy so a handler may (un)register handlers while being dispatched;
+    // the ones unregistered meanwhile are skipped
+    const QVector<RegisteredHandler> handlers = it.value();
+    const quint64 generation = m_handlerGeneration;
+    for (const RegisteredHandler& registered : handlers) {
+        if (m_handlerGeneration != generation && !isRegistered(msg.msgid, registered.handle)) {
+            continue;
+        }
+        registered.handler(msg);
+    }
+}
+
+bool MavlinkRouter::isRegistered(uint32_t msgId, int handle) const {
+    auto it = m_registeredHandlers.constFind(msgId);
+    if (it == m_registeredHandlers.constEnd()) {
+        return false;
+    }
+    return std::any_of(it->cbegin(), it->cend(), [handle](const RegisteredHandler& registered) {
+        return registered.handle == handle;
+    });
+}
+
+void MavlinkRouter::notifySubscribers(const mavlink_message_t& msg, const void* payload) {
+    auto it = m_subscribers.constFind(msg.msgid);
+    if (it == m_subscribers.constEnd()) {
+        return;
+    }
+
+    // Copy so a callback may (un)subscribe while being notified; the
+    // subscriptions cancelled meanwhile are skipped
+    const QVector<Subscription> subscriptions = it->subscriptions;
+    const quint64 generation = m_handlerGeneration;
+    for (const Subscription& subscription : subscriptions) {
+        if (m_handlerGeneration != generation && !isSubscribed(msg.msgid, subscription.handle)) {
+            continue;
+        }
+        subscription.callback(payload, msg);
+    }
+}
+
+bool MavlinkRouter::isSubscribed(uint32_t msgId, int handle) const {
+    auto it = m_subscribers.constFind(msgId);
+    if (it == m_subscribers.constEnd()) {
+        return false;
+    }
+    return std::any_of(it->subscriptions.cbegin(), it->subscriptions.cend(),
+                       [handle](const Subscription& subscription) {
+                           return subscription.handle == handle;
+                       });
+}
+
+void MavlinkRouter::runOnRouterThread(const std::function<void()>& fn) {
+    QThread* routerThread = thread();
+    if (QThread::currentThread() == routerThread || !routerThread->isRunning()) {
+        fn();
+    } else {
+        QMetaObject::invokeMethod(this, fn, Qt::BlockingQueuedConnection);
+    }
+}
+
+int MavlinkRouter::addSubscription(uint32_t msgId, DecodeAndNotify decoder,
+                                   SubscriberCallback callback) {
+    int handle = 0;
+    runOnRouterThread([&]() {
+        handle = m_nextHandlerHandle++;
+        m_handlerGeneration++;
+        SubscriberList& list = m_subscribers[msgId];
+        list.decodeAndNotify = decoder;
+        list.subscriptions.append({handle, std::move(callback)});
+        if (msgId < MSGID_BITSET_SIZE) {
+            m_hasSubscriber.set(msgId);
+        }
+    });
+    return handle;
+}
+
+void MavlinkRouter::unsubscribe(int handle) {
+    runOnRouterThread([&]() {
+        for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it) {
+            QVector<Subscription>& subscriptions = it->subscriptions;
+            for (qsizetype i = 0; i < subscriptions.size(); ++i) {
+                if (subscriptions.at(i).handle != handle) {
+                    continue;
+                }
+                m_handlerGeneration++;
+                subscriptions.removeAt(i);
+                if (subscriptions.isEmpty()) {
+                    if (it.key() < MSGID_BITSET_SIZE) {
+                        m_hasSubscriber.reset(it.key());
+                    }
+                    m_subscribers.erase(it);
+                }
+                return;
+            }
+        }
+    });
+}
+
+int MavlinkRouter::registerHandler(uint32_t msgId, MessageHandler handler) {
+    if (!handler) {
+        qWarning() << "MavlinkRouter::registerHandler() - empty handler for message ID" << msgId;
+        return 0;
     }
+
+    int handle = 0;
+    runOnRouterThread([&]() {
+        handle = m_nextHandlerHandle++;
+        m_handlerGeneration++;
+        m_registeredHandlers[msgId].append({handle, std::move(handler)});
+        if (msgId < MSGID_BITSET_SIZE) {
+            m_hasRegisteredHandler.set(msgId);
+        }
+    });
+    return handle;
 }
 
-void MavlinkRouter::handleHeartbeat(const mavlink_message_t& msg) {
-    mavlink_heartbeat_t heartbeat;
-    mavlink_msg_heartbeat_decode(&msg, &heartbeat);
+void MavlinkRouter::unregisterHandler(int handle) {
+    runOnRouterThread([&]() {
+        for (auto it = m_registeredHandlers.begin(); it != m_registeredHandlers.end(); ++it) {
+            QVector<RegisteredHandler>& handlers = it.value();
+            for (qsizetype i = 0; i < handlers.size(); ++i) {
+                if (handlers.at(i).handle != handle) {
+                    continue;
+                }
+                m_handlerGeneration++;
+                handlers.removeAt(i);
+                if (handlers.isEmpty()) {
+                    if (it.key() < MSGID_BITSET_SIZE) {
+                        m_hasRegisteredHandler.reset(it.key());
+                    }
+                    m_registeredHandlers.erase(it);
+                }
+                return;
+            }
+        }
+    });
+}
 
+void MavlinkRouter::handleHeartbeat(const mavlink_message_t& msg,
+                                    const mavlink_heartbeat_t& heartbeat) {
     // Log first heartbeat from each system/component
     static QSet<QPair<uint8_t, uint8_t>> loggedSystems;
     QPair<uint8_t, uint8_t> systemKey(msg.sysid, msg.compid);
@@ -124,12 +713,11 @@ void MavlinkRouter::handleHeartbeat(const mavlink_message_t& msg) {
 
     emit heartbeatReceived(msg.sysid, msg.compid, heartbeat.autopilot, heartbeat.type,
                            heartbeat.system_status, heartbeat.base_mode, heartbeat.custom_mode);
+    emit linkHeartbeatReceived(m_currentLink);
 }
 
-void MavlinkRouter::handleTimesync(const mavlink_message_t& msg) {
-    mavlink_timesync_t timesync;
-    mavlink_msg_timesync_decode(&msg, &timesync);
-
+void MavlinkRouter::handleTimesync(const mavlink_message_t& msg,
+                                   const mavlink_timesync_t& timesync) {
     emit timesyncReceived(timesync.tc1, timesync.ts1);
 
     // If tc1 is 0, this is a request for us to respond
@@ -141,46 +729,37 @@ void MavlinkRouter::handleTimesync(const mavlink_message_t& msg) {
         mavlink_message_t response;
         mavlink_msg_timesync_pack(m_systemId, m_componentId, &response, timesync.ts1, now,
                                   msg.sysid, msg.compid);
-        sendMessage(response);
+        sendOnLinks(response, 1u << m_currentLink);  // answer on the link that asked
 
         qDebug() << "MavlinkRouter: Sent TIMESYNC response";
     } else {
         // This is a response to our request - calculate RTT
         qint64 now = QDateTime::currentMSecsSinceEpoch() * 1000;
-        m_roundTripTime = (now - timesync.tc1) / 1000;  // Convert to milliseconds
-        emit roundTripTimeChanged(m_roundTripTime);
-        qDebug() << "MavlinkRouter: RTT =" << m_roundTripTime << "ms";
+        const qint64 rtt = (now - timesync.tc1) / 1000;  // Convert to milliseconds
+        m_roundTripTime.store(rtt, std::memory_order_relaxed);
+        emit roundTripTimeChanged(rtt);
+        qDebug() << "MavlinkRouter: RTT =" << rtt << "ms";
     }
 }
 
-void MavlinkRouter::handleAttitude(const mavlink_message_t& msg) {
-    mavlink_attitude_t attitude;
-    mavlink_msg_attitude_decode(&msg, &attitude);
-
-    emit attitudeReceived(attitude.roll, attitude.pitch, attitude.yaw, attitude.rollspeed,
-                          attitude.pitchspeed, attitude.yawspeed);
+void MavlinkRouter::handleAttitude(const mavlink_attitude_t& attitude) {
+    updateTelemetryBatch(TelemetryBatch::Attitude, [&](TelemetryBatch& batch) {
+        batch.attitude = attitude;
+        batch.attitudeTraceKey = m_currentTraceKey;
+    });
 }
 
-void MavlinkRouter::handleGlobalPosition(const mavlink_message_t& msg) {
-    mavlink_global_position_int_t pos;
-    mavlink_msg_global_position_int_decode(&msg, &pos);
-
-    emit globalPositionReceived(pos.lat, pos.lon, pos.alt, pos.relative_alt, pos.vx, pos.vy, pos.vz,
-                                pos.hdg);
+void MavlinkRouter::handleGlobalPosition(const mavlink_global_position_int_t& pos) {
+    updateTelemetryBatch(TelemetryBatch::GlobalPosition,
+                         [&pos](TelemetryBatch& batch) { batch.globalPosition = pos; });
 }
 
-void MavlinkRouter::handleVfrHud(const mavlink_message_t& msg) {
-    mavlink_vfr_hud_t hud;
-    mavlink_msg_vfr_hud_decode(&msg, &hud);
-
-    emit vfrHudReceived(hud.airspeed, hud.groundspeed, hud.heading, hud.throttle, hud.alt,
-                        hud.climb);
+void MavlinkRouter::handleVfrHud(const mavlink_vfr_hud_t& hud) {
+    updateTelemetryBatch(TelemetryBatch::VfrHud,
+                         [&hud](TelemetryBatch& batch) { batch.vfrHud = hud; });
 }
 
-void MavlinkRouter::handleBatteryStatus(const mavlink_message_t& msg) {
-    mavlink_battery_status_t battery;
-    mavlink_msg_battery_status_decode(&msg, &battery);
-
+void MavlinkRouter::handleBatteryStatus(const mavlink_battery_status_t& battery) {
     // Calculate total voltage (in millivolts)
     uint16_t totalVoltage = 0;
     for (int i = 0; i < 10; ++i) {
@@ -189,69 +768,52 @@ void MavlinkRouter::handleBatteryStatus(const mavlink_message_t& msg) {
         }
     }
 
-    emit batteryStatusReceived(totalVoltage, battery.current_battery, battery.battery_remaining);
+    updateTelemetryBatch(TelemetryBatch::BatteryStatus, [&](TelemetryBatch& batch) {
+        batch.batteryVoltage = totalVoltage;
+        batch.batteryCurrent = battery.current_battery;
+        batch.batteryRemaining = battery.battery_remaining;
+    });
 }
 
-void MavlinkRouter::handleGpsRaw(const mavlink_message_t& msg) {
-    mavlink_gps_raw_int_t gps;
-    mavlink_msg_gps_raw_int_decode(&msg, &gps);
-
-    emit gpsRawReceived(gps.fix_type, gps.lat, gps.lon, gps.alt, gps.eph, gps.epv, gps.vel, gps.cog,
-                        gps.satellites_visible);
+void MavlinkRouter::handleGpsRaw(const mavlink_gps_raw_int_t& gps) {
+    updateTelemetryBatch(TelemetryBatch::GpsRaw,
+                         [&gps](TelemetryBatch& batch) { batch.gpsRaw = gps; });
 }
 
-void MavlinkRouter::handleSystemStatus(const mavlink_message_t& msg) {
-    mavlink_sys_status_t status;
-    mavlink_msg_sys_status_decode(&msg, &status);
-
-    emit systemStatusReceived(status.voltage_battery, status.current_battery,
-                              status.battery_remaining);
+void MavlinkRouter::handleSystemStatus(const mavlink_sys_status_t& status) {
+    updateTelemetryBatch(TelemetryBatch::SystemStatus,
+                         [&status](TelemetryBatch& batch) { batch.systemStatus = status; });
 }
 
-void MavlinkRouter::handleMissionCount(const mavlink_message_t& msg) {
-    mavlink_mission_count_t missionCount;
-    mavlink_msg_mission_count_decode(&msg, &missionCount);
-
+void MavlinkRouter::handleMissionCount(const mavlink_mission_count_t& missionCount) {
     qDebug() << "MavlinkRouter: Received MISSION_COUNT, count:" << missionCount.count
              << "mission_type:" << missionCount.mission_type;
 
     emit missionCountReceived(missionCount.count, missionCount.mission_type);
 }
 
-void MavlinkRouter::handleMissionRequest(const mavlink_message_t& msg) {
-    mavlink_mission_request_t missionRequest;
-    mavlink_msg_mission_request_decode(&msg, &missionRequest);
-
+void MavlinkRouter::handleMissionRequest(const mavlink_mission_request_t& missionRequest) {
     qDebug() << "MavlinkRouter: Received MISSION_REQUEST, seq:" << missionRequest.seq
              << "mission_type:" << missionRequest.mission_type;
 
     emit missionRequestReceived(missionRequest.seq, missionRequest.mission_type);
 }
 
-void MavlinkRouter::handleMissionRequestInt(const mavlink_message_t& msg) {
-    mavlink_mission_request_int_t missionRequest;
-    mavlink_msg_mission_request_int_decode(&msg, &missionRequest);
-
+void MavlinkRouter::handleMissionRequestInt(const mavlink_mission_request_int_t& missionRequest) {
     qDebug() << "MavlinkRouter: Received MISSION_REQUEST_INT, seq:" << missionRequest.seq
              << "mission_type:" << missionRequest.mission_type;
 
     emit missionRequestIntReceived(missionRequest.seq, missionRequest.mission_type);
 }
 
-void MavlinkRouter::handleMissionItem(const mavlink_message_t& msg) {
-    mavlink_mission_item_t missionItem;
-    mavlink_msg_mission_item_decode(&msg, &missionItem);
-
+void MavlinkRouter::handleMissionItem(const mavlink_mission_item_t& missionItem) {
     qDebug() << "MavlinkRouter: Received MISSION_ITEM, seq:" << missionItem.seq
              << "command:" << missionItem.command;
 
     emit missionItemReceived(missionItem);
 }
 
-void MavlinkRouter::handleMissionItemInt(const mavlink_message_t& msg) {
-    mavlink_mission_item_int_t missionItem;
-    mavlink_msg_mission_item_int_decode(&msg, &missionItem);
-
+void MavlinkRouter::handleMissionItemInt(const mavlink_mission_item_int_t& missionItem) {
     qDebug() << "MavlinkRouter: Received MISSION_ITEM_INT, seq:" << missionItem.seq
              << "command:" << missionItem.command
              << "lat:" << missionItem.x << "lon:" << missionItem.y << "alt:" << missionItem.z;
@@ -259,10 +821,7 @@ void MavlinkRouter::handleMissionItemInt(const mavlink_message_t& msg) {
     emit missionItemIntReceived(missionItem);
 }
 
-void MavlinkRouter::handleMissionAck(const mavlink_message_t& msg) {
-    mavlink_mission_ack_t missionAck;
-    mavlink_msg_mission_ack_decode(&msg, &missionAck);
-
+void MavlinkRouter::handleMissionAck(const mavlink_mission_ack_t& missionAck) {
     const char* resultStr = "UNKNOWN";
     switch (missionAck.type) {
         case MAV_MISSION_ACCEPTED:
@@ -319,20 +878,14 @@ void MavlinkRouter::handleMissionAck(const mavlink_message_t& msg) {
     emit missionAckReceived(missionAck.type, missionAck.mission_type);
 }
 
-void MavlinkRouter::handleMissionCurrent(const mavlink_message_t& msg) {
-    mavlink_mission_current_t missionCurrent;
-    mavlink_msg_mission_current_decode(&msg, &missionCurrent);
-
+void MavlinkRouter::handleMissionCurrent(const mavlink_mission_current_t& missionCurrent) {
     qDebug() << "MavlinkRouter: Received MISSION_CURRENT, seq:" << missionCurrent.seq
              << "total:" << missionCurrent.total;
 
     emit missionCurrentReceived(missionCurrent.seq, missionCurrent.total);
 }
 
-void MavlinkRouter::handleCommandAck(const mavlink_message_t& msg) {
-    mavlink_command_ack_t commandAck;
-    mavlink_msg_command_ack_decode(&msg, &commandAck);
-
+void MavlinkRouter::handleCommandAck(const mavlink_command_ack_t& commandAck) {
     QString resultStr;
     switch (commandAck.result) {
         case MAV_RESULT_ACCEPTED:
@@ -364,31 +917,109 @@ void MavlinkRouter::handleCommandAck(const mavlink_message_t& msg) {
     emit commandAckReceived(commandAck.command, commandAck.result);
 }
 
-void MavlinkRouter::updatePacketLoss(uint8_t seq) {
-    if (m_receivedPackets > 1) {
-        // Calculate expected sequence number
-        uint8_t expectedSeq = static_cast<uint8_t>(m_lastSeq + 1);
+void MavlinkRouter::updateFailover(int linkId, uint8_t systemId, bool firstArrival,
+                                   qint64 lateMs, qint64 nowMs) {
+    const int primary = m_primaryLink[systemId].load(std::memory_order_relaxed);
+    if (primary == NO_LINK) {
+        m_primaryLink[systemId].store(linkId, std::memory_order_relaxed);
+        m_primaryMissingSince[systemId] = NEVER;
+        qInfo() << "MavlinkRouter: System" << systemId << "uses link" << linkId << "as primary";
+        return;
+    }
 
-        // Count dropped packets (handle wraparound)
-        if (seq != expectedSeq) {
-            uint8_t dropped = 0;
-            if (seq > expectedSeq) {
-                dropped = seq - expectedSeq;
-            } else {
-                // Wraparound case
-                dropped = (255 - expectedSeq) + seq + 1;
-            }
+    if (linkId == primary) {
+        if (lateMs < DEGRADED_TIMEOUT_MS) {
+            // First, or close enough behind the link that was
+            m_primaryMissingSince[systemId] = NEVER;
+        } else if (m_failoverCandidate[systemId] != NO_LINK) {
+            // Still delivering, but too late to be of use
+            m_primaryMissingSince[systemId] = nowMs - lateMs;
+            switchPrimaryLink(systemId, m_failoverCandidate[systemId], nowMs);
+        }
+        return;
+    }
 
-            m_droppedPackets += dropped;
+    // Another link delivered a packet first; the primary has DEGRADED_TIMEOUT_MS
+    // to deliver it (or anything newer) before it is considered degraded
+    if (firstArrival) {
+        m_failoverCandidate[systemId] = linkId;
+        if (m_primaryMissingSince[systemId] == NEVER) {
+            m_primaryMissingSince[systemId] = nowMs;
         }
     }
+    if (m_primaryMissingSince[systemId] != NEVER &&
+        nowMs - m_primaryMissingSince[systemId] >= DEGRADED_TIMEOUT_MS &&
+        m_failoverCandidate[systemId] != NO_LINK) {
+        switchPrimaryLink(systemId, m_failoverCandidate[systemId], nowMs);
+    }
+}
 
-    m_lastSeq = seq;
+void MavlinkRouter::checkFailover() {
+    const qint64 nowMs = m_clock.elapsed();
+    for (int systemId = 0; systemId < 256; ++systemId) {
+        const qint64 missingSince = m_primaryMissingSince[systemId];
+        if (missingSince != NEVER && nowMs - missingSince >= DEGRADED_TIMEOUT_MS &&
+            m_failoverCandidate[systemId] != NO_LINK) {
+            switchPrimaryLink(static_cast<uint8_t>(systemId), m_failoverCandidate[systemId],
+                              nowMs);
+        }
+    }
+}
 
-    // Calculate packet loss percentage
-    if (m_receivedPackets > 0) {
-        float totalPackets = static_cast<float>(m_receivedPackets + m_droppedPackets);
-        m_packetLoss = (static_cast<float>(m_droppedPackets) / totalPackets) * 100.0f;
-        emit packetLossChanged(m_packetLoss);
+void MavlinkRouter::switchPrimaryLink(uint8_t systemId, int linkId, qint64 nowMs) {
+    const int previous = m_primaryLink[systemId].exchange(linkId, std::memory_order_relaxed);
+    const qint64 switchoverMs = nowMs - m_primaryMissingSince[systemId];
+    m_primaryMissingSince[systemId] = NEVER;
+    m_failoverCandidate[systemId] = NO_LINK;
+
+    m_switchovers.fetch_add(1, std::memory_order_relaxed);
+    m_lastSwitchoverMs.store(switchoverMs, std::memory_order_relaxed);
+    qWarning() << "MavlinkRouter: Link" << previous << "degraded for system" << systemId
+               << "- switched to link" << linkId << "after" << switchoverMs << "ms";
+    emit linkSwitchover(systemId, previous, linkId, switchoverMs);
+}
+
+void MavlinkRouter::publishStatistics() {
+    const float loss = m_sequenceTracker.closeWindow();
+    m_packetLoss.store(loss, std::memory_order_relaxed);
+
+    MessageStatistics::Snapshot snapshot = messageStatistics();
+    QVector<MessageStatistics::StreamRate> rates =
+        MessageStatistics::rates(m_lastMessageSnapshot, snapshot);
+    m_lastMessageSnapshot = std::move(snapshot);
+
+    const float seconds = STATISTICS_INTERVAL_MS / 1000.0f;
+    for (LinkState& link : m_links) {
+        const quint64 messages = link.messagesReceived.load(std::memory_order_relaxed);
+        const quint64 bytes = link.bytesReceived.load(std::memory_order_relaxed);
+        link.messagesPerSecond.store((messages - link.lastMessages) / seconds,
+                                     std::memory_order_relaxed);
+        link.bytesPerSecond.store((bytes - link.lastBytes) / seconds, std::memory_order_relaxed);
+        link.lastMessages = messages;
+        link.lastBytes = bytes;
+    }
+
+    const DedupWindow::Statistics& dedup = m_dedupWindow.statistics();
+    const quint64 checked = dedup.checked - m_lastDedupStatistics.checked;
+    const quint64 duplicates = dedup.duplicates - m_lastDedupStatistics.duplicates;
+    m_duplicateRate.store(checked ? duplicates * 100.0f / checked : 0.0f,
+                          std::memory_order_relaxed);
+    m_duplicatesDropped.store(dedup.duplicates, std::memory_order_relaxed);
+    m_dedupEvictions.store(dedup.evictions, std::memory_order_relaxed);
+    m_lastDedupStatistics = dedup;
+
+    {
+        QMutexLocker locker(&m_statisticsMutex);
+        m_publishedSources = m_sequenceTracker.statistics();
+        m_publishedRates = std::move(rates);
     }
+
+    if (m_sequenceTracker.untrackedPackets() > 0 && !m_untrackedSourcesReported) {
+        m_untrackedSourcesReported = true;
+        qWarning() << "MavlinkRouter: More than" << SequenceTracker::MAX_SOURCES
+                   << "sources, loss not tracked for" << m_sequenceTracker.untrackedPackets()
+                   << "packets";
+    }
+
+    emit packetLossChanged(loss);
 }
@@ -4,7 +4,24 @@
 #include <QObject>
 #include <QByteArray>
 #include <QElapsedTimer>
-#include "mavlink/ardupilotmega/mavlink.h"
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QVector>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <type_traits>
+#include "bytering.h"
+#include "dedupwindow.h"
+#include "linkinterface.h"
+#include "mavlinkmessagetraits.h"
+#include "messagestatistics.h"
+#include "sequencetracker.h"
+
+class QTimer;
+class TlogRecorder;
 
 /**
  * @brief Parses and routes MAVLink messages
@@ -12,40 +29,297 @@
  * Handles:
  * - MAVLink message parsing from byte stream
  * - Protocol-specific message handling (HEARTBEAT, TIMESYNC, etc.)
- * - Message statistics (packet loss, message rates)
+ * - Message statistics (per-source packet loss, per-stream rate, bandwidth
+ *   and jitter)
  * - Emits signals for different message types
+ *
+ * Designed to run on its own QThread so that TIMESYNC replies never wait for
+ * the GUI. Mission-protocol replies are still sent by MissionEditor on the GUI
+ * thread, so a stalled GUI delays them. High-rate telemetry is
+ * not signalled per message: the latest value of each stream is coalesced
+ * into a TelemetryBatch per source (sysid, compid) and telemetryBatchReady()
+ * is emitted once, however many messages from however many vehicles arrive
+ * before the consumer calls takeTelemetryBatches().
+ * Discrete events (heartbeats, mission protocol, command acks) keep their own
+ * signals.
+ *
+ * Bytes from each link (identified by its LinkManager link ID) are parsed on
+ * that link's own MAVLink channel, so interleaved streams never corrupt each
+ * other's framing. The router remembers on which links each system was last
+ * heard and routes outbound messages with a target_system there; everything
+ * else is sent on all attached links.
+ *
+ * In redundancy mode the same vehicle is expected on several links at once.
+ * Whichever copy of a packet arrives first is processed and later copies are
+ * dropped by a DedupWindow. Outbound traffic to a system goes to a single
+ * primary link, which is switched as soon as the primary falls
+ * DEGRADED_TIMEOUT_MS behind another link: it has delivered nothing for that
+ * long since another link delivered a packet first, or its copies of packets
+ * arrive that much later than the first copy.
+ *
+ * With a TlogRecorder attached, each link's traffic is recorded in both
+ * directions, tagged with the link ID. Received bytes are split into frames
+ * with MavlinkFraming before they are parsed, so packets with a bad
+ * checksum, unknown messages and the duplicate copies of redundant links
+ * are all kept. Every packet handed to bytesToSend() is recorded once per
+ * link it goes out on.
+ *
+ * While LatencyTrace is enabled each accepted packet is recorded as a
+ * ParseComplete trace point, and the attitude in a TelemetryBatch carries
+ * its trace key so that later stages can continue the trace.
+ *
+ * Messages are dispatched through a table indexed by msgid that is built at
+ * compile time for the built-in handlers. Other subsystems can attach
+ * handlers for additional messages with registerHandler(), or subscribe to
+ * decoded payloads with subscribe<T>(). Each message is decoded at most once,
+ * shared by the built-in handler and all subscribers, and messages nobody
+ * handles are never decoded.
  */
 class MavlinkRouter : public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Latest decoded telemetry of one source since the previous
+     * takeTelemetryBatches()
+     */
+    struct TelemetryBatch {
+        enum Field : quint32 {
+            Attitude = 1 << 0,
+            GlobalPosition = 1 << 1,
+            VfrHud = 1 << 2,
+            BatteryStatus = 1 << 3,
+            GpsRaw = 1 << 4,
+            SystemStatus = 1 << 5,
+        };
+
+        uint8_t systemId{0};  // source of every message in this batch
+        uint8_t componentId{0};
+        quint32 fields{0};    // Field bits present in this batch
+        quint32 messages{0};  // telemetry messages folded into this batch
+
+        quint64 attitudeTraceKey{0};  // LatencyTrace key of `attitude`, 0 when not tracing
+
+        mavlink_attitude_t attitude{};
+        mavlink_global_position_int_t globalPosition{};
+        mavlink_vfr_hud_t vfrHud{};
+        mavlink_gps_raw_int_t gpsRaw{};
+        mavlink_sys_status_t systemStatus{};
+
+        // BATTERY_STATUS reduced to total pack voltage (mV)
+        uint16_t batteryVoltage{0};
+        int16_t batteryCurrent{0};
+        int8_t batteryRemaining{0};
+
+        bool has(Field field) const { return fields & field; }
+    };
+
+    /**
+     * @brief Handler for one message ID; invoked on the router's thread
+     */
+    using MessageHandler = std::function<void(const mavlink_message_t&)>;
+
+    /**
+     * @brief Per-link traffic counters (safe to read from any thread)
+     */
+    struct LinkStatistics {
+        bool attached{false};
+        quint64 messagesReceived{0};
+        quint64 bytesReceived{0};
+        quint64 messagesSent{0};
+        quint64 bytesSent{0};
+        float messagesPerSecond{0.0f};  // over the last statistics interval
+        float bytesPerSecond{0.0f};
+        qint64 timeSinceLastMessage{-1};  // ms, -1 if nothing received yet
+        quint64 duplicatesDropped{0};     // redundant copies that arrived here second
+    };
+
+    /**
+     * @brief Duplicate and failover counters (safe to read from any thread)
+     */
+    struct RedundancyStatistics {
+        bool enabled{false};
+        quint64 duplicatesDropped{0};
+        float duplicateRate{0.0f};  // % of received packets dropped, last statistics interval
+        quint64 dedupEvictions{0};  // entries displaced early; their duplicates may slip through
+        quint64 switchovers{0};
+        qint64 lastSwitchoverMs{-1};  // first packet the old primary missed -> switch
+    };
+
+    static constexpr int MAX_LINKS = LinkInterface::MAX_LINKS;
+    static constexpr qint64 ROUTE_TIMEOUT_MS = 3000;   // route to links heard within this
+    static constexpr qint64 DEGRADED_TIMEOUT_MS = 50;  // primary this far behind -> switch
+
     explicit MavlinkRouter(QObject* parent = nullptr);
     ~MavlinkRouter() override = default;
 
     /**
-     * @brief Get packet loss percentage
+     * @brief Attach a handler for a message ID
+     *
+     * Registered handlers run after the built-in handler (if any), in
+     * registration order. Handlers may (un)register handlers: one added while
+     * a message is dispatched starts with the next message, one removed is
+     * not called again. Thread-safe: when called from another thread while
+     * the router's thread is running, the call blocks until the router has
+     * applied it, so the handler never races with parsing.
+     * @return Handle for unregisterHandler()
+     */
+    int registerHandler(uint32_t msgId, MessageHandler handler);
+
+    /**
+     * @brief Detach a handler previously added with registerHandler()
      */
-    float packetLoss() const { return m_packetLoss; }
+    void unregisterHandler(int handle);
 
     /**
-     * @brief Get round-trip time in milliseconds
+     * @brief Subscribe to a decoded message payload
+     *
+     * @p callback is invoked on the router's thread as callback(const T&) or
+     * callback(const T&, const mavlink_message_t&). The payload reference is
+     * only valid for the duration of the call. T must have a
+     * MavlinkMessageTraits specialization. Callbacks may (un)subscribe like
+     * handlers may (un)register. Thread-safe like registerHandler().
+     * @return Handle for unsubscribe()
      */
-    qint64 roundTripTime() const { return m_roundTripTime; }
+    template <typename T, typename Fn>
+    int subscribe(Fn&& callback) {
+        SubscriberCallback typed;
+        if constexpr (std::is_invocable_v<Fn, const T&, const mavlink_message_t&>) {
+            typed = [fn = std::forward<Fn>(callback)](const void* payload,
+                                                      const mavlink_message_t& msg) {
+                fn(*static_cast<const T*>(payload), msg);
+            };
+        } else {
+            static_assert(std::is_invocable_v<Fn, const T&>,
+                          "callback must take (const T&) or (const T&, const mavlink_message_t&)");
+            typed = [fn = std::forward<Fn>(callback)](const void* payload,
+                                                      const mavlink_message_t&) {
+                fn(*static_cast<const T*>(payload));
+            };
+        }
+        return addSubscription(MavlinkMessageTraits<T>::MSG_ID, &decodeAndNotify<T>,
+                               std::move(typed));
+    }
+
+    /**
+     * @brief Cancel a subscription made with subscribe()
+     */
+    void unsubscribe(int handle);
+
+    /**
+     * @brief Get packet loss percentage over the last statistics interval (any thread)
+     */
+    float packetLoss() const { return m_packetLoss.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get round-trip time in milliseconds (any thread)
+     */
+    qint64 roundTripTime() const { return m_roundTripTime.load(std::memory_order_relaxed); }
 
     /**
      * @brief Get time since last message in milliseconds
      */
     qint64 timeSinceLastMessage() const;
 
+    /**
+     * @brief Per-(sysid, compid) loss, duplicate and reorder counters (any thread)
+     *
+     * Snapshot taken at the last statistics interval.
+     */
+    QVector<SequenceTracker::SourceStatistics> sourceStatistics() const;
+
+    /**
+     * @brief Cumulative per-stream counters as of now (any thread, lock-free)
+     *
+     * Diff two snapshots with MessageStatistics::rates() for a custom window.
+     */
+    MessageStatistics::Snapshot messageStatistics() const;
+
+    /**
+     * @brief Per-stream Hz, bytes/sec and jitter over the last statistics
+     * interval, highest bandwidth first (any thread)
+     */
+    QVector<MessageStatistics::StreamRate> messageRates() const;
+
+    /**
+     * @brief Traffic counters for one link (any thread)
+     */
+    LinkStatistics linkStatistics(int linkId) const;
+
+    /**
+     * @brief Duplicate rate and failover counters, as of the last statistics
+     * interval (any thread)
+     */
+    RedundancyStatistics redundancyStatistics() const;
+
+    /**
+     * @brief Enable or disable redundant-link mode
+     *
+     * Resets the duplicate filter and the primary link choices. Thread-safe
+     * like registerHandler().
+     */
+    void setRedundancyEnabled(bool enabled);
+
+    bool isRedundancyEnabled() const { return m_redundancyEnabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Link currently used for outbound traffic to a system in
+     * redundancy mode (-1 if none chosen yet)
+     */
+    int primaryLink(uint8_t systemId) const;
+
+    /**
+     * @brief Start routing outbound messages to a link
+     *
+     * Resets the link's parser channel and counters. Thread-safe like
+     * registerHandler().
+     */
+    void attachLink(int linkId);
+
+    /**
+     * @brief Stop routing to a link and forget which systems were heard on it
+     */
+    void detachLink(int linkId);
+
+    /**
+     * @brief Tee the packets of all links, both directions, into a flight log
+     *
+     * The recorder only queues packets while it is recording and never
+     * blocks the parser. Outbound packets sent from another thread are
+     * recorded on the router thread, the recorder's single producer. Pass
+     * nullptr to detach. Thread-safe like registerHandler().
+     */
+    void setTlogRecorder(TlogRecorder* recorder);
+
+    /**
+     * @brief Parse everything buffered in a link's receive ring in place
+     *
+     * Called once per LinkInterface::receiveRingReadable() wakeup. Reports
+     * ring overruns (bytes the link had to drop) when the parser fell behind.
+     */
+    void drainReceiveRing(int linkId, ByteRing& ring);
+
+    /**
+     * @brief Take the pending telemetry batches and re-arm telemetryBatchReady()
+     *
+     * One batch per source heard since the previous call, in the order the
+     * sources were first heard. Thread-safe; normally called from the GUI
+     * thread in response to telemetryBatchReady().
+     */
+    QVector<TelemetryBatch> takeTelemetryBatches();
+
 public slots:
     /**
-     * @brief Process incoming bytes from the link
+     * @brief Process incoming bytes as if received on link 0
      * @param data Raw bytes received
      */
     void receiveBytes(const QByteArray& data);
 
     /**
      * @brief Send a MAVLink message
+     *
+     * Thread-safe: only serializes the message, picks the destination links
+     * and emits bytesToSend().
      * @param msg The message to send
      */
     void sendMessage(const mavlink_message_t& msg);
@@ -53,13 +327,28 @@ public slots:
 signals:
     /**
      * @brief Emitted when bytes need to be sent
+     * @param linkMask Destination link IDs, bit N set for link N
      */
-    void bytesToSend(QByteArray data);
+    void bytesToSend(quint32 linkMask, QByteArray data);
+
+    /**
+     * @brief Emitted with the receiving link's ID for every HEARTBEAT
+     */
+    void linkHeartbeatReceived(int linkId);
+
+    /**
+     * @brief Emitted when redundancy mode moves a system to another link
+     * @param switchoverMs Time from the first packet the old link missed to the switch
+     */
+    void linkSwitchover(uint8_t systemId, int fromLinkId, int toLinkId, qint64 switchoverMs);
 
     /**
      * @brief Emitted when any MAVLink message is received
+     *
+     * Only emitted while something is connected. Prefer subscribe<T>() or
+     * registerHandler() for specific messages.
      */
-    void messageReceived(mavlink_message_t msg);
+    void messageReceived(const mavlink_message_t& msg);
 
     /**
      * @brief Emitted when a HEARTBEAT message is received
@@ -74,18 +363,11 @@ signals:
     void timesyncReceived(int64_t tc1, int64_t ts1);
 
     /**
-     * @brief Emitted when telemetry data is received
+     * @brief Emitted when telemetry is waiting in takeTelemetryBatches()
+     *
+     * Not emitted again until the pending batches have been taken.
      */
-    void attitudeReceived(float roll, float pitch, float yaw, float rollspeed, float pitchspeed,
-                          float yawspeed);
-    void globalPositionReceived(int32_t lat, int32_t lon, int32_t alt, int32_t relativeAlt,
-                                int16_t vx, int16_t vy, int16_t vz, uint16_t heading);
-    void vfrHudReceived(float airspeed, float groundspeed, int16_t heading, uint16_t throttle,
-                        float alt, float climb);
-    void batteryStatusReceived(uint16_t voltage, int16_t current, int8_t remaining);
-    void gpsRawReceived(uint8_t fixType, int32_t lat, int32_t lon, int32_t alt, uint16_t eph,
-                        uint16_t epv, uint16_t vel, uint16_t cog, uint8_t satellitesVisible);
-    void systemStatusReceived(uint16_t voltage, int16_t currentBattery, int8_t batteryRemaining);
+    void telemetryBatchReady();
 
     /**
      * @brief Emitted when mission protocol messages are received
@@ -104,7 +386,7 @@ signals:
     void commandAckReceived(uint16_t command, uint8_t result);
 
     /**
-     * @brief Emitted when packet loss changes
+     * @brief Emitted once per statistics interval with the windowed loss
      */
     void packetLossChanged(float loss);
 
@@ -114,36 +396,182 @@ signals:
     void roundTripTimeChanged(qint64 rtt);
 
 private:
+    using BuiltinHandler = void (*)(MavlinkRouter*, const mavlink_message_t&);
+    using DecodeAndNotify = void (*)(MavlinkRouter*, const mavlink_message_t&);
+    using SubscriberCallback = std::function<void(const void*, const mavlink_message_t&)>;
+
+    struct RegisteredHandler {
+        int handle;
+        MessageHandler handler;
+    };
+
+    struct Subscription {
+        int handle;
+        SubscriberCallback callback;
+    };
+
+    struct SubscriberList {
+        DecodeAndNotify decodeAndNotify{nullptr};  // used when no built-in handler decodes
+        QVector<Subscription> subscriptions;
+    };
+
+    static constexpr int BUILTIN_TABLE_SIZE = 256;   // all built-in msgids are below this
+    static constexpr int MSGID_BITSET_SIZE = 65536;  // covers every msgid in use today
+
+    static constexpr std::array<BuiltinHandler, BUILTIN_TABLE_SIZE> builtinHandlers();
+
+    /**
+     * @brief Decode once, run the built-in handler, then notify subscribers
+     */
+    template <typename T, auto Handler>
+    static void builtinThunk(MavlinkRouter* router, const mavlink_message_t& msg);
+
+    template <typename T>
+    static void decodeAndNotify(MavlinkRouter* router, const mavlink_message_t& msg) {
+        T payload;
+        MavlinkMessageTraits<T>::decode(&msg, &payload);
+        router->notifySubscribers(msg, &payload);
+    }
+
+    int addSubscription(uint32_t msgId, DecodeAndNotify decoder, SubscriberCallback callback);
+    void notifySubscribers(const mavlink_message_t& msg, const void* payload);
+    bool isSubscribed(uint32_t msgId, int handle) const;
+    void runOnRouterThread(const std::function<void()>& fn);
+    void dispatchRegistered(const mavlink_message_t& msg);
+    bool isRegistered(uint32_t msgId, int handle) const;
+    void processBytes(int linkId, const char* data, qsizetype size);
+    void sendOnLinks(const mavlink_message_t& msg, quint32 linkMask);
+    void recordInbound(int linkId, const char* data, qsizetype size);
+    void recordOutbound(quint32 linkMask, const QByteArray& packet, quint64 timestampUs);
+    quint32 routeFor(const mavlink_message_t& msg) const;
+    /**
+     * @brief Track whether the primary link keeps up, for each packet in
+     * redundancy mode
+     * @param lateMs How long after the packet's first copy this one arrived
+     */
+    void updateFailover(int linkId, uint8_t systemId, bool firstArrival, qint64 lateMs,
+                        qint64 nowMs);
+    void checkFailover();
+    void switchPrimaryLink(uint8_t systemId, int linkId, qint64 nowMs);
     void parseMessage(const mavlink_message_t& msg);
-    void handleHeartbeat(const mavlink_message_t& msg);
-    void handleTimesync(const mavlink_message_t& msg);
-    void handleAttitude(const mavlink_message_t& msg);
-    void handleGlobalPosition(const mavlink_message_t& msg);
-    void handleVfrHud(const mavlink_message_t& msg);
-    void handleBatteryStatus(const mavlink_message_t& msg);
-    void handleGpsRaw(const mavlink_message_t& msg);
-    void handleSystemStatus(const mavlink_message_t& msg);
-    void handleMissionCount(const mavlink_message_t& msg);
-    void handleMissionRequest(const mavlink_message_t& msg);
-    void handleMissionRequestInt(const mavlink_message_t& msg);
-    void handleMissionItem(const mavlink_message_t& msg);
-    void handleMissionItemInt(const mavlink_message_t& msg);
-    void handleMissionAck(const mavlink_message_t& msg);
-    void handleMissionCurrent(const mavlink_message_t& msg);
-    void handleCommandAck(const mavlink_message_t& msg);
-    void updatePacketLoss(uint8_t seq);
-
-    mavlink_status_t m_status;
+    void handleHeartbeat(const mavlink_message_t& msg, const mavlink_heartbeat_t& heartbeat);
+    void handleTimesync(const mavlink_message_t& msg, const mavlink_timesync_t& timesync);
+    void handleAttitude(const mavlink_attitude_t& attitude);
+    void handleGlobalPosition(const mavlink_global_position_int_t& pos);
+    void handleVfrHud(const mavlink_vfr_hud_t& hud);
+    void handleBatteryStatus(const mavlink_battery_status_t& battery);
+    void handleGpsRaw(const mavlink_gps_raw_int_t& gps);
+    void handleSystemStatus(const mavlink_sys_status_t& status);
+    void handleMissionCount(const mavlink_mission_count_t& missionCount);
+    void handleMissionRequest(const mavlink_mission_request_t& missionRequest);
+    void handleMissionRequestInt(const mavlink_mission_request_int_t& missionRequest);
+    void handleMissionItem(const mavlink_mission_item_t& missionItem);
+    void handleMissionItemInt(const mavlink_mission_item_int_t& missionItem);
+    void handleMissionAck(const mavlink_mission_ack_t& missionAck);
+    void handleMissionCurrent(const mavlink_mission_current_t& missionCurrent);
+    void handleCommandAck(const mavlink_command_ack_t& commandAck);
+    void publishStatistics();
+    static quint32 packetLength(const mavlink_message_t& msg);
+
+    /**
+     * @brief Fold a telemetry update into the current source's pending batch
+     */
+    template <typename Fn>
+    void updateTelemetryBatch(TelemetryBatch::Field field, Fn&& update);
+
+    /**
+     * @brief Parser channel and counters of one link slot
+     *
+     * Counters are written by the parser thread (sent counters by any
+     * sender) and read lock-free by statistics consumers.
+     */
+    struct LinkState {
+        mavlink_status_t status;     // parser thread only
+        quint64 reportedOverruns;    // parser thread only
+        quint64 lastMessages;        // parser thread only, at the last interval
+        quint64 lastBytes;           // parser thread only, at the last interval
+        std::atomic<quint64> messagesReceived;
+        std::atomic<quint64> bytesReceived;
+        std::atomic<quint64> messagesSent;
+        std::atomic<quint64> bytesSent;
+        std::atomic<float> messagesPerSecond;
+        std::atomic<float> bytesPerSecond;
+        std::atomic<qint64> lastMessageTime;  // m_clock ms, NEVER if nothing received
+        std::atomic<quint64> duplicatesDropped;
+        QByteArray tlogCarry;  // parser thread only, start of a frame split across reads
+    };
+
+    void resetLinkState(int linkId);
+
+    static constexpr qint64 NEVER = -1;
+
+    std::array<LinkState, MAX_LINKS> m_links;
+    std::atomic<quint32> m_attachedLinks;  // bit N set while link N is attached
+    int m_currentLink;                     // link whose bytes are being parsed
+    quint64 m_currentTraceKey;             // LatencyTrace key of that message, 0 if off
+    uint8_t m_currentSystemId;             // source of the message being dispatched
+    uint8_t m_currentComponentId;
+
+    // m_clock time (ms) each system was last heard on each link
+    std::array<std::array<std::atomic<qint64>, MAX_LINKS>, 256> m_systemLastHeard;
+
+    // Redundancy mode
+    static constexpr int NO_LINK = -1;
+    static constexpr int FAILOVER_CHECK_INTERVAL_MS = 20;  // catches a primary that went silent
+    std::atomic<bool> m_redundancyEnabled;
+    DedupWindow m_dedupWindow;  // parser thread only
+    QTimer* m_failoverTimer;
+    std::array<std::atomic<int>, 256> m_primaryLink;  // per sysid, written by the parser thread
+    std::array<qint64, 256> m_primaryMissingSince;    // first packet the primary has not delivered
+    std::array<int, 256> m_failoverCandidate;         // link that delivered that packet
+    DedupWindow::Statistics m_lastDedupStatistics;    // at the last statistics interval
+    std::atomic<quint64> m_duplicatesDropped;
+    std::atomic<quint64> m_dedupEvictions;
+    std::atomic<float> m_duplicateRate;
+    std::atomic<quint64> m_switchovers;
+    std::atomic<qint64> m_lastSwitchoverMs;
+
+    TlogRecorder* m_tlogRecorder;  // parser thread only
+
     uint8_t m_systemId;
     uint8_t m_componentId;
 
     // Statistics
-    uint8_t m_lastSeq;
-    uint32_t m_receivedPackets;
-    uint32_t m_droppedPackets;
-    float m_packetLoss;
-    qint64 m_roundTripTime;
-    QElapsedTimer m_lastMessageTimer;
+    static constexpr int STATISTICS_INTERVAL_MS = 1000;
+    SequenceTracker m_sequenceTracker;
+    QTimer* m_statisticsTimer;
+    mutable QMutex m_statisticsMutex;
+    QVector<SequenceTracker::SourceStatistics> m_publishedSources;
+    MessageStatistics m_messageStatistics;
+    MessageStatistics::Snapshot m_lastMessageSnapshot;  // parser thread only
+    QVector<MessageStatistics::StreamRate> m_publishedRates;
+    bool m_untrackedSourcesReported;
+    std::atomic<float> m_packetLoss;
+    std::atomic<qint64> m_roundTripTime;
+    QElapsedTimer m_clock;                  // started once in the constructor
+    std::atomic<qint64> m_lastMessageTime;  // m_clock time of the last message
+
+    // Message IDs seen so far ("first occurrence" logging)
+    std::bitset<MSGID_BITSET_SIZE> m_seenMsgIds;
+    QSet<uint32_t> m_seenLargeMsgIds;
+
+    // Registered handlers; the bitset avoids the hash lookup for unregistered IDs
+    QHash<uint32_t, QVector<RegisteredHandler>> m_registeredHandlers;
+    std::bitset<MSGID_BITSET_SIZE> m_hasRegisteredHandler;
+    int m_nextHandlerHandle;
+    quint64 m_handlerGeneration;  // bumped by every (un)registration and (un)subscription
+
+    // Typed subscribers, keyed by msgid
+    QHash<uint32_t, SubscriberList> m_subscribers;
+    std::bitset<MSGID_BITSET_SIZE> m_hasSubscriber;
+
+    // Coalesced telemetry handed to the GUI thread, one batch per source.
+    // m_pendingBatchIndex maps a sysid to its first batch (-1 if none); the
+    // few extra components of a system are found by scanning forward.
+    QMutex m_batchMutex;
+    QVector<TelemetryBatch> m_pendingBatches;
+    std::array<int, 256> m_pendingBatchIndex;
+    bool m_batchSignalPending;
 
     // TIMESYNC state
     int64_t m_timesyncTc1;
@@ -0,0 +1,146 @@
+#include "messagestatistics.h"
+#include <QHash>
+#include <algorithm>
+#include "relaxedcounter.h"
+
+namespace {
+constexpr quint64 KEY_VALID = quint64(1) << 40;
+constexpr qint64 EWMA_DIVISOR = 16;  // gain 1/16
+}  // namespace
+
+MessageStatistics::MessageStatistics()
+    : m_streams(new Stream[MAX_STREAMS]), m_streamCount(0), m_untrackedMessages(0) {}
+
+quint64 MessageStatistics::makeKey(uint8_t systemId, uint8_t componentId, uint32_t msgId) {
+    return KEY_VALID | (quint64(systemId) << 32) | (quint64(componentId) << 24) |
+           (msgId & 0xffffff);
+}
+
+MessageStatistics::Stream* MessageStatistics::findOrInsert(quint64 key) {
+    quint64 hash = key * 0x9e3779b97f4a7c15ull;
+    int index = static_cast<int>(hash >> 54) & (MAX_STREAMS - 1);
+
+    for (int probe = 0; probe < MAX_STREAMS; ++probe) {
+        Stream& stream = m_streams[index];
+        const quint64 existing = stream.key.load(std::memory_order_relaxed);
+        if (existing == key) {
+            return &stream;
+        }
+        if (existing == 0) {
+            // Keep the table at most 3/4 full so probes stay short
+            if (m_streamCount >= MAX_STREAMS * 3 / 4) {
+                return nullptr;
+            }
+            m_streamCount++;
+            // Counters are zero; publishing the key makes the entry visible
+            stream.key.store(key, std::memory_order_release);
+            return &stream;
+        }
+        index = (index + 1) & (MAX_STREAMS - 1);
+    }
+    return nullptr;
+}
+
+void MessageStatistics::record(uint8_t systemId, uint8_t componentId, uint32_t msgId,
+                               quint32 bytes, qint64 nowNs) {
+    Stream* stream = findOrInsert(makeKey(systemId, componentId, msgId));
+    if (!stream) {
+        RelaxedCounter::add(m_untrackedMessages, 1);
+        return;
+    }
+
+    if (stream->messages.load(std::memory_order_relaxed) > 0) {
+        const qint64 interval = nowNs - stream->lastArrivalNs;
+        if (stream->meanIntervalNs == 0) {
+            stream->meanIntervalNs = interval;
+        } else {
+            const qint64 deviation = qAbs(interval - stream->meanIntervalNs);
+            stream->meanIntervalNs += (interval - stream->meanIntervalNs) / EWMA_DIVISOR;
+            stream->jitterNs += (deviation - stream->jitterNs) / EWMA_DIVISOR;
+        }
+        stream->meanIntervalUs.store(static_cast<quint32>(stream->meanIntervalNs / 1000),
+                                     std::memory_order_relaxed);
+        stream->jitterUs.store(static_cast<quint32>(stream->jitterNs / 1000),
+                               std::memory_order_relaxed);
+    }
+    stream->lastArrivalNs = nowNs;
+
+    RelaxedCounter::add(stream->messages, 1);
+    RelaxedCounter::add(stream->bytes, bytes);
+}
+
+MessageStatistics::Snapshot MessageStatistics::snapshot(qint64 nowNs) const {
+    Snapshot snapshot;
+    snapshot.timestampNs = nowNs;
+    snapshot.untrackedMessages = m_untrackedMessages.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < MAX_STREAMS; ++i) {
+        const Stream& stream = m_streams[i];
+        const quint64 key = stream.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+        StreamCounters counters;
+        counters.systemId = static_cast<uint8_t>(key >> 32);
+        counters.componentId = static_cast<uint8_t>(key >> 24);
+        counters.msgId = static_cast<uint32_t>(key & 0xffffff);
+        counters.messages = stream.messages.load(std::memory_order_relaxed);
+        counters.bytes = stream.bytes.load(std::memory_order_relaxed);
+        counters.meanIntervalUs = stream.meanIntervalUs.load(std::memory_order_relaxed);
+        counters.jitterUs = stream.jitterUs.load(std::memory_order_relaxed);
+        snapshot.streams.append(counters);
+    }
+    return snapshot;
+}
+
+QVector<MessageStatistics::StreamRate> MessageStatistics::rates(const Snapshot& previous,
+                                                                const Snapshot& current) {
+    QVector<StreamRate> result;
+    const double seconds = (current.timestampNs - previous.timestampNs) / 1e9;
+    if (seconds <= 0.0) {
+        return result;
+    }
+
+    QHash<quint64, const StreamCounters*> before;
+    before.reserve(previous.streams.size());
+    for (const StreamCounters& counters : previous.streams) {
+        before.insert(makeKey(counters.systemId, counters.componentId, counters.msgId),
+                      &counters);
+    }
+
+    result.reserve(current.streams.size());
+    for (const StreamCounters& counters : current.streams) {
+        quint64 messages = counters.messages;
+        quint64 bytes = counters.bytes;
+        if (const StreamCounters* old =
+                before.value(makeKey(counters.systemId, counters.componentId, counters.msgId))) {
+            messages -= old->messages;
+            bytes -= old->bytes;
+        }
+        if (messages == 0) {
+            continue;
+        }
+
+        StreamRate rate;
+        rate.systemId = counters.systemId;
+        rate.componentId = counters.componentId;
+        rate.msgId = counters.msgId;
+        rate.hz = messages / seconds;
+        rate.bytesPerSecond = bytes / seconds;
+        rate.jitterMs = counters.jitterUs / 1000.0;
+        result.append(rate);
+    }
+
+    std::sort(result.begin(), result.end(), [](const StreamRate& a, const StreamRate& b) {
+        return a.bytesPerSecond > b.bytesPerSecond;
+    });
+    return result;
+}
+
+double MessageStatistics::totalBytesPerSecond(const QVector<StreamRate>& rates) {
+    double total = 0.0;
+    for (const StreamRate& rate : rates) {
+        total += rate.bytesPerSecond;
+    }
+    return total;
+}
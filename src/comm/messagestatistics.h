@@ -0,0 +1,96 @@
+#ifndef MESSAGESTATISTICS_H
+#define MESSAGESTATISTICS_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Per-stream message rate, bandwidth and jitter counters
+ *
+ * A stream is one msgid from one (sysid, compid) source. Streams live in a
+ * fixed-size open-addressed table written only by the parser thread with
+ * plain relaxed atomic stores (no locks, no read-modify-write), so
+ * snapshot() can run concurrently on any thread.
+ *
+ * Counters are cumulative; rates() turns two snapshots into Hz and
+ * bytes/sec. Inter-arrival jitter is the mean absolute deviation of the
+ * arrival interval from its running mean (both EWMA, gain 1/16).
+ */
+class MessageStatistics {
+public:
+    static constexpr int MAX_STREAMS = 1024;
+
+    struct StreamCounters {
+        uint8_t systemId{0};
+        uint8_t componentId{0};
+        uint32_t msgId{0};
+        quint64 messages{0};
+        quint64 bytes{0};  // on-the-wire packet bytes
+        quint32 meanIntervalUs{0};
+        quint32 jitterUs{0};
+    };
+
+    struct Snapshot {
+        qint64 timestampNs{0};
+        quint64 untrackedMessages{0};  // streams that did not fit in the table
+        QVector<StreamCounters> streams;
+    };
+
+    struct StreamRate {
+        uint8_t systemId{0};
+        uint8_t componentId{0};
+        uint32_t msgId{0};
+        double hz{0.0};
+        double bytesPerSecond{0.0};
+        double jitterMs{0.0};
+    };
+
+    MessageStatistics();
+
+    /**
+     * @brief Account for one packet (parser thread only)
+     */
+    void record(uint8_t systemId, uint8_t componentId, uint32_t msgId, quint32 bytes,
+                qint64 nowNs);
+
+    /**
+     * @brief Copy the counters (any thread)
+     * @param nowNs Timestamp on the same clock passed to record()
+     */
+    Snapshot snapshot(qint64 nowNs) const;
+
+    /**
+     * @brief Rates between two snapshots, sorted by bandwidth (highest first)
+     */
+    static QVector<StreamRate> rates(const Snapshot& previous, const Snapshot& current);
+
+    /**
+     * @brief Sum of bytesPerSecond over @p rates
+     */
+    static double totalBytesPerSecond(const QVector<StreamRate>& rates);
+
+private:
+    struct alignas(64) Stream {
+        std::atomic<quint64> key{0};  // 0 = empty
+        std::atomic<quint64> messages{0};
+        std::atomic<quint64> bytes{0};
+        std::atomic<quint32> meanIntervalUs{0};
+        std::atomic<quint32> jitterUs{0};
+
+        // Writer-private state
+        qint64 lastArrivalNs{0};
+        qint64 meanIntervalNs{0};
+        qint64 jitterNs{0};
+    };
+
+    static quint64 makeKey(uint8_t systemId, uint8_t componentId, uint32_t msgId);
+    Stream* findOrInsert(quint64 key);
+
+    std::unique_ptr<Stream[]> m_streams;
+    int m_streamCount;
+    std::atomic<quint64> m_untrackedMessages;
+};
+
+#endif  // MESSAGESTATISTICS_H
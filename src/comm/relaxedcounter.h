@@ -0,0 +1,26 @@
+#ifndef RELAXEDCOUNTER_H
+#define RELAXEDCOUNTER_H
+
+#include <atomic>
+
+/**
+ * @brief Statistics counters with one writer and any number of readers
+ *
+ * Readers load the counters with relaxed ordering from other threads; only
+ * the owning thread ever adds to them.
+ */
+namespace RelaxedCounter {
+
+/**
+ * @brief Add @p value to @p counter from its only writer
+ *
+ * Single writer: a load + store avoids a locked read-modify-write.
+ */
+template <typename T>
+inline void add(std::atomic<T>& counter, typename std::atomic<T>::value_type value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+}  // namespace RelaxedCounter
+
+#endif  // RELAXEDCOUNTER_H
@@ -0,0 +1,334 @@
+#include "replaylink.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <limits>
+
+ReplayLink::ReplayLink(const Configuration& config, QObject* parent)
+    : LinkInterface(parent), m_config(config), m_status(LinkStatus::Disconnected),
+      m_errorReported(false), m_file(nullptr), m_data(nullptr), m_size(0), m_offset(0),
+      m_firstTimestampUs(0), m_playbackTimer(nullptr), m_ring(nullptr), m_anchorTimestampUs(0),
+      m_durationUs(0), m_positionUs(0), m_packetsReplayed(0), m_bytesReplayed(0),
+      m_bytesSkipped(0), m_speed(qMax(config.speed, AS_FAST_AS_POSSIBLE)), m_paused(false),
+      m_finished(false) {}
+
+ReplayLink::~ReplayLink() {
+    disconnectLink();
+}
+
+QString ReplayLink::name() const {
+    return m_config.name;
+}
+
+ReplayLink::LinkStatus ReplayLink::status() const {
+    return m_status;
+}
+
+bool ReplayLink::isConnected() const {
+    return m_status == LinkStatus::Connected;
+}
+
+ReplayLink::PlaybackStatistics ReplayLink::playbackStatistics() const {
+    PlaybackStatistics stats;
+    stats.durationUs = m_durationUs.load(std::memory_order_relaxed);
+    stats.positionUs = m_positionUs.load(std::memory_order_relaxed);
+    stats.packetsReplayed = m_packetsReplayed.load(std::memory_order_relaxed);
+    stats.bytesReplayed = m_bytesReplayed.load(std::memory_order_relaxed);
+    stats.bytesSkipped = m_bytesSkipped.load(std::memory_order_relaxed);
+    stats.speed = m_speed.load(std::memory_order_relaxed);
+    stats.paused = m_paused.load(std::memory_order_relaxed);
+    stats.finished = m_finished.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ReplayLink::connectLink() {
+    qDebug() << "ReplayLink::connectLink() called on thread:" << QThread::currentThread();
+
+    if (m_status == LinkStatus::Connected) {
+        return;
+    }
+
+    closeFile();
+    setStatus(LinkStatus::Connecting);
+
+    m_file = new QFile(m_config.filePath, this);
+    QString reason;
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        reason = m_file->errorString();
+    } else if (m_file->size() == 0) {
+        reason = QStringLiteral("file is empty");
+    } else {
+        m_size = static_cast<qsizetype>(m_file->size());
+        m_data = m_file->map(0, m_file->size());
+        reason = m_file->errorString();
+    }
+    if (!m_data) {
+        QString error =
+            QString("Failed to open telemetry log %1: %2").arg(m_config.filePath, reason);
+        closeFile();
+        setStatus(LinkStatus::Error);
+        if (!m_errorReported) {
+            m_errorReported = true;
+            emit errorOccurred(error);
+        }
+        qWarning() << error;
+        return;
+    }
+
+    loadIndex();
+    m_ring = receiveRing().data();
+    m_packetsReplayed.store(0, std::memory_order_relaxed);
+    m_bytesReplayed.store(0, std::memory_order_relaxed);
+
+    m_playbackTimer = new QTimer(this);
+    m_playbackTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_playbackTimer, &QTimer::timeout, this, &ReplayLink::onPlaybackTimer);
+
+    m_errorReported = false;
+    setStatus(LinkStatus::Connected);
+    qDebug() << "Replay Link opened:" << m_config.name << "-" << m_size << "bytes,"
+             << m_durationUs.load(std::memory_order_relaxed) / 1000000.0 << "s at speed"
+             << m_speed.load(std::memory_order_relaxed);
+
+    if (!m_paused.load(std::memory_order_relaxed)) {
+        startPlayback();
+    }
+}
+
+void ReplayLink::disconnectLink() {
+    closeFile();
+    setStatus(LinkStatus::Disconnected);
+    qDebug() << "Replay Link disconnected:" << m_config.name;
+}
+
+void ReplayLink::writeBytes(const QByteArray& data) {
+    // Nothing is listening on the other end of a recording
+    Q_UNUSED(data)
+}
+
+void ReplayLink::setPaused(bool paused) {
+    m_paused.store(paused, std::memory_order_relaxed);
+    if (!m_playbackTimer) {
+        return;
+    }
+
+    if (paused) {
+        m_playbackTimer->stop();
+    } else if (!m_finished.load(std::memory_order_relaxed)) {
+        startPlayback();
+    }
+}
+
+void ReplayLink::setSpeed(double speed) {
+    m_speed.store(qMax(speed, AS_FAST_AS_POSSIBLE), std::memory_order_relaxed);
+    if (m_playbackTimer && m_playbackTimer->isActive()) {
+        startPlayback();  // re-anchor pacing at the current position
+    }
+}
+
+void ReplayLink::seek(qint64 positionUs) {
+    if (!m_data) {
+        return;
+    }
+
+    const qint64 position = qMax<qint64>(positionUs, 0);
+    const quint64 target = m_firstTimestampUs + static_cast<quint64>(position);
+
+    // Start from the nearest keyframe's state, then scan the rest of the way
+    // (less than one keyframe interval), keeping the latest state per stream.
+    // Only playback counts skipped bytes, so the scan leaves the counter alone.
+    QHash<quint64, qint64> latestState;
+    qsizetype offset = 0;
+    TlogIndex::Record record;
+    quint64 skipped = 0;
+    if (const TlogIndex::Keyframe* keyframe = m_index.keyframeAt(target)) {
+        offset = keyframe->offset;
+        for (qint64 stateOffset : m_index.snapshot(*keyframe)) {
+            qsizetype at = stateOffset;
+            if (TlogIndex::readRecord(m_data, m_size, at, record, skipped)) {
+                latestState.insert(TlogIndex::streamKey(record), record.offset);
+            }
+        }
+    }
+    while (TlogIndex::readRecord(m_data, m_size, offset, record, skipped) &&
+           record.timestampUs < target) {
+        if (TlogIndex::isStateMessage(record.msgId)) {
+            latestState.insert(TlogIndex::streamKey(record), record.offset);
+        }
+        offset = record.nextOffset;
+    }
+    m_offset = offset;
+    m_positionUs.store(position, std::memory_order_relaxed);
+    m_finished.store(false, std::memory_order_relaxed);
+
+    primeState(latestState.values());
+
+    if (!m_paused.load(std::memory_order_relaxed)) {
+        startPlayback();
+    }
+}
+
+void ReplayLink::onPlaybackTimer() {
+    const double speed = m_speed.load(std::memory_order_relaxed);
+    const bool paced = speed > AS_FAST_AS_POSSIBLE;
+    const quint64 elapsedUs = static_cast<quint64>(m_anchorClock.nsecsElapsed() / 1000);
+    const quint64 dueUs = paced ? m_anchorTimestampUs + static_cast<quint64>(elapsedUs * speed)
+                                : std::numeric_limits<quint64>::max();
+
+    qsizetype budget = MAX_BATCH_BYTES;
+    bool ringFull = false;
+    bool pushed = false;
+    quint64 packets = 0;
+    quint64 bytes = 0;
+    quint64 lastTimestampUs = 0;
+    TlogIndex::Record record;
+    while ((paced || budget > 0) && readRecord(m_offset, record)) {
+        if (record.timestampUs > dueUs) {
+            break;
+        }
+        // Wait for the parser rather than overrun its ring
+        if (m_ring && m_ring->writable() < record.packetBytes) {
+            ringFull = true;
+            break;
+        }
+
+        pushReceivedBytes(reinterpret_cast<const char*>(m_data + record.packetOffset),
+                          record.packetBytes);
+        m_offset = record.nextOffset;
+        lastTimestampUs = record.timestampUs;
+        budget -= record.packetBytes;
+        bytes += static_cast<quint64>(record.packetBytes);
+        packets++;
+        pushed = true;
+    }
+
+    if (pushed) {
+        flushReceivedBytes();
+        m_packetsReplayed.store(m_packetsReplayed.load(std::memory_order_relaxed) + packets,
+                                std::memory_order_relaxed);
+        m_bytesReplayed.store(m_bytesReplayed.load(std::memory_order_relaxed) + bytes,
+                              std::memory_order_relaxed);
+        m_positionUs.store(static_cast<qint64>(qMax(lastTimestampUs, m_firstTimestampUs) -
+                                               m_firstTimestampUs),
+                           std::memory_order_relaxed);
+    }
+
+    if (m_offset >= m_size || (!ringFull && !readRecord(m_offset, record))) {
+        if (m_config.loop) {
+            seek(0);
+            return;
+        }
+        m_playbackTimer->stop();
+        m_finished.store(true, std::memory_order_relaxed);
+        qDebug() << "Replay Link finished:" << m_config.name << "-"
+                 << m_packetsReplayed.load(std::memory_order_relaxed) << "packets";
+        emit playbackFinished();
+        return;
+    }
+
+    // Unpaced: spin through the event loop while there is room, back off briefly when full
+    if (!paced) {
+        const int interval = ringFull ? 1 : 0;
+        if (m_playbackTimer->interval() != interval) {
+            m_playbackTimer->setInterval(interval);
+        }
+    }
+}
+
+bool ReplayLink::readRecord(qsizetype& offset, TlogIndex::Record& record) {
+    quint64 skipped = 0;
+    const bool found = TlogIndex::readRecord(m_data, m_size, offset, record, skipped);
+    if (skipped > 0) {
+        m_bytesSkipped.store(m_bytesSkipped.load(std::memory_order_relaxed) + skipped,
+                             std::memory_order_relaxed);
+    }
+    return found;
+}
+
+void ReplayLink::loadIndex() {
+    // The sidecar is reused as long as the log has not changed since it was written
+    const QString indexPath = TlogIndex::sidecarPath(m_config.filePath);
+    const qint64 modifiedMs = QFileInfo(m_config.filePath).lastModified().toMSecsSinceEpoch();
+    if (!m_index.load(indexPath, m_size, modifiedMs)) {
+        QElapsedTimer timer;
+        timer.start();
+        if (m_index.build(m_data, m_size)) {
+            qDebug() << "Replay Link indexed" << m_index.recordCount() << "records in"
+                     << timer.elapsed() << "ms";
+            if (!m_index.save(indexPath, m_size, modifiedMs)) {
+                qDebug() << "Replay Link: Cannot write index" << indexPath;
+            }
+        }
+    }
+
+    m_firstTimestampUs = m_index.firstTimestampUs();
+    m_offset = 0;
+    m_bytesSkipped.store(0, std::memory_order_relaxed);
+    m_durationUs.store(m_index.durationUs(), std::memory_order_relaxed);
+    m_positionUs.store(0, std::memory_order_relaxed);
+    m_finished.store(false, std::memory_order_relaxed);
+}
+
+void ReplayLink::primeState(QVector<qint64> offsets) {
+    // Replayed in log order so each stream ends up at its latest value; skipped
+    // rather than waited for if the parser is still busy with earlier data
+    std::sort(offsets.begin(), offsets.end());
+    TlogIndex::Record record;
+    quint64 skipped = 0;
+    bool pushed = false;
+    for (qint64 offset : offsets) {
+        qsizetype at = offset;
+        if (!TlogIndex::readRecord(m_data, m_size, at, record, skipped) ||
+            (m_ring && m_ring->writable() < record.packetBytes)) {
+            continue;
+        }
+        pushReceivedBytes(reinterpret_cast<const char*>(m_data + record.packetOffset),
+                          record.packetBytes);
+        pushed = true;
+    }
+    if (pushed) {
+        flushReceivedBytes();
+    }
+}
+
+void ReplayLink::startPlayback() {
+    // Pacing restarts from the next record, so pauses and seeks leave no gap
+    TlogIndex::Record record;
+    m_anchorTimestampUs = readRecord(m_offset, record) ? record.timestampUs : m_firstTimestampUs;
+    m_anchorClock.start();
+
+    const bool paced = m_speed.load(std::memory_order_relaxed) > AS_FAST_AS_POSSIBLE;
+    m_playbackTimer->start(paced ? TICK_MS : 0);
+}
+
+void ReplayLink::closeFile() {
+    if (m_playbackTimer) {
+        m_playbackTimer->stop();
+        m_playbackTimer->deleteLater();
+        m_playbackTimer = nullptr;
+    }
+
+    if (m_file) {
+        if (m_data) {
+            m_file->unmap(const_cast<uchar*>(m_data));
+        }
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_index.clear();
+    m_ring = nullptr;
+}
+
+void ReplayLink::setStatus(LinkStatus status) {
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged(m_status);
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef REPLAYLINK_H
+#define REPLAYLINK_H
+
+#include "linkinterface.h"
+#include "tlogindex.h"
+#include <QElapsedTimer>
+#include <atomic>
+
+class QFile;
+class QTimer;
+
+/**
+ * @brief Plays back a telemetry log (.tlog) as if it were a live link
+ *
+ * Designed to run on a separate QThread like any other link. The log is
+ * memory-mapped and its packets are pushed through pushReceivedBytes()
+ * without the timestamps, so LinkManager, MavlinkRouter and the models see
+ * exactly the bytes that originally came off the wire.
+ *
+ * Playback is paced by the recorded timestamps scaled by the configured
+ * speed, checked every TICK_MS. At AS_FAST_AS_POSSIBLE there is no pacing:
+ * packets are pushed as long as the receive ring has room, so a long flight
+ * runs through the whole pipeline in seconds without overrunning the ring.
+ *
+ * On open the log's TlogIndex sidecar is loaded, or built and saved if it is
+ * missing or stale, so seeking jumps to a keyframe instead of scanning.
+ *
+ * Bytes that do not parse as a record (e.g. a truncated write at the end of
+ * a crashed session) are skipped until the next MAVLink start marker.
+ * Outbound traffic is discarded.
+ */
+class ReplayLink : public LinkInterface {
+    Q_OBJECT
+
+public:
+    static constexpr double AS_FAST_AS_POSSIBLE = 0.0;
+
+    struct Configuration {
+        QString name;
+        QString filePath;
+        double speed{1.0};  // 1.0 = real time, AS_FAST_AS_POSSIBLE = no pacing
+        bool loop{false};   // restart at the end instead of finishing
+    };
+
+    /**
+     * @brief Playback position and counters (safe to read from any thread)
+     */
+    struct PlaybackStatistics {
+        qint64 durationUs{0};  // first to last record
+        qint64 positionUs{0};  // last replayed record, relative to the first
+        quint64 packetsReplayed{0};
+        quint64 bytesReplayed{0};
+        quint64 bytesSkipped{0};  // not parseable as .tlog records
+        double speed{1.0};
+        bool paused{false};
+        bool finished{false};
+    };
+
+    explicit ReplayLink(const Configuration& config, QObject* parent = nullptr);
+    ~ReplayLink() override;
+
+    QString name() const override;
+    LinkStatus status() const override;
+    bool isConnected() const override;
+    bool expectsHeartbeat() const override { return false; }
+
+    PlaybackStatistics playbackStatistics() const;
+
+public slots:
+    void connectLink() override;
+    void disconnectLink() override;
+    void writeBytes(const QByteArray& data) override;
+
+    /**
+     * @brief Pause or resume playback at the current position
+     */
+    void setPaused(bool paused);
+
+    /**
+     * @brief Change the playback rate without losing the position
+     */
+    void setSpeed(double speed);
+
+    /**
+     * @brief Continue playback from the first record at or after @p positionUs
+     * (relative to the first record)
+     *
+     * The latest state messages before that point are replayed first, so the
+     * models show the vehicle as it was at @p positionUs straight away.
+     */
+    void seek(qint64 positionUs);
+
+signals:
+    /**
+     * @brief Emitted when the end of the log is reached (not emitted when looping)
+     */
+    void playbackFinished();
+
+private slots:
+    void onPlaybackTimer();
+
+private:
+    /**
+     * @brief Read the record at @p offset, counting skipped bytes
+     */
+    bool readRecord(qsizetype& offset, TlogIndex::Record& record);
+
+    void loadIndex();
+    void primeState(QVector<qint64> offsets);
+    void startPlayback();
+    void closeFile();
+    void setStatus(LinkStatus status);
+
+    static constexpr int TICK_MS = 5;                       // pacing granularity
+    static constexpr qsizetype MAX_BATCH_BYTES = 256 * 1024;  // per tick when unpaced
+
+    Configuration m_config;
+    LinkStatus m_status;
+    bool m_errorReported;  // one errorOccurred() per outage, not per retry
+
+    QFile* m_file;
+    const uchar* m_data;  // mapped file
+    qsizetype m_size;
+    qsizetype m_offset;  // next record to replay
+    TlogIndex m_index;
+    quint64 m_firstTimestampUs;
+    QTimer* m_playbackTimer;
+    ByteRing* m_ring;  // receive ring, if any; checked for room before pushing
+
+    // Pacing: log time m_anchorTimestampUs corresponds to m_anchorClock's start
+    quint64 m_anchorTimestampUs;
+    QElapsedTimer m_anchorClock;
+
+    // Written on the link thread, read by playbackStatistics()
+    std::atomic<qint64> m_durationUs;
+    std::atomic<qint64> m_positionUs;
+    std::atomic<quint64> m_packetsReplayed;
+    std::atomic<quint64> m_bytesReplayed;
+    std::atomic<quint64> m_bytesSkipped;
+    std::atomic<double> m_speed;
+    std::atomic<bool> m_paused;
+    std::atomic<bool> m_finished;
+};
+
+#endif  // REPLAYLINK_H
@@ -0,0 +1,102 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Single-writer sequence lock publishing a trivially copyable value
+ *
+ * The writer bumps the sequence to odd, copies the value in and bumps it
+ * back to even; it never waits for readers. Readers copy the value out and
+ * retry if the sequence was odd or changed meanwhile, so they always get a
+ * torn-free snapshot without taking a lock or allocating.
+ *
+ * The value is held in relaxed atomic words rather than as a plain T, so a
+ * read racing with a write is a retry, not a data race.
+ *
+ * store() must only be called from one thread at a time; load() is safe
+ * from any number of threads.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied bytewise");
+
+public:
+    explicit SeqLock(const T& initial = T{}) {
+        std::array<quint64, WORDS> words{};
+        std::memcpy(words.data(), &initial, sizeof(T));
+        for (int i = 0; i < WORDS; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value (single writer, wait-free)
+     */
+    void store(const T& value) {
+        std::array<quint64, WORDS> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const quint64 sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < WORDS; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy of the latest value, retrying while a store is in progress
+     */
+    T load() const {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * @brief Single read attempt
+     * @return false if it overlapped a store; @p value is then unspecified
+     */
+    bool tryLoad(T& value) const {
+        const quint64 before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+
+        std::array<quint64, WORDS> words;
+        for (int i = 0; i < WORDS; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+
+        std::memcpy(&value, words.data(), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Number of completed stores
+     */
+    quint64 version() const { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr int WORDS = static_cast<int>((sizeof(T) + sizeof(quint64) - 1) /
+                                                  sizeof(quint64));
+
+    std::atomic<quint64> m_sequence{0};
+    std::array<std::atomic<quint64>, WORDS> m_words{};
+};
+
+#endif  // SEQLOCK_H
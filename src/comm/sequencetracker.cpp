@@ -0,0 +1,140 @@
+#include "sequencetracker.h"
+#include <algorithm>
+
+namespace {
+float lossPercent(qint64 lost, qint64 received) {
+    lost = qMax<qint64>(lost, 0);
+    const qint64 expected = received + lost;
+    return expected > 0 ? static_cast<float>(lost) * 100.0f / static_cast<float>(expected) : 0.0f;
+}
+}  // namespace
+
+SequenceTracker::SequenceTracker() : m_sourceCount(0), m_untrackedPackets(0) {}
+
+void SequenceTracker::reset() {
+    m_sources.fill(Source());
+    m_sourceCount = 0;
+    m_untrackedPackets = 0;
+}
+
+SequenceTracker::Source* SequenceTracker::findOrInsert(uint16_t key) {
+    // Fibonacci hash of the 16-bit key, then linear probing
+    const quint32 start = (static_cast<quint32>(key) * 40503u) >> 10;
+    for (int probe = 0; probe < MAX_SOURCES; ++probe) {
+        Source& source = m_sources[(start + probe) % MAX_SOURCES];
+        if (source.used) {
+            if (source.key == key) {
+                return &source;
+            }
+            continue;
+        }
+        if (m_sourceCount >= MAX_SOURCES) {
+            return nullptr;
+        }
+        source.used = true;
+        source.key = key;
+        m_sourceCount++;
+        return &source;
+    }
+    return nullptr;
+}
+
+bool SequenceTracker::update(uint8_t systemId, uint8_t componentId, uint8_t seq) {
+    Source* source = findOrInsert(static_cast<uint16_t>((systemId << 8) | componentId));
+    if (!source) {
+        m_untrackedPackets++;
+        return true;
+    }
+
+    if (source->received == 0) {
+        // Nothing before the first packet is missing
+        source->lastSeq = seq;
+        source->seen.set();
+        source->received = 1;
+        source->windowReceived++;
+        return true;
+    }
+
+    const uint8_t delta = static_cast<uint8_t>(seq - source->lastSeq);
+    if (delta == 0) {
+        source->duplicates++;
+        return false;
+    }
+
+    if (delta >= 256 - REORDER_WINDOW) {
+        // Slightly behind the newest packet: a duplicate, or a gap filled late
+        if (source->seen.test(seq)) {
+            source->duplicates++;
+            return false;
+        }
+        source->seen.set(seq);
+        if (source->lost > 0) {
+            source->lost--;
+        }
+        source->windowLost--;
+        source->reordered++;
+    } else {
+        // Forward, however far: everything skipped is missing until it shows
+        // up late. Clearing the skipped bits also retires the previous lap's.
+        for (uint8_t k = 1; k < delta; ++k) {
+            source->seen.reset(static_cast<uint8_t>(source->lastSeq + k));
+        }
+        source->seen.set(seq);
+        source->lost += delta - 1;
+        source->windowLost += delta - 1;
+        source->lastSeq = seq;
+    }
+
+    source->received++;
+    source->windowReceived++;
+    return true;
+}
+
+float SequenceTracker::closeWindow() {
+    qint64 received = 0;
+    qint64 lost = 0;
+
+    for (Source& source : m_sources) {
+        if (!source.used) {
+            continue;
+        }
+        // Keep the previous rate for sources that were silent this window
+        if (source.windowReceived > 0) {
+            source.windowLoss = lossPercent(source.windowLost, source.windowReceived);
+        }
+        received += source.windowReceived;
+        lost += qMax<qint64>(source.windowLost, 0);
+        source.windowReceived = 0;
+        source.windowLost = 0;
+    }
+
+    return lossPercent(lost, received);
+}
+
+QVector<SequenceTracker::SourceStatistics> SequenceTracker::statistics() const {
+    QVector<SourceStatistics> result;
+    result.reserve(m_sourceCount);
+
+    for (const Source& source : m_sources) {
+        if (!source.used) {
+            continue;
+        }
+        SourceStatistics stats;
+        stats.systemId = static_cast<uint8_t>(source.key >> 8);
+        stats.componentId = static_cast<uint8_t>(source.key & 0xff);
+        stats.received = source.received;
+        stats.lost = source.lost;
+        stats.duplicates = source.duplicates;
+        stats.reordered = source.reordered;
+        stats.windowLoss = source.windowLoss;
+        stats.totalLoss = lossPercent(static_cast<qint64>(source.lost),
+                                      static_cast<qint64>(source.received));
+        result.append(stats);
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const SourceStatistics& a, const SourceStatistics& b) {
+                  return (a.systemId << 8 | a.componentId) < (b.systemId << 8 | b.componentId);
+              });
+    return result;
+}
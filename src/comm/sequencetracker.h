@@ -0,0 +1,92 @@
+#ifndef SEQUENCETRACKER_H
+#define SEQUENCETRACKER_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <array>
+#include <bitset>
+
+/**
+ * @brief Per-source MAVLink sequence tracking (loss, duplicates, reordering)
+ *
+ * Every (sysid, compid) pair numbers its packets with its own 8-bit
+ * sequence, so loss is only meaningful per source. Sources live in a small
+ * fixed-size open-addressed table.
+ *
+ * As with MAVLink's own packet_rx_drop_count, any packet that is not the
+ * newest one again counts as a step forward, and the sequence numbers it
+ * skips as lost; this covers long outages and a restarted sender. The one
+ * exception is a packet at most REORDER_WINDOW behind the newest: it is a
+ * duplicate if that sequence number was already seen, otherwise a late
+ * packet that fills a gap, which is reclassified from lost to reordered.
+ *
+ * Counters accumulate per window; closeWindow() turns them into windowed
+ * loss rates. Not thread-safe: owned by the parser thread.
+ */
+class SequenceTracker {
+public:
+    static constexpr int MAX_SOURCES = 64;
+    static constexpr int REORDER_WINDOW = 16;  // sequence numbers behind the newest
+
+    struct SourceStatistics {
+        uint8_t systemId{0};
+        uint8_t componentId{0};
+        quint64 received{0};  // unique packets
+        quint64 lost{0};      // gaps not (yet) filled by late packets
+        quint64 duplicates{0};
+        quint64 reordered{0};    // late packets that filled a gap
+        float windowLoss{0.0f};  // % over the last closed window
+        float totalLoss{0.0f};   // % since the first packet
+    };
+
+    SequenceTracker();
+
+    /**
+     * @brief Account for one parsed packet
+     * @return false if the packet is a duplicate
+     */
+    bool update(uint8_t systemId, uint8_t componentId, uint8_t seq);
+
+    /**
+     * @brief Close the current window and compute windowed loss rates
+     * @return Loss over all sources in the window, in percent
+     */
+    float closeWindow();
+
+    /**
+     * @brief Per-source counters as of now, window loss as of the last closeWindow()
+     */
+    QVector<SourceStatistics> statistics() const;
+
+    int sourceCount() const { return m_sourceCount; }
+
+    /**
+     * @brief Packets from sources that did not fit in the table
+     */
+    quint64 untrackedPackets() const { return m_untrackedPackets; }
+
+    void reset();
+
+private:
+    struct Source {
+        bool used{false};
+        uint16_t key{0};
+        uint8_t lastSeq{0};
+        std::bitset<256> seen;  // by sequence number, valid within REORDER_WINDOW of lastSeq
+        quint64 received{0};
+        quint64 lost{0};
+        quint64 duplicates{0};
+        quint64 reordered{0};
+        qint64 windowReceived{0};
+        qint64 windowLost{0};  // may go negative when a late packet fills an older gap
+        float windowLoss{0.0f};
+    };
+
+    Source* findOrInsert(uint16_t key);
+
+    std::array<Source, MAX_SOURCES> m_sources;
+    int m_sourceCount;
+    quint64 m_untrackedPackets;
+};
+
+#endif  // SEQUENCETRACKER_H
@@ -0,0 +1,192 @@
+#include "seriallink.h"
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+
+SerialLink::SerialLink(const Configuration& config, QObject* parent)
+    : LinkInterface(parent), m_config(config), m_port(nullptr), m_coalesceTimer(nullptr),
+      m_status(LinkStatus::Disconnected), m_errorReported(false) {
+    m_readBuffer.resize(qMax(m_config.readChunkSize, 1));
+    setOutboundLimit(
+        static_cast<quint64>(outboundLimitFor(m_config.baudRate, m_config.outboundQueueMs)));
+}
+
+SerialLink::~SerialLink() {
+    disconnectLink();
+}
+
+QString SerialLink::name() const {
+    return m_config.name;
+}
+
+SerialLink::LinkStatus SerialLink::status() const {
+    return m_status;
+}
+
+bool SerialLink::isConnected() const {
+    return m_status == LinkStatus::Connected;
+}
+
+qint64 SerialLink::outboundLimitFor(qint32 baudRate, int queueMs) {
+    const qint64 bytesPerSecond = qMax<qint32>(baudRate, 0) / 10;
+    return qMax(bytesPerSecond * qMax(queueMs, 0) / 1000, MIN_OUTBOUND_QUEUE_BYTES);
+}
+
+void SerialLink::connectLink() {
+    qDebug() << "SerialLink::connectLink() called on thread:" << QThread::currentThread();
+
+    if (m_status == LinkStatus::Connected || m_status == LinkStatus::Connecting) {
+        qWarning() << "SerialLink::connectLink() - Already connected or connecting";
+        return;
+    }
+
+    // Drop whatever is left of a failed attempt before retrying
+    closePort();
+    setStatus(LinkStatus::Connecting);
+
+    // Create port and timer on the current thread (should be worker thread)
+    m_port = new QSerialPort(this);
+    m_port->setPortName(m_config.portName);
+    m_port->setBaudRate(m_config.baudRate);
+    m_port->setDataBits(m_config.dataBits);
+    m_port->setParity(m_config.parity);
+    m_port->setStopBits(m_config.stopBits);
+    m_port->setFlowControl(m_config.flowControl);
+
+    if (!m_port->open(QIODevice::ReadWrite)) {
+        QString error = QString("Failed to open serial port %1: %2")
+                            .arg(m_config.portName, m_port->errorString());
+        closePort();
+        setStatus(LinkStatus::Error);
+        if (!m_errorReported) {
+            m_errorReported = true;
+            emit errorOccurred(error);
+        }
+        qWarning() << error;
+        return;
+    }
+
+    connect(m_port, &QSerialPort::readyRead, this, &SerialLink::onReadyRead);
+    connect(m_port, &QSerialPort::bytesWritten, this, &SerialLink::onPortBytesWritten);
+    connect(m_port, &QSerialPort::errorOccurred, this, &SerialLink::onErrorOccurred);
+
+    if (m_config.readCoalesceMs > 0) {
+        m_coalesceTimer = new QTimer(this);
+        m_coalesceTimer->setSingleShot(true);
+        m_coalesceTimer->setTimerType(Qt::PreciseTimer);
+        m_coalesceTimer->setInterval(m_config.readCoalesceMs);
+        connect(m_coalesceTimer, &QTimer::timeout, this, &SerialLink::drainPort);
+    }
+
+    m_errorReported = false;
+    updateOutboundQueue(0);
+    setStatus(LinkStatus::Connected);
+    qDebug() << "Serial Link connected:" << m_config.name << "on" << m_config.portName << "at"
+             << m_config.baudRate << "baud";
+}
+
+void SerialLink::disconnectLink() {
+    closePort();
+    setStatus(LinkStatus::Disconnected);
+    qDebug() << "Serial Link disconnected:" << m_config.name;
+}
+
+void SerialLink::writeBytes(const QByteArray& data) {
+    if (!isConnected() || !m_port) {
+        qWarning() << "SerialLink::writeBytes() - Not connected";
+        return;
+    }
+
+    // write() only appends to QSerialPort's buffer; keep that buffer within
+    // what the radio can drain in outboundQueueMs
+    if (!admitOutbound(m_port->bytesToWrite(), data.size())) {
+        return;
+    }
+
+    if (m_port->write(data) == -1) {
+        QString error = QString("Failed to write serial data: %1").arg(m_port->errorString());
+        emit errorOccurred(error);
+        qWarning() << error;
+        return;
+    }
+    updateOutboundQueue(m_port->bytesToWrite());
+}
+
+void SerialLink::onReadyRead() {
+    // Wait for a full chunk or the coalescing deadline, whichever comes first
+    if (m_coalesceTimer && m_port->bytesAvailable() < m_readBuffer.size()) {
+        if (!m_coalesceTimer->isActive()) {
+            m_coalesceTimer->start();
+        }
+        return;
+    }
+    drainPort();
+}
+
+void SerialLink::drainPort() {
+    if (m_coalesceTimer) {
+        m_coalesceTimer->stop();
+    }
+    if (!m_port) {
+        return;
+    }
+
+    bool received = false;
+    qint64 bytesRead = 0;
+    while ((bytesRead = m_port->read(m_readBuffer.data(), m_readBuffer.size())) > 0) {
+        pushReceivedBytes(m_readBuffer.constData(), static_cast<qsizetype>(bytesRead));
+        received = true;
+    }
+
+    if (received) {
+        flushReceivedBytes();
+    }
+}
+
+void SerialLink::onPortBytesWritten(qint64 bytes) {
+    updateOutboundQueue(m_port->bytesToWrite());
+    emit bytesWritten(bytes);
+}
+
+void SerialLink::onErrorOccurred(QSerialPort::SerialPortError error) {
+    if (error == QSerialPort::NoError || error == QSerialPort::TimeoutError) {
+        return;
+    }
+
+    // Any other error (typically ResourceError: adapter unplugged) ends this session
+    QString message = QString("Serial port error on %1: %2")
+                          .arg(m_config.portName, m_port->errorString());
+    closePort();
+    setStatus(LinkStatus::Error);
+    if (!m_errorReported) {
+        m_errorReported = true;
+        emit errorOccurred(message);
+    }
+    qWarning() << message;
+}
+
+void SerialLink::closePort() {
+    if (m_coalesceTimer) {
+        m_coalesceTimer->stop();
+        m_coalesceTimer->deleteLater();
+        m_coalesceTimer = nullptr;
+    }
+
+    if (m_port) {
+        // No errorOccurred() callbacks for a port we close ourselves
+        m_port->disconnect(this);
+        if (m_port->isOpen()) {
+            m_port->close();
+        }
+        m_port->deleteLater();
+        m_port = nullptr;
+    }
+    updateOutboundQueue(0);
+}
+
+void SerialLink::setStatus(LinkStatus status) {
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged(m_status);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef SERIALLINK_H
+#define SERIALLINK_H
+
+#include "linkinterface.h"
+#include <QSerialPort>
+
+class QTimer;
+
+/**
+ * @brief Serial communication link implementation (USB, SiK/RFD900 radios)
+ *
+ * Designed to run on a separate QThread.
+ *
+ * Received bytes are read in chunks of up to Configuration::readChunkSize.
+ * With readCoalesceMs > 0 a readyRead() that finds less than a full chunk
+ * waits up to that long for more data, trading latency for fewer, larger
+ * reads and consumer wakeups; 0 hands data on as soon as it arrives.
+ *
+ * Writes go to QSerialPort's write buffer, which never blocks the link
+ * thread. The buffer is bounded to outboundQueueMs worth of data at the
+ * configured baud rate, so a slow radio drops excess writes (reported via
+ * outboundStatistics() and backPressureChanged()) instead of building up
+ * seconds of stale commands.
+ *
+ * Device errors such as an unplugged adapter are reported as
+ * LinkStatus::Error so LinkManager's reconnect backoff reopens the port.
+ */
+class SerialLink : public LinkInterface {
+    Q_OBJECT
+
+public:
+    struct Configuration {
+        QString name;
+        QString portName;  // e.g. "/dev/ttyUSB0", "COM3"
+        qint32 baudRate{57600};
+        QSerialPort::DataBits dataBits{QSerialPort::Data8};
+        QSerialPort::Parity parity{QSerialPort::NoParity};
+        QSerialPort::StopBits stopBits{QSerialPort::OneStop};
+        QSerialPort::FlowControl flowControl{QSerialPort::NoFlowControl};  // RTS/CTS: Hardware
+        int readChunkSize{16 * 1024};  // bytes per read() call
+        int readCoalesceMs{0};         // 0 = lowest latency
+        int outboundQueueMs{500};      // outbound bound, in time at baudRate
+    };
+
+    explicit SerialLink(const Configuration& config, QObject* parent = nullptr);
+    ~SerialLink() override;
+
+    QString name() const override;
+    LinkStatus status() const override;
+    bool isConnected() const override;
+
+    /**
+     * @brief Outbound queue bound for a baud rate (8N1 framing, 10 bits per byte)
+     */
+    static qint64 outboundLimitFor(qint32 baudRate, int queueMs);
+
+public slots:
+    void connectLink() override;
+    void disconnectLink() override;
+    void writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onReadyRead();
+    void onPortBytesWritten(qint64 bytes);
+    void onErrorOccurred(QSerialPort::SerialPortError error);
+
+private:
+    void drainPort();
+    void closePort();
+    void setStatus(LinkStatus status);
+
+    static constexpr qint64 MIN_OUTBOUND_QUEUE_BYTES = 1024;  // a few full MAVLink packets
+
+    Configuration m_config;
+    QSerialPort* m_port;
+    QTimer* m_coalesceTimer;
+    LinkStatus m_status;
+    QByteArray m_readBuffer;   // preallocated, readChunkSize bytes
+    bool m_errorReported;      // one errorOccurred() per outage, not per retry
+};
+
+#endif  // SERIALLINK_H
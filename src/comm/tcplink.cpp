@@ -0,0 +1,241 @@
+#include "tcplink.h"
+#include <QDebug>
+#include <QTcpServer>
+#include <QThread>
+#include <QTimer>
+
+TcpLink::TcpLink(const Configuration& config, QObject* parent)
+    : LinkInterface(parent), m_config(config), m_server(nullptr), m_socket(nullptr),
+      m_connectTimer(new QTimer(this)), m_status(LinkStatus::Disconnected) {
+    m_readBuffer.resize(qMax(m_config.readChunkSize, 1));
+    m_connectTimer->setSingleShot(true);
+    connect(m_connectTimer, &QTimer::timeout, this, &TcpLink::onConnectTimeout);
+    setOutboundLimit(static_cast<quint64>(qMax<qint64>(m_config.maxQueuedBytes, 0)));
+}
+
+TcpLink::~TcpLink() {
+    disconnectLink();
+}
+
+QString TcpLink::name() const {
+    return m_config.name;
+}
+
+TcpLink::LinkStatus TcpLink::status() const {
+    return m_status;
+}
+
+bool TcpLink::isConnected() const {
+    return m_status == LinkStatus::Connected;
+}
+
+void TcpLink::connectLink() {
+    qDebug() << "TcpLink::connectLink() called on thread:" << QThread::currentThread();
+
+    if (m_status == LinkStatus::Connected || m_status == LinkStatus::Connecting) {
+        qWarning() << "TcpLink::connectLink() - Already connected or connecting";
+        return;
+    }
+
+    // Drop whatever is left of a failed attempt before retrying
+    closeSocket();
+    if (m_server) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = nullptr;
+    }
+
+    setStatus(LinkStatus::Connecting);
+
+    if (m_config.isServer) {
+        m_server = new QTcpServer(this);
+        connect(m_server, &QTcpServer::newConnection, this, &TcpLink::onNewConnection);
+        if (!m_server->listen(m_config.address, m_config.port)) {
+            QString error = QString("Failed to listen on TCP %1:%2: %3")
+                                .arg(m_config.address.toString())
+                                .arg(m_config.port)
+                                .arg(m_server->errorString());
+            setStatus(LinkStatus::Error);
+            emit errorOccurred(error);
+            qCritical() << error;
+            return;
+        }
+        qDebug() << "TCP Link listening:" << m_config.name << "on"
+                 << m_config.address.toString() << ":" << m_config.port;
+        return;
+    }
+
+    // Create socket on the current thread (should be worker thread)
+    attachSocket(new QTcpSocket(this));
+    m_socket->connectToHost(m_config.address, m_config.port);
+    if (m_config.connectTimeoutMs > 0) {
+        m_connectTimer->start(m_config.connectTimeoutMs);
+    }
+}
+
+void TcpLink::disconnectLink() {
+    closeSocket();
+
+    if (m_server) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = nullptr;
+    }
+
+    setStatus(LinkStatus::Disconnected);
+    qDebug() << "TCP Link disconnected:" << m_config.name;
+}
+
+void TcpLink::writeBytes(const QByteArray& data) {
+    if (!isConnected() || !m_socket) {
+        qWarning() << "TcpLink::writeBytes() - Not connected";
+        return;
+    }
+
+    // QTcpSocket::write() only appends to the write buffer; the event loop
+    // drains it. Refuse to grow that buffer past the limit.
+    if (!admitOutbound(m_socket->bytesToWrite(), data.size())) {
+        return;
+    }
+
+    if (m_socket->write(data) == -1) {
+        QString error = QString("Failed to write TCP data: %1").arg(m_socket->errorString());
+        emit errorOccurred(error);
+        qWarning() << error;
+        return;
+    }
+    updateOutboundQueue(m_socket->bytesToWrite());
+}
+
+void TcpLink::onConnected() {
+    m_connectTimer->stop();
+    configureSocket();
+    updateOutboundQueue(0);
+    setStatus(LinkStatus::Connected);
+    qDebug() << "TCP Link connected:" << m_config.name << "to" << m_config.address.toString()
+             << ":" << m_config.port;
+}
+
+void TcpLink::onReadyRead() {
+    // Read in large chunks; frames split across chunks are reassembled by the parser
+    bool received = false;
+    qint64 bytesRead = 0;
+    while ((bytesRead = m_socket->read(m_readBuffer.data(), m_readBuffer.size())) > 0) {
+        pushReceivedBytes(m_readBuffer.constData(), static_cast<qsizetype>(bytesRead));
+        received = true;
+    }
+
+    if (received) {
+        flushReceivedBytes();
+    }
+}
+
+void TcpLink::onSocketBytesWritten(qint64 bytes) {
+    updateOutboundQueue(m_socket->bytesToWrite());
+    emit bytesWritten(bytes);
+}
+
+void TcpLink::onSocketDisconnected() {
+    handlePeerLost(QStringLiteral("TCP connection closed by peer"));
+}
+
+void TcpLink::onErrorOccurred(QAbstractSocket::SocketError socketError) {
+    Q_UNUSED(socketError)
+    handlePeerLost(QString("TCP socket error: %1").arg(m_socket->errorString()));
+}
+
+void TcpLink::onNewConnection() {
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket* peer = m_server->nextPendingConnection();
+
+        // MAVLink over TCP is point-to-point: the newest peer wins
+        if (m_socket) {
+            qInfo() << "TCP Link" << m_config.name << "replacing peer"
+                    << m_socket->peerAddress().toString() << "with"
+                    << peer->peerAddress().toString();
+            closeSocket();
+        }
+
+        attachSocket(peer);
+        configureSocket();
+        updateOutboundQueue(0);
+        setStatus(LinkStatus::Connected);
+        qInfo() << "TCP Link" << m_config.name << "accepted peer"
+                << peer->peerAddress().toString() << ":" << peer->peerPort();
+    }
+}
+
+void TcpLink::onConnectTimeout() {
+    // A blackholed host never answers; without this the attempt lasts until the OS gives up
+    if (m_status != LinkStatus::Connecting || !m_socket) {
+        return;
+    }
+    handlePeerLost(QString("TCP connection to %1:%2 timed out after %3 ms")
+                       .arg(m_config.address.toString())
+                       .arg(m_config.port)
+                       .arg(m_config.connectTimeoutMs));
+}
+
+void TcpLink::attachSocket(QTcpSocket* socket) {
+    m_socket = socket;
+    connect(m_socket, &QTcpSocket::connected, this, &TcpLink::onConnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &TcpLink::onReadyRead);
+    connect(m_socket, &QTcpSocket::bytesWritten, this, &TcpLink::onSocketBytesWritten);
+    connect(m_socket, &QTcpSocket::disconnected, this, &TcpLink::onSocketDisconnected);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, &TcpLink::onErrorOccurred);
+}
+
+void TcpLink::configureSocket() {
+    // Disable Nagle: MAVLink packets are small and latency-sensitive
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+
+    if (m_config.sendBufferSize > 0) {
+        m_socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption,
+                                  m_config.sendBufferSize);
+    }
+    if (m_config.receiveBufferSize > 0) {
+        m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,
+                                  m_config.receiveBufferSize);
+    }
+}
+
+void TcpLink::closeSocket() {
+    m_connectTimer->stop();
+    if (!m_socket) {
+        return;
+    }
+
+    // No disconnected()/errorOccurred() callbacks for a socket we close ourselves
+    m_socket->disconnect(this);
+    m_socket->abort();
+    m_socket->deleteLater();
+    m_socket = nullptr;
+    updateOutboundQueue(0);
+}
+
+void TcpLink::handlePeerLost(const QString& reason) {
+    const bool wasConnected = m_status == LinkStatus::Connected;
+    closeSocket();
+
+    if (m_config.isServer && m_server) {
+        // Keep listening for the peer to come back
+        qInfo() << "TCP Link" << m_config.name << "-" << reason << "- waiting for a new peer";
+        setStatus(LinkStatus::Connecting);
+        return;
+    }
+
+    // A refused attempt is left to LinkManager's backoff; only a lost connection is an error
+    setStatus(LinkStatus::Error);
+    if (wasConnected) {
+        emit errorOccurred(reason);
+    }
+    qWarning() << "TCP Link" << m_config.name << "-" << reason;
+}
+
+void TcpLink::setStatus(LinkStatus status) {
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged(m_status);
+    }
+}
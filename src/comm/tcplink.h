@@ -0,0 +1,87 @@
+#ifndef TCPLINK_H
+#define TCPLINK_H
+
+#include "linkinterface.h"
+#include <QTcpSocket>
+#include <QHostAddress>
+
+class QTcpServer;
+class QTimer;
+
+/**
+ * @brief TCP communication link implementation
+ *
+ * Client mode connects to a remote MAVLink endpoint (e.g. SITL on 5760);
+ * server mode listens and serves the most recent peer that connected.
+ * Designed to run on a separate QThread.
+ *
+ * TCP delivers a byte stream, so chunks are pushed exactly as they come off
+ * the socket and packets split across reads are reassembled by the link's
+ * own parser channel in MavlinkRouter. Nagle's algorithm is disabled so
+ * small command packets are not held back.
+ *
+ * Writes are queued in the socket's write buffer, which never blocks the
+ * link thread. The queue is bounded by Configuration::maxQueuedBytes: when
+ * the peer stops reading, further writes are dropped and reported through
+ * outboundStatistics() and backPressureChanged() instead of growing memory.
+ *
+ * A lost connection is reported as LinkStatus::Error so LinkManager's
+ * reconnect backoff applies. So is a client attempt that has not connected
+ * within Configuration::connectTimeoutMs, rather than waiting for the OS to
+ * give up on an unanswered SYN. In server mode a lost peer only returns the
+ * link to Connecting while it keeps listening; LinkManager makes no
+ * reconnect attempts while a link is Connecting.
+ */
+class TcpLink : public LinkInterface {
+    Q_OBJECT
+
+public:
+    struct Configuration {
+        QString name;
+        bool isServer{false};  // true = listen for a peer, false = connect out
+        QHostAddress address{QHostAddress::LocalHost};  // remote (client) or local (server)
+        quint16 port{5760};
+        int sendBufferSize{0};     // SO_SNDBUF in bytes, 0 = OS default
+        int receiveBufferSize{0};  // SO_RCVBUF in bytes, 0 = OS default
+        qint64 maxQueuedBytes{256 * 1024};
+        int readChunkSize{64 * 1024};  // bytes per read() call
+        int connectTimeoutMs{5000};    // client attempt abandoned after this, 0 = OS timeout
+    };
+
+    explicit TcpLink(const Configuration& config, QObject* parent = nullptr);
+    ~TcpLink() override;
+
+    QString name() const override;
+    LinkStatus status() const override;
+    bool isConnected() const override;
+
+public slots:
+    void connectLink() override;
+    void disconnectLink() override;
+    void writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onSocketBytesWritten(qint64 bytes);
+    void onSocketDisconnected();
+    void onErrorOccurred(QAbstractSocket::SocketError socketError);
+    void onNewConnection();
+    void onConnectTimeout();
+
+private:
+    void attachSocket(QTcpSocket* socket);
+    void configureSocket();
+    void closeSocket();
+    void handlePeerLost(const QString& reason);
+    void setStatus(LinkStatus status);
+
+    Configuration m_config;
+    QTcpServer* m_server;
+    QTcpSocket* m_socket;
+    QTimer* m_connectTimer;
+    LinkStatus m_status;
+    QByteArray m_readBuffer;  // preallocated, readChunkSize bytes
+};
+
+#endif  // TCPLINK_H
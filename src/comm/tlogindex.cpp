@@ -0,0 +1,206 @@
+#include "tlogindex.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include "mavlink/ardupilotmega/mavlink.h"
+#include "mavlinkframing.h"
+
+bool TlogIndex::build(const uchar* data, qsizetype size) {
+    clear();
+
+    // Latest state message of every stream, snapshotted at each keyframe
+    QHash<quint64, qint64> latestState;
+    quint64 nextKeyframeUs = 0;
+    quint64 skipped = 0;
+    qsizetype offset = 0;
+    Record record;
+    while (readRecord(data, size, offset, record, skipped)) {
+        if (m_recordCount == 0) {
+            m_firstTimestampUs = record.timestampUs;
+            nextKeyframeUs = record.timestampUs;
+        }
+        m_lastTimestampUs = qMax(m_lastTimestampUs, record.timestampUs);
+
+        if (record.timestampUs >= nextKeyframeUs) {
+            Keyframe keyframe;
+            keyframe.timestampUs = record.timestampUs;
+            keyframe.offset = record.offset;
+            keyframe.snapshotBegin = static_cast<qint32>(m_snapshots.size());
+            keyframe.snapshotCount = static_cast<qint32>(latestState.size());
+            const qsizetype begin = m_snapshots.size();
+            for (auto it = latestState.cbegin(); it != latestState.cend(); ++it) {
+                m_snapshots.append(it.value());
+            }
+            std::sort(m_snapshots.begin() + begin, m_snapshots.end());
+            m_keyframes.append(keyframe);
+
+            // Keyframes stay on the interval grid even across gaps in the log
+            const quint64 intervals =
+                (record.timestampUs - m_firstTimestampUs) / KEYFRAME_INTERVAL_US + 1;
+            nextKeyframeUs = m_firstTimestampUs + intervals * KEYFRAME_INTERVAL_US;
+        }
+
+        if (isStateMessage(record.msgId)) {
+            latestState.insert(streamKey(record), record.offset);
+        }
+        m_positions[record.msgId].append(record.offset);
+        m_recordCount++;
+        offset = record.nextOffset;
+    }
+
+    if (skipped > 0) {
+        qDebug() << "TlogIndex: Skipped" << skipped << "bytes that are not .tlog records";
+    }
+    return !isEmpty();
+}
+
+bool TlogIndex::load(const QString& indexPath, qint64 logSize, qint64 logModifiedMs) {
+    clear();
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 size = 0;
+    qint64 modifiedMs = 0;
+    in >> magic >> version >> size >> modifiedMs;
+    if (magic != FILE_MAGIC || version != FILE_VERSION || size != logSize ||
+        modifiedMs != logModifiedMs) {
+        return false;
+    }
+
+    quint32 keyframeCount = 0;
+    in >> m_recordCount >> m_firstTimestampUs >> m_lastTimestampUs >> keyframeCount;
+    m_keyframes.resize(keyframeCount);
+    for (Keyframe& keyframe : m_keyframes) {
+        in >> keyframe.timestampUs >> keyframe.offset >> keyframe.snapshotBegin >>
+            keyframe.snapshotCount;
+    }
+    in >> m_snapshots >> m_positions;
+
+    // A truncated or inconsistent sidecar is rebuilt rather than trusted
+    const bool consistent =
+        std::all_of(m_keyframes.cbegin(), m_keyframes.cend(), [this, logSize](const Keyframe& k) {
+            return k.offset >= 0 && k.offset < logSize && k.snapshotBegin >= 0 &&
+                   k.snapshotCount >= 0 && k.snapshotBegin + k.snapshotCount <= m_snapshots.size();
+        });
+    if (in.status() != QDataStream::Ok || !consistent || m_keyframes.isEmpty()) {
+        qWarning() << "TlogIndex: Ignoring corrupt index" << indexPath;
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool TlogIndex::save(const QString& indexPath, qint64 logSize, qint64 logModifiedMs) const {
+    // Written atomically, so a crash never leaves a half-written index behind
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << FILE_MAGIC << FILE_VERSION << logSize << logModifiedMs;
+    out << m_recordCount << m_firstTimestampUs << m_lastTimestampUs
+        << static_cast<quint32>(m_keyframes.size());
+    for (const Keyframe& keyframe : m_keyframes) {
+        out << keyframe.timestampUs << keyframe.offset << keyframe.snapshotBegin
+            << keyframe.snapshotCount;
+    }
+    out << m_snapshots << m_positions;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+void TlogIndex::clear() {
+    m_recordCount = 0;
+    m_firstTimestampUs = 0;
+    m_lastTimestampUs = 0;
+    m_keyframes.clear();
+    m_snapshots.clear();
+    m_positions.clear();
+}
+
+const TlogIndex::Keyframe* TlogIndex::keyframeAt(quint64 timestampUs) const {
+    if (m_keyframes.isEmpty()) {
+        return nullptr;
+    }
+
+    auto it = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), timestampUs,
+                               [](quint64 timestamp, const Keyframe& keyframe) {
+                                   return timestamp < keyframe.timestampUs;
+                               });
+    return it == m_keyframes.cbegin() ? &m_keyframes.first() : &*(it - 1);
+}
+
+QVector<qint64> TlogIndex::snapshot(const Keyframe& keyframe) const {
+    return m_snapshots.mid(keyframe.snapshotBegin, keyframe.snapshotCount);
+}
+
+bool TlogIndex::isStateMessage(uint32_t msgId) {
+    switch (msgId) {
+        case MAVLINK_MSG_ID_HEARTBEAT:
+        case MAVLINK_MSG_ID_SYS_STATUS:
+        case MAVLINK_MSG_ID_GPS_RAW_INT:
+        case MAVLINK_MSG_ID_ATTITUDE:
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+        case MAVLINK_MSG_ID_VFR_HUD:
+        case MAVLINK_MSG_ID_BATTERY_STATUS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool TlogIndex::readRecord(const uchar* data, qsizetype size, qsizetype& offset, Record& record,
+                           quint64& skipped) {
+    const quint64 skippedBefore = skipped;
+    while (offset + TIMESTAMP_BYTES < size) {
+        const qsizetype packetOffset = offset + TIMESTAMP_BYTES;
+        const qsizetype length =
+            MavlinkFraming::packetLength(data + packetOffset, size - packetOffset);
+        if (length > 0 && skipped > skippedBefore &&
+            !plausibleRecordAt(data, size, packetOffset + length)) {
+            // A start marker inside the garbage; keep resynchronizing
+            offset++;
+            skipped++;
+            continue;
+        }
+        if (length > 0) {
+            record.offset = offset;
+            record.timestampUs = qFromBigEndian<quint64>(data + offset);
+            record.packetOffset = packetOffset;
+            record.packetBytes = length;
+            record.nextOffset = packetOffset + length;
+            MavlinkFraming::readHeader(data + packetOffset, record.systemId, record.componentId,
+                                       record.msgId);
+            return true;
+        }
+        if (length == 0) {
+            // Truncated final record
+            skipped += static_cast<quint64>(size - offset);
+            offset = size;
+            break;
+        }
+        offset++;
+        skipped++;
+    }
+    return false;
+}
+
+bool TlogIndex::plausibleRecordAt(const uchar* data, qsizetype size, qsizetype offset) {
+    // After a resync the candidate must end at the end of the log or at another record
+    if (offset + TIMESTAMP_BYTES >= size) {
+        return true;
+    }
+    return MavlinkFraming::isStartMarker(data[offset + TIMESTAMP_BYTES]);
+}
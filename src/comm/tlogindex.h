@@ -0,0 +1,140 @@
+#ifndef TLOGINDEX_H
+#define TLOGINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Seek index for a telemetry log (.tlog), stored in a sidecar file
+ *
+ * Built in one pass over the log. It holds:
+ * - a sparse keyframe table: the first record at or after every
+ *   KEYFRAME_INTERVAL_US of log time, found by binary search;
+ * - for every keyframe, a snapshot of the state messages that precede it:
+ *   the latest HEARTBEAT, SYS_STATUS, ATTITUDE, position, VFR_HUD, GPS and
+ *   battery packet of every source. Replaying the snapshot rebuilds the
+ *   vehicle and health models without reading the log from the start;
+ * - the position of every record of every msgid.
+ *
+ * All positions are byte offsets of records (their timestamp) in the log.
+ * The sidecar is `<log>.idx`; it remembers the size and modification time
+ * of the log it was built from and is rejected if either changed.
+ *
+ * Also provides the record framing shared with ReplayLink, so both agree
+ * on what counts as a record and what is skipped as garbage.
+ */
+class TlogIndex {
+public:
+    static constexpr qsizetype TIMESTAMP_BYTES = 8;           // big-endian UNIX microseconds
+    static constexpr quint64 KEYFRAME_INTERVAL_US = 1000000;  // log time between keyframes
+
+    /**
+     * @brief One log record: timestamp plus a framed MAVLink packet
+     */
+    struct Record {
+        qsizetype offset{0};  // start of the timestamp
+        quint64 timestampUs{0};
+        qsizetype packetOffset{0};
+        qsizetype packetBytes{0};
+        qsizetype nextOffset{0};
+        uint8_t systemId{0};
+        uint8_t componentId{0};
+        uint32_t msgId{0};
+    };
+
+    struct Keyframe {
+        quint64 timestampUs{0};
+        qint64 offset{0};         // record the keyframe points at
+        qint32 snapshotBegin{0};  // into the shared snapshot table
+        qint32 snapshotCount{0};
+    };
+
+    TlogIndex() = default;
+
+    /**
+     * @brief Index a mapped log in one pass, replacing the current contents
+     * @return false if the log holds no records
+     */
+    bool build(const uchar* data, qsizetype size);
+
+    /**
+     * @brief Load a sidecar, if it was built from a log of this size and mtime
+     */
+    bool load(const QString& indexPath, qint64 logSize, qint64 logModifiedMs);
+
+    /**
+     * @brief Write the sidecar; the index must have been built or loaded
+     */
+    bool save(const QString& indexPath, qint64 logSize, qint64 logModifiedMs) const;
+
+    static QString sidecarPath(const QString& logPath) { return logPath + ".idx"; }
+
+    void clear();
+
+    bool isEmpty() const { return m_recordCount == 0; }
+    quint64 recordCount() const { return m_recordCount; }
+    quint64 firstTimestampUs() const { return m_firstTimestampUs; }
+    qint64 durationUs() const {
+        return static_cast<qint64>(m_lastTimestampUs - m_firstTimestampUs);
+    }
+
+    const QVector<Keyframe>& keyframes() const { return m_keyframes; }
+
+    /**
+     * @brief Last keyframe at or before @p timestampUs (the first one if none is)
+     * @return nullptr if the index is empty
+     */
+    const Keyframe* keyframeAt(quint64 timestampUs) const;
+
+    /**
+     * @brief Record offsets of a keyframe's snapshot, in log order
+     */
+    QVector<qint64> snapshot(const Keyframe& keyframe) const;
+
+    /**
+     * @brief Record offsets of every message with @p msgId, in log order
+     */
+    QVector<qint64> positions(uint32_t msgId) const { return m_positions.value(msgId); }
+    QList<uint32_t> messageIds() const { return m_positions.keys(); }
+
+    /**
+     * @brief Messages whose latest value is part of the vehicle/health state
+     */
+    static bool isStateMessage(uint32_t msgId);
+
+    /**
+     * @brief Identifies a message stream: (system, component, msgid)
+     */
+    static quint64 streamKey(const Record& record) {
+        return (quint64(record.systemId) << 40) | (quint64(record.componentId) << 32) |
+               record.msgId;
+    }
+
+    /**
+     * @brief Read the record at @p offset, skipping bytes that are not one
+     *
+     * Advances @p offset past skipped bytes and adds them to @p skipped;
+     * returns false at the end of the log. After skipping, a candidate is
+     * only accepted if another record (or the end of the log) follows it.
+     * A truncated final record is skipped.
+     */
+    static bool readRecord(const uchar* data, qsizetype size, qsizetype& offset, Record& record,
+                           quint64& skipped);
+
+private:
+    static bool plausibleRecordAt(const uchar* data, qsizetype size, qsizetype offset);
+
+    static constexpr quint32 FILE_MAGIC = 0x46535449;  // "FSTI"
+    static constexpr quint32 FILE_VERSION = 1;
+
+    quint64 m_recordCount{0};
+    quint64 m_firstTimestampUs{0};
+    quint64 m_lastTimestampUs{0};
+    QVector<Keyframe> m_keyframes;
+    QVector<qint64> m_snapshots;  // concatenated keyframe snapshots
+    QHash<uint32_t, QVector<qint64>> m_positions;
+};
+
+#endif  // TLOGINDEX_H
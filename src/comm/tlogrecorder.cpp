@@ -0,0 +1,304 @@
+#include "tlogrecorder.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QtEndian>
+#include <chrono>
+#include <cstring>
+
+namespace {
+// Ring records carry the link tag and packet size ahead of the .tlog record
+constexpr qsizetype RING_HEADER_BYTES = 1 + sizeof(quint16);
+}  // namespace
+
+TlogRecorder::TlogRecorder(qsizetype bufferBytes, QObject* parent)
+    : QObject(parent), m_ring(std::make_unique<ByteRing>(bufferBytes)), m_recording(false),
+      m_packetsRecorded(0), m_packetsOutbound(0), m_packetsDropped(0), m_writerThread(nullptr),
+      m_writerContext(nullptr), m_file(nullptr), m_linksFile(nullptr), m_flushTimer(nullptr),
+      m_fileBytes(0),
+      m_reportedDrops(0), m_filesOpened(0), m_bytesWritten(0) {
+    // Disk I/O never runs on the caller's or the parser's thread
+    m_writerThread = new QThread(this);
+    m_writerThread->setObjectName("TlogWriter");
+    m_writerContext = new QObject();
+    m_writerContext->moveToThread(m_writerThread);
+    connect(m_writerThread, &QThread::finished, m_writerContext, &QObject::deleteLater);
+}
+
+TlogRecorder::~TlogRecorder() {
+    stop();
+    m_writerThread->quit();
+    m_writerThread->wait();
+}
+
+bool TlogRecorder::start(const Configuration& config) {
+    stop();
+    if (!m_writerThread->isRunning()) {
+        m_writerThread->start(QThread::LowPriority);
+    }
+
+    bool opened = false;
+    QMetaObject::invokeMethod(
+        m_writerContext,
+        [this, &config, &opened]() {
+            m_config = config;
+
+            // Records that raced with the previous stop() belong to no file
+            m_ring->acknowledgeWake();
+            m_ring->consume([](const char*, qsizetype) {});
+            m_reportedDrops = m_packetsDropped.load(std::memory_order_relaxed);
+            m_drainBuffer.reserve(m_ring->capacity());
+
+            opened = openFile();
+            if (!opened) {
+                return;
+            }
+            if (!m_flushTimer) {
+                m_flushTimer = new QTimer(m_writerContext);
+                connect(m_flushTimer, &QTimer::timeout, m_writerContext, [this]() { drain(); });
+            }
+            m_flushTimer->start(qMax(m_config.flushIntervalMs, 1));
+        },
+        Qt::BlockingQueuedConnection);
+
+    if (opened) {
+        m_recording.store(true, std::memory_order_release);
+    }
+    return opened;
+}
+
+void TlogRecorder::stop() {
+    if (!m_recording.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(
+        m_writerContext,
+        [this]() {
+            m_flushTimer->stop();
+            drain();
+            closeFile();
+        },
+        Qt::BlockingQueuedConnection);
+}
+
+bool TlogRecorder::record(int linkId, Direction direction, const char* packet, qsizetype size) {
+    return record(linkId, direction, packet, size, currentTimeUs());
+}
+
+bool TlogRecorder::record(int linkId, Direction direction, const char* packet, qsizetype size,
+                          quint64 timestampUs) {
+    if (!isRecording()) {
+        return false;
+    }
+
+    if (size <= 0 || size > MAX_PACKET_BYTES || linkId < 0 || linkId >= OUTBOUND_TAG) {
+        m_packetsDropped.store(m_packetsDropped.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+        return false;
+    }
+
+    // One all-or-nothing ring write per record keeps drains on record boundaries
+    const bool outbound = direction == Direction::Outbound;
+    const quint16 length = static_cast<quint16>(size);
+    char buffer[RING_HEADER_BYTES + TIMESTAMP_BYTES + MAX_PACKET_BYTES];
+    buffer[0] = static_cast<char>(linkId | (outbound ? OUTBOUND_TAG : 0));
+    memcpy(buffer + 1, &length, sizeof(length));
+    qToBigEndian<quint64>(timestampUs, buffer + RING_HEADER_BYTES);
+    memcpy(buffer + RING_HEADER_BYTES + TIMESTAMP_BYTES, packet, static_cast<size_t>(size));
+    if (!m_ring->write(buffer, RING_HEADER_BYTES + TIMESTAMP_BYTES + size)) {
+        m_packetsDropped.store(m_packetsDropped.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+        return false;
+    }
+    m_packetsRecorded.store(m_packetsRecorded.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+    if (outbound) {
+        m_packetsOutbound.store(m_packetsOutbound.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+    }
+
+    // Under heavy traffic wake the writer early instead of waiting for its timer
+    if (m_ring->readable() >= m_ring->capacity() / 4 && m_ring->requestWake()) {
+        QMetaObject::invokeMethod(m_writerContext, [this]() { drain(); }, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+TlogRecorder::Statistics TlogRecorder::statistics() const {
+    Statistics stats;
+    stats.recording = isRecording();
+    {
+        QMutexLocker locker(&m_fileNameMutex);
+        stats.fileName = m_fileName;
+    }
+    const ByteRing::Statistics ringStats = m_ring->statistics();
+    stats.filesOpened = m_filesOpened.load(std::memory_order_relaxed);
+    stats.packetsRecorded = m_packetsRecorded.load(std::memory_order_relaxed);
+    stats.packetsOutbound = m_packetsOutbound.load(std::memory_order_relaxed);
+    stats.packetsDropped = m_packetsDropped.load(std::memory_order_relaxed);
+    stats.bytesDropped = ringStats.bytesDropped;
+    stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    stats.bufferHighWater = ringStats.highWaterMark;
+    stats.bufferCapacity = m_ring->capacity();
+    return stats;
+}
+
+quint64 TlogRecorder::currentTimeUs() {
+    using namespace std::chrono;
+    return static_cast<quint64>(
+        duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+QString TlogRecorder::defaultDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) +
+           "/FlightScope/TelemetryLogs";
+}
+
+bool TlogRecorder::openFile() {
+    QDir directory(m_config.directory);
+    if (!directory.mkpath(".")) {
+        QString error = QString("Cannot create telemetry log directory %1").arg(m_config.directory);
+        emit errorOccurred(error);
+        qWarning() << error;
+        return false;
+    }
+
+    // Named after the local start time; rotations within the same second get a suffix
+    const QString baseName = QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss");
+    QString path = directory.filePath(baseName + ".tlog");
+    for (int suffix = 2; QFile::exists(path); ++suffix) {
+        path = directory.filePath(QString("%1_%2.tlog").arg(baseName).arg(suffix));
+    }
+
+    // Unbuffered: drain() already hands whole ring spans to write()
+    m_file = new QFile(path, m_writerContext);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::NewOnly | QIODevice::Unbuffered)) {
+        QString error =
+            QString("Failed to open telemetry log %1: %2").arg(path, m_file->errorString());
+        delete m_file;
+        m_file = nullptr;
+        emit errorOccurred(error);
+        qWarning() << error;
+        return false;
+    }
+
+    m_linksFile = new QFile(linksPath(path), m_writerContext);
+    if (!m_linksFile->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        QString error = QString("Failed to open telemetry log links %1: %2")
+                            .arg(m_linksFile->fileName(), m_linksFile->errorString());
+        delete m_linksFile;
+        m_linksFile = nullptr;
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+        emit errorOccurred(error);
+        qWarning() << error;
+        return false;
+    }
+
+    m_fileBytes = 0;
+    m_fileAge.start();
+    m_filesOpened.fetch_add(1, std::memory_order_relaxed);
+    setFileName(path);
+    emit fileOpened(path);
+    qInfo() << "TlogRecorder: Recording to" << path;
+    return true;
+}
+
+void TlogRecorder::closeFile() {
+    if (!m_file) {
+        return;
+    }
+
+    m_file->close();
+    m_linksFile->close();
+    qInfo() << "TlogRecorder: Closed" << m_file->fileName() << "-" << m_fileBytes << "bytes";
+    delete m_file;
+    m_file = nullptr;
+    delete m_linksFile;
+    m_linksFile = nullptr;
+    setFileName(QString());
+}
+
+void TlogRecorder::drain() {
+    // A wakeup queued before stop() may arrive after the file was closed
+    if (!m_file) {
+        return;
+    }
+
+    // Clear the wake flag first so records written while draining trigger a new wakeup
+    m_ring->acknowledgeWake();
+    m_drainBuffer.resize(0);
+    m_ring->consume(
+        [this](const char* data, qsizetype size) { m_drainBuffer.append(data, size); });
+
+    // Move each record's tag to the sidecar and close the gap it leaves, in place
+    char* bytes = m_drainBuffer.data();
+    const qsizetype available = m_drainBuffer.size();
+    qsizetype in = 0;
+    qsizetype out = 0;
+    m_tagBuffer.resize(0);
+    while (in + RING_HEADER_BYTES + TIMESTAMP_BYTES <= available) {
+        quint16 length = 0;
+        memcpy(&length, bytes + in + 1, sizeof(length));
+        const qsizetype recordBytes = TIMESTAMP_BYTES + length;
+        m_tagBuffer.append(bytes[in]);
+        memmove(bytes + out, bytes + in + RING_HEADER_BYTES, static_cast<size_t>(recordBytes));
+        in += RING_HEADER_BYTES + recordBytes;
+        out += recordBytes;
+    }
+
+    QFile* failed = nullptr;
+    if (out > 0) {
+        if (m_file->write(bytes, out) != out) {
+            failed = m_file;
+        } else if (m_linksFile->write(m_tagBuffer) != m_tagBuffer.size()) {
+            failed = m_linksFile;
+        }
+    }
+    m_fileBytes += out;
+    m_bytesWritten.store(m_bytesWritten.load(std::memory_order_relaxed) + out,
+                         std::memory_order_relaxed);
+    reportDrops();
+
+    if (failed) {
+        QString error = QString("Failed to write telemetry log %1: %2")
+                            .arg(failed->fileName(), failed->errorString());
+        m_recording.store(false, std::memory_order_release);
+        m_flushTimer->stop();
+        closeFile();
+        emit errorOccurred(error);
+        qWarning() << error;
+        return;
+    }
+
+    const bool sizeReached = m_config.maxFileBytes > 0 && m_fileBytes >= m_config.maxFileBytes;
+    const bool ageReached = m_config.maxFileSeconds > 0 &&
+                            m_fileAge.elapsed() >= qint64(m_config.maxFileSeconds) * 1000;
+    if (sizeReached || ageReached) {
+        closeFile();
+        if (!openFile()) {
+            m_recording.store(false, std::memory_order_release);
+            m_flushTimer->stop();
+        }
+    }
+}
+
+void TlogRecorder::reportDrops() {
+    const quint64 dropped = m_packetsDropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDrops) {
+        qWarning() << "TlogRecorder: Writer fell behind -" << (dropped - m_reportedDrops)
+                   << "packets dropped (total" << dropped << ")";
+        m_reportedDrops = dropped;
+    }
+}
+
+void TlogRecorder::setFileName(const QString& fileName) {
+    QMutexLocker locker(&m_fileNameMutex);
+    m_fileName = fileName;
+}
@@ -0,0 +1,174 @@
+#ifndef TLOGRECORDER_H
+#define TLOGRECORDER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include "bytering.h"
+
+class QFile;
+class QThread;
+class QTimer;
+
+/**
+ * @brief Records MAVLink packets to telemetry log (.tlog) files
+ *
+ * A .tlog is the plain concatenation of records, each an 8-byte big-endian
+ * UNIX timestamp in microseconds followed by one complete MAVLink packet as
+ * it was framed on the wire. The format is read by Mission Planner,
+ * QGroundControl, MAVExplorer and pymavlink.
+ *
+ * Every record is tagged with the link it was received on or sent to and
+ * its direction. The .tlog format has no room for that, so the tags go to
+ * a sidecar, linksPath(), with one byte per record in the same order: the
+ * link ID in the low seven bits and OUTBOUND_TAG for sent packets.
+ *
+ * record() is called on the parser thread for every packet. It never
+ * touches the disk: the record is copied into a preallocated SPSC ByteRing
+ * and a dedicated writer thread drains the ring every flushIntervalMs, or
+ * sooner once the ring is a quarter full, and appends each drain to the
+ * log and the sidecar with one write apiece. If the writer falls behind
+ * and the ring fills, records are dropped and counted instead of blocking
+ * the receive path.
+ *
+ * Files are rotated when they reach maxFileBytes or have been open for
+ * maxFileSeconds. Rotation happens between ring drains, which always end on
+ * a record boundary, so a file may overshoot the size limit by up to one
+ * drain.
+ */
+class TlogRecorder : public QObject {
+    Q_OBJECT
+
+public:
+    struct Configuration {
+        QString directory;                         // created if missing
+        qint64 maxFileBytes{256 * 1024 * 1024};    // 0 = no size rotation
+        int maxFileSeconds{0};                     // 0 = no time rotation
+        int flushIntervalMs{200};                  // writer wakeup when traffic is light
+    };
+
+    /**
+     * @brief Recording counters (safe to read from any thread)
+     */
+    struct Statistics {
+        bool recording{false};
+        QString fileName;            // file currently written, empty when stopped
+        quint64 filesOpened{0};
+        quint64 packetsRecorded{0};  // accepted by record(), both directions
+        quint64 packetsOutbound{0};  // of those, sent rather than received
+        quint64 packetsDropped{0};   // rejected because the buffer was full
+        quint64 bytesDropped{0};
+        quint64 bytesWritten{0};     // appended to disk, timestamps included
+        quint64 bufferHighWater{0};  // max bytes waiting for the writer
+        qsizetype bufferCapacity{0};
+    };
+
+    static constexpr int TIMESTAMP_BYTES = 8;
+    static constexpr qsizetype MAX_PACKET_BYTES = 512;  // larger than any MAVLink v2 frame
+    static constexpr qsizetype DEFAULT_BUFFER_BYTES = 4 * 1024 * 1024;
+    static constexpr uchar OUTBOUND_TAG = 0x80;
+
+    enum class Direction { Inbound, Outbound };
+
+    /**
+     * @param bufferBytes Capacity of the ring between record() and the writer
+     */
+    explicit TlogRecorder(qsizetype bufferBytes = DEFAULT_BUFFER_BYTES, QObject* parent = nullptr);
+    ~TlogRecorder() override;
+
+    /**
+     * @brief Open the first log file and start accepting records
+     *
+     * Stops a running recording first. Blocks until the file is open.
+     * @return false if the directory or file could not be created
+     */
+    bool start(const Configuration& config);
+
+    /**
+     * @brief Stop accepting records, write out what is buffered and close the file
+     */
+    void stop();
+
+    bool isRecording() const { return m_recording.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queue one complete packet received on or sent to @p linkId, timestamped now
+     *
+     * Never blocks. Must only be called from one thread at a time (the
+     * ring's single producer).
+     * @return false if not recording or the record was dropped
+     */
+    bool record(int linkId, Direction direction, const char* packet, qsizetype size);
+
+    /**
+     * @brief Queue one complete packet with an explicit timestamp
+     */
+    bool record(int linkId, Direction direction, const char* packet, qsizetype size,
+                quint64 timestampUs);
+
+    Statistics statistics() const;
+
+    /**
+     * @brief Microseconds since the UNIX epoch, as stored in .tlog records
+     */
+    static quint64 currentTimeUs();
+
+    /**
+     * @brief Per-user default log directory (Documents/FlightScope/TelemetryLogs)
+     */
+    static QString defaultDirectory();
+
+    /**
+     * @brief Sidecar holding the link and direction of each record of @p logPath
+     */
+    static QString linksPath(const QString& logPath) { return logPath + ".links"; }
+
+signals:
+    /**
+     * @brief Emitted on the writer thread when a new log file is opened
+     */
+    void fileOpened(QString filePath);
+
+    /**
+     * @brief Emitted when recording stops because a file could not be written
+     */
+    void errorOccurred(QString errorString);
+
+private:
+    // Writer thread only
+    bool openFile();
+    void closeFile();
+    void drain();
+    void reportDrops();
+    void setFileName(const QString& fileName);
+
+    std::unique_ptr<ByteRing> m_ring;
+    std::atomic<bool> m_recording;
+    std::atomic<quint64> m_packetsRecorded;  // producer only
+    std::atomic<quint64> m_packetsOutbound;  // producer only
+    std::atomic<quint64> m_packetsDropped;   // producer only
+
+    QThread* m_writerThread;
+    QObject* m_writerContext;  // lives on m_writerThread; drain()/timer run there
+
+    // Writer thread state
+    Configuration m_config;
+    QFile* m_file;
+    QFile* m_linksFile;
+    QByteArray m_drainBuffer;  // ring contents, compacted to .tlog records in place
+    QByteArray m_tagBuffer;    // one tag per record of m_drainBuffer
+    QTimer* m_flushTimer;
+    QElapsedTimer m_fileAge;
+    qint64 m_fileBytes;
+    quint64 m_reportedDrops;
+    std::atomic<quint64> m_filesOpened;
+    std::atomic<quint64> m_bytesWritten;
+
+    mutable QMutex m_fileNameMutex;
+    QString m_fileName;
+};
+
+#endif  // TLOGRECORDER_H
@@ -0,0 +1,340 @@
+#include "udpbatchsocket.h"
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace {
+constexpr size_t CONTROL_CAPACITY = CMSG_SPACE(sizeof(timespec));
+}  // namespace
+
+struct UdpBatchSocket::Buffers {
+    std::vector<char> data;
+    std::vector<iovec> iovecs;
+    std::vector<sockaddr_in> senders;
+    std::vector<char> control;  // SCM_TIMESTAMPNS per datagram
+    std::vector<mmsghdr> headers;
+    std::vector<iovec> sendIovecs;
+    std::vector<mmsghdr> sendHeaders;
+    sockaddr_in remote{};
+    int received{0};
+};
+
+UdpBatchSocket::UdpBatchSocket(int batchSize, int datagramCapacity)
+    : m_fd(-1), m_batchSize(qMax(1, batchSize)), m_datagramCapacity(qMax(1, datagramCapacity)),
+      m_receiveTimestamps(false), m_buffers(new Buffers) {
+    // Preallocate one slot per datagram so a batch never allocates
+    m_buffers->data.resize(static_cast<size_t>(m_batchSize) * m_datagramCapacity);
+    m_buffers->iovecs.resize(m_batchSize);
+    m_buffers->senders.resize(m_batchSize);
+    m_buffers->control.resize(static_cast<size_t>(m_batchSize) * CONTROL_CAPACITY);
+    m_buffers->headers.resize(m_batchSize);
+    m_buffers->sendIovecs.resize(m_batchSize);
+    m_buffers->sendHeaders.resize(m_batchSize);
+    m_buffers->remote.sin_family = AF_INET;
+}
+
+UdpBatchSocket::~UdpBatchSocket() {
+    close();
+    delete m_buffers;
+}
+
+bool UdpBatchSocket::isSupported() {
+    return true;
+}
+
+bool UdpBatchSocket::bind(const QHostAddress& address, quint16 port) {
+    close();
+
+    // QHostAddress::Any is dual-stack; the batched path only handles IPv4
+    quint32 ipv4 = INADDR_ANY;
+    if (address != QHostAddress::Any && address != QHostAddress::AnyIPv4) {
+        bool ok = false;
+        ipv4 = address.toIPv4Address(&ok);
+        if (!ok) {
+            m_errorString = QString("Batched UDP requires an IPv4 address, got %1")
+                                .arg(address.toString());
+            return false;
+        }
+    }
+
+    m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0) {
+        m_errorString = QString("socket() failed: %1").arg(strerror(errno));
+        return false;
+    }
+
+    // Same semantics as QUdpSocket::ReuseAddressHint
+    int enable = 1;
+    ::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(ipv4);
+    local.sin_port = htons(port);
+
+    if (::bind(m_fd, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) < 0) {
+        m_errorString = QString("bind() failed: %1").arg(strerror(errno));
+        close();
+        return false;
+    }
+
+    if (m_receiveTimestamps && !setReceiveTimestamps(true)) {
+        qWarning() << "UdpBatchSocket: SO_TIMESTAMPNS unavailable:" << strerror(errno);
+    }
+
+    m_errorString.clear();
+    return true;
+}
+
+void UdpBatchSocket::close() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_buffers->received = 0;
+}
+
+bool UdpBatchSocket::setReceiveTimestamps(bool enabled) {
+    if (m_fd < 0) {
+        // Applied by the next bind()
+        m_receiveTimestamps = enabled;
+        return false;
+    }
+
+    int value = enabled ? 1 : 0;
+    if (::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value)) < 0) {
+        m_receiveTimestamps = false;
+        return false;
+    }
+    m_receiveTimestamps = enabled;
+    return true;
+}
+
+int UdpBatchSocket::receiveBatch() {
+    if (m_fd < 0) {
+        return -1;
+    }
+
+    Buffers& b = *m_buffers;
+    for (int i = 0; i < m_batchSize; ++i) {
+        b.iovecs[i].iov_base = b.data.data() + static_cast<size_t>(i) * m_datagramCapacity;
+        b.iovecs[i].iov_len = static_cast<size_t>(m_datagramCapacity);
+
+        msghdr& hdr = b.headers[i].msg_hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name = &b.senders[i];
+        hdr.msg_namelen = sizeof(sockaddr_in);
+        hdr.msg_iov = &b.iovecs[i];
+        hdr.msg_iovlen = 1;
+        if (m_receiveTimestamps) {
+            hdr.msg_control = b.control.data() + static_cast<size_t>(i) * CONTROL_CAPACITY;
+            hdr.msg_controllen = CONTROL_CAPACITY;
+        }
+        b.headers[i].msg_len = 0;
+    }
+
+    int count = ::recvmmsg(m_fd, b.headers.data(), static_cast<unsigned int>(m_batchSize),
+                           MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+        b.received = 0;
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        m_errorString = QString("recvmmsg() failed: %1").arg(strerror(errno));
+        return -1;
+    }
+
+    b.received = count;
+    return count;
+}
+
+const char* UdpBatchSocket::datagramData(int index) const {
+    return static_cast<const char*>(m_buffers->iovecs[index].iov_base);
+}
+
+int UdpBatchSocket::datagramSize(int index) const {
+    // msg_len never exceeds the slot; datagramTruncated() tells if bytes were cut
+    return static_cast<int>(qMin<unsigned int>(m_buffers->headers[index].msg_len,
+                                               static_cast<unsigned int>(m_datagramCapacity)));
+}
+
+bool UdpBatchSocket::datagramTruncated(int index) const {
+    return (m_buffers->headers[index].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+}
+
+qint64 UdpBatchSocket::receiveTimestampNs(int index) const {
+    if (!m_receiveTimestamps) {
+        return 0;
+    }
+
+    // msghdr is not const-correct; the header is only read here
+    msghdr* hdr = const_cast<msghdr*>(&m_buffers->headers[index].msg_hdr);
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return static_cast<qint64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        }
+    }
+    return 0;
+}
+
+quint32 UdpBatchSocket::senderAddress(int index) const {
+    return ntohl(m_buffers->senders[index].sin_addr.s_addr);
+}
+
+quint16 UdpBatchSocket::senderPort(int index) const {
+    return ntohs(m_buffers->senders[index].sin_port);
+}
+
+bool UdpBatchSocket::setRemote(const QHostAddress& address, quint16 port) {
+    bool ok = false;
+    quint32 ipv4 = address.toIPv4Address(&ok);
+    if (!ok) {
+        return false;
+    }
+    setRemote(ipv4, port);
+    return true;
+}
+
+void UdpBatchSocket::setRemote(quint32 ipv4Address, quint16 port) {
+    m_buffers->remote.sin_addr.s_addr = htonl(ipv4Address);
+    m_buffers->remote.sin_port = htons(port);
+}
+
+int UdpBatchSocket::sendBatch(const QList<QByteArray>& datagrams, int first, int count) {
+    if (m_fd < 0) {
+        return -1;
+    }
+
+    Buffers& b = *m_buffers;
+    int total = 0;
+
+    while (total < count) {
+        int chunk = qMin(count - total, m_batchSize);
+        for (int i = 0; i < chunk; ++i) {
+            const QByteArray& datagram = datagrams.at(first + total + i);
+            b.sendIovecs[i].iov_base = const_cast<char*>(datagram.constData());
+            b.sendIovecs[i].iov_len = static_cast<size_t>(datagram.size());
+
+            msghdr& hdr = b.sendHeaders[i].msg_hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_name = &b.remote;
+            hdr.msg_namelen = sizeof(sockaddr_in);
+            hdr.msg_iov = &b.sendIovecs[i];
+            hdr.msg_iovlen = 1;
+        }
+
+        int sent = ::sendmmsg(m_fd, b.sendHeaders.data(), static_cast<unsigned int>(chunk), 0);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;  // socket buffer full before the first datagram of this chunk
+            }
+            m_errorString = QString("sendmmsg() failed: %1").arg(strerror(errno));
+            return total > 0 ? total : -1;
+        }
+
+        total += sent;
+        if (sent < chunk) {
+            // Socket buffer full; the caller drops the remainder
+            break;
+        }
+    }
+
+    return total;
+}
+
+#else  // !Q_OS_LINUX
+
+struct UdpBatchSocket::Buffers {};
+
+UdpBatchSocket::UdpBatchSocket(int batchSize, int datagramCapacity)
+    : m_fd(-1), m_batchSize(qMax(1, batchSize)), m_datagramCapacity(qMax(1, datagramCapacity)),
+      m_receiveTimestamps(false), m_buffers(new Buffers) {}
+
+UdpBatchSocket::~UdpBatchSocket() {
+    delete m_buffers;
+}
+
+bool UdpBatchSocket::isSupported() {
+    return false;
+}
+
+bool UdpBatchSocket::bind(const QHostAddress& address, quint16 port) {
+    Q_UNUSED(address)
+    Q_UNUSED(port)
+    m_errorString = QStringLiteral("Batched UDP I/O is only available on Linux");
+    return false;
+}
+
+void UdpBatchSocket::close() {}
+
+int UdpBatchSocket::receiveBatch() {
+    return -1;
+}
+
+const char* UdpBatchSocket::datagramData(int index) const {
+    Q_UNUSED(index)
+    return nullptr;
+}
+
+int UdpBatchSocket::datagramSize(int index) const {
+    Q_UNUSED(index)
+    return 0;
+}
+
+bool UdpBatchSocket::datagramTruncated(int index) const {
+    Q_UNUSED(index)
+    return false;
+}
+
+qint64 UdpBatchSocket::receiveTimestampNs(int index) const {
+    Q_UNUSED(index)
+    return 0;
+}
+
+bool UdpBatchSocket::setReceiveTimestamps(bool enabled) {
+    Q_UNUSED(enabled)
+    return false;
+}
+
+quint32 UdpBatchSocket::senderAddress(int index) const {
+    Q_UNUSED(index)
+    return 0;
+}
+
+quint16 UdpBatchSocket::senderPort(int index) const {
+    Q_UNUSED(index)
+    return 0;
+}
+
+bool UdpBatchSocket::setRemote(const QHostAddress& address, quint16 port) {
+    Q_UNUSED(address)
+    Q_UNUSED(port)
+    return false;
+}
+
+void UdpBatchSocket::setRemote(quint32 ipv4Address, quint16 port) {
+    Q_UNUSED(ipv4Address)
+    Q_UNUSED(port)
+}
+
+int UdpBatchSocket::sendBatch(const QList<QByteArray>& datagrams, int first, int count) {
+    Q_UNUSED(datagrams)
+    Q_UNUSED(first)
+    Q_UNUSED(count)
+    return -1;
+}
+
+#endif  // Q_OS_LINUX
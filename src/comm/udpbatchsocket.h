@@ -0,0 +1,121 @@
+#ifndef UDPBATCHSOCKET_H
+#define UDPBATCHSOCKET_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Native non-blocking UDP socket with batched receive/send
+ *
+ * Thin wrapper around a raw IPv4 datagram socket that drains up to
+ * batchSize() datagrams per call with recvmmsg() and flushes queued
+ * datagrams with sendmmsg(). Receive buffers are allocated once at
+ * construction and reused for every batch.
+ *
+ * With setReceiveTimestamps() the kernel also reports when each datagram
+ * arrived (SO_TIMESTAMPNS), which LatencyTrace uses as the start of the
+ * receive pipeline.
+ *
+ * Only available on Linux; isSupported() returns false elsewhere and
+ * UdpLink falls back to QUdpSocket.
+ */
+class UdpBatchSocket {
+public:
+    explicit UdpBatchSocket(int batchSize, int datagramCapacity = 2048);
+    ~UdpBatchSocket();
+
+    UdpBatchSocket(const UdpBatchSocket&) = delete;
+    UdpBatchSocket& operator=(const UdpBatchSocket&) = delete;
+
+    /**
+     * @brief Check if batched I/O is available on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Create the socket and bind it to the given local IPv4 address
+     * @return false on failure, see errorString()
+     */
+    bool bind(const QHostAddress& address, quint16 port);
+
+    /**
+     * @brief Close the socket
+     */
+    void close();
+
+    /**
+     * @brief Native socket descriptor (-1 when closed)
+     */
+    int descriptor() const { return m_fd; }
+
+    int batchSize() const { return m_batchSize; }
+    int datagramCapacity() const { return m_datagramCapacity; }
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Receive up to batchSize() datagrams without blocking
+     * @return Number of datagrams received, 0 if none pending, -1 on error
+     */
+    int receiveBatch();
+
+    /**
+     * @brief Access datagram @p index of the last receiveBatch() call
+     */
+    const char* datagramData(int index) const;
+    int datagramSize(int index) const;
+
+    /**
+     * @brief Whether datagram @p index was larger than its slot (MSG_TRUNC)
+     *
+     * Only the first datagram-capacity bytes of a truncated datagram were kept.
+     */
+    bool datagramTruncated(int index) const;
+
+    /**
+     * @brief Kernel receive time of datagram @p index (CLOCK_REALTIME, ns)
+     * @return 0 if receive timestamps are off or none was reported
+     */
+    qint64 receiveTimestampNs(int index) const;
+
+    /**
+     * @brief Ask the kernel to timestamp received datagrams (SO_TIMESTAMPNS)
+     * @return false if the socket is closed or the option is not supported
+     */
+    bool setReceiveTimestamps(bool enabled);
+    bool receiveTimestamps() const { return m_receiveTimestamps; }
+
+    /**
+     * @brief Sender of datagram @p index (IPv4 address in host byte order)
+     */
+    quint32 senderAddress(int index) const;
+    quint16 senderPort(int index) const;
+
+    /**
+     * @brief Set the destination used by sendBatch()
+     */
+    bool setRemote(const QHostAddress& address, quint16 port);
+    void setRemote(quint32 ipv4Address, quint16 port);
+
+    /**
+     * @brief Send datagrams [first, first + count) with as few syscalls as possible
+     *
+     * Stops early once the socket send buffer is full, which is not an error.
+     *
+     * @return Number of datagrams handed to the kernel (may be 0), -1 on error
+     */
+    int sendBatch(const QList<QByteArray>& datagrams, int first, int count);
+
+private:
+    struct Buffers;
+
+    int m_fd;
+    int m_batchSize;
+    int m_datagramCapacity;
+    bool m_receiveTimestamps;
+    Buffers* m_buffers;
+    QString m_errorString;
+};
+
+#endif  // UDPBATCHSOCKET_H
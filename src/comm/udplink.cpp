@@ -1,10 +1,14 @@
 #include "udplink.h"
+#include "udpbatchsocket.h"
+#include "latencytrace.h"
 #include <QDebug>
+#include <QSocketNotifier>
 #include <QThread>
 
 UdpLink::UdpLink(const Configuration& config, QObject* parent)
-    : LinkInterface(parent), m_config(config), m_socket(nullptr),
-      m_status(LinkStatus::Disconnected) {}
+    : LinkInterface(parent), m_config(config), m_socket(nullptr), m_batchSocket(nullptr),
+      m_readNotifier(nullptr), m_status(LinkStatus::Disconnected), m_flushScheduled(false),
+      m_remoteIPv4(0), m_remoteHeardMs(-1), m_receiveTimestampsRequested(false) {}
 
 UdpLink::~UdpLink() {
     disconnectLink();
@@ -22,6 +26,20 @@ bool UdpLink::isConnected() const {
     return m_status == LinkStatus::Connected;
 }
 
+UdpLink::BatchStatistics UdpLink::batchStatistics() const {
+    BatchStatistics stats;
+    stats.batched = m_config.batchedIo && UdpBatchSocket::isSupported();
+    stats.receiveBatches = m_receiveBatches.load(std::memory_order_relaxed);
+    stats.datagramsReceived = m_datagramsReceived.load(std::memory_order_relaxed);
+    stats.maxReceiveBatch = m_maxReceiveBatch.load(std::memory_order_relaxed);
+    stats.sendBatches = m_sendBatches.load(std::memory_order_relaxed);
+    stats.datagramsSent = m_datagramsSent.load(std::memory_order_relaxed);
+    stats.maxSendBatch = m_maxSendBatch.load(std::memory_order_relaxed);
+    stats.datagramsDropped = m_datagramsDropped.load(std::memory_order_relaxed);
+    stats.datagramsTruncated = m_datagramsTruncated.load(std::memory_order_relaxed);
+    return stats;
+}
+
 void UdpLink::connectLink() {
     qDebug() << "UdpLink::connectLink() called on thread:" << QThread::currentThread();
 
@@ -30,9 +48,19 @@ void UdpLink::connectLink() {
         return;
     }
 
+    // A reconnect after an error starts from fresh sockets
+    releaseSockets();
+    m_remoteHeardMs = -1;
+    m_remoteClock.start();
+
     m_status = LinkStatus::Connecting;
     emit statusChanged(m_status);
 
+    // Prefer the batched path; fall back to QUdpSocket if it is unavailable
+    if (m_config.batchedIo && UdpBatchSocket::isSupported() && connectBatched()) {
+        return;
+    }
+
     // Create socket on the current thread (should be worker thread)
     m_socket = new QUdpSocket(this);
     qDebug() << "Socket created, thread:" << m_socket->thread();
@@ -63,69 +91,317 @@ void UdpLink::connectLink() {
     }
 }
 
+bool UdpLink::connectBatched() {
+    bool remoteIsIPv4 = false;
+    m_remoteIPv4 = m_config.remoteAddress.toIPv4Address(&remoteIsIPv4);
+    if (!remoteIsIPv4) {
+        qInfo() << "UdpLink: Remote address is not IPv4, batched I/O disabled";
+        return false;
+    }
+
+    m_batchSocket = new UdpBatchSocket(m_config.batchSize);
+    if (!m_batchSocket->bind(m_config.localAddress, m_config.localPort)) {
+        qWarning() << "UdpLink: Batched socket unavailable, falling back to QUdpSocket:"
+                   << m_batchSocket->errorString();
+        delete m_batchSocket;
+        m_batchSocket = nullptr;
+        return false;
+    }
+    m_batchSocket->setRemote(m_remoteIPv4, m_config.remotePort);
+
+    m_readNotifier = new QSocketNotifier(m_batchSocket->descriptor(), QSocketNotifier::Read, this);
+    connect(m_readNotifier, &QSocketNotifier::activated, this, &UdpLink::onBatchReadyRead);
+
+    m_status = LinkStatus::Connected;
+    emit statusChanged(m_status);
+    qDebug() << "UDP Link connected (batched, up to" << m_batchSocket->batchSize()
+             << "datagrams per syscall):" << m_config.name << "listening on"
+             << m_config.localAddress.toString() << ":" << m_config.localPort;
+    return true;
+}
+
 void UdpLink::disconnectLink() {
+    releaseSockets();
+    m_status = LinkStatus::Disconnected;
+    emit statusChanged(m_status);
+    qDebug() << "UDP Link disconnected:" << m_config.name;
+}
+
+void UdpLink::releaseSockets() {
+    if (m_readNotifier) {
+        m_readNotifier->setEnabled(false);
+        m_readNotifier->deleteLater();
+        m_readNotifier = nullptr;
+    }
+
+    if (m_batchSocket) {
+        m_batchSocket->close();
+        delete m_batchSocket;
+        m_batchSocket = nullptr;
+    }
+
     if (m_socket) {
         m_socket->close();
         m_socket->deleteLater();
         m_socket = nullptr;
     }
 
-    m_status = LinkStatus::Disconnected;
-    emit statusChanged(m_status);
-    qDebug() << "UDP Link disconnected:" << m_config.name;
+    m_pendingWrites.clear();
+    m_receiveTimestampsRequested = false;
 }
 
 void UdpLink::writeBytes(const QByteArray& data) {
-    if (!isConnected() || !m_socket) {
+    if (!isConnected() || (!m_socket && !m_batchSocket)) {
         qWarning() << "UdpLink::writeBytes() - Not connected";
         return;
     }
 
-    qint64 written =
-        m_socket->writeDatagram(data, m_config.remoteAddress, m_config.remotePort);
+    // Queue and flush once the current burst of queued writeBytes() calls is processed
+    m_pendingWrites.append(data);
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, [this]() { flushWrites(); }, Qt::QueuedConnection);
+    }
+}
 
-    if (written == -1) {
-        QString error = QString("Failed to write UDP datagram: %1").arg(m_socket->errorString());
-        emit errorOccurred(error);
-        qWarning() << error;
-    } else {
-        emit bytesWritten(written);
+void UdpLink::flushWrites() {
+    m_flushScheduled = false;
+    if (m_pendingWrites.isEmpty()) {
+        return;
+    }
+
+    const int count = m_pendingWrites.size();
+    qint64 bytes = 0;
+    int sent = 0;
+
+    if (m_batchSocket) {
+        sent = m_batchSocket->sendBatch(m_pendingWrites, 0, count);
+        if (sent < 0) {
+            QString error =
+                QString("Failed to write UDP datagrams: %1").arg(m_batchSocket->errorString());
+            emit errorOccurred(error);
+            qWarning() << error;
+            sent = 0;
+        } else if (sent < count) {
+            qWarning() << "UdpLink: Send buffer full, dropped" << (count - sent) << "datagrams";
+        }
+        countDropped(sent, count - sent);
+        for (int i = 0; i < sent; ++i) {
+            bytes += m_pendingWrites.at(i).size();
+        }
+    } else if (m_socket) {
+        for (int i = 0; i < count; ++i) {
+            qint64 written = m_socket->writeDatagram(m_pendingWrites.at(i), m_config.remoteAddress,
+                                                     m_config.remotePort);
+            if (written == -1 && m_socket->error() == QAbstractSocket::TemporaryError) {
+                countDropped(i, 1);  // send buffer full
+                continue;
+            }
+            if (written == -1) {
+                QString error =
+                    QString("Failed to write UDP datagram: %1").arg(m_socket->errorString());
+                emit errorOccurred(error);
+                qWarning() << error;
+                continue;
+            }
+            bytes += written;
+            ++sent;
+        }
+    }
+
+    m_pendingWrites.clear();
+
+    if (sent > 0) {
+        m_sendBatches.fetch_add(1, std::memory_order_relaxed);
+        m_datagramsSent.fetch_add(static_cast<quint64>(sent), std::memory_order_relaxed);
+        updateMax(m_maxSendBatch, static_cast<quint64>(sent));
+        emit bytesWritten(bytes);
     }
 }
 
 void UdpLink::onReadyRead() {
+    quint64 datagrams = 0;
+    LatencyTrace& trace = LatencyTrace::instance();
+
     while (m_socket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(static_cast<int>(m_socket->pendingDatagramSize()));
+        const qint64 pending = qMax<qint64>(m_socket->pendingDatagramSize(), 0);
+        if (m_receiveBuffer.size() < pending) {
+            m_receiveBuffer.resize(static_cast<qsizetype>(pending));
+        }
 
         QHostAddress senderAddress;
         quint16 senderPort;
 
-        qint64 bytesRead =
-            m_socket->readDatagram(datagram.data(), datagram.size(), &senderAddress, &senderPort);
+        qint64 bytesRead = m_socket->readDatagram(m_receiveBuffer.data(), pending, &senderAddress,
+                                                  &senderPort);
 
         if (bytesRead > 0) {
-            // Always update remote address from sender (for server mode)
-            // This is necessary because Mission Planner uses random source ports
             if (m_config.isServer) {
-                // Only log when address changes to reduce noise
-                bool addressChanged = (m_config.remoteAddress != senderAddress || m_config.remotePort != senderPort);
-                m_config.remoteAddress = senderAddress;
-                m_config.remotePort = senderPort;
+                followSender(senderAddress, senderPort);
+            }
+            if (trace.isEnabled()) {
+                trace.recordDatagram(m_receiveBuffer.constData(), bytesRead);
+            }
+            pushReceivedBytes(m_receiveBuffer.constData(), static_cast<qsizetype>(bytesRead));
+            ++datagrams;
+        }
+    }
+
+    if (datagrams > 0) {
+        m_receiveBatches.fetch_add(1, std::memory_order_relaxed);
+        m_datagramsReceived.fetch_add(datagrams, std::memory_order_relaxed);
+        updateMax(m_maxReceiveBatch, datagrams);
+        flushReceivedBytes();
+    }
+}
+
+void UdpLink::onBatchReadyRead() {
+    // Kernel receive timestamps are only requested while latency tracing is on
+    LatencyTrace& trace = LatencyTrace::instance();
+    const bool tracing = trace.isEnabled();
+    if (tracing && !m_receiveTimestampsRequested) {
+        m_receiveTimestampsRequested = true;
+        if (!m_batchSocket->setReceiveTimestamps(true)) {
+            qInfo() << "UdpLink: Kernel receive timestamps unavailable, tracing from user space";
+        }
+    }
+
+    // Drain the socket; a full batch means more datagrams may be waiting
+    int count = 0;
+    do {
+        count = m_batchSocket->receiveBatch();
+        if (count < 0) {
+            // A persistent socket error would fire the notifier again at once;
+            // stop reading and let the reconnect start from a fresh socket
+            QString error = QString("UDP socket error: %1").arg(m_batchSocket->errorString());
+            m_readNotifier->setEnabled(false);
+            m_status = LinkStatus::Error;
+            emit statusChanged(m_status);
+            emit errorOccurred(error);
+            qWarning() << error;
+            return;
+        }
+        if (count == 0) {
+            return;
+        }
 
-                if (addressChanged) {
-                    qInfo() << "UDP Link remote address updated to:" << senderAddress.toString() << ":" << senderPort;
+        quint64 delivered = 0;
+        quint64 truncated = 0;
+        bool remoteHeard = false;
+        int otherSender = -1;
+        for (int i = 0; i < count; ++i) {
+            const int size = m_batchSocket->datagramSize(i);
+            if (size <= 0) {
+                continue;
+            }
+            // The tail of an oversized datagram is gone; its last frame cannot be trusted
+            if (m_batchSocket->datagramTruncated(i)) {
+                ++truncated;
+                continue;
+            }
+            if (tracing) {
+                trace.recordDatagram(m_batchSocket->datagramData(i), size,
+                                     m_batchSocket->receiveTimestampNs(i));
+            }
+            pushReceivedBytes(m_batchSocket->datagramData(i), size);
+            ++delivered;
+
+            // Compare the raw sender; a QHostAddress is only built on a switch
+            if (m_config.isServer) {
+                if (m_batchSocket->senderAddress(i) == m_remoteIPv4 &&
+                    m_batchSocket->senderPort(i) == m_config.remotePort) {
+                    remoteHeard = true;
+                } else {
+                    otherSender = i;
                 }
             }
+        }
 
-            datagram.resize(static_cast<int>(bytesRead));
-            emit bytesReceived(datagram);
+        if (m_config.isServer) {
+            followBatchSender(remoteHeard, otherSender);
+        }
+        if (truncated > 0) {
+            m_datagramsTruncated.fetch_add(truncated, std::memory_order_relaxed);
+            qWarning() << "UdpLink: Dropped" << truncated << "datagrams larger than"
+                       << m_batchSocket->datagramCapacity() << "bytes";
         }
+        if (delivered == 0) {
+            continue;
+        }
+
+        m_receiveBatches.fetch_add(1, std::memory_order_relaxed);
+        m_datagramsReceived.fetch_add(delivered, std::memory_order_relaxed);
+        updateMax(m_maxReceiveBatch, delivered);
+
+        flushReceivedBytes();
+    } while (count == m_batchSocket->batchSize());
+}
+
+void UdpLink::followSender(const QHostAddress& senderAddress, quint16 senderPort) {
+    const qint64 nowMs = m_remoteClock.elapsed();
+    if (senderAddress == m_config.remoteAddress && senderPort == m_config.remotePort) {
+        m_remoteHeardMs = nowMs;
+        return;
+    }
+    if (remoteHeldAt(nowMs)) {
+        return;
+    }
+    updateRemote(senderAddress, senderPort);
+    m_remoteHeardMs = nowMs;
+}
+
+void UdpLink::followBatchSender(bool remoteHeard, int otherSender) {
+    const qint64 nowMs = m_remoteClock.elapsed();
+    if (remoteHeard) {
+        m_remoteHeardMs = nowMs;
+        return;
+    }
+    if (otherSender < 0 || remoteHeldAt(nowMs)) {
+        return;
+    }
+    m_remoteIPv4 = m_batchSocket->senderAddress(otherSender);
+    const quint16 senderPort = m_batchSocket->senderPort(otherSender);
+    m_batchSocket->setRemote(m_remoteIPv4, senderPort);
+    updateRemote(QHostAddress(m_remoteIPv4), senderPort);
+    m_remoteHeardMs = nowMs;
+}
+
+bool UdpLink::remoteHeldAt(qint64 nowMs) const {
+    return m_remoteHeardMs >= 0 && nowMs - m_remoteHeardMs < REMOTE_HOLD_MS;
+}
+
+void UdpLink::updateRemote(const QHostAddress& senderAddress, quint16 senderPort) {
+    // Replies follow the sender (Mission Planner uses random source ports)
+    m_config.remoteAddress = senderAddress;
+    m_config.remotePort = senderPort;
+    qInfo() << "UDP Link remote address updated to:" << senderAddress.toString() << ":"
+            << senderPort;
+}
+
+void UdpLink::countDropped(int first, int count) {
+    if (count <= 0) {
+        return;
+    }
+    quint64 bytes = 0;
+    for (int i = first; i < first + count; ++i) {
+        bytes += static_cast<quint64>(m_pendingWrites.at(i).size());
+    }
+    m_datagramsDropped.fetch_add(static_cast<quint64>(count), std::memory_order_relaxed);
+    countOutboundDrop(static_cast<quint64>(count), bytes);
+}
+
+void UdpLink::updateMax(std::atomic<quint64>& max, quint64 value) {
+    quint64 current = max.load(std::memory_order_relaxed);
+    while (value > current &&
+           !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
     }
 }
 
 void UdpLink::onErrorOccurred(QAbstractSocket::SocketError socketError) {
-    Q_UNUSED(socketError)
+    // A full send buffer only drops the datagram (counted in flushWrites())
+    if (socketError == QAbstractSocket::TemporaryError) {
+        return;
+    }
     QString error = QString("UDP socket error: %1").arg(m_socket->errorString());
     m_status = LinkStatus::Error;
     emit statusChanged(m_status);
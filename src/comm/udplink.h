@@ -3,13 +3,36 @@
 
 #include "linkinterface.h"
 #include <QUdpSocket>
+#include <QElapsedTimer>
 #include <QHostAddress>
+#include <QList>
+#include <atomic>
+
+class QSocketNotifier;
+class UdpBatchSocket;
 
 /**
  * @brief UDP communication link implementation
  *
  * Supports both client (connect to remote) and server (listen) modes.
  * Designed to run on a separate QThread.
+ *
+ * On Linux the link uses batched I/O by default: each read wakeup drains up
+ * to Configuration::batchSize datagrams with recvmmsg() and delivers them to
+ * the consumer as one batch, and writeBytes() calls queued during one event
+ * loop pass are flushed together with sendmmsg(). Datagrams that do not fit
+ * in the socket send buffer are dropped and counted (batchStatistics(),
+ * outboundStatistics()) rather than reported as link errors. Received
+ * datagrams larger than the batch slots are dropped and counted as well.
+ *
+ * In server mode replies go to the peer that is talking to the link. Another
+ * sender only takes over once the current peer has been silent for
+ * REMOTE_HOLD_MS, so two senders on one port do not flip the remote back and
+ * forth on every datagram.
+ *
+ * While LatencyTrace is enabled every received MAVLink frame is recorded as a
+ * SocketReceive trace point, stamped with the kernel receive time on the
+ * batched path and with the time of the read otherwise.
  */
 class UdpLink : public LinkInterface {
     Q_OBJECT
@@ -22,8 +45,37 @@ public:
         QHostAddress remoteAddress{QHostAddress::LocalHost};
         quint16 remotePort{14550};
         bool isServer{true};  // true = listen mode, false = client mode
+        bool batchedIo{true};  // recvmmsg/sendmmsg (Linux, IPv4 only)
+        int batchSize{32};     // max datagrams per syscall
+    };
+
+    /**
+     * @brief Achieved batch sizes (safe to read from any thread)
+     */
+    struct BatchStatistics {
+        bool batched{false};
+        quint64 receiveBatches{0};
+        quint64 datagramsReceived{0};
+        quint64 maxReceiveBatch{0};
+        quint64 sendBatches{0};
+        quint64 datagramsSent{0};
+        quint64 maxSendBatch{0};
+        quint64 datagramsDropped{0};    // send buffer full
+        quint64 datagramsTruncated{0};  // received, larger than a batch slot
+
+        double averageReceiveBatch() const {
+            return receiveBatches ? static_cast<double>(datagramsReceived) / receiveBatches : 0.0;
+        }
+        double averageSendBatch() const {
+            return sendBatches ? static_cast<double>(datagramsSent) / sendBatches : 0.0;
+        }
     };
 
+    /**
+     * @brief Silence after which another sender becomes the server-mode remote
+     */
+    static constexpr qint64 REMOTE_HOLD_MS = 2000;
+
     explicit UdpLink(const Configuration& config, QObject* parent = nullptr);
     ~UdpLink() override;
 
@@ -31,6 +83,11 @@ public:
     LinkStatus status() const override;
     bool isConnected() const override;
 
+    /**
+     * @brief Snapshot of the batch counters
+     */
+    BatchStatistics batchStatistics() const;
+
 public slots:
     void connectLink() override;
     void disconnectLink() override;
@@ -38,12 +95,45 @@ public slots:
 
 private slots:
     void onReadyRead();
+    void onBatchReadyRead();
     void onErrorOccurred(QAbstractSocket::SocketError socketError);
 
 private:
+    bool connectBatched();
+    void releaseSockets();
+    void flushWrites();
+    void followSender(const QHostAddress& senderAddress, quint16 senderPort);
+    void followBatchSender(bool remoteHeard, int otherSender);
+    bool remoteHeldAt(qint64 nowMs) const;
+    void updateRemote(const QHostAddress& senderAddress, quint16 senderPort);
+    void countDropped(int first, int count);
+    static void updateMax(std::atomic<quint64>& max, quint64 value);
+
     Configuration m_config;
     QUdpSocket* m_socket;
+    UdpBatchSocket* m_batchSocket;
+    QSocketNotifier* m_readNotifier;
     LinkStatus m_status;
+
+    // Outbound datagrams waiting for the next flush
+    QList<QByteArray> m_pendingWrites;
+    bool m_flushScheduled;
+
+    // Scratch datagram buffer for the QUdpSocket fallback
+    QByteArray m_receiveBuffer;
+    quint32 m_remoteIPv4;
+    QElapsedTimer m_remoteClock;
+    qint64 m_remoteHeardMs;  // last datagram from the remote, -1 before the first
+    bool m_receiveTimestampsRequested;  // SO_TIMESTAMPNS asked for since connecting
+
+    std::atomic<quint64> m_receiveBatches{0};
+    std::atomic<quint64> m_datagramsReceived{0};
+    std::atomic<quint64> m_maxReceiveBatch{0};
+    std::atomic<quint64> m_sendBatches{0};
+    std::atomic<quint64> m_datagramsSent{0};
+    std::atomic<quint64> m_maxSendBatch{0};
+    std::atomic<quint64> m_datagramsDropped{0};
+    std::atomic<quint64> m_datagramsTruncated{0};
 };
 
 #endif  // UDPLINK_H
@@ -0,0 +1,107 @@
+# FlightScope sources shared by the app and the smoke test (everything but main.cpp)
+
+# Include paths
+INCLUDEPATH += $$PWD/../third-party
+INCLUDEPATH += $$PWD
+
+# Source files
+SOURCES += \
+    $$PWD/ui/mainwindow.cpp \
+    $$PWD/ui/connectdialog.cpp \
+    $$PWD/ui/missioneditor.cpp \
+    $$PWD/ui/commandeditordialog.cpp \
+    $$PWD/ui/mapwidget.cpp \
+    $$PWD/ui/compasswidget.cpp \
+    $$PWD/ui/hudwidget.cpp \
+    $$PWD/ui/seriesdecimator.cpp \
+    $$PWD/ui/telemetrychartwidget.cpp \
+    $$PWD/comm/linkinterface.cpp \
+    $$PWD/comm/bytering.cpp \
+    $$PWD/comm/udplink.cpp \
+    $$PWD/comm/udpbatchsocket.cpp \
+    $$PWD/comm/tcplink.cpp \
+    $$PWD/comm/replaylink.cpp \
+    $$PWD/comm/tlogindex.cpp \
+    $$PWD/comm/impairedlink.cpp \
+    $$PWD/comm/linkmanager.cpp \
+    $$PWD/comm/mavlinkrouter.cpp \
+    $$PWD/comm/messagestatistics.cpp \
+    $$PWD/comm/sequencetracker.cpp \
+    $$PWD/comm/dedupwindow.cpp \
+    $$PWD/comm/tlogrecorder.cpp \
+    $$PWD/comm/commandbus.cpp \
+    $$PWD/comm/latencytrace.cpp \
+    $$PWD/sim/simvehicle.cpp \
+    $$PWD/sim/vehiclesimulator.cpp \
+    $$PWD/sim/simulatorlink.cpp \
+    $$PWD/models/vehiclemodel.cpp \
+    $$PWD/models/telemetryhistory.cpp \
+    $$PWD/models/vehicleregistry.cpp \
+    $$PWD/models/fleetmodel.cpp \
+    $$PWD/models/trailmodel.cpp \
+    $$PWD/models/traillodstore.cpp \
+    $$PWD/models/healthmodel.cpp \
+    $$PWD/models/waypoint.cpp \
+    $$PWD/models/missionmodel.cpp \
+    $$PWD/models/geofencemodel.cpp
+
+# Header files
+HEADERS += \
+    $$PWD/ui/mainwindow.h \
+    $$PWD/ui/connectdialog.h \
+    $$PWD/ui/missioneditor.h \
+    $$PWD/ui/commandeditordialog.h \
+    $$PWD/ui/mapwidget.h \
+    $$PWD/ui/compasswidget.h \
+    $$PWD/ui/hudwidget.h \
+    $$PWD/ui/seriesdecimator.h \
+    $$PWD/ui/telemetrychartwidget.h \
+    $$PWD/comm/linkinterface.h \
+    $$PWD/comm/bytering.h \
+    $$PWD/comm/udplink.h \
+    $$PWD/comm/udpbatchsocket.h \
+    $$PWD/comm/tcplink.h \
+    $$PWD/comm/replaylink.h \
+    $$PWD/comm/tlogindex.h \
+    $$PWD/comm/impairedlink.h \
+    $$PWD/comm/linkmanager.h \
+    $$PWD/comm/mavlinkrouter.h \
+    $$PWD/comm/mavlinkmessagetraits.h \
+    $$PWD/comm/mavlinkframing.h \
+    $$PWD/comm/messagestatistics.h \
+    $$PWD/comm/sequencetracker.h \
+    $$PWD/comm/dedupwindow.h \
+    $$PWD/comm/tlogrecorder.h \
+    $$PWD/comm/commandbus.h \
+    $$PWD/comm/latencytrace.h \
+    $$PWD/comm/seqlock.h \
+    $$PWD/comm/relaxedcounter.h \
+    $$PWD/sim/simvehicle.h \
+    $$PWD/sim/vehiclesimulator.h \
+    $$PWD/sim/simulatorlink.h \
+    $$PWD/models/vehiclemodel.h \
+    $$PWD/models/telemetryhistory.h \
+    $$PWD/models/vehicleregistry.h \
+    $$PWD/models/fleetmodel.h \
+    $$PWD/models/trailmodel.h \
+    $$PWD/models/traillodstore.h \
+    $$PWD/models/healthmodel.h \
+    $$PWD/models/waypoint.h \
+    $$PWD/models/missionmodel.h \
+    $$PWD/models/geofencemodel.h
+
+# Serial links (Qt SerialPort is not available on mobile platforms)
+!android:!ios {
+    QT += serialport
+    DEFINES += FLIGHTSCOPE_SERIAL_LINK
+    SOURCES += $$PWD/comm/seriallink.cpp
+    HEADERS += $$PWD/comm/seriallink.h
+}
+
+# Forms
+FORMS += \
+    $$PWD/ui/mainwindow.ui
+
+# Resources
+RESOURCES += \
+    $$PWD/../resources/resources.qrc
@@ -0,0 +1,198 @@
+#include "fleetmodel.h"
+#include <QTimer>
+
+FleetModel::FleetModel(QObject* parent)
+    : QAbstractListModel(parent), m_activeVehicle(nullptr), m_hasViewport(false), m_north(0.0),
+      m_west(0.0), m_south(0.0), m_east(0.0), m_layoutDirty(false),
+      m_flushTimer(new QTimer(this)) {
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FRAME_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &FleetModel::flush);
+}
+
+void FleetModel::addVehicle(VehicleModel* vehicle) {
+    const int index = int(m_vehicles.size());
+    m_vehicles.push_back(Vehicle{vehicle, -1, true});
+
+    // Only mark the vehicle; the rows are updated once per frame
+    connect(vehicle, &VehicleModel::stateChanged, this,
+            [this, index](VehicleModel::Fields changed) {
+                if (!(changed & (VehicleModel::Latitude | VehicleModel::Longitude |
+                                 VehicleModel::Heading | VehicleModel::Armed))) {
+                    return;
+                }
+                m_vehicles[index].dirty = true;
+                scheduleFlush();
+            });
+    scheduleFlush();
+}
+
+void FleetModel::setActiveVehicle(VehicleModel* vehicle) {
+    if (m_activeVehicle == vehicle) {
+        return;
+    }
+    m_activeVehicle = vehicle;
+    m_layoutDirty = true;
+    scheduleFlush();
+}
+
+void FleetModel::setViewport(double north, double west, double south, double east) {
+    const double latMargin = (north - south) * VIEWPORT_MARGIN;
+    const double lonSpan = west <= east ? east - west : east + 360.0 - west;
+    const double lonMargin = lonSpan * VIEWPORT_MARGIN;
+    north = qMin(north + latMargin, 90.0);
+    south = qMax(south - latMargin, -90.0);
+    if (lonSpan + 2 * lonMargin >= 360.0) {
+        west = -180.0;
+        east = 180.0;
+    } else {
+        west = west - lonMargin < -180.0 ? west - lonMargin + 360.0 : west - lonMargin;
+        east = east + lonMargin > 180.0 ? east + lonMargin - 360.0 : east + lonMargin;
+    }
+
+    if (m_hasViewport && north == m_north && west == m_west && south == m_south &&
+        east == m_east) {
+        return;
+    }
+    m_hasViewport = true;
+    m_north = north;
+    m_west = west;
+    m_south = south;
+    m_east = east;
+    m_layoutDirty = true;
+    scheduleFlush();
+}
+
+VehicleModel* FleetModel::vehicleAt(int row) const {
+    return row >= 0 && row < m_rows.size() ? m_vehicles[m_rows.at(row)].model : nullptr;
+}
+
+bool FleetModel::isShown(const Vehicle& vehicle) const {
+    const VehicleModel* model = vehicle.model;
+    if (model == m_activeVehicle) {
+        return false;
+    }
+    const double lat = model->latitude();
+    const double lon = model->longitude();
+    if (lat == 0.0 && lon == 0.0) {
+        return false;  // no position yet
+    }
+    if (!m_hasViewport) {
+        return true;
+    }
+    if (lat > m_north || lat < m_south) {
+        return false;
+    }
+    return m_west <= m_east ? lon >= m_west && lon <= m_east : lon >= m_west || lon <= m_east;
+}
+
+void FleetModel::scheduleFlush() {
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void FleetModel::flush() {
+    m_flushTimer->stop();
+
+    // Cull rows whose vehicle left the viewport, one removal per contiguous run
+    bool removed = false;
+    int row = m_rows.size() - 1;
+    while (row >= 0) {
+        const Vehicle& vehicle = m_vehicles[m_rows.at(row)];
+        if ((!vehicle.dirty && !m_layoutDirty) || isShown(vehicle)) {
+            --row;
+            continue;
+        }
+        int first = row;
+        while (first > 0) {
+            const Vehicle& previous = m_vehicles[m_rows.at(first - 1)];
+            if ((!previous.dirty && !m_layoutDirty) || isShown(previous)) {
+                break;
+            }
+            --first;
+        }
+        beginRemoveRows(QModelIndex(), first, row);
+        for (int i = first; i <= row; ++i) {
+            m_vehicles[m_rows.at(i)].row = -1;
+        }
+        m_rows.remove(first, row - first + 1);
+        endRemoveRows();
+        removed = true;
+        row = first - 1;
+    }
+    if (removed) {
+        for (int i = 0; i < m_rows.size(); ++i) {
+            m_vehicles[m_rows.at(i)].row = i;
+        }
+    }
+
+    // Changed rows that stay on screen, one dataChanged() per contiguous run
+    static const QList<int> changedRoles = {LatitudeRole, LongitudeRole, HeadingRole, ArmedRole};
+    int runStart = -1;
+    for (int i = 0; i <= m_rows.size(); ++i) {
+        const bool changed = i < m_rows.size() && m_vehicles[m_rows.at(i)].dirty;
+        if (changed && runStart < 0) {
+            runStart = i;
+        } else if (!changed && runStart >= 0) {
+            emit dataChanged(index(runStart), index(i - 1), changedRoles);
+            runStart = -1;
+        }
+    }
+
+    // Vehicles that came into view, appended in one insertion
+    QVector<int> entering;
+    for (int i = 0; i < int(m_vehicles.size()); ++i) {
+        Vehicle& vehicle = m_vehicles[i];
+        if (vehicle.row < 0 && (vehicle.dirty || m_layoutDirty) && isShown(vehicle)) {
+            entering.append(i);
+        }
+        vehicle.dirty = false;
+    }
+    if (!entering.isEmpty()) {
+        const int first = m_rows.size();
+        beginInsertRows(QModelIndex(), first, first + entering.size() - 1);
+        for (int i = 0; i < entering.size(); ++i) {
+            m_vehicles[entering.at(i)].row = first + i;
+        }
+        m_rows.append(entering);
+        endInsertRows();
+    }
+    m_layoutDirty = false;
+}
+
+int FleetModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant FleetModel::data(const QModelIndex& index, int role) const {
+    const VehicleModel* vehicle = vehicleAt(index.row());
+    if (!vehicle) {
+        return QVariant();
+    }
+
+    switch (role) {
+        case SystemIdRole:
+            return int(vehicle->systemId());
+        case ComponentIdRole:
+            return int(vehicle->componentId());
+        case LatitudeRole:
+            return vehicle->latitude();
+        case LongitudeRole:
+            return vehicle->longitude();
+        case HeadingRole:
+            return int(vehicle->heading());
+        case ArmedRole:
+            return vehicle->armed();
+        default:
+            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> FleetModel::roleNames() const {
+    return {
+        {SystemIdRole, "systemId"}, {ComponentIdRole, "componentId"},
+        {LatitudeRole, "latitude"}, {LongitudeRole, "longitude"},
+        {HeadingRole, "heading"},   {ArmedRole, "armed"},
+    };
+}
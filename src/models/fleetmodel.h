@@ -0,0 +1,98 @@
+#ifndef FLEETMODEL_H
+#define FLEETMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <vector>
+#include "vehiclemodel.h"
+
+class QTimer;
+
+/**
+ * @brief The map's vehicle layer: one row per vehicle currently on screen
+ *
+ * Backs a MapItemView in MapView.qml whose delegate binds to the roles, so
+ * position updates never go through QML JavaScript.
+ *
+ * Vehicle changes only mark the vehicle dirty. Once per frame
+ * (FRAME_INTERVAL_MS after the first change) flush() applies them all:
+ * - vehicles that left the viewport, or have no position yet, are removed
+ *   (culled), so their delegates are destroyed rather than laid out;
+ * - vehicles that entered it are appended in one insertion;
+ * - the rest are reported with one dataChanged() per contiguous run of
+ *   changed rows.
+ *
+ * The active vehicle is left out; MapView.qml draws it with its own marker.
+ * Rows are in no particular order. GUI thread only.
+ */
+class FleetModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        SystemIdRole = Qt::UserRole + 1,
+        ComponentIdRole,
+        LatitudeRole,
+        LongitudeRole,
+        HeadingRole,
+        ArmedRole,
+    };
+
+    static constexpr int FRAME_INTERVAL_MS = 16;
+    static constexpr double VIEWPORT_MARGIN = 0.1;  // of the viewport span, on each side
+
+    explicit FleetModel(QObject* parent = nullptr);
+
+    void addVehicle(VehicleModel* vehicle);
+    int vehicleCount() const { return int(m_vehicles.size()); }
+
+    /**
+     * @brief Vehicle shown by the map's own marker instead of a row
+     */
+    void setActiveVehicle(VehicleModel* vehicle);
+
+    /**
+     * @brief Visible map area in degrees; vehicles outside it are culled
+     *
+     * west > east spans the antimeridian. Until this is called every
+     * vehicle is considered on screen.
+     */
+    Q_INVOKABLE void setViewport(double north, double west, double south, double east);
+
+    VehicleModel* vehicleAt(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+public slots:
+    /**
+     * @brief Apply pending vehicle and viewport changes to the rows now
+     */
+    void flush();
+
+private:
+    struct Vehicle {
+        VehicleModel* model;
+        int row;     // -1 while culled
+        bool dirty;  // changed since the last flush
+    };
+
+    bool isShown(const Vehicle& vehicle) const;
+    void scheduleFlush();
+
+    std::vector<Vehicle> m_vehicles;  // in the order they were added
+    QVector<int> m_rows;              // row -> index into m_vehicles
+    VehicleModel* m_activeVehicle;
+
+    bool m_hasViewport;
+    double m_north;
+    double m_west;
+    double m_south;
+    double m_east;
+
+    bool m_layoutDirty;  // viewport or active vehicle changed: re-cull everything
+    QTimer* m_flushTimer;
+};
+
+#endif  // FLEETMODEL_H
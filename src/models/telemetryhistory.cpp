@@ -0,0 +1,372 @@
+#include "telemetryhistory.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TelemetryHistory::TelemetryHistory(qint64 durationMs, double sampleRateHz, qint64 maxBytes)
+    : m_durationMs(qMax<qint64>(1, durationMs)), m_capacity(1) {
+    // Enough for the whole duration at the nominal rate, unless that breaks the byte cap
+    const int channels = qPopulationCount(HISTORY_FIELDS);
+    const qint64 wanted = static_cast<qint64>(std::ceil(m_durationMs * sampleRateHz / 1000.0));
+    const qint64 affordable = maxBytes / (qint64(channels) * BYTES_PER_SAMPLE);
+    m_capacity = static_cast<int>(
+        qBound<qint64>(1, qMin(wanted, affordable), std::numeric_limits<int>::max()));
+
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+        if (HISTORY_FIELDS & (1u << i)) {
+            Channel& channel = m_channels[i];
+            channel.times.reset(new qint64[m_capacity]);
+            channel.values.reset(new double[m_capacity]);
+            channel.sumsBefore.reset(new double[m_capacity]);
+        }
+    }
+}
+
+int TelemetryHistory::channelIndex(VehicleModel::Field field) {
+    Q_ASSERT(qPopulationCount(quint32(field)) == 1);
+    return qCountTrailingZeroBits(quint32(field));
+}
+
+void TelemetryHistory::record(qint64 timestampMs, const VehicleState& state,
+                              VehicleModel::Fields changed) {
+    quint32 fields = quint32(changed) & HISTORY_FIELDS;
+    while (fields) {
+        const auto field = static_cast<VehicleModel::Field>(fields & (~fields + 1));
+        append(field, timestampMs, fieldValue(state, field));
+        fields &= fields - 1;
+    }
+}
+
+void TelemetryHistory::append(VehicleModel::Field field, qint64 timestampMs, double value) {
+    Channel& channel = m_channels[channelIndex(field)];
+    if (!channel.times || !qIsFinite(value)) {
+        return;
+    }
+
+    if (channel.head > channel.tail) {
+        timestampMs = qMax(timestampMs, channel.times[slot(channel.head - 1)]);
+    }
+
+    const int s = slot(channel.head);
+    channel.times[s] = timestampMs;
+    channel.values[s] = value;
+    channel.sumsBefore[s] = channel.total;
+    channel.total += value;
+    ++channel.head;
+
+    // Full ring: the write above replaced the oldest sample
+    if (channel.head - channel.tail > quint64(m_capacity)) {
+        channel.tail = channel.head - m_capacity;
+    }
+    const qint64 oldest = timestampMs - m_durationMs;
+    while (channel.tail < channel.head && channel.times[slot(channel.tail)] < oldest) {
+        ++channel.tail;
+    }
+}
+
+void TelemetryHistory::clear() {
+    // Sequences keep counting so open Windows notice the samples are gone
+    for (Channel& channel : m_channels) {
+        channel.tail = channel.head;
+    }
+}
+
+quint64 TelemetryHistory::lowerBound(const Channel& channel, qint64 timestampMs) const {
+    quint64 first = channel.tail;
+    quint64 count = channel.head - channel.tail;
+    while (count > 0) {
+        const quint64 step = count / 2;
+        const quint64 middle = first + step;
+        if (channel.times[slot(middle)] < timestampMs) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+double TelemetryHistory::sum(const Channel& channel, quint64 first, quint64 end) const {
+    if (first >= end) {
+        return 0.0;
+    }
+    const double before = channel.sumsBefore[slot(first)];
+    const double through = end == channel.head ? channel.total : channel.sumsBefore[slot(end)];
+    return through - before;
+}
+
+TelemetryHistory::Range TelemetryHistory::range(VehicleModel::Field field, qint64 fromMs,
+                                                qint64 toMs) const {
+    Range result;
+    const Channel& channel = m_channels[channelIndex(field)];
+    if (!channel.times || fromMs > toMs) {
+        return result;
+    }
+
+    const quint64 first = lowerBound(channel, fromMs);
+    const quint64 end = toMs == std::numeric_limits<qint64>::max()
+                            ? channel.head
+                            : lowerBound(channel, toMs + 1);
+    if (first >= end) {
+        return result;
+    }
+
+    const int start = slot(first);
+    const int count = static_cast<int>(end - first);
+    result.sizes[0] = qMin(count, m_capacity - start);
+    result.sizes[1] = count - result.sizes[0];
+    result.times[0] = channel.times.get() + start;
+    result.values[0] = channel.values.get() + start;
+    result.times[1] = channel.times.get();
+    result.values[1] = channel.values.get();
+    return result;
+}
+
+TelemetryHistory::Stats TelemetryHistory::stats(VehicleModel::Field field, qint64 fromMs,
+                                                qint64 toMs) const {
+    Stats result;
+    const Range samples = range(field, fromMs, toMs);
+    if (samples.size() == 0) {
+        return result;
+    }
+
+    result.count = samples.size();
+    result.min = samples.values[0][0];
+    result.max = result.min;
+    for (int segment = 0; segment < 2; ++segment) {
+        const double* values = samples.values[segment];
+        for (int i = 0; i < samples.sizes[segment]; ++i) {
+            result.min = qMin(result.min, values[i]);
+            result.max = qMax(result.max, values[i]);
+        }
+    }
+
+    const Channel& channel = m_channels[channelIndex(field)];
+    const quint64 first = lowerBound(channel, fromMs);
+    result.mean = sum(channel, first, first + result.count) / result.count;
+    return result;
+}
+
+int TelemetryHistory::size(VehicleModel::Field field) const {
+    const Channel& channel = m_channels[channelIndex(field)];
+    return static_cast<int>(channel.head - channel.tail);
+}
+
+bool TelemetryHistory::latest(VehicleModel::Field field, qint64* timestampMs,
+                              double* value) const {
+    const Channel& channel = m_channels[channelIndex(field)];
+    if (channel.head == channel.tail) {
+        return false;
+    }
+    const int s = slot(channel.head - 1);
+    if (timestampMs) {
+        *timestampMs = channel.times[s];
+    }
+    if (value) {
+        *value = channel.values[s];
+    }
+    return true;
+}
+
+bool TelemetryHistory::valueAt(VehicleModel::Field field, qint64 timestampMs,
+                               double* value) const {
+    const Channel& channel = m_channels[channelIndex(field)];
+    if (!channel.times) {
+        return false;
+    }
+    const quint64 end = timestampMs == std::numeric_limits<qint64>::max()
+                            ? channel.head
+                            : lowerBound(channel, timestampMs + 1);
+    if (end == channel.tail) {
+        return false;
+    }
+    if (value) {
+        *value = channel.values[slot(end - 1)];
+    }
+    return true;
+}
+
+qint64 TelemetryHistory::memoryUsage() const {
+    return qint64(qPopulationCount(HISTORY_FIELDS)) * m_capacity * BYTES_PER_SAMPLE;
+}
+
+double TelemetryHistory::fieldValue(const VehicleState& state, VehicleModel::Field field) {
+    switch (field) {
+        case VehicleModel::Armed:
+            return state.armed ? 1.0 : 0.0;
+        case VehicleModel::Roll:
+            return state.roll;
+        case VehicleModel::Pitch:
+            return state.pitch;
+        case VehicleModel::Yaw:
+            return state.yaw;
+        case VehicleModel::RollSpeed:
+            return state.rollSpeed;
+        case VehicleModel::PitchSpeed:
+            return state.pitchSpeed;
+        case VehicleModel::YawSpeed:
+            return state.yawSpeed;
+        case VehicleModel::Latitude:
+            return state.latitude;
+        case VehicleModel::Longitude:
+            return state.longitude;
+        case VehicleModel::Altitude:
+            return state.altitude;
+        case VehicleModel::RelativeAltitude:
+            return state.relativeAltitude;
+        case VehicleModel::Heading:
+            return state.heading;
+        case VehicleModel::GroundSpeed:
+            return state.groundSpeed;
+        case VehicleModel::AirSpeed:
+            return state.airSpeed;
+        case VehicleModel::ClimbRate:
+            return state.climbRate;
+        case VehicleModel::BatteryVoltage:
+            return state.batteryVoltage;
+        case VehicleModel::BatteryCurrent:
+            return state.batteryCurrent;
+        case VehicleModel::BatteryRemaining:
+            return state.batteryRemaining;
+        case VehicleModel::Throttle:
+            return state.throttle;
+        default:
+            return qQNaN();
+    }
+}
+
+QString TelemetryHistory::fieldName(VehicleModel::Field field) {
+    switch (field) {
+        case VehicleModel::Armed:
+            return "Armed";
+        case VehicleModel::Roll:
+            return "Roll";
+        case VehicleModel::Pitch:
+            return "Pitch";
+        case VehicleModel::Yaw:
+            return "Yaw";
+        case VehicleModel::RollSpeed:
+            return "Roll Rate";
+        case VehicleModel::PitchSpeed:
+            return "Pitch Rate";
+        case VehicleModel::YawSpeed:
+            return "Yaw Rate";
+        case VehicleModel::Latitude:
+            return "Latitude";
+        case VehicleModel::Longitude:
+            return "Longitude";
+        case VehicleModel::Altitude:
+            return "Altitude (MSL)";
+        case VehicleModel::RelativeAltitude:
+            return "Altitude (Relative)";
+        case VehicleModel::Heading:
+            return "Heading";
+        case VehicleModel::GroundSpeed:
+            return "Ground Speed";
+        case VehicleModel::AirSpeed:
+            return "Air Speed";
+        case VehicleModel::ClimbRate:
+            return "Climb Rate";
+        case VehicleModel::BatteryVoltage:
+            return "Battery Voltage";
+        case VehicleModel::BatteryCurrent:
+            return "Battery Current";
+        case VehicleModel::BatteryRemaining:
+            return "Battery Remaining";
+        case VehicleModel::Throttle:
+            return "Throttle";
+        default:
+            return "Unknown";
+    }
+}
+
+QString TelemetryHistory::fieldUnit(VehicleModel::Field field) {
+    switch (field) {
+        case VehicleModel::Roll:
+        case VehicleModel::Pitch:
+        case VehicleModel::Yaw:
+        case VehicleModel::Latitude:
+        case VehicleModel::Longitude:
+        case VehicleModel::Heading:
+            return "deg";
+        case VehicleModel::RollSpeed:
+        case VehicleModel::PitchSpeed:
+        case VehicleModel::YawSpeed:
+            return "rad/s";
+        case VehicleModel::Altitude:
+        case VehicleModel::RelativeAltitude:
+            return "m";
+        case VehicleModel::GroundSpeed:
+        case VehicleModel::AirSpeed:
+        case VehicleModel::ClimbRate:
+            return "m/s";
+        case VehicleModel::BatteryVoltage:
+            return "V";
+        case VehicleModel::BatteryCurrent:
+            return "A";
+        case VehicleModel::BatteryRemaining:
+        case VehicleModel::Throttle:
+            return "%";
+        default:
+            return QString();
+    }
+}
+
+TelemetryHistory::Window::Window(const TelemetryHistory* history, VehicleModel::Field field,
+                                 qint64 durationMs)
+    : m_history(history), m_channel(channelIndex(field)), m_durationMs(durationMs), m_next(0),
+      m_start(0) {}
+
+TelemetryHistory::Stats TelemetryHistory::Window::stats() {
+    Stats result;
+    const Channel& channel = m_history->m_channels[m_channel];
+    if (!channel.times) {
+        return result;
+    }
+    auto value = [&](quint64 sequence) { return channel.values[m_history->slot(sequence)]; };
+
+    // Drop anything the ring has evicted or overwritten since the last call
+    while (!m_min.empty() && m_min.front() < channel.tail) {
+        m_min.pop_front();
+    }
+    while (!m_max.empty() && m_max.front() < channel.tail) {
+        m_max.pop_front();
+    }
+    m_next = qMax(m_next, channel.tail);
+    m_start = qMax(m_start, channel.tail);
+
+    // Each sample is pushed and popped at most once: amortized O(1)
+    for (; m_next < channel.head; ++m_next) {
+        const double v = value(m_next);
+        while (!m_min.empty() && value(m_min.back()) >= v) {
+            m_min.pop_back();
+        }
+        m_min.push_back(m_next);
+        while (!m_max.empty() && value(m_max.back()) <= v) {
+            m_max.pop_back();
+        }
+        m_max.push_back(m_next);
+    }
+    if (channel.head == channel.tail) {
+        return result;
+    }
+
+    const qint64 oldest = channel.times[m_history->slot(channel.head - 1)] - m_durationMs;
+    while (m_start < channel.head && channel.times[m_history->slot(m_start)] < oldest) {
+        ++m_start;
+    }
+    while (m_min.front() < m_start) {
+        m_min.pop_front();
+    }
+    while (m_max.front() < m_start) {
+        m_max.pop_front();
+    }
+
+    result.count = static_cast<int>(channel.head - m_start);
+    result.min = value(m_min.front());
+    result.max = value(m_max.front());
+    result.mean = m_history->sum(channel, m_start, channel.head) / result.count;
+    return result;
+}
@@ -0,0 +1,176 @@
+#ifndef TELEMETRYHISTORY_H
+#define TELEMETRYHISTORY_H
+
+#include <QtGlobal>
+#include <QString>
+#include <array>
+#include <deque>
+#include <memory>
+#include "vehiclemodel.h"
+
+/**
+ * @brief Fixed-memory, timestamped history of one vehicle's numeric telemetry
+ *
+ * Every numeric VehicleModel field (HISTORY_FIELDS) gets its own ring of
+ * samples, stored structure-of-arrays: timestamps, values and running sums
+ * are separate contiguous arrays, so scans and decimation touch only the
+ * array they need. All rings are allocated up front; appending never
+ * allocates and evicts the oldest sample in O(1).
+ *
+ * Capacity per field is duration * sampleRate, cut down if needed so the
+ * whole store stays under the byte cap. Samples older than the duration
+ * (relative to the newest sample of the same field) are dropped as well.
+ *
+ * record() stores the fields a VehicleModel batch changed; a field that
+ * holds steady is not re-recorded, so readers should treat the series as
+ * sample-and-hold. Timestamps are ms since the epoch and never go
+ * backwards within a field.
+ *
+ * Queries:
+ * - range(): samples in a time interval, binary search, no copy
+ * - stats(): count/min/max/mean of an interval; the mean is O(1) from the
+ *   running sums, min/max scan the interval
+ * - Window: min/max/mean of a trailing window that slides forward with
+ *   the data, amortized O(1) per new sample (monotonic deques)
+ *
+ * Not thread-safe: record and query on the thread that owns the model.
+ */
+class TelemetryHistory {
+public:
+    static constexpr qint64 DEFAULT_DURATION_MS = 10 * 60 * 1000;
+    static constexpr double DEFAULT_SAMPLE_RATE_HZ = 50.0;
+    static constexpr qint64 DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+    // Everything but the identity/display-string fields
+    static constexpr quint32 HISTORY_FIELDS =
+        VehicleModel::AllFields & ~(VehicleModel::SystemId | VehicleModel::ComponentId |
+                                    VehicleModel::AutopilotType | VehicleModel::VehicleType |
+                                    VehicleModel::FlightMode);
+
+    // timestamp + value + running sum
+    static constexpr int BYTES_PER_SAMPLE = sizeof(qint64) + 2 * sizeof(double);
+
+    struct Stats {
+        int count{0};
+        double min{0.0};
+        double max{0.0};
+        double mean{0.0};
+    };
+
+    /**
+     * @brief Samples of one field in a time interval, oldest first
+     *
+     * Points straight into the ring, so it is only valid until the next
+     * record() or clear(). The ring may wrap, giving two segments.
+     */
+    struct Range {
+        const qint64* times[2]{nullptr, nullptr};
+        const double* values[2]{nullptr, nullptr};
+        int sizes[2]{0, 0};
+
+        int size() const { return sizes[0] + sizes[1]; }
+        qint64 timeAt(int i) const {
+            return i < sizes[0] ? times[0][i] : times[1][i - sizes[0]];
+        }
+        double valueAt(int i) const {
+            return i < sizes[0] ? values[0][i] : values[1][i - sizes[0]];
+        }
+    };
+
+    /**
+     * @brief Statistics over the trailing @p durationMs of one field
+     *
+     * Keeps its own cursor into the history; each stats() call only looks
+     * at samples added since the previous call. If the history overwrote
+     * samples the window had not seen yet it restarts from the oldest one.
+     */
+    class Window {
+    public:
+        Window(const TelemetryHistory* history, VehicleModel::Field field, qint64 durationMs);
+
+        Stats stats();
+
+    private:
+        const TelemetryHistory* m_history;
+        int m_channel;
+        qint64 m_durationMs;
+        quint64 m_next;   // first sequence not yet pushed into the deques
+        quint64 m_start;  // first sequence inside the window
+        std::deque<quint64> m_min;  // sequences with increasing values
+        std::deque<quint64> m_max;  // sequences with decreasing values
+    };
+
+    explicit TelemetryHistory(qint64 durationMs = DEFAULT_DURATION_MS,
+                              double sampleRateHz = DEFAULT_SAMPLE_RATE_HZ,
+                              qint64 maxBytes = DEFAULT_MAX_BYTES);
+
+    TelemetryHistory(const TelemetryHistory&) = delete;
+    TelemetryHistory& operator=(const TelemetryHistory&) = delete;
+
+    /**
+     * @brief Append the @p changed fields of @p state at @p timestampMs
+     */
+    void record(qint64 timestampMs, const VehicleState& state, VehicleModel::Fields changed);
+
+    /**
+     * @brief Append one sample of one field
+     */
+    void append(VehicleModel::Field field, qint64 timestampMs, double value);
+
+    void clear();
+
+    Range range(VehicleModel::Field field, qint64 fromMs, qint64 toMs) const;
+    Stats stats(VehicleModel::Field field, qint64 fromMs, qint64 toMs) const;
+
+    int size(VehicleModel::Field field) const;
+    bool latest(VehicleModel::Field field, qint64* timestampMs, double* value) const;
+
+    /**
+     * @brief Value held at @p timestampMs: the newest sample at or before it
+     * @return false if the field has no sample that old
+     */
+    bool valueAt(VehicleModel::Field field, qint64 timestampMs, double* value) const;
+
+    qint64 duration() const { return m_durationMs; }
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief Bytes preallocated for all rings
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * @brief Value of @p field in @p state as a double, in display units
+     */
+    static double fieldValue(const VehicleState& state, VehicleModel::Field field);
+
+    /**
+     * @brief Human-readable name and unit of a history field
+     */
+    static QString fieldName(VehicleModel::Field field);
+    static QString fieldUnit(VehicleModel::Field field);
+
+private:
+    static constexpr int FIELD_COUNT = 24;
+
+    struct Channel {
+        std::unique_ptr<qint64[]> times;
+        std::unique_ptr<double[]> values;
+        std::unique_ptr<double[]> sumsBefore;  // sum of all earlier values, for O(1) means
+        quint64 head{0};                       // sequence of the next sample
+        quint64 tail{0};                       // sequence of the oldest sample kept
+        double total{0.0};
+    };
+
+    static int channelIndex(VehicleModel::Field field);
+
+    int slot(quint64 sequence) const { return static_cast<int>(sequence % m_capacity); }
+    quint64 lowerBound(const Channel& channel, qint64 timestampMs) const;
+    double sum(const Channel& channel, quint64 first, quint64 end) const;
+
+    qint64 m_durationMs;
+    int m_capacity;
+    std::array<Channel, FIELD_COUNT> m_channels;
+};
+
+#endif  // TELEMETRYHISTORY_H
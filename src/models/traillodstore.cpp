@@ -0,0 +1,151 @@
+#include "traillodstore.h"
+#include <QtMath>
+
+namespace {
+
+// Cell index along one axis; cells are aligned so that they nest across levels
+qint32 cellOf(qint32 value, qint64 cell) {
+    return qint32(value >= 0 ? value / cell : -((cell - 1 - qint64(value)) / cell));
+}
+
+void extend(TrailLodStore::Box& box, const TrailLodStore::Point& point) {
+    box.south = qMin(box.south, point.latitude);
+    box.north = qMax(box.north, point.latitude);
+    box.west = qMin(box.west, point.longitude);
+    box.east = qMax(box.east, point.longitude);
+}
+
+}  // namespace
+
+TrailLodStore::TrailLodStore() : m_size(0) {
+}
+
+void TrailLodStore::append(qint32 latitude, qint32 longitude) {
+    if (m_size % POINTS_PER_BLOCK == 0) {
+        m_blocks.push_back(std::make_unique<Point[]>(POINTS_PER_BLOCK));
+    }
+    const Point point{latitude, longitude};
+    const qint64 sequence = m_size++;
+    m_blocks.back()[sequence % POINTS_PER_BLOCK] = point;
+    addToBoxes(m_levels[0], int(sequence), point);
+
+    // A point in the same cell as a level's last vertex is in the same
+    // (larger) cell at every level above as well, so stop at the first one
+    for (int level = 1; level < LEVEL_COUNT; ++level) {
+        Level& lod = m_levels[size_t(level)];
+        const qint32 cellLatitude = cellOf(latitude, cellSize(level));
+        const qint32 cellLongitude = cellOf(longitude, cellSize(level));
+        const int index = storedCount(level);
+        if (index > 0 && cellLatitude == lod.cellLatitude && cellLongitude == lod.cellLongitude) {
+            break;
+        }
+        lod.cellLatitude = cellLatitude;
+        lod.cellLongitude = cellLongitude;
+        if (lod.vertices.empty() && index == storedCount(level - 1) - 1) {
+            ++lod.shared;
+        } else {
+            lod.vertices.push_back(quint32(sequence));
+        }
+        addToBoxes(lod, index, point);
+    }
+}
+
+void TrailLodStore::appendDegrees(double latitude, double longitude) {
+    if (!qIsFinite(latitude) || !qIsFinite(longitude)) {
+        return;
+    }
+    append(qint32(qRound64(latitude * 1e7)), qint32(qRound64(longitude * 1e7)));
+}
+
+void TrailLodStore::clear() {
+    m_blocks.clear();
+    m_size = 0;
+    m_levels.fill(Level());
+}
+
+int TrailLodStore::levelFor(double tolerance) {
+    if (!(tolerance >= BASE_CELL)) {
+        return 0;
+    }
+    const int level = 1 + int(std::floor(std::log2(tolerance / BASE_CELL)));
+    return qMin(level, LEVEL_COUNT - 1);
+}
+
+int TrailLodStore::vertexCount(int level) const {
+    const int stored = storedCount(level);
+    if (level == 0 || stored == 0) {
+        return stored;
+    }
+    return vertexSequence(level, stored - 1) == m_size - 1 ? stored : stored + 1;
+}
+
+qint64 TrailLodStore::vertexSequence(int level, int index) const {
+    if (index >= storedCount(level)) {
+        return m_size - 1;
+    }
+    while (level > 0 && quint32(index) < m_levels[size_t(level)].shared) {
+        --level;
+    }
+    if (level == 0) {
+        return index;
+    }
+    const Level& lod = m_levels[size_t(level)];
+    return lod.vertices[size_t(index) - lod.shared];
+}
+
+int TrailLodStore::nextVisibleSegment(int level, const Box& view, int from) const {
+    const Level& lod = m_levels[size_t(level)];
+    const int stored = storedCount(level);
+    const int segments = vertexCount(level) - 1;
+
+    int segment = qMax(0, from);
+    while (segment < segments) {
+        // The block box covers the segment once its end vertex is stored; the
+        // segment to the newest point (when not a stored vertex) never is
+        const size_t block = size_t(segment / BLOCK_SIZE);
+        if (segment + 1 < stored && !intersects(lod.boxes[block], view)) {
+            segment = qMin(int(block + 1) * BLOCK_SIZE, stored - 1);
+            continue;
+        }
+        const Point start = vertex(level, segment);
+        Box box{start.latitude, start.longitude, start.latitude, start.longitude};
+        extend(box, vertex(level, segment + 1));
+        if (intersects(box, view)) {
+            return segment;
+        }
+        ++segment;
+    }
+    return -1;
+}
+
+bool TrailLodStore::intersects(const Box& box, const Box& view) {
+    if (box.south > view.north || box.north < view.south) {
+        return false;
+    }
+    if (view.west <= view.east) {
+        return box.west <= view.east && box.east >= view.west;
+    }
+    return box.east >= view.west || box.west <= view.east;
+}
+
+qint64 TrailLodStore::memoryUsage() const {
+    qint64 bytes = qint64(m_blocks.size()) * POINTS_PER_BLOCK * qint64(sizeof(Point));
+    for (const Level& lod : m_levels) {
+        bytes += qint64(lod.vertices.capacity()) * qint64(sizeof(quint32));
+        bytes += qint64(lod.boxes.capacity()) * qint64(sizeof(Box));
+    }
+    return bytes;
+}
+
+void TrailLodStore::addToBoxes(Level& level, int index, const Point& point) {
+    const size_t block = size_t(index / BLOCK_SIZE);
+    if (block == level.boxes.size()) {
+        level.boxes.push_back(Box{point.latitude, point.longitude, point.latitude, point.longitude});
+    } else {
+        extend(level.boxes[block], point);
+    }
+    // The first vertex of a block closes the last segment of the previous one
+    if (index % BLOCK_SIZE == 0 && block > 0) {
+        extend(level.boxes[block - 1], point);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef TRAILLODSTORE_H
+#define TRAILLODSTORE_H
+
+#include <QtGlobal>
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Unbounded flight trail with grid-snapped level-of-detail levels
+ *
+ * The full-resolution history is kept in memory as degE7 integer pairs
+ * (8 bytes per point) in fixed-size blocks, so appending never moves
+ * earlier points. With the levels below, a flight at about 1 m between
+ * points takes some 20 bytes per point: 7 MiB for 10 h at 10 Hz.
+ *
+ * Level 0 is every point. Level k > 0 keeps a point only when it lies in
+ * a different cell of a grid of cellSize(k) than the level's previous
+ * vertex; cells double in size per level and nest, so each level is a
+ * subset of the one below it. Vertices are stored as point sequence
+ * numbers (4 bytes each) and never change once kept, which makes the
+ * levels incremental: append() is O(1) amortized and only visits the
+ * levels that keep the point. Every skipped point shares a cell with the
+ * level's previous vertex, so a level is within one cell of the full path.
+ * While a level has kept every vertex of the one below (cells smaller than
+ * the spacing of the points) it shares them instead of storing a copy.
+ *
+ * Each level also ends in the newest point, as a last vertex that moves
+ * with every append until the level keeps a real vertex after it.
+ *
+ * For culling, every BLOCK_SIZE vertices of a level have a bounding box
+ * (which also holds the first vertex of the next block, so it covers every
+ * segment starting in the block); nextVisibleSegment() skips whole blocks.
+ *
+ * Not thread-safe.
+ */
+class TrailLodStore {
+public:
+    static constexpr int LEVEL_COUNT = 20;
+    static constexpr qint32 BASE_CELL = 32;  // degE7 (3.6 m of latitude), about 1 px at zoom 19
+    static constexpr int BLOCK_SIZE = 256;
+    static constexpr int POINTS_PER_BLOCK = 4096;
+
+    struct Point {
+        qint32 latitude;  // degE7
+        qint32 longitude;
+    };
+
+    // degE7; west > east for a box across the antimeridian
+    struct Box {
+        qint32 south;
+        qint32 west;
+        qint32 north;
+        qint32 east;
+    };
+
+    TrailLodStore();
+
+    void append(qint32 latitude, qint32 longitude);
+    /**
+     * @brief Append a point given in degrees; non-finite positions are skipped
+     */
+    void appendDegrees(double latitude, double longitude);
+    void clear();
+
+    qint64 size() const { return m_size; }
+    Point point(qint64 sequence) const {
+        return m_blocks[size_t(sequence / POINTS_PER_BLOCK)][sequence % POINTS_PER_BLOCK];
+    }
+
+    static qint64 cellSize(int level) { return level > 0 ? qint64(BASE_CELL) << (level - 1) : 0; }
+
+    /**
+     * @brief Coarsest level whose cells are no larger than @p tolerance (degE7)
+     */
+    static int levelFor(double tolerance);
+
+    // Vertices of a level, oldest first, ending in the newest point
+    int vertexCount(int level) const;
+    qint64 vertexSequence(int level, int index) const;
+    Point vertex(int level, int index) const { return point(vertexSequence(level, index)); }
+
+    /**
+     * @brief First segment (vertex i to i + 1) at or after @p from whose
+     * bounding box meets @p view, or -1
+     */
+    int nextVisibleSegment(int level, const Box& view, int from) const;
+
+    static bool intersects(const Box& box, const Box& view);
+
+    qint64 memoryUsage() const;
+
+private:
+    struct Level {
+        quint32 shared{0};              // leading vertices the same as the level below
+        std::vector<quint32> vertices;  // point sequences of the rest; empty for level 0
+        std::vector<Box> boxes;         // one per BLOCK_SIZE vertices
+        qint32 cellLatitude{0};         // cell of the last vertex
+        qint32 cellLongitude{0};
+    };
+
+    int storedCount(int level) const {
+        const Level& lod = m_levels[size_t(level)];
+        return level == 0 ? int(m_size) : int(lod.shared + lod.vertices.size());
+    }
+    static void addToBoxes(Level& level, int index, const Point& point);
+
+    std::vector<std::unique_ptr<Point[]>> m_blocks;
+    qint64 m_size;
+    std::array<Level, LEVEL_COUNT> m_levels;
+};
+
+#endif  // TRAILLODSTORE_H
@@ -0,0 +1,215 @@
+#include "trailmodel.h"
+#include <QTimer>
+#include <QtMath>
+
+namespace {
+
+constexpr qint64 FULL_TURN = 3600000000LL;  // degE7
+
+qint32 toE7(double degrees) {
+    return qint32(qRound64(degrees * 1e7));
+}
+
+// Longitude interval with east >= west, possibly past 180 deg
+void unwrap(const TrailLodStore::Box& box, qint64* west, qint64* east) {
+    *west = box.west;
+    *east = box.west <= box.east ? box.east : box.east + FULL_TURN;
+}
+
+bool contains(const TrailLodStore::Box& outer, const TrailLodStore::Box& inner) {
+    if (inner.north > outer.north || inner.south < outer.south) {
+        return false;
+    }
+    qint64 outerWest = 0;
+    qint64 outerEast = 0;
+    qint64 innerWest = 0;
+    qint64 innerEast = 0;
+    unwrap(outer, &outerWest, &outerEast);
+    unwrap(inner, &innerWest, &innerEast);
+    for (qint64 shift : {qint64(0), FULL_TURN, -FULL_TURN}) {
+        if (innerWest + shift >= outerWest && innerEast + shift <= outerEast) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TrailModel::TrailModel(QObject* parent)
+    : QAbstractListModel(parent), m_store(&m_ownStore),
+      m_cover{-900000000, -1800000000, 900000000, 1800000000}, m_level(0), m_layoutDirty(false),
+      m_shownSize(0), m_shownVertices(0), m_flushTimer(new QTimer(this)) {
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FRAME_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &TrailModel::flush);
+}
+
+void TrailModel::append(double latitude, double longitude) {
+    m_store->appendDegrees(latitude, longitude);
+    scheduleFlush();
+}
+
+void TrailModel::clear() {
+    m_flushTimer->stop();
+    beginResetModel();
+    m_store->clear();
+    m_rowRanges.clear();
+    m_shownSize = 0;
+    m_shownVertices = 0;
+    endResetModel();
+}
+
+void TrailModel::setStore(TrailLodStore* store) {
+    if (!store) {
+        store = &m_ownStore;
+    }
+    if (store == m_store) {
+        return;
+    }
+    m_store = store;
+    m_layoutDirty = true;
+    flush();
+}
+
+QGeoCoordinate TrailModel::pointAt(qint64 index) const {
+    if (index < 0 || index >= size()) {
+        return QGeoCoordinate();
+    }
+    const TrailLodStore::Point point = m_store->point(index);
+    return QGeoCoordinate(point.latitude / 1e7, point.longitude / 1e7);
+}
+
+void TrailModel::setViewport(double north, double west, double south, double east, int width,
+                             int height) {
+    if (width <= 0 || height <= 0 || !(north > south)) {
+        return;
+    }
+    const double lonSpan = west <= east ? east - west : east + 360.0 - west;
+    const double latSpan = north - south;
+
+    // Coarsest level that stays within the tolerance on both axes
+    const double tolerance = qMin(lonSpan / width, latSpan / height) * 1e7 * TOLERANCE_PIXELS;
+    const int level = TrailLodStore::levelFor(tolerance);
+    const TrailLodStore::Box view{toE7(south), toE7(west), toE7(north), toE7(east)};
+    if (level == m_level && contains(m_cover, view)) {
+        return;
+    }
+
+    const double latMargin = latSpan * VIEWPORT_MARGIN;
+    const double lonMargin = lonSpan * VIEWPORT_MARGIN;
+    north = qMin(north + latMargin, 90.0);
+    south = qMax(south - latMargin, -90.0);
+    if (lonSpan + 2 * lonMargin >= 360.0) {
+        west = -180.0;
+        east = 180.0;
+    } else {
+        west = west - lonMargin < -180.0 ? west - lonMargin + 360.0 : west - lonMargin;
+        east = east + lonMargin > 180.0 ? east + lonMargin - 360.0 : east + lonMargin;
+    }
+    m_cover = {toE7(south), toE7(west), toE7(north), toE7(east)};
+    m_level = level;
+    m_layoutDirty = true;
+    scheduleFlush();
+}
+
+void TrailModel::scheduleFlush() {
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void TrailModel::flush() {
+    m_flushTimer->stop();
+    if (m_layoutDirty) {
+        rebuild();
+    } else if (m_store->size() != m_shownSize) {
+        update();
+    }
+}
+
+bool TrailModel::appendSegments(int from, Row* tail, QVector<Row>* added) const {
+    bool tailGrew = false;
+    for (int segment = m_store->nextVisibleSegment(m_level, m_cover, from); segment >= 0;
+         segment = m_store->nextVisibleSegment(m_level, m_cover, segment + 1)) {
+        Row* run = added->isEmpty() ? tail : &added->last();
+        if (run && run->last == segment && run->last - run->first < CHUNK_SIZE) {
+            run->last = segment + 1;
+            tailGrew = tailGrew || run == tail;
+        } else {
+            added->append(Row{segment, segment + 1});
+        }
+    }
+    return tailGrew;
+}
+
+void TrailModel::rebuild() {
+    beginResetModel();
+    m_rowRanges.clear();
+    appendSegments(0, nullptr, &m_rowRanges);
+    m_shownSize = m_store->size();
+    m_shownVertices = m_store->vertexCount(m_level);
+    m_layoutDirty = false;
+    endResetModel();
+}
+
+void TrailModel::update() {
+    // The last vertex shown may have been the newest point, which has moved
+    // on since: re-check the segment ending in it along with the new ones
+    const int from = qMax(0, m_shownVertices - 2);
+    const int rows = m_rowRanges.size();
+    Row tail = rows > 0 ? m_rowRanges.last() : Row{0, 0};
+    const bool tailTrimmed = rows > 0 && tail.last > from;
+    if (tailTrimmed) {
+        tail.last = from;
+    }
+
+    QVector<Row> added;
+    const bool tailGrew = appendSegments(from, rows > 0 ? &tail : nullptr, &added);
+    m_shownSize = m_store->size();
+    m_shownVertices = m_store->vertexCount(m_level);
+
+    if (rows > 0 && tail.first == tail.last) {
+        // The last row lost its only segment: reuse it for the first new row
+        if (added.isEmpty()) {
+            beginRemoveRows(QModelIndex(), rows - 1, rows - 1);
+            m_rowRanges.removeLast();
+            endRemoveRows();
+        } else {
+            m_rowRanges.last() = added.takeFirst();
+            emit dataChanged(index(rows - 1), index(rows - 1), {PathRole});
+        }
+    } else if (tailTrimmed || tailGrew) {
+        m_rowRanges.last() = tail;
+        emit dataChanged(index(rows - 1), index(rows - 1), {PathRole});
+    }
+
+    if (!added.isEmpty()) {
+        const int first = m_rowRanges.size();
+        beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+        m_rowRanges.append(added);
+        endInsertRows();
+    }
+}
+
+int TrailModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_rowRanges.size();
+}
+
+QVariant TrailModel::data(const QModelIndex& index, int role) const {
+    if (role != PathRole || index.row() < 0 || index.row() >= m_rowRanges.size()) {
+        return QVariant();
+    }
+    const Row& row = m_rowRanges.at(index.row());
+    QList<QGeoCoordinate> path;
+    path.reserve(row.last - row.first + 1);
+    for (int i = row.first; i <= row.last; ++i) {
+        const TrailLodStore::Point point = m_store->vertex(m_level, i);
+        path.append(QGeoCoordinate(point.latitude / 1e7, point.longitude / 1e7));
+    }
+    return QVariant::fromValue(path);
+}
+
+QHash<int, QByteArray> TrailModel::roleNames() const {
+    return {{PathRole, "path"}};
+}
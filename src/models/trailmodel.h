@@ -0,0 +1,125 @@
+#ifndef TRAILMODEL_H
+#define TRAILMODEL_H
+
+#include <QAbstractListModel>
+#include <QGeoCoordinate>
+#include <QList>
+#include <QVector>
+#include "traillodstore.h"
+
+class QTimer;
+
+/**
+ * @brief Flight trail exposed to QML at the detail the map can show
+ *
+ * The whole flight is kept in a TrailLodStore: the model's own, or one
+ * set with setStore() whose owner appends to it and then calls
+ * pointsAppended(). The rows hold only the
+ * part of one level-of-detail level that is on screen: the level whose
+ * cells are at most TOLERANCE_PIXELS wide at the current zoom, and the
+ * segments whose bounding box meets the viewport. A MapItemView in
+ * MapView.qml draws each row as its own MapPolyline bound to the "path"
+ * role.
+ *
+ * A row is a run of consecutive visible segments, at most CHUNK_SIZE of
+ * them; a run that is longer continues in the next row, which repeats the
+ * shared vertex so the polylines join up.
+ *
+ * Updates are applied once per frame (FRAME_INTERVAL_MS after the first
+ * change):
+ * - appends only touch the newest segments, so they reach QML as a
+ *   dataChanged() for the last row and/or the insertion of new rows;
+ * - the rows cover the viewport plus VIEWPORT_MARGIN on every side, so
+ *   panning within that area changes nothing; leaving it, or zooming to
+ *   another level, resets the model from the store, at a cost of the
+ *   visible vertices plus one box test per BLOCK_SIZE vertices.
+ *
+ * Until setViewport() is called the rows show the whole trail at full
+ * resolution. GUI thread only.
+ */
+class TrailModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        PathRole = Qt::UserRole + 1,
+    };
+
+    static constexpr int CHUNK_SIZE = 256;
+    static constexpr int FRAME_INTERVAL_MS = 16;
+    static constexpr double VIEWPORT_MARGIN = 0.5;  // of the view's size
+    static constexpr double TOLERANCE_PIXELS = 1.0;
+
+    explicit TrailModel(QObject* parent = nullptr);
+
+    /**
+     * @brief Append a point (deg)
+     */
+    void append(double latitude, double longitude);
+    void clear();
+
+    /**
+     * @brief Show the trail in @p store, owned by the caller; nullptr for the model's own
+     *
+     * Resets the rows from the new store. The store must outlive its use here.
+     */
+    void setStore(TrailLodStore* store);
+
+    /**
+     * @brief Show points the owner of the store appended, next frame
+     */
+    void pointsAppended() { scheduleFlush(); }
+
+    qint64 size() const { return m_store->size(); }
+    QGeoCoordinate pointAt(qint64 index) const;  // 0 = first point of the flight
+    const TrailLodStore& store() const { return *m_store; }
+    int level() const { return m_level; }  // of the rows
+
+    /**
+     * @brief Show the trail for a view of @p width x @p height pixels
+     *
+     * Corners are in degrees; west > east for a view across the antimeridian.
+     */
+    Q_INVOKABLE void setViewport(double north, double west, double south, double east, int width,
+                                 int height);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+public slots:
+    /**
+     * @brief Apply pending appends and viewport changes to the rows now
+     */
+    void flush();
+
+private:
+    // Vertices first .. last of m_level
+    struct Row {
+        int first;
+        int last;
+    };
+
+    void scheduleFlush();
+    void rebuild();
+    void update();
+
+    // Add the visible segments from @p from on to the run ending in *tail
+    // (if any) and to new rows in @p added; returns whether *tail grew
+    bool appendSegments(int from, Row* tail, QVector<Row>* added) const;
+
+    TrailLodStore m_ownStore;
+    TrailLodStore* m_store;  // m_ownStore unless setStore() says otherwise
+    QVector<Row> m_rowRanges;
+    TrailLodStore::Box m_cover;  // what the rows cover: the viewport plus margin
+    int m_level;
+    bool m_layoutDirty;
+
+    // The store as of the last flush()
+    qint64 m_shownSize;
+    int m_shownVertices;
+
+    QTimer* m_flushTimer;
+};
+
+#endif  // TRAILMODEL_H
@@ -1,101 +1,202 @@
 #include "vehiclemodel.h"
 #include "mavlink/common/mavlink.h"
+#include "../comm/latencytrace.h"
+#include <QTimer>
 #include <QtMath>
 
 VehicleModel::VehicleModel(QObject* parent)
-    : QObject(parent), m_systemId(0), m_componentId(0), m_armed(false), m_autopilotEnum(0),
-      m_roll(0.0f), m_pitch(0.0f), m_yaw(0.0f), m_rollSpeed(0.0f), m_pitchSpeed(0.0f),
-      m_yawSpeed(0.0f), m_latitude(0.0), m_longitude(0.0), m_altitude(0.0f),
-      m_relativeAltitude(0.0f), m_heading(0), m_groundSpeed(0.0f), m_airSpeed(0.0f),
-      m_climbRate(0.0f), m_batteryVoltage(0.0f), m_batteryCurrent(0.0f), m_batteryRemaining(0),
-      m_throttle(0) {}
+    : QObject(parent), m_updateDepth(0), m_notifyIntervalMs(DEFAULT_NOTIFY_INTERVAL_MS),
+      m_notifyTimer(new QTimer(this)) {
+    m_notifyTimer->setSingleShot(true);
+    m_notifyTimer->setInterval(m_notifyIntervalMs);
+    connect(m_notifyTimer, &QTimer::timeout, this, [this]() {
+        // Keep throttling while changes keep coming; go idle once they stop
+        if (m_pendingNotify) {
+            emitPropertySignals();
+            m_notifyTimer->start();
+        }
+    });
+}
 
-void VehicleModel::setSystemId(uint8_t id) {
-    if (m_systemId != id) {
-        m_systemId = id;
-        emit systemIdChanged(m_systemId);
+void VehicleModel::beginUpdate() {
+    ++m_updateDepth;
+}
+
+void VehicleModel::endUpdate() {
+    Q_ASSERT(m_updateDepth > 0);
+    if (--m_updateDepth > 0 || (!m_dirty && !m_unpublished)) {
+        return;
+    }
+
+    // Readers on other threads see the whole batch or none of it
+    m_snapshot.store(m_state);
+    m_unpublished = false;
+    if (!m_dirty) {
+        return;
+    }
+
+    const Fields changed = m_dirty;
+    m_dirty = {};
+    emit stateChanged(changed);
+
+    m_pendingNotify |= changed;
+    if (m_notifyIntervalMs <= 0) {
+        emitPropertySignals();
+    } else if (!m_notifyTimer->isActive()) {
+        // First change after a quiet period goes out at once
+        emitPropertySignals();
+        m_notifyTimer->start();
     }
 }
 
-void VehicleModel::setComponentId(uint8_t id) {
-    if (m_componentId != id) {
-        m_componentId = id;
-        emit componentIdChanged(m_componentId);
+void VehicleModel::setNotifyInterval(int ms) {
+    m_notifyIntervalMs = qMax(0, ms);
+    m_notifyTimer->setInterval(m_notifyIntervalMs);
+    if (m_notifyIntervalMs == 0) {
+        m_notifyTimer->stop();
+        emitPropertySignals();
+    }
+}
+
+void VehicleModel::emitPropertySignals() {
+    const Fields fields = m_pendingNotify;
+    m_pendingNotify = {};
+    if (!fields) {
+        return;
+    }
+
+    if (fields & SystemId) {
+        emit systemIdChanged(m_state.systemId);
+    }
+    if (fields & ComponentId) {
+        emit componentIdChanged(m_state.componentId);
+    }
+    if (fields & AutopilotType) {
+        emit autopilotTypeChanged(m_autopilotType);
     }
+    if (fields & VehicleType) {
+        emit vehicleTypeChanged(m_vehicleType);
+    }
+    if (fields & FlightMode) {
+        emit flightModeChanged(m_flightMode);
+    }
+    if (fields & Armed) {
+        emit armedChanged(m_state.armed);
+    }
+
+    if (fields & Roll) {
+        emit rollChanged(m_state.roll);
+    }
+    if (fields & Pitch) {
+        emit pitchChanged(m_state.pitch);
+    }
+    if (fields & Yaw) {
+        emit yawChanged(m_state.yaw);
+    }
+    if (fields & RollSpeed) {
+        emit rollSpeedChanged(m_state.rollSpeed);
+    }
+    if (fields & PitchSpeed) {
+        emit pitchSpeedChanged(m_state.pitchSpeed);
+    }
+    if (fields & YawSpeed) {
+        emit yawSpeedChanged(m_state.yawSpeed);
+    }
+
+    if (fields & Latitude) {
+        emit latitudeChanged(m_state.latitude);
+    }
+    if (fields & Longitude) {
+        emit longitudeChanged(m_state.longitude);
+    }
+    if (fields & Altitude) {
+        emit altitudeChanged(m_state.altitude);
+    }
+    if (fields & RelativeAltitude) {
+        emit relativeAltitudeChanged(m_state.relativeAltitude);
+    }
+    if (fields & Heading) {
+        emit headingChanged(m_state.heading);
+    }
+
+    if (fields & GroundSpeed) {
+        emit groundSpeedChanged(m_state.groundSpeed);
+    }
+    if (fields & AirSpeed) {
+        emit airSpeedChanged(m_state.airSpeed);
+    }
+    if (fields & ClimbRate) {
+        emit climbRateChanged(m_state.climbRate);
+    }
+
+    if (fields & BatteryVoltage) {
+        emit batteryVoltageChanged(m_state.batteryVoltage);
+    }
+    if (fields & BatteryCurrent) {
+        emit batteryCurrentChanged(m_state.batteryCurrent);
+    }
+    if (fields & BatteryRemaining) {
+        emit batteryRemainingChanged(m_state.batteryRemaining);
+    }
+
+    if (fields & Throttle) {
+        emit throttleChanged(m_state.throttle);
+    }
+}
+
+void VehicleModel::setSystemId(uint8_t id) {
+    UpdateBatch batch(this);
+    assign(m_state.systemId, id, SystemId);
+}
+
+void VehicleModel::setComponentId(uint8_t id) {
+    UpdateBatch batch(this);
+    assign(m_state.componentId, id, ComponentId);
 }
 
 void VehicleModel::handleHeartbeat(uint8_t systemId, uint8_t componentId, uint8_t autopilot,
                                    uint8_t type, uint8_t systemStatus, uint8_t baseMode,
                                    uint32_t customMode) {
     Q_UNUSED(systemStatus)
+    UpdateBatch batch(this);
 
     setSystemId(systemId);
     setComponentId(componentId);
 
     // Decode autopilot type
-    if (m_autopilotEnum != autopilot) {
-        m_autopilotEnum = autopilot;
-        m_autopilotType = decodeAutopilotType(autopilot);
-        emit autopilotTypeChanged(m_autopilotType);
+    if (m_state.autopilot != autopilot) {
+        assignUnsignalled(m_state.autopilot, autopilot);
+        assign(m_autopilotType, decodeAutopilotType(autopilot), AutopilotType);
     }
 
     // Decode vehicle type
-    QString vehicleType = decodeVehicleType(type);
-    if (m_vehicleType != vehicleType) {
-        m_vehicleType = vehicleType;
-        emit vehicleTypeChanged(m_vehicleType);
-    }
+    assignUnsignalled(m_state.vehicleType, type);
+    assign(m_vehicleType, decodeVehicleType(type), VehicleType);
 
     // Check armed state
-    bool armed = (baseMode & MAV_MODE_FLAG_SAFETY_ARMED) != 0;
-    if (m_armed != armed) {
-        m_armed = armed;
-        emit armedChanged(m_armed);
-    }
+    assign(m_state.armed, (baseMode & MAV_MODE_FLAG_SAFETY_ARMED) != 0, Armed);
 
     // Decode flight mode
-    QString flightMode = decodeFlightMode(baseMode, customMode);
-    if (m_flightMode != flightMode) {
-        m_flightMode = flightMode;
-        emit flightModeChanged(m_flightMode);
-    }
+    assignUnsignalled(m_state.baseMode, baseMode);
+    assignUnsignalled(m_state.customMode, customMode);
+    assign(m_flightMode, decodeFlightMode(baseMode, customMode), FlightMode);
 }
 
 void VehicleModel::handleAttitude(float roll, float pitch, float yaw, float rollspeed,
-                                  float pitchspeed, float yawspeed) {
-    // Convert from radians to degrees
-    float rollDeg = qRadiansToDegrees(roll);
-    float pitchDeg = qRadiansToDegrees(pitch);
-    float yawDeg = qRadiansToDegrees(yaw);
+                                  float pitchspeed, float yawspeed, quint64 traceKey) {
+    UpdateBatch batch(this);
 
-    if (!qFuzzyCompare(m_roll, rollDeg)) {
-        m_roll = rollDeg;
-        emit rollChanged(m_roll);
-    }
-
-    if (!qFuzzyCompare(m_pitch, pitchDeg)) {
-        m_pitch = pitchDeg;
-        emit pitchChanged(m_pitch);
-    }
-
-    if (!qFuzzyCompare(m_yaw, yawDeg)) {
-        m_yaw = yawDeg;
-        emit yawChanged(m_yaw);
-    }
-
-    if (!qFuzzyCompare(m_rollSpeed, rollspeed)) {
-        m_rollSpeed = rollspeed;
-        emit rollSpeedChanged(m_rollSpeed);
-    }
-
-    if (!qFuzzyCompare(m_pitchSpeed, pitchspeed)) {
-        m_pitchSpeed = pitchspeed;
-        emit pitchSpeedChanged(m_pitchSpeed);
-    }
-
-    if (!qFuzzyCompare(m_yawSpeed, yawspeed)) {
-        m_yawSpeed = yawspeed;
-        emit yawSpeedChanged(m_yawSpeed);
+    // Convert from radians to degrees
+    assign(m_state.roll, qRadiansToDegrees(roll), Roll);
+    assign(m_state.pitch, qRadiansToDegrees(pitch), Pitch);
+    assign(m_state.yaw, qRadiansToDegrees(yaw), Yaw);
+    assign(m_state.rollSpeed, rollspeed, RollSpeed);
+    assign(m_state.pitchSpeed, pitchspeed, PitchSpeed);
+    assign(m_state.yawSpeed, yawspeed, YawSpeed);
+
+    assignUnsignalled(m_state.attitudeTraceKey, traceKey);
+    if (traceKey) {
+        LatencyTrace::instance().record(LatencyTrace::ModelUpdate, traceKey);
     }
 }
 
@@ -104,95 +205,42 @@ void VehicleModel::handleGlobalPosition(int32_t lat, int32_t lon, int32_t alt, i
     Q_UNUSED(vx)
     Q_UNUSED(vy)
     Q_UNUSED(vz)
+    UpdateBatch batch(this);
 
     // Convert from 1E7 to degrees
-    double latitude = lat / 1e7;
-    double longitude = lon / 1e7;
-
-    if (!qFuzzyCompare(m_latitude, latitude)) {
-        m_latitude = latitude;
-        emit latitudeChanged(m_latitude);
-    }
-
-    if (!qFuzzyCompare(m_longitude, longitude)) {
-        m_longitude = longitude;
-        emit longitudeChanged(m_longitude);
-    }
+    assign(m_state.latitude, lat / 1e7, Latitude);
+    assign(m_state.longitude, lon / 1e7, Longitude);
 
     // Convert from millimeters to meters
-    float altitude = alt / 1000.0f;
-    float relAlt = relativeAlt / 1000.0f;
-
-    if (!qFuzzyCompare(m_altitude, altitude)) {
-        m_altitude = altitude;
-        emit altitudeChanged(m_altitude);
-    }
-
-    if (!qFuzzyCompare(m_relativeAltitude, relAlt)) {
-        m_relativeAltitude = relAlt;
-        emit relativeAltitudeChanged(m_relativeAltitude);
-    }
+    assign(m_state.altitude, alt / 1000.0f, Altitude);
+    assign(m_state.relativeAltitude, relativeAlt / 1000.0f, RelativeAltitude);
 
     // Convert heading from centidegrees to degrees
-    uint16_t headingDeg = heading / 100;
-    if (m_heading != headingDeg) {
-        m_heading = headingDeg;
-        emit headingChanged(m_heading);
-    }
+    assign(m_state.heading, static_cast<uint16_t>(heading / 100), Heading);
 }
 
 void VehicleModel::handleVfrHud(float airspeed, float groundspeed, int16_t heading,
                                 uint16_t throttle, float alt, float climb) {
-    if (!qFuzzyCompare(m_airSpeed, airspeed)) {
-        m_airSpeed = airspeed;
-        emit airSpeedChanged(m_airSpeed);
-    }
-
-    if (!qFuzzyCompare(m_groundSpeed, groundspeed)) {
-        m_groundSpeed = groundspeed;
-        emit groundSpeedChanged(m_groundSpeed);
-    }
-
-    if (m_heading != static_cast<uint16_t>(heading)) {
-        m_heading = static_cast<uint16_t>(heading);
-        emit headingChanged(m_heading);
-    }
-
-    if (m_throttle != throttle) {
-        m_throttle = throttle;
-        emit throttleChanged(m_throttle);
-    }
-
-    if (!qFuzzyCompare(m_altitude, alt)) {
-        m_altitude = alt;
-        emit altitudeChanged(m_altitude);
-    }
-
-    if (!qFuzzyCompare(m_climbRate, climb)) {
-        m_climbRate = climb;
-        emit climbRateChanged(m_climbRate);
-    }
+    UpdateBatch batch(this);
+
+    assign(m_state.airSpeed, airspeed, AirSpeed);
+    assign(m_state.groundSpeed, groundspeed, GroundSpeed);
+    assign(m_state.heading, static_cast<uint16_t>(heading), Heading);
+    assign(m_state.throttle, throttle, Throttle);
+    assign(m_state.altitude, alt, Altitude);
+    assign(m_state.climbRate, climb, ClimbRate);
 }
 
 void VehicleModel::handleBatteryStatus(uint16_t voltage, int16_t current, int8_t remaining) {
+    UpdateBatch batch(this);
+
     // Convert from millivolts to volts
-    float volts = voltage / 1000.0f;
-    if (!qFuzzyCompare(m_batteryVoltage, volts)) {
-        m_batteryVoltage = volts;
-        emit batteryVoltageChanged(m_batteryVoltage);
-    }
+    assign(m_state.batteryVoltage, voltage / 1000.0f, BatteryVoltage);
 
     // Convert from centiamps to amps
-    float amps = current / 100.0f;
-    if (!qFuzzyCompare(m_batteryCurrent, amps)) {
-        m_batteryCurrent = amps;
-        emit batteryCurrentChanged(m_batteryCurrent);
-    }
+    assign(m_state.batteryCurrent, current / 100.0f, BatteryCurrent);
 
-    if (m_batteryRemaining != remaining) {
-        m_batteryRemaining = remaining;
-        emit batteryRemainingChanged(m_batteryRemaining);
-    }
+    assign(m_state.batteryRemaining, static_cast<int>(remaining), BatteryRemaining);
 }
 
 QString VehicleModel::decodeAutopilotType(uint8_t autopilot) {
@@ -283,7 +331,7 @@ QString VehicleModel::decodeVehicleType(uint8_t type) {
 
 QString VehicleModel::decodeFlightMode(uint8_t baseMode, uint32_t customMode) {
     // For ArduPilot (most common), custom mode directly maps to flight mode
-    if (m_autopilotEnum == MAV_AUTOPILOT_ARDUPILOTMEGA) {
+    if (m_state.autopilot == MAV_AUTOPILOT_ARDUPILOTMEGA) {
         // ArduCopter modes
         switch (customMode) {
             case 0:
@@ -3,12 +3,80 @@
 
 #include <QObject>
 #include <QString>
+#include "../comm/seqlock.h"
+
+class QTimer;
+
+/**
+ * @brief Plain copy of the vehicle state, in display units
+ *
+ * VehicleModel publishes one through a SeqLock after every update batch;
+ * see VehicleModel::snapshot().
+ */
+struct VehicleState {
+    // HEARTBEAT
+    uint8_t systemId{0};
+    uint8_t componentId{0};
+    uint8_t autopilot{0};    // MAV_AUTOPILOT
+    uint8_t vehicleType{0};  // MAV_TYPE
+    uint8_t baseMode{0};     // MAV_MODE_FLAG bits
+    uint32_t customMode{0};
+    bool armed{false};
+
+    // Attitude (deg, rad/s)
+    float roll{0.0f};
+    float pitch{0.0f};
+    float yaw{0.0f};
+    float rollSpeed{0.0f};
+    float pitchSpeed{0.0f};
+    float yawSpeed{0.0f};
+
+    // Position (deg, m)
+    double latitude{0.0};
+    double longitude{0.0};
+    float altitude{0.0f};
+    float relativeAltitude{0.0f};
+    uint16_t heading{0};
+
+    // Velocity (m/s)
+    float groundSpeed{0.0f};
+    float airSpeed{0.0f};
+    float climbRate{0.0f};
+
+    // Battery (V, A, %)
+    float batteryVoltage{0.0f};
+    float batteryCurrent{0.0f};
+    int batteryRemaining{0};
+
+    uint16_t throttle{0};  // %
+
+    quint64 attitudeTraceKey{0};  // LatencyTrace key of the attitude, 0 when not tracing
+};
 
 /**
- * @brief Model representing the vehicle's state and telemetry
+ * @brief Model representing one vehicle's state and telemetry
  *
  * All properties use Q_PROPERTY for automatic notification and QML binding.
  * This class aggregates all primary telemetry data from the vehicle.
+ * VehicleRegistry creates one per vehicle heard and routes only that
+ * vehicle's messages to it.
+ *
+ * Changes are applied in batches: each handle*() call, or a whole time
+ * slice wrapped in an UpdateBatch, updates the fields and then emits a
+ * single stateChanged() carrying the bitmask of fields that changed. C++
+ * consumers should connect to stateChanged() and test the bits they need.
+ *
+ * The per-property NOTIFY signals are kept for QML bindings but throttled
+ * to at most one emission per property every notifyInterval() ms: the first
+ * change after a quiet period is signalled at once, later changes within
+ * the interval are coalesced and signalled with the latest value when it
+ * expires.
+ *
+ * The raw state lives in a VehicleState that is published through a
+ * SeqLock when each batch ends. snapshot() returns a consistent copy from
+ * any thread without locking, so recorders and exporters never see a
+ * half-applied message; the setters and handlers must be called on the
+ * model's own thread.
  */
 class VehicleModel : public QObject {
     Q_OBJECT
@@ -50,38 +118,117 @@ class VehicleModel : public QObject {
     Q_PROPERTY(uint16_t throttle READ throttle NOTIFY throttleChanged)
 
 public:
+    enum Field : quint32 {
+        SystemId = 1u << 0,
+        ComponentId = 1u << 1,
+        AutopilotType = 1u << 2,
+        VehicleType = 1u << 3,
+        FlightMode = 1u << 4,
+        Armed = 1u << 5,
+        Roll = 1u << 6,
+        Pitch = 1u << 7,
+        Yaw = 1u << 8,
+        RollSpeed = 1u << 9,
+        PitchSpeed = 1u << 10,
+        YawSpeed = 1u << 11,
+        Latitude = 1u << 12,
+        Longitude = 1u << 13,
+        Altitude = 1u << 14,
+        RelativeAltitude = 1u << 15,
+        Heading = 1u << 16,
+        GroundSpeed = 1u << 17,
+        AirSpeed = 1u << 18,
+        ClimbRate = 1u << 19,
+        BatteryVoltage = 1u << 20,
+        BatteryCurrent = 1u << 21,
+        BatteryRemaining = 1u << 22,
+        Throttle = 1u << 23,
+
+        AttitudeFields = Roll | Pitch | Yaw | RollSpeed | PitchSpeed | YawSpeed,
+        PositionFields = Latitude | Longitude | Altitude | RelativeAltitude | Heading,
+        AllFields = (1u << 24) - 1,
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+    Q_FLAG(Fields)
+
+    /**
+     * @brief Defers stateChanged() until the outermost batch ends
+     */
+    class UpdateBatch {
+    public:
+        explicit UpdateBatch(VehicleModel* model) : m_model(model) { m_model->beginUpdate(); }
+        ~UpdateBatch() { m_model->endUpdate(); }
+        UpdateBatch(const UpdateBatch&) = delete;
+        UpdateBatch& operator=(const UpdateBatch&) = delete;
+
+    private:
+        VehicleModel* m_model;
+    };
+
+    static constexpr int DEFAULT_NOTIFY_INTERVAL_MS = 50;
+
     explicit VehicleModel(QObject* parent = nullptr);
 
+    /**
+     * @brief Start/end a batch of updates; batches nest
+     *
+     * stateChanged() is emitted once when the outermost batch ends, if
+     * anything changed. Prefer UpdateBatch.
+     */
+    void beginUpdate();
+    void endUpdate();
+
+    /**
+     * @brief Minimum time between two emissions of a per-property signal
+     *
+     * 0 emits them right after stateChanged() for every batch.
+     */
+    void setNotifyInterval(int ms);
+    int notifyInterval() const { return m_notifyIntervalMs; }
+
+    /**
+     * @brief State as of the last completed update batch (any thread)
+     */
+    VehicleState snapshot() const { return m_snapshot.load(); }
+
+    /**
+     * @brief Number of batches published to snapshot() (any thread)
+     */
+    quint64 snapshotVersion() const { return m_snapshot.version(); }
+
     // Getters
-    uint8_t systemId() const { return m_systemId; }
-    uint8_t componentId() const { return m_componentId; }
+    uint8_t systemId() const { return m_state.systemId; }
+    uint8_t componentId() const { return m_state.componentId; }
     QString autopilotType() const { return m_autopilotType; }
     QString vehicleType() const { return m_vehicleType; }
     QString flightMode() const { return m_flightMode; }
-    bool armed() const { return m_armed; }
+    bool armed() const { return m_state.armed; }
 
-    float roll() const { return m_roll; }
-    float pitch() const { return m_pitch; }
-    float yaw() const { return m_yaw; }
-    float rollSpeed() const { return m_rollSpeed; }
-    float pitchSpeed() const { return m_pitchSpeed; }
-    float yawSpeed() const { return m_yawSpeed; }
+    float roll() const { return m_state.roll; }
+    float pitch() const { return m_state.pitch; }
+    float yaw() const { return m_state.yaw; }
+    float rollSpeed() const { return m_state.rollSpeed; }
+    float pitchSpeed() const { return m_state.pitchSpeed; }
+    float yawSpeed() const { return m_state.yawSpeed; }
 
-    double latitude() const { return m_latitude; }
-    double longitude() const { return m_longitude; }
-    float altitude() const { return m_altitude; }
-    float relativeAltitude() const { return m_relativeAltitude; }
-    uint16_t heading() const { return m_heading; }
+    double latitude() const { return m_state.latitude; }
+    double longitude() const { return m_state.longitude; }
+    float altitude() const { return m_state.altitude; }
+    float relativeAltitude() const { return m_state.relativeAltitude; }
+    uint16_t heading() const { return m_state.heading; }
 
-    float groundSpeed() const { return m_groundSpeed; }
-    float airSpeed() const { return m_airSpeed; }
-    float climbRate() const { return m_climbRate; }
+    float groundSpeed() const { return m_state.groundSpeed; }
+    float airSpeed() const { return m_state.airSpeed; }
+    float climbRate() const { return m_state.climbRate; }
 
-    float batteryVoltage() const { return m_batteryVoltage; }
-    float batteryCurrent() const { return m_batteryCurrent; }
-    int batteryRemaining() const { return m_batteryRemaining; }
+    float batteryVoltage() const { return m_state.batteryVoltage; }
+    float batteryCurrent() const { return m_state.batteryCurrent; }
+    int batteryRemaining() const { return m_state.batteryRemaining; }
 
-    uint16_t throttle() const { return m_throttle; }
+    uint16_t throttle() const { return m_state.throttle; }
+
+    // LatencyTrace key of the attitude currently held, 0 when not tracing
+    quint64 attitudeTraceKey() const { return m_state.attitudeTraceKey; }
 
     // Setters
     void setSystemId(uint8_t id);
@@ -91,7 +238,7 @@ public slots:
     void handleHeartbeat(uint8_t systemId, uint8_t componentId, uint8_t autopilot, uint8_t type,
                          uint8_t systemStatus, uint8_t baseMode, uint32_t customMode);
     void handleAttitude(float roll, float pitch, float yaw, float rollspeed, float pitchspeed,
-                        float yawspeed);
+                        float yawspeed, quint64 traceKey = 0);
     void handleGlobalPosition(int32_t lat, int32_t lon, int32_t alt, int32_t relativeAlt,
                               int16_t vx, int16_t vy, int16_t vz, uint16_t heading);
     void handleVfrHud(float airspeed, float groundspeed, int16_t heading, uint16_t throttle,
@@ -99,6 +246,11 @@ public slots:
     void handleBatteryStatus(uint16_t voltage, int16_t current, int8_t remaining);
 
 signals:
+    /**
+     * @brief Emitted once per update batch with the fields that changed
+     */
+    void stateChanged(VehicleModel::Fields changed);
+
     void systemIdChanged(uint8_t systemId);
     void componentIdChanged(uint8_t componentId);
     void autopilotTypeChanged(QString type);
@@ -130,40 +282,50 @@ signals:
     void throttleChanged(uint16_t throttle);
 
 private:
+    template <typename T>
+    static bool sameValue(const T& a, const T& b) {
+        return a == b;
+    }
+    static bool sameValue(float a, float b) { return qFuzzyCompare(a, b); }
+    static bool sameValue(double a, double b) { return qFuzzyCompare(a, b); }
+
+    template <typename T>
+    void assign(T& member, const T& value, Field field) {
+        if (!sameValue(member, value)) {
+            member = value;
+            m_dirty |= field;
+        }
+    }
+
+    // For raw fields without a property signal: published in the snapshot only
+    template <typename T>
+    void assignUnsignalled(T& member, const T& value) {
+        if (member != value) {
+            member = value;
+            m_unpublished = true;
+        }
+    }
+
+    void emitPropertySignals();
+
     QString decodeAutopilotType(uint8_t autopilot);
     QString decodeVehicleType(uint8_t type);
     QString decodeFlightMode(uint8_t baseMode, uint32_t customMode);
 
-    uint8_t m_systemId;
-    uint8_t m_componentId;
+    VehicleState m_state;              // owned by the model's thread
+    SeqLock<VehicleState> m_snapshot;  // m_state as of the last batch
     QString m_autopilotType;
     QString m_vehicleType;
     QString m_flightMode;
-    bool m_armed;
-    uint8_t m_autopilotEnum;
-
-    float m_roll;
-    float m_pitch;
-    float m_yaw;
-    float m_rollSpeed;
-    float m_pitchSpeed;
-    float m_yawSpeed;
-
-    double m_latitude;
-    double m_longitude;
-    float m_altitude;
-    float m_relativeAltitude;
-    uint16_t m_heading;
-
-    float m_groundSpeed;
-    float m_airSpeed;
-    float m_climbRate;
-
-    float m_batteryVoltage;
-    float m_batteryCurrent;
-    int m_batteryRemaining;
-
-    uint16_t m_throttle;
+
+    int m_updateDepth;
+    Fields m_dirty;           // changed in the current batch
+    bool m_unpublished{false};  // unsignalled fields changed since the last snapshot
+    Fields m_pendingNotify;   // per-property signals waiting for the throttle
+    int m_notifyIntervalMs;
+    QTimer* m_notifyTimer;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(VehicleModel::Fields)
+
 #endif  // VEHICLEMODEL_H
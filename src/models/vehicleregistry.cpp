@@ -0,0 +1,139 @@
+#include "vehicleregistry.h"
+#include "mavlink/common/mavlink.h"
+#include "telemetryhistory.h"
+#include "traillodstore.h"
+#include <QDateTime>
+#include <QDebug>
+
+VehicleRegistry::VehicleRegistry(QObject* parent) : QObject(parent) {}
+
+VehicleRegistry::~VehicleRegistry() = default;
+
+VehicleModel* VehicleRegistry::vehicle(uint8_t systemId, uint8_t componentId) const {
+    for (const Vehicle* entry : m_bySystem[systemId]) {
+        if (entry->model->componentId() == componentId) {
+            return entry->model;
+        }
+    }
+    return nullptr;
+}
+
+VehicleModel* VehicleRegistry::addVehicle(uint8_t systemId, uint8_t componentId) {
+    if (VehicleModel* existing = vehicle(systemId, componentId)) {
+        return existing;
+    }
+
+    auto* model = new VehicleModel(this);
+    model->setSystemId(systemId);
+    model->setComponentId(componentId);
+
+    m_vehicles.push_back(std::make_unique<Vehicle>());
+    Vehicle* entry = m_vehicles.back().get();
+    entry->model = model;
+    m_models.append(model);
+    m_bySystem[systemId].append(entry);
+
+    // One trail point per position batch
+    connect(model, &VehicleModel::stateChanged, this, [entry](VehicleModel::Fields changed) {
+        if ((changed & (VehicleModel::Latitude | VehicleModel::Longitude)) &&
+            entry->model->armed()) {
+            trailOf(entry)->appendDegrees(entry->model->latitude(), entry->model->longitude());
+        }
+    });
+
+    qInfo() << "VehicleRegistry: Vehicle" << systemId << "/" << componentId << "added ("
+            << m_models.size() << "total)";
+    emit vehicleAdded(model);
+    return model;
+}
+
+VehicleRegistry::Vehicle* VehicleRegistry::find(const VehicleModel* model) const {
+    if (!model) {
+        return nullptr;
+    }
+    for (Vehicle* entry : m_bySystem[model->systemId()]) {
+        if (entry->model == model) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+TelemetryHistory* VehicleRegistry::history(const VehicleModel* vehicle) const {
+    const Vehicle* entry = find(vehicle);
+    return entry ? entry->history.get() : nullptr;
+}
+
+TelemetryHistory* VehicleRegistry::enableHistory(VehicleModel* vehicle) {
+    Vehicle* entry = find(vehicle);
+    if (!entry) {
+        return nullptr;
+    }
+    if (entry->history) {
+        m_historyOrder.removeOne(entry);
+        m_historyOrder.append(entry);
+        return entry->history.get();
+    }
+
+    while (m_historyOrder.size() >= MAX_HISTORIES) {
+        releaseHistory(m_historyOrder.takeFirst());
+    }
+    entry->history = std::make_unique<TelemetryHistory>();
+    TelemetryHistory* history = entry->history.get();
+    // One append per changed field per batch
+    entry->historyFeed = connect(vehicle, &VehicleModel::stateChanged, this,
+                                 [vehicle, history](VehicleModel::Fields changed) {
+                                     history->record(QDateTime::currentMSecsSinceEpoch(),
+                                                     vehicle->snapshot(), changed);
+                                 });
+    m_historyOrder.append(entry);
+    return history;
+}
+
+void VehicleRegistry::releaseHistory(Vehicle* entry) {
+    qInfo() << "VehicleRegistry: Releasing telemetry history of vehicle"
+            << entry->model->systemId() << "/" << entry->model->componentId();
+    disconnect(entry->historyFeed);
+    entry->history.reset();
+}
+
+TrailLodStore* VehicleRegistry::trail(const VehicleModel* vehicle) {
+    Vehicle* entry = find(vehicle);
+    return entry ? trailOf(entry) : nullptr;
+}
+
+TrailLodStore* VehicleRegistry::trailOf(Vehicle* entry) {
+    if (!entry->trail) {
+        entry->trail = std::make_unique<TrailLodStore>();
+    }
+    return entry->trail.get();
+}
+
+bool VehicleRegistry::isVehicle(uint8_t autopilot, uint8_t type) {
+    // Peripherals usually report no autopilot; some report their host's
+    if (autopilot == MAV_AUTOPILOT_INVALID) {
+        return false;
+    }
+    switch (type) {
+        case MAV_TYPE_GCS:
+        case MAV_TYPE_ANTENNA_TRACKER:
+        case MAV_TYPE_ONBOARD_CONTROLLER:
+        case MAV_TYPE_GIMBAL:
+        case MAV_TYPE_ADSB:
+        case MAV_TYPE_CAMERA:
+            return false;
+        default:
+            return true;
+    }
+}
+
+void VehicleRegistry::handleHeartbeat(uint8_t systemId, uint8_t componentId, uint8_t autopilot,
+                                      uint8_t type, uint8_t systemStatus, uint8_t baseMode,
+                                      uint32_t customMode) {
+    if (!isVehicle(autopilot, type)) {
+        return;
+    }
+    addVehicle(systemId, componentId)
+        ->handleHeartbeat(systemId, componentId, autopilot, type, systemStatus, baseMode,
+                          customMode);
+}
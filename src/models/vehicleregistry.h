@@ -0,0 +1,146 @@
+#ifndef VEHICLEREGISTRY_H
+#define VEHICLEREGISTRY_H
+
+#include <QObject>
+#include <QVarLengthArray>
+#include <QVector>
+#include <array>
+#include <memory>
+#include <vector>
+#include "vehiclemodel.h"
+
+class TelemetryHistory;
+class TrailLodStore;
+
+/**
+ * @brief Every vehicle heard on the links, one VehicleModel per (sysid, compid)
+ *
+ * A vehicle is created the first time it sends a HEARTBEAT that identifies
+ * an autopilot (see isVehicle()); heartbeats from ground stations and
+ * peripheral components never create one, and each model only ever sees
+ * its own heartbeats, so its systemId()/componentId() are stable.
+ *
+ * Lookups go through a flat 256-entry table indexed by sysid whose entries
+ * hold that system's vehicles inline (normally exactly one), so routing a
+ * message is an array index plus, at most, a short scan over components.
+ *
+ * A vehicle costs its VehicleModel and a few pointers. The much larger
+ * TelemetryHistory is only allocated for vehicles that are actually
+ * plotted, by enableHistory(), and only the MAX_HISTORIES most recently
+ * plotted vehicles keep theirs. Each vehicle's flight trail is recorded
+ * here too, whether or not it is on screen; it is allocated when the
+ * vehicle is first shown or first moves while armed.
+ *
+ * Vehicles are never removed; models are owned by the registry. GUI thread
+ * only.
+ */
+class VehicleRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Vehicles that keep a telemetry history at the same time
+     *
+     * Each history is about 14 MB. Switching back and forth between a few
+     * vehicles keeps their plots; the least recently plotted one beyond
+     * this many loses its history.
+     */
+    static constexpr int MAX_HISTORIES = 4;
+
+    explicit VehicleRegistry(QObject* parent = nullptr);
+    ~VehicleRegistry() override;
+
+    /**
+     * @brief The vehicle with exactly this (sysid, compid), or nullptr
+     */
+    VehicleModel* vehicle(uint8_t systemId, uint8_t componentId) const;
+
+    /**
+     * @brief Model that a message from (sysid, compid) belongs to
+     *
+     * The exact vehicle if there is one; otherwise the system's first
+     * vehicle, so that telemetry a companion component sends on behalf of
+     * its autopilot still lands on the vehicle. nullptr for systems without
+     * a vehicle.
+     */
+    VehicleModel* route(uint8_t systemId, uint8_t componentId) const {
+        const Slot& slot = m_bySystem[systemId];
+        for (const Vehicle* entry : slot) {
+            if (entry->model->componentId() == componentId) {
+                return entry->model;
+            }
+        }
+        return slot.isEmpty() ? nullptr : slot.first()->model;
+    }
+
+    /**
+     * @brief Find or create the vehicle (sysid, compid)
+     *
+     * Emits vehicleAdded() when a new model is created.
+     */
+    VehicleModel* addVehicle(uint8_t systemId, uint8_t componentId);
+
+    /**
+     * @brief All vehicles, in the order they were first heard
+     */
+    const QVector<VehicleModel*>& vehicles() const { return m_models; }
+    int count() const { return m_models.size(); }
+
+    /**
+     * @brief The vehicle's telemetry history, or nullptr if not enabled
+     */
+    TelemetryHistory* history(const VehicleModel* vehicle) const;
+
+    /**
+     * @brief Start recording the vehicle's telemetry history
+     *
+     * Allocates the history on first use and feeds it from the model's
+     * stateChanged() from then on. Returns the existing history otherwise.
+     * Frees the history of the least recently enabled vehicle when more than
+     * MAX_HISTORIES would be kept; pointers to that history become invalid.
+     */
+    TelemetryHistory* enableHistory(VehicleModel* vehicle);
+
+    /**
+     * @brief The vehicle's flight trail, allocated on first use; nullptr for unknown vehicles
+     *
+     * Every position the vehicle reports while armed is appended, from the
+     * model's stateChanged(). The trail lives as long as the registry.
+     */
+    TrailLodStore* trail(const VehicleModel* vehicle);
+
+    /**
+     * @brief Whether a HEARTBEAT with this autopilot and type comes from a vehicle
+     */
+    static bool isVehicle(uint8_t autopilot, uint8_t type);
+
+public slots:
+    /**
+     * @brief Create the sender's model if it is a vehicle, then update it
+     */
+    void handleHeartbeat(uint8_t systemId, uint8_t componentId, uint8_t autopilot, uint8_t type,
+                         uint8_t systemStatus, uint8_t baseMode, uint32_t customMode);
+
+signals:
+    void vehicleAdded(VehicleModel* vehicle);
+
+private:
+    struct Vehicle {
+        VehicleModel* model;
+        std::unique_ptr<TelemetryHistory> history;  // set by enableHistory()
+        QMetaObject::Connection historyFeed;        // model -> history
+        std::unique_ptr<TrailLodStore> trail;       // allocated by trailOf()
+    };
+    using Slot = QVarLengthArray<Vehicle*, 1>;  // a system's vehicles, by arrival
+
+    Vehicle* find(const VehicleModel* model) const;
+    void releaseHistory(Vehicle* entry);
+    static TrailLodStore* trailOf(Vehicle* entry);
+
+    std::vector<std::unique_ptr<Vehicle>> m_vehicles;
+    QVector<VehicleModel*> m_models;  // same order as m_vehicles
+    std::array<Slot, 256> m_bySystem;
+    QVector<Vehicle*> m_historyOrder;  // vehicles with a history, least recently enabled first
+};
+
+#endif  // VEHICLEREGISTRY_H
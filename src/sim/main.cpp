@@ -0,0 +1,113 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QNetworkDatagram>
+#include <QTimer>
+#include <QUdpSocket>
+#include <cstdio>
+#include "vehiclesimulator.h"
+
+/**
+ * flightscope-sim: headless load generator
+ *
+ * Streams telemetry from N simulated vehicles to a ground station over UDP
+ * (FlightScope's UDP link listens on 14550 by default) and answers whatever
+ * comes back. All vehicles share one socket, like a telemetry radio mesh or
+ * a MAVLink router would.
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("FlightScope");
+    QCoreApplication::setApplicationName("flightscope-sim");
+    QCoreApplication::setApplicationVersion("0.1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Lightweight MAVLink vehicle simulator for load testing");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption vehiclesOption({"n", "vehicles"}, "Number of vehicles.", "count",
+                                            "10");
+    const QCommandLineOption systemIdOption("first-system-id", "System ID of the first vehicle.",
+                                            "id", "1");
+    const QCommandLineOption targetOption({"t", "target"}, "Ground station address.",
+                                          "host:port", "127.0.0.1:14550");
+    const QCommandLineOption bindOption("bind", "Local UDP port (0 = any).", "port", "0");
+    const QCommandLineOption attitudeOption("attitude-rate", "ATTITUDE rate in Hz.", "hz", "50");
+    const QCommandLineOption positionOption("position-rate", "GLOBAL_POSITION_INT rate in Hz.",
+                                            "hz", "10");
+    const QCommandLineOption hudOption("hud-rate", "VFR_HUD rate in Hz.", "hz", "10");
+    const QCommandLineOption tickOption("tick", "Simulation step in milliseconds.", "ms", "5");
+    const QCommandLineOption groundOption("ground", "Start disarmed on the ground.");
+    const QCommandLineOption durationOption("duration", "Stop after this many seconds.",
+                                            "seconds", "0");
+    parser.addOptions({vehiclesOption, systemIdOption, targetOption, bindOption, attitudeOption,
+                       positionOption, hudOption, tickOption, groundOption, durationOption});
+    parser.process(app);
+
+    const QString target = parser.value(targetOption);
+    const int separator = target.lastIndexOf(':');
+    const QHostAddress targetAddress(separator > 0 ? target.left(separator) : target);
+    const quint16 targetPort = separator > 0 ? target.mid(separator + 1).toUShort() : 14550;
+    if (targetAddress.isNull() || targetPort == 0) {
+        std::fprintf(stderr, "Invalid target %s\n", qPrintable(target));
+        return 1;
+    }
+
+    VehicleSimulator::Configuration config;
+    config.vehicleCount = parser.value(vehiclesOption).toInt();
+    config.firstSystemId = static_cast<uint8_t>(qBound(1, parser.value(systemIdOption).toInt(),
+                                                       255));
+    config.rates.attitudeHz = parser.value(attitudeOption).toDouble();
+    config.rates.globalPositionHz = parser.value(positionOption).toDouble();
+    config.rates.vfrHudHz = parser.value(hudOption).toDouble();
+    config.tickMs = parser.value(tickOption).toInt();
+    config.airborne = !parser.isSet(groundOption);
+    VehicleSimulator simulator(config);
+
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::AnyIPv4, parser.value(bindOption).toUShort())) {
+        std::fprintf(stderr, "Cannot bind UDP socket: %s\n", qPrintable(socket.errorString()));
+        return 1;
+    }
+    QObject::connect(&simulator, &VehicleSimulator::bytesReady, &socket,
+                     [&](uint8_t, const QByteArray& data) {
+                         socket.writeDatagram(data, targetAddress, targetPort);
+                     });
+    QObject::connect(&socket, &QUdpSocket::readyRead, &simulator, [&]() {
+        while (socket.hasPendingDatagrams()) {
+            simulator.receiveBytes(socket.receiveDatagram().data());
+        }
+    });
+
+    // Throughput once every few seconds, so it is obvious what the GCS is being fed
+    QElapsedTimer clock;
+    clock.start();
+    VehicleSimulator::Statistics last;
+    qint64 lastMs = 0;
+    QTimer report;
+    QObject::connect(&report, &QTimer::timeout, &simulator, [&]() {
+        const VehicleSimulator::Statistics stats = simulator.statistics();
+        const double seconds = (clock.elapsed() - lastMs) / 1000.0;
+        std::printf("%d vehicles: %.0f msg/s, %.1f KiB/s out, %llu messages in\n", stats.vehicles,
+                    (stats.messagesSent - last.messagesSent) / seconds,
+                    (stats.bytesSent - last.bytesSent) / seconds / 1024.0,
+                    static_cast<unsigned long long>(stats.messagesReceived));
+        std::fflush(stdout);
+        last = stats;
+        lastMs = clock.elapsed();
+    });
+    report.start(5000);
+
+    const int durationSeconds = parser.value(durationOption).toInt();
+    if (durationSeconds > 0) {
+        QTimer::singleShot(durationSeconds * 1000, &app, &QCoreApplication::quit);
+    }
+
+    const int vehicleCount = simulator.configuration().vehicleCount;
+    std::printf("Simulating %d vehicles (system IDs %d-%d) -> %s:%u\n", vehicleCount,
+                config.firstSystemId, config.firstSystemId + vehicleCount - 1,
+                qPrintable(targetAddress.toString()), static_cast<unsigned>(targetPort));
+    simulator.start();
+    return app.exec();
+}
@@ -0,0 +1,70 @@
+#include "simulatorlink.h"
+#include <QDebug>
+#include <QThread>
+
+SimulatorLink::SimulatorLink(const Configuration& config, QObject* parent)
+    : LinkInterface(parent),
+      m_config(config),
+      m_simulator(nullptr),
+      m_status(LinkStatus::Disconnected) {}
+
+SimulatorLink::~SimulatorLink() {
+    disconnectLink();
+}
+
+QString SimulatorLink::name() const {
+    return m_config.name;
+}
+
+SimulatorLink::LinkStatus SimulatorLink::status() const {
+    return m_status;
+}
+
+bool SimulatorLink::isConnected() const {
+    return m_status == LinkStatus::Connected;
+}
+
+void SimulatorLink::connectLink() {
+    qDebug() << "SimulatorLink::connectLink() called on thread:" << QThread::currentThread();
+
+    if (m_simulator) {
+        emit statusChanged(m_status);
+        return;
+    }
+
+    m_simulator = new VehicleSimulator(m_config.simulator, this);
+    connect(m_simulator, &VehicleSimulator::bytesReady, this, &SimulatorLink::onSimulatorBytes);
+    m_simulator->start();
+    setStatus(LinkStatus::Connected);
+}
+
+void SimulatorLink::disconnectLink() {
+    if (!m_simulator) {
+        return;
+    }
+    m_simulator->stop();
+    delete m_simulator;
+    m_simulator = nullptr;
+    setStatus(LinkStatus::Disconnected);
+}
+
+void SimulatorLink::writeBytes(const QByteArray& data) {
+    if (!m_simulator) {
+        return;
+    }
+    m_simulator->receiveBytes(data);
+    emit bytesWritten(data.size());
+}
+
+void SimulatorLink::onSimulatorBytes(uint8_t systemId, const QByteArray& data) {
+    Q_UNUSED(systemId)
+    pushReceivedBytes(data.constData(), data.size());
+    flushReceivedBytes();
+}
+
+void SimulatorLink::setStatus(LinkStatus status) {
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged(status);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SIMULATORLINK_H
+#define SIMULATORLINK_H
+
+#include "../comm/linkinterface.h"
+#include "vehiclesimulator.h"
+
+/**
+ * @brief In-process link to a VehicleSimulator fleet
+ *
+ * The simulator is created on connect, so it and its tick timer live on the
+ * link thread. Its packets go straight into the receive ring, skipping the
+ * network stack entirely, so what is measured is FlightScope itself.
+ * Everything written to the link is parsed by the simulator and answered
+ * like an autopilot would.
+ */
+class SimulatorLink : public LinkInterface {
+    Q_OBJECT
+
+public:
+    struct Configuration {
+        QString name;
+        VehicleSimulator::Configuration simulator;
+    };
+
+    explicit SimulatorLink(const Configuration& config, QObject* parent = nullptr);
+    ~SimulatorLink() override;
+
+    QString name() const override;
+    LinkStatus status() const override;
+    bool isConnected() const override;
+
+    /**
+     * @brief The running simulator, or nullptr while disconnected (link thread only)
+     */
+    VehicleSimulator* simulator() const { return m_simulator; }
+
+public slots:
+    void connectLink() override;
+    void disconnectLink() override;
+    void writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onSimulatorBytes(uint8_t systemId, const QByteArray& data);
+
+private:
+    void setStatus(LinkStatus status);
+
+    Configuration m_config;
+    VehicleSimulator* m_simulator;
+    LinkStatus m_status;
+};
+
+#endif  // SIMULATORLINK_H
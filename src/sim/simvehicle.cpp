@@ -0,0 +1,814 @@
+#include "simvehicle.h"
+#include <QDebug>
+#include <QtMath>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr double EARTH_RADIUS_M = 6378137.0;
+constexpr double GRAVITY = 9.80665;
+constexpr double HOME_ALTITUDE_MSL_M = 584.0;
+constexpr double CLIMB_RATE = 2.5;    // m/s
+constexpr double DESCENT_RATE = 1.5;  // m/s
+constexpr double LAND_RATE = 0.7;     // m/s, final descent
+constexpr double RTL_ALTITUDE_M = 15.0;
+constexpr double ACCEPTANCE_RADIUS_M = 2.0;
+constexpr double FLIGHT_TIME_S = 1200.0;  // full to empty battery when armed
+constexpr qint64 MISSION_RETRY_US = 1000000;
+constexpr int MISSION_MAX_RETRIES = 5;
+constexpr uint16_t FORCE_DISARM_MAGIC = 21196;
+
+qint64 intervalFromHz(double hz) {
+    return hz > 0.0 ? static_cast<qint64>(1e6 / hz) : 0;
+}
+
+bool isGlobalFrame(uint8_t frame) {
+    switch (frame) {
+        case MAV_FRAME_GLOBAL:
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT:
+        case MAV_FRAME_GLOBAL_INT:
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT_INT:
+        case MAV_FRAME_GLOBAL_TERRAIN_ALT:
+        case MAV_FRAME_GLOBAL_TERRAIN_ALT_INT:
+            return true;
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+template <typename T>
+void SimVehicle::send(const T& payload, QByteArray& out) {
+    // Like mavlink_msg_*_encode_chan(), but with this vehicle's own sequence counter
+    constexpr uint32_t msgId = MavlinkMessageTraits<T>::MSG_ID;
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msgId);
+    if (!entry) {
+        return;
+    }
+
+    mavlink_message_t msg{};
+    msg.msgid = msgId;
+    std::memcpy(_MAV_PAYLOAD_NON_CONST(&msg), &payload,
+                qMin<size_t>(sizeof(T), entry->max_msg_len));
+    mavlink_finalize_message_buffer(&msg, m_systemId, MAV_COMP_ID_AUTOPILOT1, &m_txStatus,
+                                    entry->min_msg_len, entry->max_msg_len, entry->crc_extra);
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t length = mavlink_msg_to_send_buffer(buffer, &msg);
+    out.append(reinterpret_cast<const char*>(buffer), length);
+    m_messagesSent++;
+}
+
+SimVehicle::SimVehicle(uint8_t systemId, double homeLatitude, double homeLongitude,
+                       const Rates& rates, bool airborne)
+    : m_systemId(systemId),
+      m_txStatus{},
+      m_random(systemId),
+      m_lastUpdateUs(-1),
+      m_bootUs(0),
+      m_homeLatitude(homeLatitude),
+      m_homeLongitude(homeLongitude),
+      m_latitude(homeLatitude),
+      m_longitude(homeLongitude),
+      m_north(0.0),
+      m_east(0.0),
+      m_altitude(0.0),
+      m_targetNorth(0.0),
+      m_targetEast(0.0),
+      m_targetAltitude(0.0),
+      m_velocityNorth(0.0),
+      m_velocityEast(0.0),
+      m_climbRate(0.0),
+      m_roll(0.0),
+      m_pitch(0.0),
+      m_yaw(0.0),
+      m_cruiseSpeed(5.0),
+      m_orbitRadius(50.0 + 10.0 * (systemId % 10)),
+      m_orbitAngle(systemId * 0.7),
+      m_orbiting(false),
+      m_batteryRemaining(1.0),
+      m_armed(false),
+      m_mode(Stabilize),
+      m_currentSeq(0),
+      m_messagesSent(0) {
+    const struct {
+        uint32_t msgId;
+        double hz;
+    } streams[] = {
+        {MAVLINK_MSG_ID_HEARTBEAT, rates.heartbeatHz},
+        {MAVLINK_MSG_ID_ATTITUDE, rates.attitudeHz},
+        {MAVLINK_MSG_ID_GLOBAL_POSITION_INT, rates.globalPositionHz},
+        {MAVLINK_MSG_ID_VFR_HUD, rates.vfrHudHz},
+        {MAVLINK_MSG_ID_GPS_RAW_INT, rates.gpsRawHz},
+        {MAVLINK_MSG_ID_SYS_STATUS, rates.sysStatusHz},
+        {MAVLINK_MSG_ID_BATTERY_STATUS, rates.batteryStatusHz},
+        {MAVLINK_MSG_ID_MISSION_CURRENT, rates.missionCurrentHz},
+    };
+    for (const auto& stream : streams) {
+        const qint64 intervalUs = intervalFromHz(stream.hz);
+        m_streams.append(Stream{stream.msgId, intervalUs, intervalUs, 0});
+    }
+
+    if (airborne) {
+        // Spread altitude and start position so the fleet is not one dot on the map
+        m_armed = true;
+        m_mode = Guided;
+        m_orbiting = true;
+        m_altitude = 30.0 + (systemId * 7) % 31;
+        m_targetAltitude = m_altitude;
+        m_north = m_orbitRadius * qCos(m_orbitAngle);
+        m_east = m_orbitRadius * qSin(m_orbitAngle);
+        m_batteryRemaining = 0.6 + 0.4 * ((systemId * 13) % 100) / 100.0;
+        holdPosition();
+    }
+}
+
+void SimVehicle::update(qint64 nowUs, QByteArray& out) {
+    if (m_lastUpdateUs < 0) {
+        // Phase-shift every stream by system ID so vehicles do not send in lockstep
+        m_bootUs = nowUs;
+        for (Stream& stream : m_streams) {
+            const qint64 phaseUs =
+                stream.intervalUs > 0 ? (m_systemId * 997) % stream.intervalUs : 0;
+            stream.nextUs = nowUs + phaseUs;
+        }
+        m_lastUpdateUs = nowUs;
+    }
+
+    const double dt = (nowUs - m_lastUpdateUs) * 1e-6;
+    if (dt > 0.0) {
+        step(dt);
+        m_lastUpdateUs = nowUs;
+    }
+
+    for (Stream& stream : m_streams) {
+        if (stream.intervalUs <= 0 || nowUs < stream.nextUs) {
+            continue;
+        }
+        emitTelemetry(stream.msgId, nowUs, out);
+        // Keep the nominal rate, but never try to catch up on a backlog
+        stream.nextUs += stream.intervalUs;
+        if (stream.nextUs <= nowUs) {
+            stream.nextUs = nowUs + stream.intervalUs;
+        }
+    }
+
+    // Ask again for a mission item that did not arrive
+    if (m_upload.active && nowUs - m_upload.lastRequestUs >= MISSION_RETRY_US) {
+        if (m_upload.retries >= MISSION_MAX_RETRIES) {
+            qDebug() << "SimVehicle" << m_systemId << ": Mission upload timed out at item"
+                     << m_upload.nextSeq;
+            m_upload.active = false;
+        } else {
+            m_upload.retries++;
+            requestNextItem(nowUs, out);
+        }
+    }
+}
+
+void SimVehicle::step(double dt) {
+    const double previousYaw = m_yaw;
+
+    if (!m_armed) {
+        m_velocityNorth = 0.0;
+        m_velocityEast = 0.0;
+        m_climbRate = 0.0;
+    } else {
+        switch (m_mode) {
+            case Guided:
+                if (m_orbiting && m_altitude > 1.0) {
+                    m_orbitAngle += m_cruiseSpeed / m_orbitRadius * dt;
+                    m_targetNorth = m_orbitRadius * qCos(m_orbitAngle);
+                    m_targetEast = m_orbitRadius * qSin(m_orbitAngle);
+                }
+                break;
+            case Auto:
+                updatePositionTarget();
+                break;
+            case Rtl:
+                // Climb first, then head home, then land
+                if (m_altitude < RTL_ALTITUDE_M - 0.5 && qHypot(m_north, m_east) > 1.0) {
+                    m_targetNorth = m_north;
+                    m_targetEast = m_east;
+                    m_targetAltitude = RTL_ALTITUDE_M;
+                } else if (qHypot(m_north, m_east) > ACCEPTANCE_RADIUS_M) {
+                    m_targetNorth = 0.0;
+                    m_targetEast = 0.0;
+                    m_targetAltitude = qMax(m_altitude, RTL_ALTITUDE_M);
+                } else {
+                    m_mode = Land;
+                    holdPosition();
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (m_mode == Land) {
+            m_targetAltitude = -1.0;  // aim below the ground so the descent rate holds to touchdown
+        }
+        flyTowards(m_targetNorth, m_targetEast, dt);
+
+        const double error = m_targetAltitude - m_altitude;
+        const double maxDescent = m_mode == Land && m_altitude < 10.0 ? LAND_RATE : DESCENT_RATE;
+        m_climbRate = qBound(-maxDescent, error, CLIMB_RATE);
+        m_altitude += m_climbRate * dt;
+        if (m_altitude <= 0.0) {
+            m_altitude = 0.0;
+            m_climbRate = 0.0;
+            if (m_mode == Land) {
+                arm(false);
+            }
+        }
+
+        m_batteryRemaining = qMax(0.0, m_batteryRemaining - dt / FLIGHT_TIME_S);
+    }
+
+    m_north += m_velocityNorth * dt;
+    m_east += m_velocityEast * dt;
+    m_latitude = m_homeLatitude + qRadiansToDegrees(m_north / EARTH_RADIUS_M);
+    const double metresPerRadianEast = EARTH_RADIUS_M * qCos(qDegreesToRadians(m_homeLatitude));
+    m_longitude = m_homeLongitude + qRadiansToDegrees(m_east / metresPerRadianEast);
+
+    // Attitude follows the motion: pitch into the velocity, bank into the turn
+    const double groundSpeed = qHypot(m_velocityNorth, m_velocityEast);
+    if (groundSpeed > 0.5) {
+        m_yaw = qAtan2(m_velocityEast, m_velocityNorth);
+    }
+    double yawRate = 0.0;
+    if (dt > 0.0) {
+        yawRate = std::remainder(m_yaw - previousYaw, 2.0 * M_PI) / dt;
+    }
+    const double wobble = m_armed ? 0.005 : 0.0;
+    m_roll = qAtan(groundSpeed * yawRate / GRAVITY) + wobble * m_noise(m_random);
+    m_pitch = -0.03 * groundSpeed + wobble * m_noise(m_random);
+}
+
+void SimVehicle::flyTowards(double north, double east, double dt) {
+    const double dn = north - m_north;
+    const double de = east - m_east;
+    const double distance = qHypot(dn, de);
+
+    // Slow down over the last metres instead of overshooting
+    double desiredNorth = 0.0;
+    double desiredEast = 0.0;
+    if (distance > 0.05) {
+        const double speed = qMin(m_cruiseSpeed, distance);
+        desiredNorth = dn / distance * speed;
+        desiredEast = de / distance * speed;
+    }
+    const double response = qMin(1.0, 2.0 * dt);
+    m_velocityNorth += (desiredNorth - m_velocityNorth) * response;
+    m_velocityEast += (desiredEast - m_velocityEast) * response;
+}
+
+void SimVehicle::holdPosition() {
+    m_targetNorth = m_north;
+    m_targetEast = m_east;
+    m_targetAltitude = m_altitude;
+}
+
+void SimVehicle::updatePositionTarget() {
+    if (m_mode != Auto) {
+        return;
+    }
+    const QVector<mavlink_mission_item_int_t>& mission = m_missions.value(MAV_MISSION_TYPE_MISSION);
+    if (m_currentSeq <= 0 || m_currentSeq >= mission.size()) {
+        return;
+    }
+
+    const mavlink_mission_item_int_t& item = mission.at(m_currentSeq);
+    switch (item.command) {
+        case MAV_CMD_NAV_TAKEOFF:
+            m_targetAltitude = item.z;
+            if (m_altitude >= item.z - 0.5) {
+                startMissionItem(m_currentSeq + 1);
+            }
+            return;
+        case MAV_CMD_NAV_LAND:
+            m_mode = Land;
+            holdPosition();
+            return;
+        case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+            m_mode = Rtl;
+            return;
+        case MAV_CMD_NAV_WAYPOINT:
+        case MAV_CMD_NAV_SPLINE_WAYPOINT:
+        case MAV_CMD_NAV_LOITER_UNLIM:
+        case MAV_CMD_NAV_LOITER_TIME:
+        case MAV_CMD_NAV_LOITER_TURNS:
+            break;
+        default:
+            // DO_ commands and the like take effect immediately
+            startMissionItem(m_currentSeq + 1);
+            return;
+    }
+
+    if (isGlobalFrame(item.frame) && (item.x != 0 || item.y != 0)) {
+        const double latitude = item.x * 1e-7;
+        const double longitude = item.y * 1e-7;
+        m_targetNorth = qDegreesToRadians(latitude - m_homeLatitude) * EARTH_RADIUS_M;
+        m_targetEast = qDegreesToRadians(longitude - m_homeLongitude) * EARTH_RADIUS_M *
+                       qCos(qDegreesToRadians(m_homeLatitude));
+    }
+    if (item.z > 0.0f) {
+        m_targetAltitude = item.z;
+    }
+    if (qHypot(m_targetNorth - m_north, m_targetEast - m_east) < ACCEPTANCE_RADIUS_M &&
+        qAbs(m_targetAltitude - m_altitude) < 1.0) {
+        startMissionItem(m_currentSeq + 1);
+    }
+}
+
+void SimVehicle::emitTelemetry(uint32_t msgId, qint64 nowUs, QByteArray& out) {
+    const uint32_t timeBootMs = static_cast<uint32_t>((nowUs - m_bootUs) / 1000);
+    const double groundSpeed = qHypot(m_velocityNorth, m_velocityEast);
+    const double headingDeg = std::fmod(qRadiansToDegrees(m_yaw) + 360.0, 360.0);
+    const double voltage = 14.0 + 2.8 * m_batteryRemaining;  // 4S LiPo
+    const double current = m_armed ? 12.0 + 4.0 * qMax(0.0, m_climbRate) : 0.4;
+
+    switch (msgId) {
+        case MAVLINK_MSG_ID_HEARTBEAT: {
+            mavlink_heartbeat_t heartbeat{};
+            heartbeat.type = MAV_TYPE_QUADROTOR;
+            heartbeat.autopilot = MAV_AUTOPILOT_ARDUPILOTMEGA;
+            heartbeat.base_mode = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED |
+                                  MAV_MODE_FLAG_STABILIZE_ENABLED;
+            if (m_armed) {
+                heartbeat.base_mode |= MAV_MODE_FLAG_SAFETY_ARMED;
+            }
+            if (m_mode == Guided || m_mode == Auto || m_mode == Rtl) {
+                heartbeat.base_mode |= MAV_MODE_FLAG_GUIDED_ENABLED;
+            }
+            heartbeat.custom_mode = m_mode;
+            heartbeat.system_status = m_armed ? MAV_STATE_ACTIVE : MAV_STATE_STANDBY;
+            heartbeat.mavlink_version = 3;
+            send(heartbeat, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_ATTITUDE: {
+            mavlink_attitude_t attitude{};
+            attitude.time_boot_ms = timeBootMs;
+            attitude.roll = static_cast<float>(m_roll);
+            attitude.pitch = static_cast<float>(m_pitch);
+            attitude.yaw = static_cast<float>(m_yaw);
+            send(attitude, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT: {
+            mavlink_global_position_int_t position{};
+            position.time_boot_ms = timeBootMs;
+            position.lat = static_cast<int32_t>(m_latitude * 1e7);
+            position.lon = static_cast<int32_t>(m_longitude * 1e7);
+            position.alt = static_cast<int32_t>((HOME_ALTITUDE_MSL_M + m_altitude) * 1000.0);
+            position.relative_alt = static_cast<int32_t>(m_altitude * 1000.0);
+            position.vx = static_cast<int16_t>(m_velocityNorth * 100.0);
+            position.vy = static_cast<int16_t>(m_velocityEast * 100.0);
+            position.vz = static_cast<int16_t>(-m_climbRate * 100.0);
+            position.hdg = static_cast<uint16_t>(headingDeg * 100.0);
+            send(position, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_VFR_HUD: {
+            mavlink_vfr_hud_t hud{};
+            hud.airspeed = static_cast<float>(groundSpeed);
+            hud.groundspeed = static_cast<float>(groundSpeed);
+            hud.heading = static_cast<int16_t>(headingDeg);
+            hud.throttle = static_cast<uint16_t>(m_armed ? 45 + 10 * m_climbRate : 0);
+            hud.alt = static_cast<float>(HOME_ALTITUDE_MSL_M + m_altitude);
+            hud.climb = static_cast<float>(m_climbRate);
+            send(hud, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_GPS_RAW_INT: {
+            mavlink_gps_raw_int_t gps{};
+            gps.time_usec = static_cast<uint64_t>(nowUs);
+            gps.fix_type = GPS_FIX_TYPE_3D_FIX;
+            gps.lat = static_cast<int32_t>(m_latitude * 1e7);
+            gps.lon = static_cast<int32_t>(m_longitude * 1e7);
+            gps.alt = static_cast<int32_t>((HOME_ALTITUDE_MSL_M + m_altitude) * 1000.0);
+            gps.eph = 80;
+            gps.epv = 120;
+            gps.vel = static_cast<uint16_t>(groundSpeed * 100.0);
+            gps.cog = static_cast<uint16_t>(headingDeg * 100.0);
+            gps.satellites_visible = 14;
+            send(gps, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_SYS_STATUS: {
+            mavlink_sys_status_t status{};
+            const uint32_t sensors = MAV_SYS_STATUS_SENSOR_3D_GYRO |
+                                     MAV_SYS_STATUS_SENSOR_3D_ACCEL |
+                                     MAV_SYS_STATUS_SENSOR_3D_MAG |
+                                     MAV_SYS_STATUS_SENSOR_ABSOLUTE_PRESSURE |
+                                     MAV_SYS_STATUS_SENSOR_GPS | MAV_SYS_STATUS_AHRS |
+                                     MAV_SYS_STATUS_SENSOR_BATTERY;
+            status.onboard_control_sensors_present = sensors;
+            status.onboard_control_sensors_enabled = sensors;
+            status.onboard_control_sensors_health = sensors;
+            status.load = 250;
+            status.voltage_battery = static_cast<uint16_t>(voltage * 1000.0);
+            status.current_battery = static_cast<int16_t>(current * 100.0);
+            status.battery_remaining = static_cast<int8_t>(m_batteryRemaining * 100.0);
+            send(status, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_BATTERY_STATUS: {
+            mavlink_battery_status_t battery{};
+            battery.id = 0;
+            battery.battery_function = MAV_BATTERY_FUNCTION_ALL;
+            battery.type = MAV_BATTERY_TYPE_LIPO;
+            battery.temperature = INT16_MAX;
+            for (uint16_t& cell : battery.voltages) {
+                cell = UINT16_MAX;
+            }
+            battery.voltages[0] = static_cast<uint16_t>(voltage * 1000.0);
+            battery.current_battery = static_cast<int16_t>(current * 100.0);
+            battery.current_consumed =
+                static_cast<int32_t>((1.0 - m_batteryRemaining) * 5000.0);  // 5 Ah pack
+            battery.energy_consumed = -1;
+            battery.battery_remaining = static_cast<int8_t>(m_batteryRemaining * 100.0);
+            send(battery, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_CURRENT:
+            sendMissionCurrent(out);
+            break;
+        default:
+            break;
+    }
+}
+
+bool SimVehicle::setStreamInterval(uint32_t msgId, qint64 intervalUs, qint64 nowUs) {
+    for (Stream& stream : m_streams) {
+        if (stream.msgId != msgId) {
+            continue;
+        }
+        // MAV_CMD_SET_MESSAGE_INTERVAL: -1 disables, 0 restores the default
+        if (intervalUs < 0) {
+            stream.intervalUs = 0;
+        } else if (intervalUs == 0) {
+            stream.intervalUs = stream.defaultIntervalUs;
+        } else {
+            stream.intervalUs = intervalUs;
+        }
+        stream.nextUs = nowUs;  // takes effect straight away
+        return true;
+    }
+    return false;
+}
+
+void SimVehicle::handleMessage(const mavlink_message_t& msg, qint64 nowUs, QByteArray& out) {
+    switch (msg.msgid) {
+        case MAVLINK_MSG_ID_COMMAND_LONG:
+            handleCommand(msg, nowUs, out);
+            break;
+        case MAVLINK_MSG_ID_SET_MODE: {
+            mavlink_set_mode_t setModeMessage;
+            mavlink_msg_set_mode_decode(&msg, &setModeMessage);
+            // ArduPilot acknowledges SET_MODE with the message ID as the command
+            const bool accepted = setMode(setModeMessage.custom_mode);
+            sendCommandAck(msg, MAVLINK_MSG_ID_SET_MODE,
+                           accepted ? MAV_RESULT_ACCEPTED : MAV_RESULT_DENIED, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_COUNT:
+            handleMissionCount(msg, nowUs, out);
+            break;
+        case MAVLINK_MSG_ID_MISSION_ITEM_INT: {
+            mavlink_mission_item_int_t item;
+            mavlink_msg_mission_item_int_decode(&msg, &item);
+            handleMissionItem(item, nowUs, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_ITEM: {
+            // Legacy float items are stored in the int form
+            mavlink_mission_item_t legacy;
+            mavlink_msg_mission_item_decode(&msg, &legacy);
+            mavlink_mission_item_int_t item{};
+            const double scale = isGlobalFrame(legacy.frame) ? 1e7 : 1e4;
+            item.param1 = legacy.param1;
+            item.param2 = legacy.param2;
+            item.param3 = legacy.param3;
+            item.param4 = legacy.param4;
+            item.x = static_cast<int32_t>(std::llround(legacy.x * scale));
+            item.y = static_cast<int32_t>(std::llround(legacy.y * scale));
+            item.z = legacy.z;
+            item.seq = legacy.seq;
+            item.command = legacy.command;
+            item.frame = legacy.frame;
+            item.current = legacy.current;
+            item.autocontinue = legacy.autocontinue;
+            item.mission_type = legacy.mission_type;
+            handleMissionItem(item, nowUs, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_REQUEST_LIST: {
+            mavlink_mission_request_list_t request;
+            mavlink_msg_mission_request_list_decode(&msg, &request);
+            mavlink_mission_count_t count{};
+            count.target_system = msg.sysid;
+            count.target_component = msg.compid;
+            count.count = static_cast<uint16_t>(missionCount(request.mission_type));
+            count.mission_type = request.mission_type;
+            send(count, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_REQUEST_INT: {
+            mavlink_mission_request_int_t request;
+            mavlink_msg_mission_request_int_decode(&msg, &request);
+            handleMissionRequest(msg, request.seq, request.mission_type, true, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_REQUEST: {
+            mavlink_mission_request_t request;
+            mavlink_msg_mission_request_decode(&msg, &request);
+            handleMissionRequest(msg, request.seq, request.mission_type, false, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_CLEAR_ALL: {
+            mavlink_mission_clear_all_t clear;
+            mavlink_msg_mission_clear_all_decode(&msg, &clear);
+            m_missions.remove(clear.mission_type);
+            if (clear.mission_type == MAV_MISSION_TYPE_MISSION) {
+                m_currentSeq = 0;
+            }
+            sendMissionAck(msg.sysid, msg.compid, clear.mission_type, MAV_MISSION_ACCEPTED, out);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_SET_CURRENT: {
+            mavlink_mission_set_current_t setCurrent;
+            mavlink_msg_mission_set_current_decode(&msg, &setCurrent);
+            if (setCurrent.seq < missionCount()) {
+                startMissionItem(setCurrent.seq);
+            }
+            sendMissionCurrent(out);
+            break;
+        }
+        case MAVLINK_MSG_ID_TIMESYNC: {
+            mavlink_timesync_t timesync;
+            mavlink_msg_timesync_decode(&msg, &timesync);
+            if (timesync.tc1 == 0) {
+                mavlink_timesync_t reply{};
+                reply.tc1 = nowUs * 1000;
+                reply.ts1 = timesync.ts1;
+                send(reply, out);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void SimVehicle::handleCommand(const mavlink_message_t& msg, qint64 nowUs, QByteArray& out) {
+    mavlink_command_long_t command;
+    mavlink_msg_command_long_decode(&msg, &command);
+
+    uint8_t result = MAV_RESULT_ACCEPTED;
+    switch (command.command) {
+        case MAV_CMD_COMPONENT_ARM_DISARM:
+            if (command.param1 > 0.5f) {
+                arm(true);
+            } else if (m_altitude > 0.5 &&
+                       static_cast<uint16_t>(command.param2) != FORCE_DISARM_MAGIC) {
+                result = MAV_RESULT_DENIED;  // in flight
+            } else {
+                arm(false);
+            }
+            break;
+        case MAV_CMD_NAV_TAKEOFF:
+            if (!m_armed || m_mode != Guided) {
+                result = MAV_RESULT_FAILED;
+            } else {
+                m_orbiting = false;
+                holdPosition();
+                m_targetAltitude = command.param7 > 0.0f ? command.param7 : 10.0;
+            }
+            break;
+        case MAV_CMD_NAV_LAND:
+            setMode(Land);
+            break;
+        case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+            setMode(Rtl);
+            break;
+        case MAV_CMD_DO_SET_MODE:
+            result = setMode(static_cast<uint32_t>(command.param2)) ? MAV_RESULT_ACCEPTED
+                                                                    : MAV_RESULT_DENIED;
+            break;
+        case MAV_CMD_DO_CHANGE_SPEED:
+            if (command.param2 > 0.0f) {
+                m_cruiseSpeed = command.param2;
+            }
+            break;
+        case MAV_CMD_MISSION_START:
+            if (!m_armed || !setMode(Auto)) {
+                result = MAV_RESULT_FAILED;
+            } else if (command.param1 >= 1.0f) {
+                startMissionItem(static_cast<int>(command.param1));
+            }
+            break;
+        case MAV_CMD_SET_MESSAGE_INTERVAL:
+            result = setStreamInterval(static_cast<uint32_t>(command.param1),
+                                       static_cast<qint64>(command.param2), nowUs)
+                         ? MAV_RESULT_ACCEPTED
+                         : MAV_RESULT_DENIED;
+            break;
+        case MAV_CMD_GET_HOME_POSITION:
+            sendHomePosition(out);
+            break;
+        default:
+            result = MAV_RESULT_UNSUPPORTED;
+            break;
+    }
+    sendCommandAck(msg, command.command, result, out);
+}
+
+void SimVehicle::handleMissionCount(const mavlink_message_t& msg, qint64 nowUs,
+                                    QByteArray& out) {
+    mavlink_mission_count_t count;
+    mavlink_msg_mission_count_decode(&msg, &count);
+
+    // A new count restarts any upload in progress
+    m_upload = Upload{};
+    m_upload.missionType = count.mission_type;
+    m_upload.gcsSystemId = msg.sysid;
+    m_upload.gcsComponentId = msg.compid;
+    m_upload.count = count.count;
+
+    if (count.count == 0) {
+        m_missions.remove(count.mission_type);
+        sendMissionAck(msg.sysid, msg.compid, count.mission_type, MAV_MISSION_ACCEPTED, out);
+        return;
+    }
+    m_upload.active = true;
+    m_upload.items.resize(count.count);
+    requestNextItem(nowUs, out);
+}
+
+void SimVehicle::handleMissionItem(const mavlink_mission_item_int_t& item, qint64 nowUs,
+                                   QByteArray& out) {
+    if (!m_upload.active) {
+        // The ground station resends the last item when our ACK got lost
+        if (m_upload.count > 0 && item.mission_type == m_upload.missionType &&
+            item.seq == m_upload.count - 1) {
+            sendMissionAck(m_upload.gcsSystemId, m_upload.gcsComponentId, m_upload.missionType,
+                           MAV_MISSION_ACCEPTED, out);
+        }
+        return;
+    }
+    if (item.mission_type != m_upload.missionType || item.seq != m_upload.nextSeq) {
+        return;  // duplicate or out of order; the retry timer asks again
+    }
+
+    m_upload.items[item.seq] = item;
+    m_upload.nextSeq++;
+    m_upload.retries = 0;
+    if (m_upload.nextSeq < m_upload.count) {
+        requestNextItem(nowUs, out);
+        return;
+    }
+
+    m_upload.active = false;
+    m_missions.insert(m_upload.missionType, m_upload.items);
+    m_upload.items.clear();
+    if (m_upload.missionType == MAV_MISSION_TYPE_MISSION) {
+        m_currentSeq = m_upload.count > 1 ? 1 : 0;
+    }
+    sendMissionAck(m_upload.gcsSystemId, m_upload.gcsComponentId, m_upload.missionType,
+                   MAV_MISSION_ACCEPTED, out);
+}
+
+void SimVehicle::handleMissionRequest(const mavlink_message_t& msg, uint16_t seq,
+                                      uint8_t missionType, bool asInt, QByteArray& out) {
+    const QVector<mavlink_mission_item_int_t> mission = m_missions.value(missionType);
+    if (seq >= mission.size()) {
+        sendMissionAck(msg.sysid, msg.compid, missionType, MAV_MISSION_INVALID_SEQUENCE, out);
+        return;
+    }
+
+    mavlink_mission_item_int_t item = mission.at(seq);
+    item.target_system = msg.sysid;
+    item.target_component = msg.compid;
+    item.current = seq == m_currentSeq ? 1 : 0;
+    if (asInt) {
+        send(item, out);
+        return;
+    }
+
+    mavlink_mission_item_t legacy{};
+    const double scale = isGlobalFrame(item.frame) ? 1e-7 : 1e-4;
+    legacy.param1 = item.param1;
+    legacy.param2 = item.param2;
+    legacy.param3 = item.param3;
+    legacy.param4 = item.param4;
+    legacy.x = static_cast<float>(item.x * scale);
+    legacy.y = static_cast<float>(item.y * scale);
+    legacy.z = item.z;
+    legacy.seq = item.seq;
+    legacy.command = item.command;
+    legacy.target_system = item.target_system;
+    legacy.target_component = item.target_component;
+    legacy.frame = item.frame;
+    legacy.current = item.current;
+    legacy.autocontinue = item.autocontinue;
+    legacy.mission_type = item.mission_type;
+    send(legacy, out);
+}
+
+void SimVehicle::requestNextItem(qint64 nowUs, QByteArray& out) {
+    mavlink_mission_request_int_t request{};
+    request.target_system = m_upload.gcsSystemId;
+    request.target_component = m_upload.gcsComponentId;
+    request.seq = m_upload.nextSeq;
+    request.mission_type = m_upload.missionType;
+    send(request, out);
+    m_upload.lastRequestUs = nowUs;
+}
+
+void SimVehicle::sendMissionAck(uint8_t targetSystem, uint8_t targetComponent,
+                                uint8_t missionType, uint8_t result, QByteArray& out) {
+    mavlink_mission_ack_t ack{};
+    ack.target_system = targetSystem;
+    ack.target_component = targetComponent;
+    ack.type = result;
+    ack.mission_type = missionType;
+    send(ack, out);
+}
+
+void SimVehicle::sendCommandAck(const mavlink_message_t& msg, uint16_t command, uint8_t result,
+                                QByteArray& out) {
+    mavlink_command_ack_t ack{};
+    ack.command = command;
+    ack.result = result;
+    ack.target_system = msg.sysid;
+    ack.target_component = msg.compid;
+    send(ack, out);
+}
+
+void SimVehicle::sendMissionCurrent(QByteArray& out) {
+    mavlink_mission_current_t current{};
+    current.seq = static_cast<uint16_t>(m_currentSeq);
+    send(current, out);
+}
+
+void SimVehicle::sendHomePosition(QByteArray& out) {
+    mavlink_home_position_t home{};
+    home.latitude = static_cast<int32_t>(m_homeLatitude * 1e7);
+    home.longitude = static_cast<int32_t>(m_homeLongitude * 1e7);
+    home.altitude = static_cast<int32_t>(HOME_ALTITUDE_MSL_M * 1000.0);
+    home.q[0] = 1.0f;
+    send(home, out);
+}
+
+bool SimVehicle::setMode(uint32_t mode) {
+    switch (mode) {
+        case Stabilize:
+        case AltHold:
+        case Loiter:
+        case Guided:
+        case Land:
+        case Rtl:
+            break;
+        case Auto:
+            // Needs something to fly besides the home position
+            if (missionCount() < 2) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+    if (mode == m_mode) {
+        return true;
+    }
+
+    m_mode = mode;
+    m_orbiting = false;
+    holdPosition();
+    if (mode == Auto) {
+        startMissionItem(m_currentSeq);
+    }
+    return true;
+}
+
+void SimVehicle::arm(bool armed) {
+    if (armed == m_armed) {
+        return;
+    }
+    m_armed = armed;
+    holdPosition();
+    if (!armed) {
+        m_orbiting = false;
+    }
+}
+
+void SimVehicle::startMissionItem(int seq) {
+    // Item 0 is home; (re)starting the mission starts at 1
+    m_currentSeq = m_mode == Auto ? qMax(1, seq) : seq;
+    if (m_mode == Auto && seq >= missionCount()) {
+        // Mission complete: hold where it ended
+        m_mode = Loiter;
+        holdPosition();
+    }
+}
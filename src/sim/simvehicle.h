@@ -0,0 +1,172 @@
+#ifndef SIMVEHICLE_H
+#define SIMVEHICLE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <random>
+#include "../comm/mavlinkmessagetraits.h"
+
+/**
+ * @brief One lightweight simulated ArduCopter for load generation
+ *
+ * Not a flight dynamics model: the vehicle moves towards its current target
+ * at a fixed cruise speed, banks and pitches in proportion, and drains its
+ * battery, which is enough for telemetry that looks and varies like the real
+ * thing. Each telemetry message is streamed at its own rate, with the phase
+ * spread across vehicles so a fleet does not send in lockstep.
+ *
+ * It answers what a GCS sends an autopilot: the mission protocol (upload,
+ * download, clear, set current), COMMAND_LONG (arm/disarm, takeoff, land,
+ * RTL, mode, speed, mission start, message intervals), SET_MODE and
+ * TIMESYNC. Packets are framed with the vehicle's own sequence counter, not
+ * a shared MAVLink channel, so any number of vehicles can run in one process.
+ *
+ * Not thread-safe; driven by VehicleSimulator.
+ */
+class SimVehicle {
+public:
+    // ArduCopter custom modes
+    enum Mode : uint32_t {
+        Stabilize = 0,
+        AltHold = 2,
+        Auto = 3,
+        Guided = 4,
+        Loiter = 5,
+        Rtl = 6,
+        Land = 9,
+    };
+
+    /**
+     * @brief Telemetry stream rates in Hz (0 disables a stream)
+     */
+    struct Rates {
+        double heartbeatHz{1.0};
+        double attitudeHz{50.0};
+        double globalPositionHz{10.0};
+        double vfrHudHz{10.0};
+        double gpsRawHz{5.0};
+        double sysStatusHz{1.0};
+        double batteryStatusHz{1.0};
+        double missionCurrentHz{1.0};
+    };
+
+    /**
+     * @param airborne Start armed in GUIDED, orbiting home at 30-60 m
+     */
+    SimVehicle(uint8_t systemId, double homeLatitude, double homeLongitude, const Rates& rates,
+               bool airborne);
+
+    uint8_t systemId() const { return m_systemId; }
+    bool armed() const { return m_armed; }
+    uint32_t customMode() const { return m_mode; }
+    double latitude() const { return m_latitude; }
+    double longitude() const { return m_longitude; }
+    double altitude() const { return m_altitude; }
+    int missionCount(uint8_t missionType = MAV_MISSION_TYPE_MISSION) const {
+        return m_missions.value(missionType).size();
+    }
+    int currentMissionItem() const { return m_currentSeq; }
+    quint64 messagesSent() const { return m_messagesSent; }
+
+    /**
+     * @brief Advance the vehicle to @p nowUs and append the telemetry that is due
+     */
+    void update(qint64 nowUs, QByteArray& out);
+
+    /**
+     * @brief Handle a message addressed to this vehicle (or broadcast)
+     *
+     * Replies are appended to @p out.
+     */
+    void handleMessage(const mavlink_message_t& msg, qint64 nowUs, QByteArray& out);
+
+private:
+    struct Stream {
+        uint32_t msgId;
+        qint64 defaultIntervalUs;
+        qint64 intervalUs;  // 0 = disabled
+        qint64 nextUs;
+    };
+
+    // Mission upload in progress (the vehicle drives it by requesting items)
+    struct Upload {
+        bool active{false};
+        uint8_t missionType{0};
+        uint8_t gcsSystemId{0};
+        uint8_t gcsComponentId{0};
+        uint16_t count{0};
+        uint16_t nextSeq{0};
+        QVector<mavlink_mission_item_int_t> items;
+        qint64 lastRequestUs{0};
+        int retries{0};
+    };
+
+    template <typename T>
+    void send(const T& payload, QByteArray& out);
+
+    void step(double dt);
+    void flyTowards(double north, double east, double dt);
+    void holdPosition();
+    void updatePositionTarget();
+    void emitTelemetry(uint32_t msgId, qint64 nowUs, QByteArray& out);
+    bool setStreamInterval(uint32_t msgId, qint64 intervalUs, qint64 nowUs);
+
+    void handleCommand(const mavlink_message_t& msg, qint64 nowUs, QByteArray& out);
+    void handleMissionCount(const mavlink_message_t& msg, qint64 nowUs, QByteArray& out);
+    void handleMissionItem(const mavlink_mission_item_int_t& item, qint64 nowUs, QByteArray& out);
+    void handleMissionRequest(const mavlink_message_t& msg, uint16_t seq, uint8_t missionType,
+                              bool asInt, QByteArray& out);
+    void requestNextItem(qint64 nowUs, QByteArray& out);
+    void sendMissionAck(uint8_t targetSystem, uint8_t targetComponent, uint8_t missionType,
+                        uint8_t result, QByteArray& out);
+    void sendCommandAck(const mavlink_message_t& msg, uint16_t command, uint8_t result,
+                        QByteArray& out);
+
+    bool setMode(uint32_t mode);
+    void arm(bool armed);
+    void startMissionItem(int seq);
+    void sendMissionCurrent(QByteArray& out);
+    void sendHomePosition(QByteArray& out);
+
+    uint8_t m_systemId;
+    mavlink_status_t m_txStatus;  // per-vehicle sequence numbers
+    std::mt19937 m_random;
+    std::normal_distribution<double> m_noise{0.0, 1.0};
+
+    QVector<Stream> m_streams;
+    qint64 m_lastUpdateUs;
+    qint64 m_bootUs;
+
+    // State; positions are metres north/east of home
+    double m_homeLatitude;
+    double m_homeLongitude;
+    double m_latitude;
+    double m_longitude;
+    double m_north;
+    double m_east;
+    double m_altitude;  // relative to home
+    double m_targetNorth;
+    double m_targetEast;
+    double m_targetAltitude;
+    double m_velocityNorth;
+    double m_velocityEast;
+    double m_climbRate;
+    double m_roll;
+    double m_pitch;
+    double m_yaw;
+    double m_cruiseSpeed;
+    double m_orbitRadius;
+    double m_orbitAngle;
+    bool m_orbiting;  // demo circuit in GUIDED until given something else to do
+    double m_batteryRemaining;  // 0..1
+    bool m_armed;
+    uint32_t m_mode;
+
+    QHash<uint8_t, QVector<mavlink_mission_item_int_t>> m_missions;  // by mission type
+    Upload m_upload;
+    int m_currentSeq;
+    quint64 m_messagesSent;
+};
+
+#endif  // SIMVEHICLE_H
@@ -0,0 +1,114 @@
+#include "vehiclesimulator.h"
+#include <QDebug>
+#include <QTimer>
+#include "../comm/relaxedcounter.h"
+
+VehicleSimulator::VehicleSimulator(const Configuration& config, QObject* parent)
+    : QObject(parent), m_config(config), m_tickTimer(nullptr), m_rxMessage{}, m_rxStatus{} {
+    const int count = qBound(0, config.vehicleCount, 255 - config.firstSystemId + 1);
+    m_vehicles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_vehicles.push_back(std::make_unique<SimVehicle>(
+            static_cast<uint8_t>(config.firstSystemId + i), config.homeLatitude,
+            config.homeLongitude, config.rates, config.airborne));
+    }
+    m_config.vehicleCount = count;
+
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    m_tickTimer->setInterval(qMax(1, config.tickMs));
+    connect(m_tickTimer, &QTimer::timeout, this, &VehicleSimulator::onTick);
+    m_clock.start();
+}
+
+VehicleSimulator::~VehicleSimulator() = default;
+
+VehicleSimulator::Statistics VehicleSimulator::statistics() const {
+    Statistics stats;
+    stats.vehicles = m_config.vehicleCount;
+    stats.messagesSent = m_messagesSent.load(std::memory_order_relaxed);
+    stats.bytesSent = m_bytesSent.load(std::memory_order_relaxed);
+    stats.messagesReceived = m_messagesReceived.load(std::memory_order_relaxed);
+    stats.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool VehicleSimulator::isRunning() const {
+    return m_tickTimer->isActive();
+}
+
+const SimVehicle* VehicleSimulator::vehicle(uint8_t systemId) const {
+    const int index = systemId - m_config.firstSystemId;
+    if (index < 0 || index >= static_cast<int>(m_vehicles.size())) {
+        return nullptr;
+    }
+    return m_vehicles[index].get();
+}
+
+void VehicleSimulator::start() {
+    if (isRunning()) {
+        return;
+    }
+    qInfo() << "VehicleSimulator: Starting" << m_config.vehicleCount << "vehicles from system ID"
+            << m_config.firstSystemId;
+    m_tickTimer->start();
+    onTick();
+}
+
+void VehicleSimulator::stop() {
+    m_tickTimer->stop();
+}
+
+void VehicleSimulator::receiveBytes(const QByteArray& data) {
+    RelaxedCounter::add(m_bytesReceived, static_cast<quint64>(data.size()));
+
+    mavlink_message_t msg;
+    mavlink_status_t status;
+    for (const char byte : data) {
+        if (mavlink_frame_char_buffer(&m_rxMessage, &m_rxStatus, static_cast<uint8_t>(byte), &msg,
+                                      &status) == MAVLINK_FRAMING_OK) {
+            RelaxedCounter::add(m_messagesReceived, 1);
+            dispatch(msg);
+        }
+    }
+}
+
+void VehicleSimulator::onTick() {
+    const qint64 now = nowUs();
+    for (const auto& vehicle : m_vehicles) {
+        const quint64 sentBefore = vehicle->messagesSent();
+        m_output.clear();
+        vehicle->update(now, m_output);
+        emitBytes(*vehicle, sentBefore);
+    }
+}
+
+void VehicleSimulator::dispatch(const mavlink_message_t& msg) {
+    // Target system from the message definition; trimmed (zero) bytes mean broadcast
+    uint8_t targetSystem = 0;
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msg.msgid);
+    if (entry && (entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) &&
+        entry->target_system_ofs < msg.len) {
+        targetSystem = static_cast<uint8_t>(_MAV_PAYLOAD(&msg)[entry->target_system_ofs]);
+    }
+
+    const qint64 now = nowUs();
+    for (const auto& vehicle : m_vehicles) {
+        if (targetSystem != 0 && vehicle->systemId() != targetSystem) {
+            continue;
+        }
+        const quint64 sentBefore = vehicle->messagesSent();
+        m_output.clear();
+        vehicle->handleMessage(msg, now, m_output);
+        emitBytes(*vehicle, sentBefore);
+    }
+}
+
+void VehicleSimulator::emitBytes(const SimVehicle& vehicle, quint64 sentBefore) {
+    if (m_output.isEmpty()) {
+        return;
+    }
+    RelaxedCounter::add(m_messagesSent, vehicle.messagesSent() - sentBefore);
+    RelaxedCounter::add(m_bytesSent, static_cast<quint64>(m_output.size()));
+    emit bytesReady(vehicle.systemId(), m_output);
+}
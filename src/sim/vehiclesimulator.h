@@ -0,0 +1,106 @@
+#ifndef VEHICLESIMULATOR_H
+#define VEHICLESIMULATOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "simvehicle.h"
+
+class QTimer;
+
+/**
+ * @brief Fleet of SimVehicle instances acting as a load generator
+ *
+ * Lighter than SITL by orders of magnitude: dozens of vehicles streaming
+ * ATTITUDE at 50 Hz and GLOBAL_POSITION_INT at 10 Hz cost a fraction of one
+ * core, so FlightScope can be stressed well beyond what a desk full of
+ * autopilots would produce.
+ *
+ * Every TICK the vehicles are advanced and whatever each one has due is
+ * emitted as one bytesReady() chunk per vehicle. Bytes from the ground
+ * station go into receiveBytes(), are parsed without touching any global
+ * MAVLink channel and dispatched by target system (0 = every vehicle);
+ * replies go out through bytesReady() straight away.
+ *
+ * Transport-agnostic: SimulatorLink feeds it in process, the headless
+ * flightscope-sim tool sends it over UDP.
+ */
+class VehicleSimulator : public QObject {
+    Q_OBJECT
+
+public:
+    struct Configuration {
+        int vehicleCount{10};
+        uint8_t firstSystemId{1};
+        SimVehicle::Rates rates;
+        double homeLatitude{-35.363261};  // ArduPilot SITL default (Canberra)
+        double homeLongitude{149.165230};
+        bool airborne{true};  // start flying instead of disarmed on the ground
+        int tickMs{5};
+    };
+
+    /**
+     * @brief Traffic counters (safe to read from any thread)
+     */
+    struct Statistics {
+        int vehicles{0};
+        quint64 messagesSent{0};
+        quint64 bytesSent{0};
+        quint64 messagesReceived{0};
+        quint64 bytesReceived{0};
+    };
+
+    explicit VehicleSimulator(const Configuration& config, QObject* parent = nullptr);
+    ~VehicleSimulator() override;
+
+    Configuration configuration() const { return m_config; }
+    Statistics statistics() const;
+    bool isRunning() const;
+
+    /**
+     * @brief Vehicle by system ID, or nullptr
+     */
+    const SimVehicle* vehicle(uint8_t systemId) const;
+
+public slots:
+    void start();
+    void stop();
+
+    /**
+     * @brief Bytes from the ground station, in any chunking
+     */
+    void receiveBytes(const QByteArray& data);
+
+signals:
+    /**
+     * @brief Framed MAVLink packets from one vehicle
+     */
+    void bytesReady(uint8_t systemId, QByteArray data);
+
+private slots:
+    void onTick();
+
+private:
+    void dispatch(const mavlink_message_t& msg);
+    void emitBytes(const SimVehicle& vehicle, quint64 sentBefore);  // what is in m_output
+    qint64 nowUs() const { return m_clock.nsecsElapsed() / 1000; }
+
+    Configuration m_config;
+    std::vector<std::unique_ptr<SimVehicle>> m_vehicles;
+    QTimer* m_tickTimer;
+    QElapsedTimer m_clock;
+    QByteArray m_output;
+
+    // Private parser state; no MAVLink channel is shared with a router in the same process
+    mavlink_message_t m_rxMessage;
+    mavlink_status_t m_rxStatus;
+
+    std::atomic<quint64> m_messagesSent{0};
+    std::atomic<quint64> m_bytesSent{0};
+    std::atomic<quint64> m_messagesReceived{0};
+    std::atomic<quint64> m_bytesReceived{0};
+};
+
+#endif  // VEHICLESIMULATOR_H
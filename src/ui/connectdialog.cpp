@@ -1,15 +1,31 @@
 #include "connectdialog.h"
+#include "../comm/impairedlink.h"
+#include "../comm/replaylink.h"
+#include "../comm/tcplink.h"
+#include "../comm/tlogrecorder.h"
+#include "../comm/udplink.h"
+#include "../sim/simulatorlink.h"
+#ifdef FLIGHTSCOPE_SERIAL_LINK
+#include "../comm/seriallink.h"
+#include <QSerialPortInfo>
+#endif
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFormLayout>
-#include <QGroupBox>
 #include <QLabel>
 #include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QFileInfo>
 
 ConnectDialog::ConnectDialog(QWidget* parent)
     : QDialog(parent), m_presetCombo(nullptr), m_connectTypeCombo(nullptr),
       m_localAddressEdit(nullptr), m_localPortSpin(nullptr), m_remoteAddressEdit(nullptr),
-      m_remotePortSpin(nullptr), m_connectButton(nullptr), m_cancelButton(nullptr) {
+      m_remotePortSpin(nullptr), m_tcpServerCheck(nullptr), m_serialPortCombo(nullptr),
+      m_baudRateCombo(nullptr), m_flowControlCheck(nullptr), m_replayFileEdit(nullptr),
+      m_replayBrowseButton(nullptr), m_replaySpeedCombo(nullptr),
+      m_simulatorVehiclesSpin(nullptr), m_impairmentGroup(nullptr), m_latencySpin(nullptr),
+      m_jitterSpin(nullptr), m_lossSpin(nullptr), m_bandwidthSpin(nullptr), m_seedSpin(nullptr),
+      m_connectButton(nullptr), m_cancelButton(nullptr) {
     setupUi();
     loadPresets();
 }
@@ -17,7 +33,7 @@ ConnectDialog::ConnectDialog(QWidget* parent)
 void ConnectDialog::setupUi() {
     setWindowTitle("Connect to Vehicle");
     setModal(true);
-    resize(450, 350);
+    resize(450, 500);
 
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
 
@@ -39,8 +55,14 @@ void ConnectDialog::setupUi() {
 
     m_connectTypeCombo = new QComboBox(this);
     m_connectTypeCombo->addItem("UDP");
-    m_connectTypeCombo->addItem("Serial (Coming Soon)");
-    m_connectTypeCombo->addItem("TCP (Coming Soon)");
+#ifdef FLIGHTSCOPE_SERIAL_LINK
+    m_connectTypeCombo->addItem("Serial");
+#else
+    m_connectTypeCombo->addItem("Serial (Not Available)");
+#endif
+    m_connectTypeCombo->addItem("TCP");
+    m_connectTypeCombo->addItem("Replay Telemetry Log");
+    m_connectTypeCombo->addItem("Simulated Vehicles");
     m_connectTypeCombo->setCurrentIndex(0);
     m_connectTypeCombo->setEnabled(true);
     connect(m_connectTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
@@ -64,8 +86,96 @@ void ConnectDialog::setupUi() {
     m_remotePortSpin->setValue(14550);
     connectionLayout->addRow("Remote Port:", m_remotePortSpin);
 
+    // TCP server mode uses the local address/port, client mode the remote one
+    m_tcpServerCheck = new QCheckBox("Listen for incoming connection", this);
+    connectionLayout->addRow("TCP Mode:", m_tcpServerCheck);
+    connect(m_tcpServerCheck, &QCheckBox::toggled, this,
+            [this]() { onConnectTypeChanged(m_connectTypeCombo->currentIndex()); });
+
+    // Serial Configuration
+    m_serialPortCombo = new QComboBox(this);
+    m_serialPortCombo->setEditable(true);  // allow ports that are not enumerated (e.g. ptys)
+#ifdef FLIGHTSCOPE_SERIAL_LINK
+    for (const QSerialPortInfo& info : QSerialPortInfo::availablePorts()) {
+        m_serialPortCombo->addItem(info.systemLocation());
+    }
+#endif
+    connectionLayout->addRow("Serial Port:", m_serialPortCombo);
+
+    m_baudRateCombo = new QComboBox(this);
+    for (int baud : {57600, 115200, 230400, 460800, 921600}) {
+        m_baudRateCombo->addItem(QString::number(baud), baud);
+    }
+    connectionLayout->addRow("Baud Rate:", m_baudRateCombo);
+
+    m_flowControlCheck = new QCheckBox("Hardware flow control (RTS/CTS)", this);
+    connectionLayout->addRow("Flow Control:", m_flowControlCheck);
+
+    // Replay Configuration
+    QWidget* replayFileWidget = new QWidget(this);
+    QHBoxLayout* replayFileLayout = new QHBoxLayout(replayFileWidget);
+    replayFileLayout->setContentsMargins(0, 0, 0, 0);
+    m_replayFileEdit = new QLineEdit(this);
+    m_replayFileEdit->setPlaceholderText("flight.tlog");
+    m_replayBrowseButton = new QPushButton("Browse...", this);
+    connect(m_replayBrowseButton, &QPushButton::clicked, this,
+            &ConnectDialog::onBrowseReplayFile);
+    replayFileLayout->addWidget(m_replayFileEdit);
+    replayFileLayout->addWidget(m_replayBrowseButton);
+    connectionLayout->addRow("Log File:", replayFileWidget);
+
+    m_replaySpeedCombo = new QComboBox(this);
+    for (double speed : {1.0, 2.0, 5.0, 10.0, 50.0}) {
+        m_replaySpeedCombo->addItem(QString("%1x").arg(speed), speed);
+    }
+    m_replaySpeedCombo->addItem("As fast as possible", ReplayLink::AS_FAST_AS_POSSIBLE);
+    connectionLayout->addRow("Replay Speed:", m_replaySpeedCombo);
+
+    // Simulator Configuration
+    m_simulatorVehiclesSpin = new QSpinBox(this);
+    m_simulatorVehiclesSpin->setRange(1, 255);
+    m_simulatorVehiclesSpin->setValue(10);
+    connectionLayout->addRow("Vehicles:", m_simulatorVehiclesSpin);
+
     mainLayout->addWidget(connectionGroup);
 
+    // Impairment: makes a local link behave like a poor radio link, for testing
+    m_impairmentGroup = new QGroupBox("Emulate Poor Link (Testing)", this);
+    m_impairmentGroup->setCheckable(true);
+    m_impairmentGroup->setChecked(false);
+    QFormLayout* impairmentLayout = new QFormLayout(m_impairmentGroup);
+
+    m_latencySpin = new QSpinBox(this);
+    m_latencySpin->setRange(0, 10000);
+    m_latencySpin->setValue(150);
+    m_latencySpin->setSuffix(" ms");
+    impairmentLayout->addRow("Latency:", m_latencySpin);
+
+    m_jitterSpin = new QSpinBox(this);
+    m_jitterSpin->setRange(0, 5000);
+    m_jitterSpin->setSuffix(" ms");
+    impairmentLayout->addRow("Jitter:", m_jitterSpin);
+
+    m_lossSpin = new QDoubleSpinBox(this);
+    m_lossSpin->setRange(0.0, 100.0);
+    m_lossSpin->setSingleStep(0.5);
+    m_lossSpin->setValue(5.0);
+    m_lossSpin->setSuffix(" %");
+    impairmentLayout->addRow("Packet Loss:", m_lossSpin);
+
+    m_bandwidthSpin = new QSpinBox(this);
+    m_bandwidthSpin->setRange(0, 100000);
+    m_bandwidthSpin->setSuffix(" kB/s");
+    m_bandwidthSpin->setSpecialValueText("Unlimited");
+    impairmentLayout->addRow("Bandwidth:", m_bandwidthSpin);
+
+    // Same seed, same traffic: the same packets are lost every run
+    m_seedSpin = new QSpinBox(this);
+    m_seedSpin->setRange(1, 1000000);
+    impairmentLayout->addRow("Seed:", m_seedSpin);
+
+    mainLayout->addWidget(m_impairmentGroup);
+
     // Info label
     QLabel* infoLabel = new QLabel(
         "<b>Important:</b> FlightScope listens on a different port to avoid conflicts.<br>"
@@ -89,6 +199,8 @@ void ConnectDialog::setupUi() {
     connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
 
     mainLayout->addWidget(buttonBox);
+
+    onConnectTypeChanged(m_connectTypeCombo->currentIndex());
 }
 
 void ConnectDialog::loadPresets() {
@@ -122,6 +234,16 @@ void ConnectDialog::loadPresets() {
     mavproxy.remotePort = 14550;
     m_presets.append(mavproxy);
 
+    // ArduPilot SITL serves MAVLink on TCP 5760
+    Preset arduPilotTcp;
+    arduPilotTcp.name = "ArduPilot SITL (TCP 5760)";
+    arduPilotTcp.type = Tcp;
+    arduPilotTcp.localAddress = "0.0.0.0";
+    arduPilotTcp.localPort = 5760;
+    arduPilotTcp.remoteAddress = "127.0.0.1";
+    arduPilotTcp.remotePort = 5760;
+    m_presets.append(arduPilotTcp);
+
     // Populate combo box
     for (const Preset& preset : m_presets) {
         m_presetCombo->addItem(preset.name);
@@ -137,6 +259,8 @@ void ConnectDialog::onPresetChanged(int index) {
     // Apply preset (index - 1 because first item is "Custom Configuration")
     const Preset& preset = m_presets[index - 1];
 
+    m_connectTypeCombo->setCurrentIndex(preset.type);
+    m_tcpServerCheck->setChecked(preset.tcpServer);
     m_localAddressEdit->setText(preset.localAddress);
     m_localPortSpin->setValue(preset.localPort);
     m_remoteAddressEdit->setText(preset.remoteAddress);
@@ -144,17 +268,113 @@ void ConnectDialog::onPresetChanged(int index) {
 }
 
 void ConnectDialog::onConnectTypeChanged(int index) {
-    // Currently only UDP is supported
-    bool isUdp = (index == 0);
-
-    m_localAddressEdit->setEnabled(isUdp);
-    m_localPortSpin->setEnabled(isUdp);
-    m_remoteAddressEdit->setEnabled(isUdp);
-    m_remotePortSpin->setEnabled(isUdp);
-    m_connectButton->setEnabled(isUdp);
+    const bool isUdp = (index == Udp);
+    const bool isTcp = (index == Tcp);
+#ifdef FLIGHTSCOPE_SERIAL_LINK
+    const bool isSerial = (index == Serial);
+#else
+    const bool isSerial = false;
+#endif
+    const bool isReplay = (index == Replay);
+    const bool isSimulator = (index == Simulator);
+    const bool tcpServer = isTcp && m_tcpServerCheck->isChecked();
+
+    m_localAddressEdit->setEnabled(isUdp || tcpServer);
+    m_localPortSpin->setEnabled(isUdp || tcpServer);
+    m_remoteAddressEdit->setEnabled(isUdp || (isTcp && !tcpServer));
+    m_remotePortSpin->setEnabled(isUdp || (isTcp && !tcpServer));
+    m_tcpServerCheck->setEnabled(isTcp);
+    m_serialPortCombo->setEnabled(isSerial);
+    m_baudRateCombo->setEnabled(isSerial);
+    m_flowControlCheck->setEnabled(isSerial);
+    m_replayFileEdit->setEnabled(isReplay);
+    m_replayBrowseButton->setEnabled(isReplay);
+    m_replaySpeedCombo->setEnabled(isReplay);
+    m_simulatorVehiclesSpin->setEnabled(isSimulator);
+    // A replay is paced by its own timestamps
+    m_impairmentGroup->setEnabled(!isReplay);
+    m_connectButton->setEnabled(isUdp || isTcp || isSerial || isReplay || isSimulator);
 }
 
-UdpLink* ConnectDialog::getConfiguredLink() {
+void ConnectDialog::onBrowseReplayFile() {
+    const QString filePath = QFileDialog::getOpenFileName(
+        this, "Open Telemetry Log", TlogRecorder::defaultDirectory(),
+        "Telemetry Logs (*.tlog);;All Files (*)");
+    if (!filePath.isEmpty()) {
+        m_replayFileEdit->setText(filePath);
+    }
+}
+
+LinkInterface* ConnectDialog::getConfiguredLink() {
+    LinkInterface* link = createLink();
+    if (!link || !m_impairmentGroup->isEnabled() || !m_impairmentGroup->isChecked()) {
+        return link;
+    }
+
+    ImpairedLink::Configuration config;
+    config.inbound.latencyMs = m_latencySpin->value();
+    config.inbound.jitterMs = m_jitterSpin->value();
+    config.inbound.lossRate = m_lossSpin->value() / 100.0;
+    config.inbound.bandwidthBytesPerSec = static_cast<quint64>(m_bandwidthSpin->value()) * 1000;
+    config.outbound = config.inbound;
+    config.seed = static_cast<quint32>(m_seedSpin->value());
+    return new ImpairedLink(link, config);
+}
+
+LinkInterface* ConnectDialog::createLink() {
+    if (m_connectTypeCombo->currentIndex() == Tcp) {
+        TcpLink::Configuration config;
+        config.isServer = m_tcpServerCheck->isChecked();
+        if (config.isServer) {
+            config.address = QHostAddress(m_localAddressEdit->text());
+            config.port = static_cast<quint16>(m_localPortSpin->value());
+            config.name =
+                QString("TCP server %1:%2").arg(m_localAddressEdit->text()).arg(config.port);
+        } else {
+            config.address = QHostAddress(m_remoteAddressEdit->text());
+            config.port = static_cast<quint16>(m_remotePortSpin->value());
+            config.name = QString("TCP %1:%2").arg(m_remoteAddressEdit->text()).arg(config.port);
+        }
+        return new TcpLink(config);
+    }
+
+    if (m_connectTypeCombo->currentIndex() == Replay) {
+        ReplayLink::Configuration config;
+        config.filePath = m_replayFileEdit->text().trimmed();
+        if (config.filePath.isEmpty()) {
+            return nullptr;
+        }
+        config.speed = m_replaySpeedCombo->currentData().toDouble();
+        config.name = QString("Replay %1").arg(QFileInfo(config.filePath).fileName());
+        return new ReplayLink(config);
+    }
+
+    if (m_connectTypeCombo->currentIndex() == Simulator) {
+        SimulatorLink::Configuration config;
+        config.simulator.vehicleCount = m_simulatorVehiclesSpin->value();
+        config.name = QString("Simulator (%1 vehicles)").arg(config.simulator.vehicleCount);
+        return new SimulatorLink(config);
+    }
+
+#ifdef FLIGHTSCOPE_SERIAL_LINK
+    if (m_connectTypeCombo->currentIndex() == Serial) {
+        SerialLink::Configuration config;
+        config.portName = m_serialPortCombo->currentText().trimmed();
+        if (config.portName.isEmpty()) {
+            return nullptr;
+        }
+        config.baudRate = m_baudRateCombo->currentData().toInt();
+        config.flowControl = m_flowControlCheck->isChecked() ? QSerialPort::HardwareControl
+                                                             : QSerialPort::NoFlowControl;
+        config.name = QString("Serial %1 @ %2").arg(config.portName).arg(config.baudRate);
+        return new SerialLink(config);
+    }
+#endif
+
+    if (m_connectTypeCombo->currentIndex() != Udp) {
+        return nullptr;
+    }
+
     UdpLink::Configuration config;
     config.name = QString("UDP %1:%2").arg(m_localAddressEdit->text()).arg(m_localPortSpin->value());
     config.localAddress = QHostAddress(m_localAddressEdit->text());
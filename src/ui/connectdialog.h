@@ -2,19 +2,24 @@
 #define CONNECTDIALOG_H
 
 #include <QDialog>
+#include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QGroupBox>
 #include <QLineEdit>
 #include <QSpinBox>
 #include <QPushButton>
-#include "../comm/udplink.h"
+#include "../comm/linkinterface.h"
 
 /**
  * @brief Dialog for configuring and initiating connections
  *
  * Provides UI for:
- * - Selecting connection type (UDP, Serial, TCP)
+ * - Selecting connection type (UDP, Serial, TCP, telemetry log replay,
+ *   simulated vehicles)
  * - Configuring connection parameters
  * - Preset configurations for SITL
+ * - Optional link impairment (latency, loss, bandwidth) for testing
  */
 class ConnectDialog : public QDialog {
     Q_OBJECT
@@ -24,18 +29,25 @@ public:
     ~ConnectDialog() override = default;
 
     /**
-     * @brief Get the configured UDP link
-     * @return Configured UdpLink (caller takes ownership)
+     * @brief Get the configured link
+     * @return Configured UdpLink, TcpLink, SerialLink, ReplayLink or SimulatorLink,
+     * wrapped in an ImpairedLink when impairment is enabled (caller takes
+     * ownership), or null
      */
-    UdpLink* getConfiguredLink();
+    LinkInterface* getConfiguredLink();
 
 private slots:
     void onPresetChanged(int index);
     void onConnectTypeChanged(int index);
+    void onBrowseReplayFile();
 
 private:
+    // Indices of m_connectTypeCombo
+    enum ConnectType { Udp = 0, Serial = 1, Tcp = 2, Replay = 3, Simulator = 4 };
+
     void setupUi();
     void loadPresets();
+    LinkInterface* createLink();
 
     // UI Elements
     QComboBox* m_presetCombo;
@@ -47,12 +59,38 @@ private:
     QLineEdit* m_remoteAddressEdit;
     QSpinBox* m_remotePortSpin;
 
+    // TCP specific
+    QCheckBox* m_tcpServerCheck;
+
+    // Serial specific
+    QComboBox* m_serialPortCombo;
+    QComboBox* m_baudRateCombo;
+    QCheckBox* m_flowControlCheck;
+
+    // Replay specific
+    QLineEdit* m_replayFileEdit;
+    QPushButton* m_replayBrowseButton;
+    QComboBox* m_replaySpeedCombo;
+
+    // Simulator specific
+    QSpinBox* m_simulatorVehiclesSpin;
+
+    // Impairment (both directions alike)
+    QGroupBox* m_impairmentGroup;
+    QSpinBox* m_latencySpin;
+    QSpinBox* m_jitterSpin;
+    QDoubleSpinBox* m_lossSpin;
+    QSpinBox* m_bandwidthSpin;
+    QSpinBox* m_seedSpin;
+
     QPushButton* m_connectButton;
     QPushButton* m_cancelButton;
 
     // Presets
     struct Preset {
         QString name;
+        ConnectType type{Udp};
+        bool tcpServer{false};
         QString localAddress;
         quint16 localPort;
         QString remoteAddress;
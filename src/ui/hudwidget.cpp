@@ -1,4 +1,5 @@
 #include "hudwidget.h"
+#include "../comm/latencytrace.h"
 #include <QPainter>
 #include <QPainterPath>
 #include <QFont>
@@ -12,7 +13,9 @@ HudWidget::HudWidget(QWidget* parent)
       m_heading(0.0f),
       m_groundSpeed(0.0f),
       m_pitch(0.0f),
-      m_roll(0.0f) {
+      m_roll(0.0f),
+      m_attitudeTraceKey(0),
+      m_paintedTraceKey(0) {
 
     setMinimumSize(400, 350);
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -52,6 +55,12 @@ void HudWidget::setRoll(float roll) {
     update();
 }
 
+void HudWidget::setAttitudeTraceKey(quint64 key) {
+    if (key != m_paintedTraceKey) {
+        m_attitudeTraceKey = key;
+    }
+}
+
 void HudWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
 
@@ -78,6 +87,13 @@ void HudWidget::paintEvent(QPaintEvent* event) {
 
     // Draw telemetry data corners
     drawTelemetryData(painter, rect);
+
+    // Frame is complete; close the latency trace of the attitude it shows
+    if (m_attitudeTraceKey) {
+        LatencyTrace::instance().record(LatencyTrace::WidgetPaint, m_attitudeTraceKey);
+        m_paintedTraceKey = m_attitudeTraceKey;
+        m_attitudeTraceKey = 0;
+    }
 }
 
 void HudWidget::drawArtificialHorizon(QPainter& painter, const QRect& rect) {
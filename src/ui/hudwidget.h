@@ -15,6 +15,14 @@ public:
     void setPitch(float pitch);
     void setRoll(float roll);
 
+    /**
+     * @brief LatencyTrace key of the attitude being shown
+     *
+     * The next paint after the key changes is recorded as its WidgetPaint
+     * trace point.
+     */
+    void setAttitudeTraceKey(quint64 key);
+
 protected:
     void paintEvent(QPaintEvent* event) override;
 
@@ -31,6 +39,9 @@ private:
     float m_groundSpeed;
     float m_pitch;
     float m_roll;
+
+    quint64 m_attitudeTraceKey;  // waiting to be painted, 0 if none
+    quint64 m_paintedTraceKey;   // last key recorded as painted
 };
 
 #endif  // HUDWIDGET_H
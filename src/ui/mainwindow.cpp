@@ -1,6 +1,9 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "connectdialog.h"
+#include "../comm/impairedlink.h"
+#include "../comm/udplink.h"
+#include "../comm/latencytrace.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QAction>
@@ -9,24 +12,32 @@
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QFormLayout>
+#include <QDateTime>
 #include <QFile>
+#include <QFileDialog>
 #include <QFrame>
 #include <QHBoxLayout>
 #include <QSplitter>
 #include <QScrollArea>
 #include <QGuiApplication>
 #include <QResizeEvent>
+#include <QThread>
+#include <QActionGroup>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent), ui(new Ui::MainWindow), m_currentFormFactor(Desktop),
       m_connectionStatusLabel(nullptr),
       m_gpsStatusLabel(nullptr), m_batteryStatusLabel(nullptr), m_modeStatusLabel(nullptr),
-      m_linkStatsLabel(nullptr), m_linkManager(nullptr), m_mavlinkRouter(nullptr),
-      m_commandBus(nullptr), m_vehicleModel(nullptr), m_healthModel(nullptr),
-      m_missionModel(nullptr), m_geofenceModel(nullptr), m_telemetryDock(nullptr), m_hudDock(nullptr),
-      m_healthDock(nullptr), m_missionDock(nullptr), m_telemetryWidget(nullptr),
-      m_hudWidget(nullptr), m_healthWidget(nullptr), m_missionEditor(nullptr), m_mapWidget(nullptr),
-      m_disconnectAction(nullptr), m_disconnectToolAction(nullptr), m_updateTimer(nullptr),
+      m_linkStatsLabel(nullptr), m_linkManager(nullptr), m_parserThread(nullptr),
+      m_mavlinkRouter(nullptr), m_commandBus(nullptr), m_tlogRecorder(nullptr),
+      m_vehicleRegistry(nullptr), m_vehicleModel(nullptr), m_healthModel(nullptr),
+      m_missionModel(nullptr), m_geofenceModel(nullptr), m_vehicleCombo(nullptr),
+      m_telemetryDock(nullptr), m_hudDock(nullptr),
+      m_healthDock(nullptr), m_missionDock(nullptr), m_chartDock(nullptr),
+      m_telemetryWidget(nullptr), m_hudWidget(nullptr), m_healthWidget(nullptr),
+      m_missionEditor(nullptr), m_chartWidget(nullptr), m_mapWidget(nullptr),
+      m_disconnectAction(nullptr), m_disconnectToolAction(nullptr), m_recordAction(nullptr),
+      m_replayMenu(nullptr), m_replayPauseAction(nullptr), m_updateTimer(nullptr),
       m_bottomNavBar(nullptr), m_contentStack(nullptr) {
     ui->setupUi(this);
 
@@ -35,7 +46,23 @@ MainWindow::MainWindow(QWidget* parent)
 
     // Create core components
     m_linkManager = new LinkManager(this);
-    m_mavlinkRouter = new MavlinkRouter(this);
+
+    // MAVLink parsing runs on its own thread so GUI stalls cannot delay
+    // protocol replies; decoded telemetry comes back in coalesced batches
+    m_parserThread = new QThread(this);
+    m_parserThread->setObjectName("MavlinkParser");
+    m_mavlinkRouter = new MavlinkRouter();
+    m_mavlinkRouter->moveToThread(m_parserThread);
+    connect(m_parserThread, &QThread::finished, m_mavlinkRouter, &QObject::deleteLater);
+    m_parserThread->start();
+
+    // Every packet the router accepts is teed into the flight log
+    m_tlogRecorder = new TlogRecorder(TlogRecorder::DEFAULT_BUFFER_BYTES, this);
+    m_mavlinkRouter->setTlogRecorder(m_tlogRecorder);
+
+    // Vehicles are created as their heartbeats arrive; until the first one
+    // the UI shows an empty placeholder model
+    m_vehicleRegistry = new VehicleRegistry(this);
     m_vehicleModel = new VehicleModel(this);
     m_healthModel = new HealthModel(this);
     m_missionModel = new MissionModel(this);
@@ -63,7 +90,14 @@ MainWindow::MainWindow(QWidget* parent)
 
 MainWindow::~MainWindow() {
     if (m_linkManager) {
-        m_linkManager->closeActiveLink();
+        m_linkManager->closeAllLinks();
+    }
+    if (m_parserThread) {
+        m_parserThread->quit();
+        m_parserThread->wait();
+    }
+    if (m_tlogRecorder) {
+        m_tlogRecorder->stop();
     }
     delete ui;
 }
@@ -93,6 +127,59 @@ void MainWindow::setupMenus() {
     connect(m_disconnectAction, &QAction::triggered, this, &MainWindow::onDisconnectTriggered);
     fileMenu->addAction(m_disconnectAction);
 
+    // Same vehicle on several links: drop duplicate packets, fail over outbound traffic
+    QAction* redundancyAction = new QAction(tr("Link &Redundancy"), this);
+    redundancyAction->setCheckable(true);
+    connect(redundancyAction, &QAction::toggled, this,
+            [this](bool checked) { m_mavlinkRouter->setRedundancyEnabled(checked); });
+    fileMenu->addAction(redundancyAction);
+
+    // Flight logs are recorded while links are open unless switched off
+    m_recordAction = new QAction(tr("Record &Telemetry Log"), this);
+    m_recordAction->setCheckable(true);
+    m_recordAction->setChecked(true);
+    connect(m_recordAction, &QAction::toggled, this, [this](bool checked) {
+        if (!checked) {
+            m_tlogRecorder->stop();
+        } else if (!m_linkManager->links().isEmpty()) {
+            startTelemetryLog();
+        }
+    });
+    fileMenu->addAction(m_recordAction);
+
+    // Per-message trace points from socket receive to HUD paint
+    QAction* latencyTraceAction = new QAction(tr("&Latency Tracing"), this);
+    latencyTraceAction->setCheckable(true);
+    connect(latencyTraceAction, &QAction::toggled, this, [](bool checked) {
+        LatencyTrace& trace = LatencyTrace::instance();
+        if (checked) {
+            trace.clear();
+        }
+        trace.setEnabled(checked);
+    });
+    fileMenu->addAction(latencyTraceAction);
+
+    QAction* exportTraceAction = new QAction(tr("&Export Latency Trace..."), this);
+    connect(exportTraceAction, &QAction::triggered, this, [this]() {
+        const QString suggested =
+            QString("%1/latency-%2.json")
+                .arg(TlogRecorder::defaultDirectory(),
+                     QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss"));
+        const QString fileName = QFileDialog::getSaveFileName(
+            this, tr("Export Latency Trace"), suggested, tr("Chrome trace (*.json)"));
+        if (fileName.isEmpty()) {
+            return;
+        }
+        QString error;
+        if (LatencyTrace::instance().exportChromeTrace(fileName, &error)) {
+            statusBar()->showMessage(tr("Latency trace written to %1").arg(fileName), 5000);
+        } else {
+            QMessageBox::warning(this, tr("Export Latency Trace"),
+                                 tr("Cannot write %1: %2").arg(fileName, error));
+        }
+    });
+    fileMenu->addAction(exportTraceAction);
+
     fileMenu->addSeparator();
 
     QAction* exitAction = new QAction(tr("E&xit"), this);
@@ -100,6 +187,69 @@ void MainWindow::setupMenus() {
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
     fileMenu->addAction(exitAction);
 
+    // Replay Menu (controls the open telemetry log replay link)
+    m_replayMenu = menuBar()->addMenu(tr("&Replay"));
+
+    m_replayPauseAction = new QAction(tr("&Pause"), this);
+    m_replayPauseAction->setCheckable(true);
+    connect(m_replayPauseAction, &QAction::triggered, this, [this](bool checked) {
+        if (ReplayLink* link = replayLink()) {
+            QMetaObject::invokeMethod(link, [link, checked]() { link->setPaused(checked); });
+        }
+    });
+    m_replayMenu->addAction(m_replayPauseAction);
+
+    QAction* seekAction = new QAction(tr("&Seek..."), this);
+    connect(seekAction, &QAction::triggered, this, [this]() {
+        ReplayLink* link = replayLink();
+        if (!link) {
+            return;
+        }
+        const ReplayLink::PlaybackStatistics stats = link->playbackStatistics();
+        bool ok = false;
+        const int seconds = QInputDialog::getInt(
+            this, tr("Seek Replay"), tr("Position (seconds from start):"),
+            static_cast<int>(stats.positionUs / 1000000), 0,
+            static_cast<int>(stats.durationUs / 1000000), 10, &ok);
+        if (ok) {
+            const qint64 positionUs = qint64(seconds) * 1000000;
+            QMetaObject::invokeMethod(link, [link, positionUs]() { link->seek(positionUs); });
+        }
+    });
+    m_replayMenu->addAction(seekAction);
+
+    QMenu* speedMenu = m_replayMenu->addMenu(tr("Sp&eed"));
+    QActionGroup* speedGroup = new QActionGroup(this);
+    for (double speed : {1.0, 2.0, 5.0, 10.0, 50.0, ReplayLink::AS_FAST_AS_POSSIBLE}) {
+        QAction* speedAction = speedMenu->addAction(
+            speed == ReplayLink::AS_FAST_AS_POSSIBLE ? tr("As Fast as Possible")
+                                                     : QString("%1x").arg(speed));
+        speedAction->setCheckable(true);
+        speedAction->setData(speed);
+        speedGroup->addAction(speedAction);
+        connect(speedAction, &QAction::triggered, this, [this, speed]() {
+            if (ReplayLink* link = replayLink()) {
+                QMetaObject::invokeMethod(link, [link, speed]() { link->setSpeed(speed); });
+            }
+        });
+    }
+
+    // Reflect the replay link's state; everything is disabled without one
+    connect(m_replayMenu, &QMenu::aboutToShow, this, [this, speedGroup]() {
+        ReplayLink* link = replayLink();
+        for (QAction* action : m_replayMenu->actions()) {
+            action->setEnabled(link != nullptr);
+        }
+        if (!link) {
+            return;
+        }
+        const ReplayLink::PlaybackStatistics stats = link->playbackStatistics();
+        m_replayPauseAction->setChecked(stats.paused);
+        for (QAction* speedAction : speedGroup->actions()) {
+            speedAction->setChecked(speedAction->data().toDouble() == stats.speed);
+        }
+    });
+
     // Help Menu
     QMenu* helpMenu = menuBar()->addMenu(tr("&Help"));
 
@@ -133,6 +283,15 @@ void MainWindow::setupToolbars() {
 
     mainToolbar->addSeparator();
 
+    // Active vehicle: HUD, map, charts, commands and missions follow it
+    m_vehicleCombo = new QComboBox(this);
+    m_vehicleCombo->setObjectName("vehicleCombo");
+    m_vehicleCombo->setPlaceholderText(tr("No vehicle"));
+    m_vehicleCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    mainToolbar->addWidget(m_vehicleCombo);
+
+    mainToolbar->addSeparator();
+
     // Flight control toolbar
     QToolBar* flightToolbar = addToolBar(tr("Flight Control"));
     flightToolbar->setObjectName("FlightControlToolbar");
@@ -332,42 +491,90 @@ void MainWindow::setupDockWidgets() {
     m_missionEditor = new MissionEditor(m_missionModel, m_mavlinkRouter, m_vehicleModel, this);
     m_missionDock->setWidget(m_missionEditor);
     addDockWidget(Qt::LeftDockWidgetArea, m_missionDock);
+
+    // Telemetry Charts Dock (plots the active vehicle's history)
+    m_chartDock = new QDockWidget(tr("Telemetry Charts"), this);
+
+    // Force white text on dock title bar
+    QPalette chartPalette = m_chartDock->palette();
+    chartPalette.setColor(QPalette::WindowText, Qt::white);
+    m_chartDock->setPalette(chartPalette);
+
+    m_chartWidget = new TelemetryChartWidget(nullptr, this);
+    m_chartDock->setWidget(m_chartWidget);
+    addDockWidget(Qt::BottomDockWidgetArea, m_chartDock);
 }
 
 void MainWindow::setupConnections() {
     // Link Manager <-> MAVLink Router
-    connect(m_linkManager, &LinkManager::bytesReceived, m_mavlinkRouter,
-            &MavlinkRouter::receiveBytes);
-    connect(m_mavlinkRouter, &MavlinkRouter::bytesToSend, this,
-            [this](QByteArray data) {
-                if (m_linkManager->activeLink()) {
-                    QMetaObject::invokeMethod(m_linkManager->activeLink(), "writeBytes",
-                                              Qt::QueuedConnection, Q_ARG(QByteArray, data));
+    // Each link thread writes into its own ring; the router is woken once per
+    // batch on the parser thread, and its replies go straight to the link
+    // threads selected by the routing mask
+    connect(m_linkManager, &LinkManager::linkAdded, this,
+            [this](LinkInterface* link, int linkId) {
+                QSharedPointer<ByteRing> ring = link->receiveRing();
+                MavlinkRouter* router = m_mavlinkRouter;
+                router->attachLink(linkId);
+                connect(link, &LinkInterface::receiveRingReadable, router,
+                        [router, ring, linkId]() { router->drainReceiveRing(linkId, *ring); });
+                connect(router, &MavlinkRouter::bytesToSend, link,
+                        [link, linkId](quint32 linkMask, const QByteArray& data) {
+                            if (linkMask & (1u << linkId)) {
+                                link->writeBytes(data);
+                            }
+                        });
+            },
+            Qt::DirectConnection);
+    connect(m_linkManager, &LinkManager::linkRemoved, this,
+            [this](LinkInterface*, int linkId) { m_mavlinkRouter->detachLink(linkId); },
+            Qt::DirectConnection);
+
+    // MAVLink Router -> Vehicle Registry (creates and updates per-vehicle models)
+    connect(m_mavlinkRouter, &MavlinkRouter::heartbeatReceived, m_vehicleRegistry,
+            &VehicleRegistry::handleHeartbeat);
+
+    // New vehicles go on the map and become selectable; the first one heard becomes active
+    connect(m_vehicleRegistry, &VehicleRegistry::vehicleAdded, this,
+            [this](VehicleModel* vehicle) {
+                m_mapWidget->fleetModel()->addVehicle(vehicle);
+                m_vehicleCombo->addItem(
+                    tr("Vehicle %1:%2").arg(vehicle->systemId()).arg(vehicle->componentId()));
+                if (m_vehicleCombo->currentIndex() < 0) {
+                    m_vehicleCombo->setCurrentIndex(0);
                 }
             });
+    connect(m_vehicleCombo, &QComboBox::currentIndexChanged, this, [this](int index) {
+        setActiveVehicle(m_vehicleRegistry->vehicles().value(index));
+    });
+
+    // MAVLink Router -> Vehicle/Health Models (coalesced telemetry)
+    connect(m_mavlinkRouter, &MavlinkRouter::telemetryBatchReady, this,
+            &MainWindow::onTelemetryBatchReady);
 
-    // MAVLink Router -> Vehicle Model
-    connect(m_mavlinkRouter, &MavlinkRouter::heartbeatReceived, m_vehicleModel,
-            &VehicleModel::handleHeartbeat);
-    connect(m_mavlinkRouter, &MavlinkRouter::attitudeReceived, m_vehicleModel,
-            &VehicleModel::handleAttitude);
-    connect(m_mavlinkRouter, &MavlinkRouter::globalPositionReceived, m_vehicleModel,
-            &VehicleModel::handleGlobalPosition);
-    connect(m_mavlinkRouter, &MavlinkRouter::vfrHudReceived, m_vehicleModel,
-            &VehicleModel::handleVfrHud);
-    connect(m_mavlinkRouter, &MavlinkRouter::batteryStatusReceived, m_vehicleModel,
-            &VehicleModel::handleBatteryStatus);
-
-    // MAVLink Router -> Health Model
-    connect(m_mavlinkRouter, &MavlinkRouter::gpsRawReceived, m_healthModel,
-            &HealthModel::handleGpsRaw);
-    connect(m_mavlinkRouter, &MavlinkRouter::systemStatusReceived, m_healthModel,
-            &HealthModel::handleSystemStatus);
-
-    // MAVLink Router heartbeat -> Link Manager (reset timeout)
-    connect(m_mavlinkRouter, &MavlinkRouter::heartbeatReceived, m_linkManager,
+    // MAVLink Router heartbeat -> Link Manager (reset the receiving link's timeout)
+    connect(m_mavlinkRouter, &MavlinkRouter::linkHeartbeatReceived, m_linkManager,
             &LinkManager::resetHeartbeatTimeout);
 
+    // MAVLink Router -> status bar (redundant link failover)
+    connect(m_mavlinkRouter, &MavlinkRouter::linkSwitchover, this,
+            [this](uint8_t systemId, int fromLinkId, int toLinkId, qint64 switchoverMs) {
+                statusBar()->showMessage(
+                    tr("System %1: link %2 degraded, switched to link %3 in %4 ms")
+                        .arg(systemId)
+                        .arg(fromLinkId)
+                        .arg(toLinkId)
+                        .arg(switchoverMs),
+                    5000);
+            });
+
+    // Telemetry log recorder (signals arrive from its writer thread)
+    connect(m_tlogRecorder, &TlogRecorder::fileOpened, this, [this](const QString& filePath) {
+        statusBar()->showMessage(tr("Recording telemetry to %1").arg(filePath), 5000);
+    });
+    connect(m_tlogRecorder, &TlogRecorder::errorOccurred, this, [this](const QString& error) {
+        statusBar()->showMessage(tr("Telemetry log stopped: %1").arg(error), 10000);
+    });
+
     // Link Manager status
     connect(m_linkManager, &LinkManager::connectionStatusChanged, this,
             &MainWindow::onConnectionStatusChanged);
@@ -394,17 +601,48 @@ void MainWindow::setupConnections() {
 void MainWindow::onConnectTriggered() {
     ConnectDialog dialog(this);
     if (dialog.exec() == QDialog::Accepted) {
-        UdpLink* link = dialog.getConfiguredLink();
+        LinkInterface* link = dialog.getConfiguredLink();
         if (link) {
-            m_linkManager->setActiveLink(link);
-            statusBar()->showMessage(tr("Connecting to %1...").arg(link->name()));
+            const QString name = link->name();
+            const bool isReplay = qobject_cast<ReplayLink*>(link) != nullptr;
+            if (m_linkManager->addLink(link) < 0) {
+                QMessageBox::warning(this, tr("Link Error"),
+                                     tr("Cannot add %1: at most %2 links can be active.")
+                                         .arg(name)
+                                         .arg(LinkInterface::MAX_LINKS));
+                return;
+            }
+            statusBar()->showMessage(tr("Connecting to %1...").arg(name));
+
+            // A replay is already a log; recording it again would only duplicate it
+            if (!isReplay && m_recordAction->isChecked() && !m_tlogRecorder->isRecording()) {
+                startTelemetryLog();
+            }
         }
     }
 }
 
+void MainWindow::startTelemetryLog() {
+    TlogRecorder::Configuration config;
+    config.directory = TlogRecorder::defaultDirectory();
+    // Failures are reported through TlogRecorder::errorOccurred
+    m_tlogRecorder->start(config);
+}
+
+ReplayLink* MainWindow::replayLink() const {
+    const QList<LinkInterface*> links = m_linkManager->links();
+    for (LinkInterface* link : links) {
+        if (auto* replay = qobject_cast<ReplayLink*>(link)) {
+            return replay;
+        }
+    }
+    return nullptr;
+}
+
 void MainWindow::onDisconnectTriggered() {
     if (m_linkManager) {
-        m_linkManager->closeActiveLink();
+        m_linkManager->closeAllLinks();
+        m_tlogRecorder->stop();
         statusBar()->showMessage(tr("Disconnected"));
     }
 }
@@ -445,14 +683,96 @@ void MainWindow::onConnectionStatusChanged(bool connected) {
     }
 }
 
-void MainWindow::onLinkError(QString errorString) {
-    statusBar()->showMessage(tr("Link Error: %1").arg(errorString), 5000);
-    QMessageBox::warning(this, tr("Link Error"), errorString);
+void MainWindow::onLinkError(QString linkName, QString errorString) {
+    statusBar()->showMessage(tr("Link Error (%1): %2").arg(linkName, errorString), 5000);
+    QMessageBox::warning(this, tr("Link Error"), tr("%1: %2").arg(linkName, errorString));
 }
 
-void MainWindow::onReconnecting(int attemptNumber, int delayMs) {
-    statusBar()->showMessage(
-        tr("Reconnecting... (Attempt %1, waiting %2ms)").arg(attemptNumber).arg(delayMs));
+void MainWindow::onReconnecting(QString linkName, int attemptNumber, int delayMs) {
+    statusBar()->showMessage(tr("Reconnecting %1... (Attempt %2, waiting %3ms)")
+                                 .arg(linkName)
+                                 .arg(attemptNumber)
+                                 .arg(delayMs));
+}
+
+void MainWindow::setActiveVehicle(VehicleModel* vehicle) {
+    if (!vehicle || vehicle == m_vehicleModel) {
+        return;
+    }
+
+    // Placeholder created before any vehicle was heard
+    if (m_vehicleModel && m_vehicleModel->parent() == this) {
+        m_vehicleModel->deleteLater();
+    }
+
+    m_vehicleModel = vehicle;
+    m_commandBus->setVehicleModel(vehicle);
+    m_missionEditor->setVehicleModel(vehicle);
+    m_mapWidget->setVehicleModel(vehicle, m_vehicleRegistry->trail(vehicle));
+    // Enabling may free the least recently plotted history, never the one on screen
+    static_assert(VehicleRegistry::MAX_HISTORIES >= 2);
+    m_chartWidget->setHistory(m_vehicleRegistry->enableHistory(vehicle));
+
+    const int index = m_vehicleRegistry->vehicles().indexOf(vehicle);
+    if (index != m_vehicleCombo->currentIndex()) {
+        m_vehicleCombo->setCurrentIndex(index);
+    }
+    statusBar()->showMessage(tr("Active vehicle: system %1, component %2")
+                                 .arg(vehicle->systemId())
+                                 .arg(vehicle->componentId()),
+                             3000);
+}
+
+void MainWindow::onTelemetryBatchReady() {
+    using Field = MavlinkRouter::TelemetryBatch::Field;
+
+    for (const MavlinkRouter::TelemetryBatch& batch : m_mavlinkRouter->takeTelemetryBatches()) {
+        // Telemetry from systems that have not sent a vehicle heartbeat yet is dropped
+        VehicleModel* vehicle = m_vehicleRegistry->route(batch.systemId, batch.componentId);
+        if (!vehicle) {
+            continue;
+        }
+
+        {
+            // Everything in the batch reaches the model's observers as one stateChanged()
+            VehicleModel::UpdateBatch modelUpdate(vehicle);
+
+            if (batch.has(Field::Attitude)) {
+                const mavlink_attitude_t& att = batch.attitude;
+                vehicle->handleAttitude(att.roll, att.pitch, att.yaw, att.rollspeed,
+                                        att.pitchspeed, att.yawspeed, batch.attitudeTraceKey);
+            }
+            if (batch.has(Field::GlobalPosition)) {
+                const mavlink_global_position_int_t& pos = batch.globalPosition;
+                vehicle->handleGlobalPosition(pos.lat, pos.lon, pos.alt, pos.relative_alt, pos.vx,
+                                              pos.vy, pos.vz, pos.hdg);
+            }
+            if (batch.has(Field::VfrHud)) {
+                const mavlink_vfr_hud_t& hud = batch.vfrHud;
+                vehicle->handleVfrHud(hud.airspeed, hud.groundspeed, hud.heading, hud.throttle,
+                                      hud.alt, hud.climb);
+            }
+            if (batch.has(Field::BatteryStatus)) {
+                vehicle->handleBatteryStatus(batch.batteryVoltage, batch.batteryCurrent,
+                                             batch.batteryRemaining);
+            }
+        }
+
+        // The health panel follows the active vehicle only
+        if (vehicle != m_vehicleModel) {
+            continue;
+        }
+        if (batch.has(Field::GpsRaw)) {
+            const mavlink_gps_raw_int_t& gps = batch.gpsRaw;
+            m_healthModel->handleGpsRaw(gps.fix_type, gps.lat, gps.lon, gps.alt, gps.eph, gps.epv,
+                                        gps.vel, gps.cog, gps.satellites_visible);
+        }
+        if (batch.has(Field::SystemStatus)) {
+            const mavlink_sys_status_t& status = batch.systemStatus;
+            m_healthModel->handleSystemStatus(status.voltage_battery, status.current_battery,
+                                              status.battery_remaining);
+        }
+    }
 }
 
 void MainWindow::updateTelemetryDisplay() {
@@ -464,6 +784,7 @@ void MainWindow::updateTelemetryDisplay() {
         // VehicleModel already stores pitch/roll in DEGREES (converted in handleAttitude)
         m_hudWidget->setPitch(m_vehicleModel->pitch());
         m_hudWidget->setRoll(m_vehicleModel->roll());
+        m_hudWidget->setAttitudeTraceKey(m_vehicleModel->attitudeTraceKey());
     }
 
     // Update status bar widgets
@@ -575,17 +896,222 @@ void MainWindow::updateTelemetryDisplay() {
 }
 
 void MainWindow::updateLinkStats() {
+    QString tooltip;
+
     if (m_mavlinkRouter) {
         qint64 timeSince = m_mavlinkRouter->timeSinceLastMessage();
         float packetLoss = m_mavlinkRouter->packetLoss();
         qint64 rtt = m_mavlinkRouter->roundTripTime();
 
+        const QVector<MessageStatistics::StreamRate> rates = m_mavlinkRouter->messageRates();
+        const double rxBytesPerSecond = MessageStatistics::totalBytesPerSecond(rates);
+
         m_linkStatsLabel->setText(
-            QString("RTT: %1ms | Loss: %2% | Last msg: %3s ago")
+            QString("RTT: %1ms | Loss: %2% | RX: %3 kB/s | Last msg: %4s ago")
                 .arg(rtt)
                 .arg(packetLoss, 0, 'f', 1)
+                .arg(rxBytesPerSecond / 1000.0, 0, 'f', 1)
                 .arg(timeSince / 1000.0, 0, 'f', 1));
+
+        // Loss per (sysid, compid); sequences are only comparable within a source
+        const QVector<SequenceTracker::SourceStatistics> sources =
+            m_mavlinkRouter->sourceStatistics();
+        if (!sources.isEmpty()) {
+            tooltip = tr("Per-source loss (last second / total):");
+            for (const SequenceTracker::SourceStatistics& source : sources) {
+                tooltip += QString("\n  %1:%2  %3% / %4%  dup %5  reordered %6")
+                               .arg(source.systemId)
+                               .arg(source.componentId)
+                               .arg(source.windowLoss, 0, 'f', 1)
+                               .arg(source.totalLoss, 0, 'f', 1)
+                               .arg(source.duplicates)
+                               .arg(source.reordered);
+            }
+        }
+
+        // Streams using the most bandwidth
+        if (!rates.isEmpty()) {
+            if (!tooltip.isEmpty()) {
+                tooltip += "\n\n";
+            }
+            tooltip += tr("Top streams (last second, %1 total):").arg(rates.size());
+            const int shown = qMin<int>(rates.size(), MAX_TOOLTIP_STREAMS);
+            for (int i = 0; i < shown; ++i) {
+                const MessageStatistics::StreamRate& rate = rates.at(i);
+                tooltip += QString("\n  msg %1 from %2:%3  %4 Hz  %5 B/s  jitter %6 ms")
+                               .arg(rate.msgId)
+                               .arg(rate.systemId)
+                               .arg(rate.componentId)
+                               .arg(rate.hz, 0, 'f', 1)
+                               .arg(rate.bytesPerSecond, 0, 'f', 0)
+                               .arg(rate.jitterMs, 0, 'f', 1);
+            }
+        }
+    }
+
+    // Duplicate rate and failover history when listening on redundant links
+    const MavlinkRouter::RedundancyStatistics redundancy =
+        m_mavlinkRouter->redundancyStatistics();
+    if (redundancy.enabled) {
+        if (!tooltip.isEmpty()) {
+            tooltip += "\n\n";
+        }
+        tooltip += QString("Redundancy: %1% duplicates (%2 dropped, %3 evicted)\n"
+                           "Switchovers: %4, last took %5")
+                       .arg(redundancy.duplicateRate, 0, 'f', 1)
+                       .arg(redundancy.duplicatesDropped)
+                       .arg(redundancy.dedupEvictions)
+                       .arg(redundancy.switchovers)
+                       .arg(redundancy.lastSwitchoverMs < 0
+                                ? tr("n/a")
+                                : QString("%1 ms").arg(redundancy.lastSwitchoverMs));
+    }
+
+    // Flight log health: drops mean the disk could not keep up
+    const TlogRecorder::Statistics logStats = m_tlogRecorder->statistics();
+    if (logStats.recording) {
+        if (!tooltip.isEmpty()) {
+            tooltip += "\n\n";
+        }
+        tooltip += QString("Telemetry log: %1\n%2 packets (%7 sent), %3 KiB written, "
+                           "dropped: %4 (buffer peak %5 / %6 KiB)")
+                       .arg(logStats.fileName)
+                       .arg(logStats.packetsRecorded)
+                       .arg(logStats.bytesWritten / 1024)
+                       .arg(logStats.packetsDropped)
+                       .arg(logStats.bufferHighWater / 1024)
+                       .arg(logStats.bufferCapacity / 1024)
+                       .arg(logStats.packetsOutbound);
     }
+
+    // Socket-to-pixels latency while tracing
+    LatencyTrace& trace = LatencyTrace::instance();
+    if (trace.isEnabled()) {
+        if (!tooltip.isEmpty()) {
+            tooltip += "\n\n";
+        }
+        tooltip += QString("Latency since socket receive (%1 trace events):")
+                       .arg(trace.eventsRecorded());
+        for (int i = LatencyTrace::ParseComplete; i < LatencyTrace::STAGE_COUNT; ++i) {
+            const auto stage = static_cast<LatencyTrace::Stage>(i);
+            const LatencyTrace::Histogram histogram = trace.histogram(stage);
+            tooltip += QString("\n  %1: p50 %2 ms  p90 %3 ms  p99 %4 ms  max %5 ms (%6)")
+                           .arg(QLatin1String(LatencyTrace::stageName(stage)))
+                           .arg(histogram.p50Us / 1000.0, 0, 'f', 2)
+                           .arg(histogram.p90Us / 1000.0, 0, 'f', 2)
+                           .arg(histogram.p99Us / 1000.0, 0, 'f', 2)
+                           .arg(histogram.maxUs / 1000.0, 0, 'f', 2)
+                           .arg(histogram.count);
+        }
+    }
+
+    // Per-link traffic, then transport details
+    const QList<LinkInterface*> links =
+        m_linkManager ? m_linkManager->links() : QList<LinkInterface*>();
+    for (LinkInterface* link : links) {
+        const int linkId = m_linkManager->linkId(link);
+        const MavlinkRouter::LinkStatistics linkStats = m_mavlinkRouter->linkStatistics(linkId);
+        if (!tooltip.isEmpty()) {
+            tooltip += "\n\n";
+        }
+        tooltip += QString("Link %1: %2 (%3)\nRX: %4 msgs, %5 msg/s, %6 kB/s, last %7\n"
+                           "TX: %8 msgs, %9 bytes")
+                       .arg(linkId)
+                       .arg(link->name())
+                       .arg(link->isConnected() ? tr("connected") : tr("not connected"))
+                       .arg(linkStats.messagesReceived)
+                       .arg(linkStats.messagesPerSecond, 0, 'f', 1)
+                       .arg(linkStats.bytesPerSecond / 1000.0, 0, 'f', 1)
+                       .arg(linkStats.timeSinceLastMessage < 0
+                                ? tr("never")
+                                : QString("%1s ago").arg(linkStats.timeSinceLastMessage / 1000.0,
+                                                         0, 'f', 1))
+                       .arg(linkStats.messagesSent)
+                       .arg(linkStats.bytesSent);
+        if (redundancy.enabled) {
+            tooltip += QString("\nLater copies dropped: %1").arg(linkStats.duplicatesDropped);
+        }
+
+        // Emulated impairment; transport details come from the wrapped link
+        LinkInterface* transport = link;
+        if (auto* impaired = qobject_cast<ImpairedLink*>(link)) {
+            transport = impaired->wrappedLink();
+            auto describe = [](const QString& label,
+                               const ImpairedLink::DirectionStatistics& direction) {
+                return QString("\nImpaired %1: %2 of %3 delivered, %4 lost (%5 in bursts), "
+                               "%6 queue-dropped, %7 ring-dropped")
+                    .arg(label)
+                    .arg(direction.delivered)
+                    .arg(direction.packets)
+                    .arg(direction.lost + direction.burstLost)
+                    .arg(direction.burstLost)
+                    .arg(direction.queueDropped)
+                    .arg(direction.ringDropped);
+            };
+            const ImpairedLink::Statistics stats = impaired->statistics();
+            tooltip += describe(tr("in"), stats.inbound) + describe(tr("out"), stats.outbound);
+        }
+
+        // Achieved UDP batch sizes (recvmmsg/sendmmsg)
+        if (auto* udpLink = qobject_cast<UdpLink*>(transport)) {
+            const UdpLink::BatchStatistics stats = udpLink->batchStatistics();
+            tooltip +=
+                QString("\nUDP %1 I/O\nRX: %2 datagrams in %3 batches (avg %4, max %5), "
+                        "%11 oversized\n"
+                        "TX: %6 datagrams in %7 batches (avg %8, max %9), %10 dropped")
+                    .arg(stats.batched ? "batched" : "per-datagram")
+                    .arg(stats.datagramsReceived)
+                    .arg(stats.receiveBatches)
+                    .arg(stats.averageReceiveBatch(), 0, 'f', 1)
+                    .arg(stats.maxReceiveBatch)
+                    .arg(stats.datagramsSent)
+                    .arg(stats.sendBatches)
+                    .arg(stats.averageSendBatch(), 0, 'f', 1)
+                    .arg(stats.maxSendBatch)
+                    .arg(stats.datagramsDropped)
+                    .arg(stats.datagramsTruncated);
+        }
+
+        // Replay position and throughput
+        if (auto* replay = qobject_cast<ReplayLink*>(link)) {
+            const ReplayLink::PlaybackStatistics stats = replay->playbackStatistics();
+            tooltip += QString("\nReplay: %1 / %2 s at %3%4, %5 packets, %6 bytes skipped")
+                           .arg(stats.positionUs / 1000000.0, 0, 'f', 1)
+                           .arg(stats.durationUs / 1000000.0, 0, 'f', 1)
+                           .arg(stats.speed == ReplayLink::AS_FAST_AS_POSSIBLE
+                                    ? tr("max speed")
+                                    : QString("%1x").arg(stats.speed))
+                           .arg(stats.finished ? tr(" (finished)")
+                                               : stats.paused ? tr(" (paused)") : QString())
+                           .arg(stats.packetsReplayed)
+                           .arg(stats.bytesSkipped);
+        }
+
+        // Outbound queue of stream links (peer or radio not keeping up)
+        const LinkInterface::OutboundStatistics outbound = transport->outboundStatistics();
+        if (outbound.bounded) {
+            tooltip += QString("\nTX queue: %1 / %2 KiB (peak %3 KiB)%4, dropped: %5 (%6 bytes)")
+                           .arg(outbound.queuedBytes / 1024)
+                           .arg(outbound.maxQueuedBytes / 1024)
+                           .arg(outbound.peakQueuedBytes / 1024)
+                           .arg(outbound.congested ? tr(" congested") : QString())
+                           .arg(outbound.droppedWrites)
+                           .arg(outbound.droppedBytes);
+        }
+
+        // Receive ring fill and overruns (parser falling behind)
+        if (QSharedPointer<ByteRing> ring = link->receiveRing()) {
+            const ByteRing::Statistics ringStats = ring->statistics();
+            tooltip += QString("\nRX ring: %1 / %2 KiB (peak %3 KiB), overruns: %4 (%5 bytes)")
+                           .arg(ring->readable() / 1024)
+                           .arg(ring->capacity() / 1024)
+                           .arg(ringStats.highWaterMark / 1024)
+                           .arg(ringStats.overruns)
+                           .arg(ringStats.bytesDropped);
+        }
+    }
+
+    m_linkStatsLabel->setToolTip(tooltip);
 }
 
 void MainWindow::onAboutTriggered() {
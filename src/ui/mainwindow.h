@@ -11,16 +11,21 @@
 #include <QScreen>
 #include <QStackedWidget>
 #include <QPushButton>
+#include <QComboBox>
 #include "../comm/linkmanager.h"
 #include "../comm/mavlinkrouter.h"
+#include "../comm/replaylink.h"
 #include "../comm/commandbus.h"
+#include "../comm/tlogrecorder.h"
 #include "../models/vehiclemodel.h"
 #include "../models/healthmodel.h"
 #include "../models/missionmodel.h"
 #include "../models/geofencemodel.h"
+#include "../models/vehicleregistry.h"
 #include "missioneditor.h"
 #include "mapwidget.h"
 #include "hudwidget.h"
+#include "telemetrychartwidget.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -51,11 +56,12 @@ private slots:
     void onAboutTriggered();
 
     void onConnectionStatusChanged(bool connected);
-    void onLinkError(QString errorString);
-    void onReconnecting(int attemptNumber, int delayMs);
+    void onLinkError(QString linkName, QString errorString);
+    void onReconnecting(QString linkName, int attemptNumber, int delayMs);
 
     void updateTelemetryDisplay();
     void updateLinkStats();
+    void onTelemetryBatchReady();
 
     // Map interaction
     void onMapClicked(double lat, double lon);
@@ -83,6 +89,9 @@ private:
     void setupStatusBar();
     void setupDockWidgets();
     void setupConnections();
+    void startTelemetryLog();
+    void setActiveVehicle(VehicleModel* vehicle);
+    ReplayLink* replayLink() const;
 
     // Responsive layout methods
     FormFactor detectFormFactor() const;
@@ -93,6 +102,8 @@ private:
     void addFloatingActionButtons();
     void loadPlatformStylesheet();
 
+    static constexpr int MAX_TOOLTIP_STREAMS = 8;  // streams listed in the link stats tooltip
+
     Ui::MainWindow* ui;
 
     // Responsive layout state
@@ -107,26 +118,35 @@ private:
 
     // Core components
     LinkManager* m_linkManager;
-    MavlinkRouter* m_mavlinkRouter;
+    QThread* m_parserThread;
+    MavlinkRouter* m_mavlinkRouter;  // lives on m_parserThread
     CommandBus* m_commandBus;
-    VehicleModel* m_vehicleModel;
-    HealthModel* m_healthModel;
+    TlogRecorder* m_tlogRecorder;  // fed by m_mavlinkRouter, writes on its own thread
+    VehicleRegistry* m_vehicleRegistry;  // one model per vehicle heard
+    VehicleModel* m_vehicleModel;        // active vehicle; placeholder until one is heard
+    HealthModel* m_healthModel;          // active vehicle only
     MissionModel* m_missionModel;
     GeofenceModel* m_geofenceModel;
 
     // UI components
+    QComboBox* m_vehicleCombo;
     QDockWidget* m_telemetryDock;
     QDockWidget* m_hudDock;
     QDockWidget* m_healthDock;
     QDockWidget* m_missionDock;
+    QDockWidget* m_chartDock;
     QWidget* m_telemetryWidget;
     HudWidget* m_hudWidget;
     QWidget* m_healthWidget;
     MissionEditor* m_missionEditor;
+    TelemetryChartWidget* m_chartWidget;
     MapWidget* m_mapWidget;
 
     QAction* m_disconnectAction;
     QAction* m_disconnectToolAction;
+    QAction* m_recordAction;
+    QMenu* m_replayMenu;
+    QAction* m_replayPauseAction;
 
     // Flight control actions
     QAction* m_guidedAction;
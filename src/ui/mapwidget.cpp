@@ -1,5 +1,7 @@
 #include "mapwidget.h"
 #include "../models/vehiclemodel.h"
+#include "../models/fleetmodel.h"
+#include "../models/trailmodel.h"
 #include "../models/missionmodel.h"
 #include "../models/geofencemodel.h"
 #include "../models/waypoint.h"
@@ -13,6 +15,9 @@ MapWidget::MapWidget(QWidget* parent)
     , m_vehicleModel(nullptr)
     , m_missionModel(nullptr)
     , m_geofenceModel(nullptr)
+    , m_fleetModel(new FleetModel(this))
+    , m_trailModel(new TrailModel(this))
+    , m_recordTrail(true)
     , m_followVehicle(false)
     , m_geofenceMode(false)
     , m_homePosition(-35.3632, 149.1654) // Canberra, SITL default
@@ -48,20 +53,38 @@ void MapWidget::setupQmlContext() {
     QQmlContext* context = rootContext();
     if (context) {
         context->setContextProperty("mapWidget", this);
+        context->setContextProperty("fleetModel", m_fleetModel);
+        context->setContextProperty("trailModel", m_trailModel);
         context->setContextProperty("followVehicle", m_followVehicle);
         context->setContextProperty("geofenceMode", m_geofenceMode);
     }
 }
 
-void MapWidget::setVehicleModel(VehicleModel* model) {
+void MapWidget::setVehicleModel(VehicleModel* model, TrailLodStore* trail) {
     if (m_vehicleModel == model) {
         return;
     }
 
+    if (m_vehicleModel) {
+        disconnect(m_vehicleModel, nullptr, this, nullptr);
+    }
+
     m_vehicleModel = model;
+    m_fleetModel->setActiveVehicle(model);
+
+    // A given trail keeps its history across switches; our own belonged to
+    // the previous vehicle
+    m_recordTrail = !trail;
+    m_trailModel->setStore(trail);
+    if (m_recordTrail) {
+        clearTrail();
+    }
 
     if (m_vehicleModel) {
         connectModelSignals();
+        if (m_vehicleModel->latitude() != 0.0 || m_vehicleModel->longitude() != 0.0) {
+            onVehiclePositionChanged();
+        }
     }
 }
 
@@ -98,13 +121,14 @@ void MapWidget::connectModelSignals() {
         return;
     }
 
-    // Connect to vehicle position updates
-    connect(m_vehicleModel, &VehicleModel::latitudeChanged,
-            this, &MapWidget::onVehiclePositionChanged);
-    connect(m_vehicleModel, &VehicleModel::longitudeChanged,
-            this, &MapWidget::onVehiclePositionChanged);
-    connect(m_vehicleModel, &VehicleModel::headingChanged,
-            this, &MapWidget::onVehiclePositionChanged);
+    // One QML update per model batch, however many position fields changed
+    connect(m_vehicleModel, &VehicleModel::stateChanged, this,
+            [this](VehicleModel::Fields changed) {
+                if (changed & (VehicleModel::Latitude | VehicleModel::Longitude |
+                               VehicleModel::Heading)) {
+                    onVehiclePositionChanged();
+                }
+            });
 }
 
 void MapWidget::setVehiclePosition(double lat, double lon, double heading) {
@@ -171,30 +195,12 @@ void MapWidget::centerOnVehicle() {
 }
 
 void MapWidget::addTrailPoint(double lat, double lon) {
-    QVariantMap point;
-    point["latitude"] = lat;
-    point["longitude"] = lon;
-    m_trailPoints.append(point);
-
-    // Limit trail length to last 500 points
-    if (m_trailPoints.size() > 500) {
-        m_trailPoints.removeFirst();
-    }
-
-    QQuickItem* rootItem = rootObject();
-    if (rootItem) {
-        QMetaObject::invokeMethod(rootItem, "updateTrail",
-                                 Q_ARG(QVariant, QVariant::fromValue(m_trailPoints)));
-    }
+    // QML sees the change next frame, if the new segment is on screen
+    m_trailModel->append(lat, lon);
 }
 
 void MapWidget::clearTrail() {
-    m_trailPoints.clear();
-    QQuickItem* rootItem = rootObject();
-    if (rootItem) {
-        QMetaObject::invokeMethod(rootItem, "updateTrail",
-                                 Q_ARG(QVariant, QVariant::fromValue(m_trailPoints)));
-    }
+    m_trailModel->clear();
 }
 
 void MapWidget::updateWaypoints() {
@@ -450,8 +456,10 @@ void MapWidget::onVehiclePositionChanged() {
     // Update vehicle position on map
     setVehiclePosition(lat, lon, heading);
 
-    // Add to trail if vehicle is armed (flying)
-    if (m_vehicleModel->armed()) {
+    // Add to trail if vehicle is armed (flying); a given trail is fed by its owner
+    if (!m_recordTrail) {
+        m_trailModel->pointsAppended();
+    } else if (m_vehicleModel->armed()) {
         addTrailPoint(lat, lon);
     }
 }
@@ -8,6 +8,9 @@
 class VehicleModel;
 class MissionModel;
 class GeofenceModel;
+class FleetModel;
+class TrailModel;
+class TrailLodStore;
 
 class MapWidget : public QQuickWidget {
     Q_OBJECT
@@ -18,11 +21,19 @@ public:
     explicit MapWidget(QWidget* parent = nullptr);
     ~MapWidget() override;
 
-    // Set references to models
-    void setVehicleModel(VehicleModel* model);
+    // Set references to models; the vehicle model is the active vehicle. The
+    // trail is the vehicle's flight path, kept up to date by its owner; without
+    // one the widget records the path itself and starts afresh on every switch
+    void setVehicleModel(VehicleModel* model, TrailLodStore* trail = nullptr);
     void setMissionModel(MissionModel* model);
     void setGeofenceModel(GeofenceModel* model);
 
+    // Every other vehicle, drawn by the fleet layer
+    FleetModel* fleetModel() const { return m_fleetModel; }
+
+    // Flight path of the active vehicle
+    TrailModel* trailModel() const { return m_trailModel; }
+
     // Geofence mode
     bool geofenceMode() const { return m_geofenceMode; }
     void setGeofenceMode(bool enabled);
@@ -74,11 +85,13 @@ private:
     VehicleModel* m_vehicleModel;
     MissionModel* m_missionModel;
     GeofenceModel* m_geofenceModel;
+    FleetModel* m_fleetModel;
+    TrailModel* m_trailModel;
 
+    bool m_recordTrail;  // no trail store given: append the vehicle's positions here
     bool m_followVehicle;
     bool m_geofenceMode;
     QGeoCoordinate m_homePosition;
-    QVariantList m_trailPoints;
 };
 
 #endif // MAPWIDGET_H
@@ -68,6 +68,13 @@ public:
                            VehicleModel* vehicleModel, QWidget* parent = nullptr);
     ~MissionEditor() override = default;
 
+    /**
+     * @brief Vehicle that later uploads/downloads target
+     *
+     * A transfer already in progress keeps its target.
+     */
+    void setVehicleModel(VehicleModel* vehicleModel) { m_vehicleModel = vehicleModel; }
+
 public slots:
     /**
      * @brief Handle mission protocol responses
@@ -0,0 +1,156 @@
+#include "seriesdecimator.h"
+#include <cmath>
+
+void SeriesDecimator::decimate(const TelemetryHistory::Range& range, qint64 fromMs, qint64 toMs,
+                               int columns, Method method, QList<QPointF>* points) {
+    columns = qMax(1, columns);
+    if (method == Lttb) {
+        lttb(range, columns, points);
+    } else {
+        minMax(range, fromMs, toMs, columns, points);
+    }
+}
+
+void SeriesDecimator::copy(const TelemetryHistory::Range& range, QList<QPointF>* points) {
+    points->clear();
+    points->reserve(range.size());
+    for (int segment = 0; segment < 2; ++segment) {
+        const qint64* times = range.times[segment];
+        const double* values = range.values[segment];
+        for (int i = 0; i < range.sizes[segment]; ++i) {
+            points->append(QPointF(times[i], values[i]));
+        }
+    }
+}
+
+void SeriesDecimator::minMax(const TelemetryHistory::Range& range, qint64 fromMs, qint64 toMs,
+                             int columns, QList<QPointF>* points) {
+    const int count = range.size();
+    if (count <= 2 * columns) {
+        copy(range, points);
+        return;
+    }
+
+    points->clear();
+    points->reserve(2 * columns + 2);
+    const double columnsPerMs = double(columns) / qMax<qint64>(1, toMs - fromMs);
+
+    int column = -1;
+    QPointF first;
+    QPointF low;
+    QPointF high;
+    int lowIndex = 0;
+    int highIndex = 0;
+
+    // Emits the current column's extremes in time order
+    auto flush = [&]() {
+        if (column < 0) {
+            return;
+        }
+        if (lowIndex == highIndex) {
+            points->append(low);
+        } else if (lowIndex < highIndex) {
+            points->append(low);
+            points->append(high);
+        } else {
+            points->append(high);
+            points->append(low);
+        }
+    };
+
+    int index = 0;
+    for (int segment = 0; segment < 2; ++segment) {
+        const qint64* times = range.times[segment];
+        const double* values = range.values[segment];
+        for (int i = 0; i < range.sizes[segment]; ++i, ++index) {
+            const QPointF point(times[i], values[i]);
+            const int c = qBound(0, int((times[i] - fromMs) * columnsPerMs), columns - 1);
+            if (c != column) {
+                flush();
+                column = c;
+                low = high = point;
+                lowIndex = highIndex = index;
+                if (index == 0) {
+                    first = point;
+                }
+            } else if (values[i] < low.y()) {
+                low = point;
+                lowIndex = index;
+            } else if (values[i] > high.y()) {
+                high = point;
+                highIndex = index;
+            }
+        }
+    }
+    flush();
+
+    // Keep the line anchored at both ends of the range
+    const QPointF last(range.timeAt(count - 1), range.valueAt(count - 1));
+    if (points->constFirst() != first) {
+        points->prepend(first);
+    }
+    if (points->constLast() != last) {
+        points->append(last);
+    }
+}
+
+void SeriesDecimator::lttb(const TelemetryHistory::Range& range, int threshold,
+                           QList<QPointF>* points) {
+    const int count = range.size();
+    if (threshold >= count || threshold < 3) {
+        copy(range, points);
+        return;
+    }
+
+    points->clear();
+    points->reserve(threshold);
+
+    // Relative times keep the triangle areas well inside double precision
+    const qint64 origin = range.timeAt(0);
+    auto x = [&](int i) { return double(range.timeAt(i) - origin); };
+    auto y = [&](int i) { return range.valueAt(i); };
+
+    points->append(QPointF(range.timeAt(0), y(0)));
+
+    // First and last points are fixed; the rest is split into threshold - 2 buckets
+    const double bucketSize = double(count - 2) / (threshold - 2);
+    int selected = 0;
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        // Average of the next bucket is the third triangle vertex
+        const int nextStart = int((bucket + 1) * bucketSize) + 1;
+        const int nextEnd = qMin(int((bucket + 2) * bucketSize) + 1, count);
+        double averageX = 0.0;
+        double averageY = 0.0;
+        if (nextStart < nextEnd) {
+            for (int i = nextStart; i < nextEnd; ++i) {
+                averageX += x(i);
+                averageY += y(i);
+            }
+            averageX /= nextEnd - nextStart;
+            averageY /= nextEnd - nextStart;
+        } else {
+            averageX = x(count - 1);
+            averageY = y(count - 1);
+        }
+
+        const int start = int(bucket * bucketSize) + 1;
+        const int end = int((bucket + 1) * bucketSize) + 1;
+        const double selectedX = x(selected);
+        const double selectedY = y(selected);
+        double maxArea = -1.0;
+        int best = start;
+        for (int i = start; i < end; ++i) {
+            const double area = std::fabs((selectedX - averageX) * (y(i) - selectedY) -
+                                          (selectedX - x(i)) * (averageY - selectedY));
+            if (area > maxArea) {
+                maxArea = area;
+                best = i;
+            }
+        }
+
+        points->append(QPointF(range.timeAt(best), y(best)));
+        selected = best;
+    }
+
+    points->append(QPointF(range.timeAt(count - 1), y(count - 1)));
+}
@@ -0,0 +1,40 @@
+#ifndef SERIESDECIMATOR_H
+#define SERIESDECIMATOR_H
+
+#include <QList>
+#include <QPointF>
+#include "../models/telemetryhistory.h"
+
+/**
+ * @brief Reduces a history range to roughly one point per pixel column
+ *
+ * Output points are (ms since epoch, value), ready for QXYSeries::replace()
+ * with a QDateTimeAxis. Both methods are a single O(n) pass.
+ *
+ * - MinMax: the minimum and maximum of every column, in time order, plus
+ *   the first and last sample. Spikes are never lost, so it is the default
+ *   for live telemetry.
+ * - Lttb: Largest-Triangle-Three-Buckets, one point per column chosen to
+ *   keep the visual shape. Smoother, but a one-sample spike can vanish.
+ */
+class SeriesDecimator {
+public:
+    enum Method { MinMax, Lttb };
+
+    /**
+     * @brief Decimate @p range, spanning [fromMs, toMs], into @p columns columns
+     *
+     * Ranges that already fit are copied unchanged. @p points is cleared first.
+     */
+    static void decimate(const TelemetryHistory::Range& range, qint64 fromMs, qint64 toMs,
+                         int columns, Method method, QList<QPointF>* points);
+
+    static void minMax(const TelemetryHistory::Range& range, qint64 fromMs, qint64 toMs,
+                       int columns, QList<QPointF>* points);
+    static void lttb(const TelemetryHistory::Range& range, int threshold, QList<QPointF>* points);
+
+private:
+    static void copy(const TelemetryHistory::Range& range, QList<QPointF>* points);
+};
+
+#endif  // SERIESDECIMATOR_H
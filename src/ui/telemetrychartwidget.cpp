@@ -0,0 +1,268 @@
+#include "telemetrychartwidget.h"
+#include <QChart>
+#include <QChartView>
+#include <QComboBox>
+#include <QDateTime>
+#include <QDateTimeAxis>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineSeries>
+#include <QMenu>
+#include <QTimer>
+#include <QToolButton>
+#include <QValueAxis>
+#include <QVBoxLayout>
+#include <limits>
+
+TelemetryChartWidget::TelemetryChartWidget(const TelemetryHistory* history, QWidget* parent)
+    : QWidget(parent), m_history(history), m_chart(new QChart()), m_chartView(nullptr),
+      m_axisX(new QDateTimeAxis()), m_fieldMenu(nullptr),
+      m_windowCombo(nullptr), m_methodCombo(nullptr), m_refreshTimer(new QTimer(this)),
+      m_windowMs(DEFAULT_WINDOW_MS), m_method(SeriesDecimator::MinMax), m_newestMs(-1),
+      m_plotWidth(0) {
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(2);
+
+    // Controls: field selection, window length, decimation method
+    auto* controls = new QHBoxLayout();
+    controls->setContentsMargins(4, 2, 4, 0);
+
+    auto* fieldButton = new QToolButton(this);
+    fieldButton->setText(tr("Fields"));
+    fieldButton->setPopupMode(QToolButton::InstantPopup);
+    m_fieldMenu = new QMenu(fieldButton);
+    for (int bit = 0; bit < 32; ++bit) {
+        const quint32 flag = 1u << bit;
+        if (!(TelemetryHistory::HISTORY_FIELDS & flag)) {
+            continue;
+        }
+        const auto field = static_cast<VehicleModel::Field>(flag);
+        QAction* action = m_fieldMenu->addAction(TelemetryHistory::fieldName(field));
+        action->setData(flag);
+        action->setCheckable(true);
+        connect(action, &QAction::toggled, this, [this, field](bool checked) {
+            if (checked) {
+                addField(field);
+            } else {
+                removeField(field);
+            }
+        });
+    }
+    fieldButton->setMenu(m_fieldMenu);
+    controls->addWidget(fieldButton);
+
+    m_windowCombo = new QComboBox(this);
+    const int windowMinutes[] = {1, 2, 5, 10};
+    for (int minutes : windowMinutes) {
+        m_windowCombo->addItem(tr("%1 min").arg(minutes), qint64(minutes) * 60 * 1000);
+    }
+    connect(m_windowCombo, &QComboBox::currentIndexChanged, this, [this](int index) {
+        setWindow(m_windowCombo->itemData(index).toLongLong());
+    });
+    controls->addWidget(new QLabel(tr("Window:"), this));
+    controls->addWidget(m_windowCombo);
+
+    m_methodCombo = new QComboBox(this);
+    m_methodCombo->addItem(tr("Min/Max"), SeriesDecimator::MinMax);
+    m_methodCombo->addItem(tr("LTTB"), SeriesDecimator::Lttb);
+    connect(m_methodCombo, &QComboBox::currentIndexChanged, this, [this](int index) {
+        const int method = m_methodCombo->itemData(index).toInt();
+        setDecimation(static_cast<SeriesDecimator::Method>(method));
+    });
+    controls->addWidget(new QLabel(tr("Decimation:"), this));
+    controls->addWidget(m_methodCombo);
+    controls->addStretch();
+    layout->addLayout(controls);
+
+    // Animations and antialiasing would cost more per frame than the data itself
+    m_chart->setTheme(QChart::ChartThemeDark);
+    m_chart->setAnimationOptions(QChart::NoAnimation);
+    m_chart->legend()->setAlignment(Qt::AlignTop);
+    m_chart->setMargins(QMargins(4, 4, 4, 4));
+    m_axisX->setFormat("HH:mm:ss");
+    m_axisX->setTickCount(7);
+    m_chart->addAxis(m_axisX, Qt::AlignBottom);
+
+    m_chartView = new QChartView(m_chart, this);
+    m_chartView->setRenderHint(QPainter::Antialiasing, false);
+    m_chartView->setMinimumHeight(160);
+    layout->addWidget(m_chartView, 1);
+
+    m_refreshTimer->setInterval(REFRESH_INTERVAL_MS);
+    connect(m_refreshTimer, &QTimer::timeout, this, &TelemetryChartWidget::refresh);
+
+    setWindow(DEFAULT_WINDOW_MS);
+    setFields({VehicleModel::RelativeAltitude, VehicleModel::ClimbRate});
+}
+
+void TelemetryChartWidget::setFields(const QList<VehicleModel::Field>& fields) {
+    // Toggling the menu actions adds/removes the series
+    for (QAction* action : m_fieldMenu->actions()) {
+        const auto field = static_cast<VehicleModel::Field>(action->data().toUInt());
+        action->setChecked(fields.contains(field));
+    }
+}
+
+void TelemetryChartWidget::setHistory(const TelemetryHistory* history) {
+    if (m_history == history) {
+        return;
+    }
+    m_history = history;
+    if (!m_history) {
+        for (QLineSeries* series : std::as_const(m_series)) {
+            series->clear();
+        }
+    }
+    setWindow(m_windowMs);
+}
+
+void TelemetryChartWidget::setWindow(qint64 ms) {
+    m_windowMs = qBound<qint64>(1000, ms, m_history ? m_history->duration() : ms);
+    const int index = m_windowCombo->findData(m_windowMs);
+    if (index >= 0 && index != m_windowCombo->currentIndex()) {
+        m_windowCombo->setCurrentIndex(index);
+    }
+    invalidate();
+}
+
+void TelemetryChartWidget::setDecimation(SeriesDecimator::Method method) {
+    m_method = method;
+    const int index = m_methodCombo->findData(method);
+    if (index >= 0 && index != m_methodCombo->currentIndex()) {
+        m_methodCombo->setCurrentIndex(index);
+    }
+    invalidate();
+}
+
+void TelemetryChartWidget::addField(VehicleModel::Field field) {
+    if (m_series.contains(field)) {
+        return;
+    }
+
+    auto* series = new QLineSeries();
+    const QString name = TelemetryHistory::fieldName(field);
+    const QString unit = TelemetryHistory::fieldUnit(field);
+    series->setName(unit.isEmpty() ? name : QString("%1 (%2)").arg(name, unit));
+    m_chart->addSeries(series);
+    series->attachAxis(m_axisX);
+    series->attachAxis(valueAxis(unit));
+    m_series.insert(field, series);
+    invalidate();
+}
+
+QValueAxis* TelemetryChartWidget::valueAxis(const QString& unit) {
+    if (QValueAxis* axis = m_valueAxes.value(unit)) {
+        return axis;
+    }
+
+    int left = 0;
+    for (const QValueAxis* axis : std::as_const(m_valueAxes)) {
+        left += axis->alignment() == Qt::AlignLeft ? 1 : 0;
+    }
+    auto* axis = new QValueAxis();
+    axis->setTitleText(unit);
+    m_chart->addAxis(axis, left * 2 <= m_valueAxes.size() ? Qt::AlignLeft : Qt::AlignRight);
+    m_valueAxes.insert(unit, axis);
+    return axis;
+}
+
+void TelemetryChartWidget::removeField(VehicleModel::Field field) {
+    QLineSeries* series = m_series.take(field);
+    if (!series) {
+        return;
+    }
+    m_chart->removeSeries(series);
+    delete series;
+
+    // Drop the unit's axis with its last field
+    const QString unit = TelemetryHistory::fieldUnit(field);
+    bool unitInUse = false;
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it) {
+        unitInUse |= TelemetryHistory::fieldUnit(it.key()) == unit;
+    }
+    if (!unitInUse) {
+        QValueAxis* axis = m_valueAxes.take(unit);
+        m_chart->removeAxis(axis);
+        delete axis;
+    }
+    invalidate();
+}
+
+void TelemetryChartWidget::refresh() {
+    if (!m_history || m_series.isEmpty()) {
+        return;
+    }
+
+    qint64 newestMs = -1;
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it) {
+        qint64 timestampMs = 0;
+        if (m_history->latest(it.key(), &timestampMs, nullptr)) {
+            newestMs = qMax(newestMs, timestampMs);
+        }
+    }
+    const int plotWidth = qMax(1, int(m_chart->plotArea().width()));
+    if (newestMs < 0 || (newestMs == m_newestMs && plotWidth == m_plotWidth)) {
+        return;
+    }
+    m_newestMs = newestMs;
+    m_plotWidth = plotWidth;
+
+    // Value range per unit, i.e. per value axis
+    struct Bounds {
+        double low{std::numeric_limits<double>::max()};
+        double high{std::numeric_limits<double>::lowest()};
+    };
+    QMap<QString, Bounds> bounds;
+
+    const qint64 fromMs = newestMs - m_windowMs;
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it) {
+        const TelemetryHistory::Range range = m_history->range(it.key(), fromMs, newestMs);
+        SeriesDecimator::decimate(range, fromMs, newestMs, plotWidth, m_method, &m_points);
+
+        // Sample-and-hold: a field that holds steady is not re-recorded, so
+        // start at the value held when the window opens and carry the last
+        // value to the window's end
+        double held = 0.0;
+        if ((range.size() == 0 || range.timeAt(0) > fromMs) &&
+            m_history->valueAt(it.key(), fromMs, &held)) {
+            m_points.prepend(QPointF(fromMs, held));
+        }
+        if (!m_points.isEmpty() && m_points.constLast().x() < newestMs) {
+            m_points.append(QPointF(newestMs, m_points.constLast().y()));
+        }
+
+        // Exact for MinMax, which keeps every extreme; LTTB may have dropped a spike
+        Bounds& unitBounds = bounds[TelemetryHistory::fieldUnit(it.key())];
+        for (const QPointF& point : std::as_const(m_points)) {
+            unitBounds.low = qMin(unitBounds.low, point.y());
+            unitBounds.high = qMax(unitBounds.high, point.y());
+        }
+        it.value()->replace(m_points);
+    }
+
+    m_axisX->setRange(QDateTime::fromMSecsSinceEpoch(fromMs),
+                      QDateTime::fromMSecsSinceEpoch(newestMs));
+    for (auto it = bounds.constBegin(); it != bounds.constEnd(); ++it) {
+        const Bounds& unitBounds = it.value();
+        if (unitBounds.low <= unitBounds.high) {
+            // 5 % headroom; a flat line gets some room around it instead
+            const double span = unitBounds.high - unitBounds.low;
+            const double margin =
+                span > 0.0 ? span * 0.05 : qMax(qAbs(unitBounds.high) * 0.05, 0.5);
+            m_valueAxes.value(it.key())->setRange(unitBounds.low - margin,
+                                                  unitBounds.high + margin);
+        }
+    }
+}
+
+void TelemetryChartWidget::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    invalidate();
+    m_refreshTimer->start();
+}
+
+void TelemetryChartWidget::hideEvent(QHideEvent* event) {
+    QWidget::hideEvent(event);
+    m_refreshTimer->stop();
+}
@@ -0,0 +1,103 @@
+#ifndef TELEMETRYCHARTWIDGET_H
+#define TELEMETRYCHARTWIDGET_H
+
+#include <QList>
+#include <QMap>
+#include <QPointF>
+#include <QWidget>
+#include "../models/telemetryhistory.h"
+#include "seriesdecimator.h"
+
+class QChart;
+class QChartView;
+class QComboBox;
+class QDateTimeAxis;
+class QLineSeries;
+class QMenu;
+class QTimer;
+class QValueAxis;
+
+/**
+ * @brief Live plot of any TelemetryHistory fields over a trailing window
+ *
+ * A timer redraws the chart while it is visible. Each refresh decimates
+ * every selected field down to the plot area's pixel width and hands it
+ * to its series with a single QXYSeries::replace(), so the cost per frame
+ * depends on the on-screen width rather than the sample rate or window
+ * length. Refreshes are skipped while no new samples have arrived and
+ * nothing else has changed.
+ *
+ * The window ends at the newest sample of the plotted fields, so a paused
+ * or replayed stream stays on screen instead of scrolling away.
+ * Fields are drawn sample-and-hold: each line starts at the value held
+ * when the window opens and runs to the window's end.
+ *
+ * Fields with the same unit share a value axis scaled to them; each unit
+ * gets its own, on whichever side has fewer, so a small series (roll in
+ * deg) is not flattened by a large one (altitude in m).
+ */
+class TelemetryChartWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    static constexpr int REFRESH_INTERVAL_MS = 16;
+    static constexpr qint64 DEFAULT_WINDOW_MS = 60 * 1000;
+
+    explicit TelemetryChartWidget(const TelemetryHistory* history, QWidget* parent = nullptr);
+
+    /**
+     * @brief Plot another history (nullptr clears the chart)
+     */
+    void setHistory(const TelemetryHistory* history);
+    const TelemetryHistory* history() const { return m_history; }
+
+    void setFields(const QList<VehicleModel::Field>& fields);
+    QList<VehicleModel::Field> fields() const { return m_series.keys(); }
+
+    void setWindow(qint64 ms);
+    qint64 window() const { return m_windowMs; }
+
+    void setDecimation(SeriesDecimator::Method method);
+    SeriesDecimator::Method decimation() const { return m_method; }
+
+    QChart* chart() const { return m_chart; }
+
+public slots:
+    /**
+     * @brief Re-decimate and push the series if anything changed
+     */
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void addField(VehicleModel::Field field);
+    void removeField(VehicleModel::Field field);
+    QValueAxis* valueAxis(const QString& unit);
+    void invalidate() { m_newestMs = -1; }
+
+    const TelemetryHistory* m_history;
+
+    QChart* m_chart;
+    QChartView* m_chartView;
+    QDateTimeAxis* m_axisX;
+    QMenu* m_fieldMenu;
+    QComboBox* m_windowCombo;
+    QComboBox* m_methodCombo;
+    QTimer* m_refreshTimer;
+
+    QMap<VehicleModel::Field, QLineSeries*> m_series;  // in field order
+    QMap<QString, QValueAxis*> m_valueAxes;            // by unit, while a field uses it
+    QList<QPointF> m_points;  // decimation scratch buffer
+
+    qint64 m_windowMs;
+    SeriesDecimator::Method m_method;
+
+    // What the chart currently shows; refresh() is a no-op while unchanged
+    qint64 m_newestMs;
+    int m_plotWidth;
+};
+
+#endif  // TELEMETRYCHARTWIDGET_H
@@ -0,0 +1,12 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_bytering.cpp \
+    $$FLIGHTSCOPE_SRC/comm/bytering.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/bytering.h
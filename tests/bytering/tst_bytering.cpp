@@ -0,0 +1,210 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include "comm/bytering.h"
+
+/**
+ * @brief Checks ByteRing wraparound, all-or-nothing overruns, wake
+ * coalescing, and byte-exact delivery between two threads
+ */
+class ByteRingTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundsCapacityUp();
+    void wrapsAroundTheEnd();
+    void overrunDropsWholeChunks();
+    void highWaterMarkIsExact();
+    void coalescesWakeups();
+    void producerConsumerStress();
+
+private:
+    // Consume everything into a QByteArray, counting the callbacks
+    static QByteArray drain(ByteRing& ring, int* calls = nullptr, qsizetype maxBytes = -1) {
+        QByteArray out;
+        int count = 0;
+        ring.consume(
+            [&](const char* data, qsizetype size) {
+                out.append(data, size);
+                ++count;
+            },
+            maxBytes);
+        if (calls) {
+            *calls = count;
+        }
+        return out;
+    }
+
+    static QByteArray pattern(int size, int seed) {
+        QByteArray data(size, Qt::Uninitialized);
+        for (int i = 0; i < size; ++i) {
+            data[i] = char(seed + i * 7);
+        }
+        return data;
+    }
+};
+
+void ByteRingTest::roundsCapacityUp() {
+    QCOMPARE(ByteRing(100).capacity(), qsizetype(128));
+    QCOMPARE(ByteRing(128).capacity(), qsizetype(128));
+    QCOMPARE(ByteRing(1).capacity(), qsizetype(64));  // minimum
+}
+
+void ByteRingTest::wrapsAroundTheEnd() {
+    ByteRing ring(64);
+    QVERIFY(ring.write(pattern(40, 1).constData(), 40));
+    QCOMPARE(drain(ring), pattern(40, 1));
+    QCOMPARE(ring.readPosition(), quint64(40));
+
+    // 24 bytes up to the end of the buffer, 26 from its start
+    const QByteArray wrapped = pattern(50, 2);
+    QVERIFY(ring.write(wrapped.constData(), wrapped.size()));
+    QCOMPARE(ring.readable(), qsizetype(50));
+    QCOMPARE(ring.writable(), qsizetype(14));
+    int calls = 0;
+    QCOMPARE(drain(ring, &calls, 30), wrapped.left(30));
+    QCOMPARE(calls, 2);
+    QCOMPARE(drain(ring, &calls), wrapped.mid(30));
+    QCOMPARE(calls, 1);
+    QCOMPARE(ring.readable(), qsizetype(0));
+    QCOMPARE(ring.readPosition(), quint64(90));
+
+    const ByteRing::Statistics stats = ring.statistics();
+    QCOMPARE(stats.bytesWritten, quint64(90));
+    QCOMPARE(stats.bytesRead, quint64(90));
+}
+
+void ByteRingTest::overrunDropsWholeChunks() {
+    ByteRing ring(64);
+    QVERIFY(ring.write(pattern(60, 3).constData(), 60));
+
+    // Does not fit: nothing of it is written
+    QVERIFY(!ring.write(pattern(10, 4).constData(), 10));
+    QCOMPARE(ring.readable(), qsizetype(60));
+    ByteRing::Statistics stats = ring.statistics();
+    QCOMPARE(stats.overruns, quint64(1));
+    QCOMPARE(stats.bytesDropped, quint64(10));
+    QCOMPARE(stats.bytesWritten, quint64(60));
+
+    // Exactly the free space still fits
+    QVERIFY(ring.write(pattern(4, 5).constData(), 4));
+    QCOMPARE(ring.writable(), qsizetype(0));
+    QVERIFY(!ring.write("x", 1));
+    stats = ring.statistics();
+    QCOMPARE(stats.overruns, quint64(2));
+    QCOMPARE(stats.bytesDropped, quint64(11));
+    QCOMPARE(stats.highWaterMark, quint64(64));
+    QCOMPARE(drain(ring), pattern(60, 3) + pattern(4, 5));
+
+    // Freed space is found again once the consumer has caught up
+    QVERIFY(ring.write(pattern(64, 6).constData(), 64));
+    QCOMPARE(drain(ring), pattern(64, 6));
+    QVERIFY(ring.write(nullptr, 0));
+    QCOMPARE(ring.statistics().overruns, quint64(2));
+}
+
+void ByteRingTest::highWaterMarkIsExact() {
+    // The producer's cached view of the consumer index lags behind
+    ByteRing ring(1024);
+    for (int i = 0; i < 50; ++i) {
+        QVERIFY(ring.write(pattern(10, i).constData(), 10));
+        QCOMPARE(drain(ring), pattern(10, i));
+    }
+    QCOMPARE(ring.statistics().highWaterMark, quint64(10));
+
+    QVERIFY(ring.write(pattern(10, 0).constData(), 10));
+    QVERIFY(ring.write(pattern(20, 0).constData(), 20));
+    QCOMPARE(ring.statistics().highWaterMark, quint64(30));
+}
+
+void ByteRingTest::coalescesWakeups() {
+    ByteRing ring(64);
+
+    // Only the first request of a batch wakes the consumer
+    QVERIFY(ring.write("a", 1));
+    QVERIFY(ring.requestWake());
+    QVERIFY(ring.write("b", 1));
+    QVERIFY(!ring.requestWake());
+    QVERIFY(!ring.requestWake());
+
+    // Once the consumer has acknowledged, the next batch wakes it again
+    ring.acknowledgeWake();
+    QCOMPARE(drain(ring), QByteArray("ab"));
+    QVERIFY(ring.write("c", 1));
+    QVERIFY(ring.requestWake());
+
+    // Data written after the acknowledgement but before the drain is seen
+    // by that drain and still wakes the consumer once more (harmless)
+    ring.acknowledgeWake();
+    QVERIFY(ring.write("d", 1));
+    QVERIFY(ring.requestWake());
+    QCOMPARE(drain(ring), QByteArray("cd"));
+}
+
+void ByteRingTest::producerConsumerStress() {
+    // A small ring, so the producer keeps running into a full buffer
+    ByteRing ring(4096);
+    constexpr quint64 TOTAL = 64 * 1024 * 1024;
+    QSemaphore wakeups;
+    std::atomic<quint64> retries{0};
+
+    // Stream byte n is n * 31 mod 256; chunks of random size, retried whole when full
+    std::unique_ptr<QThread> producer(QThread::create([&]() {
+        QRandomGenerator random(42);
+        char chunk[1500];
+        quint64 position = 0;
+        while (position < TOTAL) {
+            const int size = int(qMin<quint64>(random.bounded(1, 1500), TOTAL - position));
+            for (int i = 0; i < size; ++i) {
+                chunk[i] = char((position + quint64(i)) * 31);
+            }
+            while (!ring.write(chunk, size)) {
+                retries.fetch_add(1, std::memory_order_relaxed);
+                QThread::yieldCurrentThread();
+            }
+            position += quint64(size);
+            if (ring.requestWake()) {
+                wakeups.release();
+            }
+        }
+    }));
+    producer->start();
+
+    // Sleep until woken; a lost wakeup leaves data behind and times out
+    quint64 position = 0;
+    quint64 mismatches = 0;
+    int wakes = 0;
+    while (position < TOTAL) {
+        QVERIFY2(wakeups.tryAcquire(1, 10000),
+                 qPrintable(QString("stalled at byte %1, %2 readable")
+                                .arg(position)
+                                .arg(ring.readable())));
+        ++wakes;
+        ring.acknowledgeWake();
+        ring.consume([&](const char* data, qsizetype size) {
+            for (qsizetype i = 0; i < size; ++i) {
+                if (data[i] != char((position + quint64(i)) * 31)) {
+                    ++mismatches;
+                }
+            }
+            position += quint64(size);
+        });
+    }
+    QVERIFY(producer->wait(10000));
+
+    const ByteRing::Statistics stats = ring.statistics();
+    qInfo().nospace() << "ByteRing: " << TOTAL << " bytes in " << wakes << " wakeups, "
+                      << stats.overruns << " full-ring retries";
+    QCOMPARE(mismatches, quint64(0));
+    QCOMPARE(position, TOTAL);
+    QCOMPARE(stats.bytesRead, TOTAL);
+    QCOMPARE(stats.bytesWritten, TOTAL);
+    QCOMPARE(stats.overruns, retries.load());
+    QVERIFY(stats.highWaterMark <= quint64(ring.capacity()));
+}
+
+QTEST_MAIN(ByteRingTest)
+#include "tst_bytering.moc"
@@ -0,0 +1,9 @@
+# LinkInterface and its receive ring
+SOURCES *= \
+    $$FLIGHTSCOPE_SRC/comm/bytering.cpp \
+    $$FLIGHTSCOPE_SRC/comm/linkinterface.cpp
+
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/bytering.h \
+    $$FLIGHTSCOPE_SRC/comm/linkinterface.h \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkframing.h
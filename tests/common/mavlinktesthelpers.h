@@ -0,0 +1,76 @@
+#ifndef MAVLINKTESTHELPERS_H
+#define MAVLINKTESTHELPERS_H
+
+#include <QByteArray>
+#include <QLoggingCategory>
+#include <cstring>
+#include <utility>
+#include "mavlink/ardupilotmega/mavlink.h"
+
+/**
+ * @brief Fixtures shared by the test cases: quiet logging and MAVLink
+ * packets built without a per-message pack function
+ */
+namespace MavlinkTestHelpers {
+
+/**
+ * @brief Silence the per-packet debug logging of links and the router
+ *
+ * Call from initTestCase(). @p infoToo also hides qInfo() lines, for tests
+ * whose code under test logs every file or batch at info level.
+ */
+inline void quietLogging(bool infoToo = false) {
+    QLoggingCategory::setFilterRules(infoToo ? "default.debug=false\ndefault.info=false"
+                                             : "default.debug=false");
+}
+
+/**
+ * @brief Serialize a finalized message into its wire frame
+ */
+inline QByteArray frame(const mavlink_message_t& msg) {
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t len = mavlink_msg_to_send_buffer(buffer, &msg);
+    return QByteArray(reinterpret_cast<const char*>(buffer), len);
+}
+
+/**
+ * @brief Frame message @p msgId with a full-length payload
+ *
+ * Payload byte i is payloadByte(i). @p minLength, @p maxLength and
+ * @p crcExtra describe the message; makePacket() looks them up in the
+ * dialect, this overload also builds messages the dialect does not know.
+ */
+template <typename PayloadByte>
+QByteArray makePacket(uint32_t msgId, uint8_t systemId, uint8_t componentId,
+                      mavlink_channel_t channel, uint8_t minLength, uint8_t maxLength,
+                      uint8_t crcExtra, PayloadByte&& payloadByte) {
+    mavlink_message_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msgid = msgId;
+    auto* payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(&msg));
+    for (int i = 0; i < maxLength; ++i) {
+        payload[i] = static_cast<uint8_t>(payloadByte(i));
+    }
+    mavlink_finalize_message_chan(&msg, systemId, componentId, channel, minLength, maxLength,
+                                  crcExtra);
+    return frame(msg);
+}
+
+/**
+ * @brief Frame dialect message @p msgId; empty if the dialect lacks it
+ */
+template <typename PayloadByte>
+QByteArray makePacket(uint32_t msgId, uint8_t systemId, uint8_t componentId,
+                      mavlink_channel_t channel, PayloadByte&& payloadByte) {
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msgId);
+    if (!entry) {
+        return QByteArray();
+    }
+    return makePacket(msgId, systemId, componentId, channel, entry->min_msg_len,
+                      entry->max_msg_len, entry->crc_extra,
+                      std::forward<PayloadByte>(payloadByte));
+}
+
+}  // namespace MavlinkTestHelpers
+
+#endif  // MAVLINKTESTHELPERS_H
@@ -0,0 +1,21 @@
+# MavlinkRouter and everything it parses, counts and records with
+SOURCES *= \
+    $$FLIGHTSCOPE_SRC/comm/bytering.cpp \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkrouter.cpp \
+    $$FLIGHTSCOPE_SRC/comm/messagestatistics.cpp \
+    $$FLIGHTSCOPE_SRC/comm/sequencetracker.cpp \
+    $$FLIGHTSCOPE_SRC/comm/dedupwindow.cpp \
+    $$FLIGHTSCOPE_SRC/comm/tlogrecorder.cpp \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.cpp
+
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/bytering.h \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkrouter.h \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkmessagetraits.h \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkframing.h \
+    $$FLIGHTSCOPE_SRC/comm/messagestatistics.h \
+    $$FLIGHTSCOPE_SRC/comm/relaxedcounter.h \
+    $$FLIGHTSCOPE_SRC/comm/sequencetracker.h \
+    $$FLIGHTSCOPE_SRC/comm/dedupwindow.h \
+    $$FLIGHTSCOPE_SRC/comm/tlogrecorder.h \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.h
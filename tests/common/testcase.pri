@@ -0,0 +1,19 @@
+# Settings shared by every test project; include() it first
+QT += testlib
+
+CONFIG += qt console warn_on depend_includepath testcase c++17
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+# Sources are added with *= and this prefix, so groups from several .pri
+# files that share a file list it only once
+FLIGHTSCOPE_SRC = $$clean_path($$PWD/../../src)
+
+# Include paths
+INCLUDEPATH += $$FLIGHTSCOPE_SRC
+INCLUDEPATH += $$clean_path($$PWD/../../third-party)
+INCLUDEPATH += $$PWD
+
+# Fixtures shared by the test cases
+HEADERS *= $$PWD/mavlinktesthelpers.h
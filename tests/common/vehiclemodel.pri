@@ -0,0 +1,9 @@
+# VehicleModel and the seqlock snapshot it publishes
+SOURCES *= \
+    $$FLIGHTSCOPE_SRC/models/vehiclemodel.cpp \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.cpp
+
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/models/vehiclemodel.h \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.h \
+    $$FLIGHTSCOPE_SRC/comm/seqlock.h
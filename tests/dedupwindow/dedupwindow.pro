@@ -0,0 +1,12 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_dedupwindow.cpp \
+    $$FLIGHTSCOPE_SRC/comm/dedupwindow.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/dedupwindow.h
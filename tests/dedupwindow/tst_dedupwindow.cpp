@@ -0,0 +1,167 @@
+#include <QtTest>
+#include "comm/dedupwindow.h"
+
+/**
+ * @brief Duplicate detection, window expiry and set eviction of DedupWindow
+ */
+class DedupWindowTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void secondCopyIsDuplicate();
+    void keyFields();
+    void windowExpiry();
+    void copiesDoNotExtendWindow();
+    void setEviction();
+    void expiredEntriesAreNotEvictions();
+    void reset();
+
+private:
+    static constexpr uint8_t SYSTEM = 1;
+    static constexpr uint8_t COMPONENT = 1;
+    static constexpr uint32_t MSG_ID = 30;
+
+    static bool seen(DedupWindow& window, uint16_t checksum, qint64 nowMs,
+                     qint64* firstSeenMs = nullptr);
+
+    // Set a packet of SYSTEM/COMPONENT/MSG_ID with sequence 0 lands in, the
+    // same Fibonacci hash of its key as the table's
+    static quint64 setOf(uint16_t checksum);
+    static QVector<uint16_t> checksumsInOneSet(int count);
+};
+
+bool DedupWindowTest::seen(DedupWindow& window, uint16_t checksum, qint64 nowMs,
+                           qint64* firstSeenMs) {
+    return window.isDuplicate(SYSTEM, COMPONENT, 0, MSG_ID, checksum, nowMs, firstSeenMs);
+}
+
+quint64 DedupWindowTest::setOf(uint16_t checksum) {
+    const quint64 key = (static_cast<quint64>(SYSTEM) << 56) |
+                        (static_cast<quint64>(COMPONENT) << 48) |
+                        (static_cast<quint64>(MSG_ID) << 16) | checksum;
+    return (key * 0x9E3779B97F4A7C15ull) >> (64 - DedupWindow::SET_BITS);
+}
+
+QVector<uint16_t> DedupWindowTest::checksumsInOneSet(int count) {
+    QVector<uint16_t> checksums;
+    for (int checksum = 0; checksum <= 0xFFFF && checksums.size() < count; ++checksum) {
+        if (setOf(static_cast<uint16_t>(checksum)) == setOf(0)) {
+            checksums.append(static_cast<uint16_t>(checksum));
+        }
+    }
+    return checksums;
+}
+
+void DedupWindowTest::secondCopyIsDuplicate() {
+    DedupWindow window;
+    qint64 firstSeenMs = -1;
+    QVERIFY(!seen(window, 0x1234, 1000, &firstSeenMs));
+    QCOMPARE(firstSeenMs, qint64(1000));
+    QVERIFY(seen(window, 0x1234, 1030, &firstSeenMs));
+    QCOMPARE(firstSeenMs, qint64(1000));
+    QVERIFY(seen(window, 0x1234, 1040));  // a third link
+
+    QCOMPARE(window.statistics().checked, quint64(3));
+    QCOMPARE(window.statistics().duplicates, quint64(2));
+    QCOMPARE(window.statistics().evictions, quint64(0));
+}
+
+void DedupWindowTest::keyFields() {
+    // Every field of the key tells packets apart
+    DedupWindow window;
+    QVERIFY(!window.isDuplicate(1, 1, 7, 30, 0xABCD, 0));
+    QVERIFY(!window.isDuplicate(2, 1, 7, 30, 0xABCD, 0));
+    QVERIFY(!window.isDuplicate(1, 2, 7, 30, 0xABCD, 0));
+    QVERIFY(!window.isDuplicate(1, 1, 8, 30, 0xABCD, 0));
+    QVERIFY(!window.isDuplicate(1, 1, 7, 31, 0xABCD, 0));
+    QVERIFY(!window.isDuplicate(1, 1, 7, 30, 0xABCE, 0));  // sequence reused after a wrap
+    QVERIFY(window.isDuplicate(1, 1, 7, 30, 0xABCD, 0));
+    QCOMPARE(window.statistics().duplicates, quint64(1));
+}
+
+void DedupWindowTest::windowExpiry() {
+    DedupWindow window;
+    QVERIFY(!seen(window, 1, 0));
+    QVERIFY(seen(window, 1, DedupWindow::WINDOW_MS));  // still inside
+
+    QVERIFY(!seen(window, 2, 0));
+    QVERIFY(!seen(window, 2, DedupWindow::WINDOW_MS + 1));  // too late: a new packet
+
+    // ... which starts a window of its own
+    qint64 firstSeenMs = -1;
+    QVERIFY(seen(window, 2, 2 * DedupWindow::WINDOW_MS, &firstSeenMs));
+    QCOMPARE(firstSeenMs, DedupWindow::WINDOW_MS + 1);
+    QCOMPARE(window.statistics().duplicates, quint64(2));
+}
+
+void DedupWindowTest::copiesDoNotExtendWindow() {
+    DedupWindow window;
+    QVERIFY(!seen(window, 1, 0));
+    for (qint64 t = 100; t <= DedupWindow::WINDOW_MS; t += 100) {
+        QVERIFY(seen(window, 1, t));
+    }
+    QVERIFY(!seen(window, 1, DedupWindow::WINDOW_MS + 100));
+}
+
+void DedupWindowTest::setEviction() {
+    const QVector<uint16_t> checksums = checksumsInOneSet(DedupWindow::WAYS + 1);
+    QCOMPARE(checksums.size(), DedupWindow::WAYS + 1);
+
+    // A full set keeps all of its keys
+    DedupWindow window;
+    for (int i = 0; i < DedupWindow::WAYS; ++i) {
+        QVERIFY(!seen(window, checksums.at(i), i));
+    }
+    QCOMPARE(window.statistics().evictions, quint64(0));
+
+    // One more displaces the oldest while it is still live
+    QVERIFY(!seen(window, checksums.at(DedupWindow::WAYS), 10));
+    QCOMPARE(window.statistics().evictions, quint64(1));
+    for (int i = 1; i <= DedupWindow::WAYS; ++i) {
+        QVERIFY(seen(window, checksums.at(i), 20));
+    }
+
+    // Its duplicate slips through, and displaces the next oldest
+    QVERIFY(!seen(window, checksums.at(0), 30));
+    QCOMPARE(window.statistics().evictions, quint64(2));
+    QVERIFY(!seen(window, checksums.at(1), 40));
+    QCOMPARE(window.statistics().evictions, quint64(3));
+
+    // Other sets are untouched
+    const uint16_t other = static_cast<uint16_t>(checksums.at(0) + 1);
+    QVERIFY(setOf(other) != setOf(checksums.at(0)));
+    QVERIFY(!seen(window, other, 50));
+    QCOMPARE(window.statistics().evictions, quint64(3));
+}
+
+void DedupWindowTest::expiredEntriesAreNotEvictions() {
+    const QVector<uint16_t> checksums = checksumsInOneSet(2 * DedupWindow::WAYS);
+    DedupWindow window;
+    for (int i = 0; i < DedupWindow::WAYS; ++i) {
+        QVERIFY(!seen(window, checksums.at(i), i));
+    }
+
+    // Once the set's keys are out of the window, replacing them costs nothing
+    const qint64 later = DedupWindow::WAYS + DedupWindow::WINDOW_MS;
+    for (int i = DedupWindow::WAYS; i < 2 * DedupWindow::WAYS; ++i) {
+        QVERIFY(!seen(window, checksums.at(i), later));
+    }
+    QCOMPARE(window.statistics().evictions, quint64(0));
+    for (int i = DedupWindow::WAYS; i < 2 * DedupWindow::WAYS; ++i) {
+        QVERIFY(seen(window, checksums.at(i), later));
+    }
+}
+
+void DedupWindowTest::reset() {
+    DedupWindow window;
+    QVERIFY(!seen(window, 1, 0));
+    QVERIFY(seen(window, 1, 0));
+
+    window.reset();
+    QCOMPARE(window.statistics().checked, quint64(0));
+    QCOMPARE(window.statistics().duplicates, quint64(0));
+    QVERIFY(!seen(window, 1, 0));
+}
+
+QTEST_MAIN(DedupWindowTest)
+#include "tst_dedupwindow.moc"
@@ -0,0 +1,17 @@
+QT += quick location positioning
+
+include(../common/testcase.pri)
+include(../common/vehiclemodel.pri)
+
+# Source files
+SOURCES *= \
+    tst_fleetmap.cpp \
+    $$FLIGHTSCOPE_SRC/models/fleetmodel.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/models/fleetmodel.h
+
+# FleetLayer.qml and its icons
+RESOURCES += \
+    ../../resources/resources.qrc
@@ -0,0 +1,222 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#include <QSignalSpy>
+#include <QtMath>
+#include <memory>
+#include <vector>
+#include "models/fleetmodel.h"
+
+/**
+ * @brief Checks FleetModel's once-per-frame batching and viewport culling,
+ * and measures map frame time against fleet size with the software renderer
+ *
+ * Frame times are only reported unless FLIGHTSCOPE_BENCH_ASSERT is set,
+ * since they depend on the machine and its load.
+ */
+class FleetMapTest : public QObject {
+    Q_OBJECT
+
+public:
+    static void initMain() { QQuickWindow::setGraphicsApi(QSGRendererInterface::Software); }
+
+private slots:
+    void batchesUpdatesPerFrame();
+    void cullsOffscreenVehicles();
+    void frameTimeVsFleetSize();
+
+private:
+    static constexpr double CENTER_LAT = -35.3632;
+    static constexpr double CENTER_LON = 149.1654;
+
+    static bool assertTimings() { return qEnvironmentVariableIsSet("FLIGHTSCOPE_BENCH_ASSERT"); }
+
+    // Vehicles are placed on a grid around the map center, spacing in degrees
+    static std::vector<std::unique_ptr<VehicleModel>> makeFleet(int count, double spacing) {
+        std::vector<std::unique_ptr<VehicleModel>> fleet;
+        const int columns = qCeil(qSqrt(count));
+        for (int i = 0; i < count; ++i) {
+            auto vehicle = std::make_unique<VehicleModel>();
+            vehicle->setSystemId(uint8_t(1 + i % 250));
+            vehicle->setComponentId(1);
+            move(vehicle.get(), CENTER_LAT + (i / columns - columns / 2) * spacing,
+                 CENTER_LON + (i % columns - columns / 2) * spacing, i * 10 % 360);
+            fleet.push_back(std::move(vehicle));
+        }
+        return fleet;
+    }
+
+    static void move(VehicleModel* vehicle, double lat, double lon, int heading) {
+        vehicle->handleGlobalPosition(qRound(lat * 1e7), qRound(lon * 1e7), 584000, 10000, 0, 0,
+                                      0, uint16_t(heading * 100));
+    }
+};
+
+void FleetMapTest::batchesUpdatesPerFrame() {
+    FleetModel model;
+    auto fleet = makeFleet(100, 0.001);
+    for (const auto& vehicle : fleet) {
+        model.addVehicle(vehicle.get());
+    }
+    model.flush();
+    QCOMPARE(model.rowCount(), 100);
+
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    // Ten updates per vehicle between two frames
+    for (int update = 0; update < 10; ++update) {
+        for (const auto& vehicle : fleet) {
+            move(vehicle.get(), vehicle->latitude() + 1e-5, vehicle->longitude(), update);
+        }
+    }
+    QCOMPARE(changedSpy.count(), 0);
+    model.flush();
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toModelIndex().row(), 0);
+    QCOMPARE(changedSpy.at(0).at(1).toModelIndex().row(), 99);
+    QCOMPARE(insertedSpy.count(), 0);
+
+    // Only the changed runs are reported
+    changedSpy.clear();
+    for (int row : {10, 11, 50}) {
+        VehicleModel* vehicle = model.vehicleAt(row);
+        move(vehicle, vehicle->latitude() + 1e-5, vehicle->longitude(), 0);
+    }
+    model.flush();
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(changedSpy.at(0).at(1).toModelIndex().row(), 11);
+    QCOMPARE(changedSpy.at(1).at(0).toModelIndex().row(), 50);
+
+    // The frame timer flushes on its own
+    move(fleet.front().get(), CENTER_LAT, CENTER_LON, 0);
+    QTRY_COMPARE(changedSpy.count(), 3);
+}
+
+void FleetMapTest::cullsOffscreenVehicles() {
+    FleetModel model;
+    auto fleet = makeFleet(100, 0.001);  // 10 x 10 grid, 0.009 deg wide
+    for (const auto& vehicle : fleet) {
+        model.addVehicle(vehicle.get());
+    }
+
+    // Northern half only; the margin reaches just under 0.001 deg past the edges
+    model.setViewport(CENTER_LAT + 0.01, CENTER_LON - 0.01, CENTER_LAT + 0.0005,
+                      CENTER_LON + 0.01);
+    model.flush();
+    int expected = 0;
+    for (const auto& vehicle : fleet) {
+        expected += vehicle->latitude() >= CENTER_LAT + 0.0005 - 0.001 ? 1 : 0;
+    }
+    QVERIFY(expected > 0 && expected < 100);
+    QCOMPARE(model.rowCount(), expected);
+
+    // A vehicle flying out of view is removed, one flying in is added
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    VehicleModel* leaving = model.vehicleAt(0);
+    move(leaving, CENTER_LAT + 1.0, CENTER_LON, 0);
+    VehicleModel* entering = fleet.front().get();
+    QVERIFY(entering->latitude() < CENTER_LAT);
+    move(entering, CENTER_LAT + 0.005, CENTER_LON, 0);
+    model.flush();
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), expected);
+    QCOMPARE(model.vehicleAt(model.rowCount() - 1), entering);
+
+    // The active vehicle has its own marker
+    model.setActiveVehicle(entering);
+    model.flush();
+    QCOMPARE(model.rowCount(), expected - 1);
+
+    // A viewport across the antimeridian
+    move(leaving, 0.5, 179.9, 0);
+    model.setViewport(1.0, 179.5, 0.0, -179.5);
+    model.flush();
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.vehicleAt(0), leaving);
+}
+
+void FleetMapTest::frameTimeVsFleetSize() {
+    // A map without tiles, so only the fleet layer is measured
+    const QByteArray qml = R"(
+        import QtQuick
+        import QtLocation
+        import QtPositioning
+
+        Map {
+            width: 1280
+            height: 720
+            plugin: Plugin { name: "itemsoverlay" }
+            center: QtPositioning.coordinate(-35.3632, 149.1654)
+            zoomLevel: 15
+            FleetLayer { model: fleetModel }
+        }
+    )";
+    struct Case {
+        int vehicles;
+        int inView;
+    };
+    const Case cases[] = {{25, 25}, {50, 50}, {100, 100}, {200, 200}, {400, 400}, {400, 100}};
+    const int frames = 60;
+
+    double frameMsAt100 = 0.0;
+    for (const Case& c : cases) {
+        FleetModel model;
+        auto fleet = makeFleet(c.vehicles, 0.0004);  // 20 x 20 fits on a 1280 x 720 view
+        for (int i = c.inView; i < c.vehicles; ++i) {
+            move(fleet[i].get(), CENTER_LAT + 1.0, CENTER_LON, 0);  // far off screen
+        }
+        for (const auto& vehicle : fleet) {
+            model.addVehicle(vehicle.get());
+        }
+        model.setViewport(CENTER_LAT + 0.01, CENTER_LON - 0.02, CENTER_LAT - 0.01,
+                          CENTER_LON + 0.02);
+        model.flush();
+        QCOMPARE(model.rowCount(), c.inView);
+
+        QQuickWindow window;
+        window.resize(1280, 720);
+        QQmlEngine engine;
+        engine.rootContext()->setContextProperty("fleetModel", &model);
+        QQmlComponent component(&engine);
+        component.setData(qml, QUrl("qrc:/qml/FleetBenchmark.qml"));
+        std::unique_ptr<QQuickItem> map(qobject_cast<QQuickItem*>(component.create()));
+        QVERIFY2(map, qPrintable(component.errorString()));
+        map->setParentItem(window.contentItem());
+        window.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&window));
+        window.grabWindow();
+
+        // One frame = every vehicle moved once, one flush, one software render
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int i = 0; i < c.inView; ++i) {
+                VehicleModel* vehicle = fleet[i].get();
+                move(vehicle, vehicle->latitude() + 1e-6, vehicle->longitude() + 1e-6, frame);
+            }
+            model.flush();
+            window.grabWindow();
+        }
+        const double frameMs = timer.nsecsElapsed() / 1e6 / frames;
+        if (c.vehicles == 100 && c.inView == 100) {
+            frameMsAt100 = frameMs;
+        }
+        qInfo().nospace() << "FleetMap: " << c.vehicles << " vehicles (" << c.inView
+                          << " on screen): " << frameMs << " ms per frame";
+    }
+
+    qInfo() << "FleetMap: 100 vehicles on screen:" << frameMsAt100 << "ms per frame (budget"
+            << 1000.0 / 60 << "ms)";
+    if (assertTimings()) {
+        QVERIFY2(frameMsAt100 < 1000.0 / 60, qPrintable(QString::number(frameMsAt100)));
+    }
+}
+
+QTEST_MAIN(FleetMapTest)
+#include "tst_fleetmap.moc"
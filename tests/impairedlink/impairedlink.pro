@@ -0,0 +1,14 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/link.pri)
+
+# Source files
+SOURCES *= \
+    tst_impairedlink.cpp \
+    $$FLIGHTSCOPE_SRC/comm/impairedlink.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/impairedlink.h \
+    $$FLIGHTSCOPE_SRC/comm/relaxedcounter.h
@@ -0,0 +1,293 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <algorithm>
+#include "comm/impairedlink.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Loopback link: records what is written, injects what is "received"
+ */
+class LoopbackLink : public LinkInterface {
+    Q_OBJECT
+
+public:
+    using LinkInterface::LinkInterface;
+
+    QString name() const override { return "loopback"; }
+    LinkStatus status() const override { return m_status; }
+    bool isConnected() const override { return m_status == LinkStatus::Connected; }
+
+    void inject(const QByteArray& data) {
+        pushReceivedBytes(data.constData(), data.size());
+        flushReceivedBytes();
+    }
+
+    QList<QByteArray> written;
+
+public slots:
+    void connectLink() override {
+        m_status = LinkStatus::Connected;
+        emit statusChanged(m_status);
+    }
+    void disconnectLink() override { m_status = LinkStatus::Disconnected; }
+    void writeBytes(const QByteArray& data) override {
+        written.append(data);
+        emit bytesWritten(data.size());
+    }
+
+private:
+    LinkStatus m_status{LinkStatus::Disconnected};
+};
+
+/**
+ * @brief Checks that impairment decisions are reproducible per seed and
+ * match their configured rates, delays and bandwidth
+ */
+class ImpairedLinkTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sameSeedSameOutcome();
+    void appliesLatencyAndBandwidth();
+    void lossRatesMatchConfiguration();
+    void splitsInboundIntoFrames();
+    void fullReceiveRingCountsAsDropped();
+
+private:
+    static constexpr qsizetype FRAME_BYTES = 32;  // MAVLink v2, 20-byte payload
+
+    static QByteArray makeFrame(int index);
+    static int frameIndex(const QByteArray& frame);
+    static QList<int> run(const ImpairedLink::Configuration& config, int count);
+};
+
+void ImpairedLinkTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+}
+
+QByteArray ImpairedLinkTest::makeFrame(int index) {
+    // Only the framing matters to the emulator; the index goes in the payload
+    QByteArray frame(FRAME_BYTES, '\0');
+    frame[0] = static_cast<char>(0xFD);
+    frame[1] = static_cast<char>(FRAME_BYTES - 12);
+    qToLittleEndian<qint32>(index, frame.data() + 10);
+    return frame;
+}
+
+int ImpairedLinkTest::frameIndex(const QByteArray& frame) {
+    return qFromLittleEndian<qint32>(frame.constData() + 10);
+}
+
+QList<int> ImpairedLinkTest::run(const ImpairedLink::Configuration& config, int count) {
+    // Sends count frames inbound and outbound; returns the indices delivered in each direction
+    auto* loopback = new LoopbackLink();
+    ImpairedLink link(loopback, config);
+    QByteArray inbound;
+    connect(&link, &LinkInterface::bytesReceived, &link,
+            [&inbound](const QByteArray& data) { inbound.append(data); });
+    link.connectLink();
+
+    for (int i = 0; i < count; ++i) {
+        loopback->inject(makeFrame(i));
+        link.writeBytes(makeFrame(i));
+        if (i % 100 == 99) {
+            QTest::qWait(1);
+        }
+    }
+
+    // Wait until everything still in flight has landed
+    auto settled = [&link]() {
+        const ImpairedLink::Statistics stats = link.statistics();
+        auto done = [](const ImpairedLink::DirectionStatistics& d) {
+            return d.delivered + d.lost + d.burstLost + d.queueDropped ==
+                   d.packets + d.duplicated;
+        };
+        return done(stats.inbound) && done(stats.outbound);
+    };
+    QElapsedTimer timeout;
+    timeout.start();
+    while (!settled() && timeout.elapsed() < 10000) {
+        QTest::qWait(5);
+    }
+
+    // Which packets arrive is reproducible; their exact interleaving follows the wall clock
+    QList<int> delivered;
+    for (qsizetype offset = 0; offset + FRAME_BYTES <= inbound.size(); offset += FRAME_BYTES) {
+        delivered.append(frameIndex(inbound.mid(offset, FRAME_BYTES)));
+    }
+    std::sort(delivered.begin(), delivered.end());
+    delivered.append(-1);  // separator
+    const qsizetype outboundBegin = delivered.size();
+    for (const QByteArray& frame : loopback->written) {
+        delivered.append(frameIndex(frame));
+    }
+    std::sort(delivered.begin() + outboundBegin, delivered.end());
+    return delivered;
+}
+
+void ImpairedLinkTest::sameSeedSameOutcome() {
+    ImpairedLink::Impairment radio;
+    radio.latencyMs = 2;
+    radio.jitterMs = 3;
+    radio.lossRate = 0.05;
+    radio.burstStartRate = 0.01;
+    radio.burstEndRate = 0.3;
+    radio.reorderRate = 0.05;
+    radio.reorderDelayMs = 5;
+    radio.duplicateRate = 0.05;
+
+    ImpairedLink::Configuration config;
+    config.inbound = radio;
+    config.outbound = radio;
+    config.seed = 42;
+
+    const QList<int> first = run(config, 2000);
+    const QList<int> second = run(config, 2000);
+    QCOMPARE(first, second);
+
+    // Impairments did happen: some packets lost, some twice
+    QVERIFY(first.size() != 2 * 2000 + 1);
+    QVERIFY(std::adjacent_find(first.cbegin(), first.cend()) != first.cend());
+
+    // A different seed picks different packets
+    config.seed = 43;
+    QVERIFY(run(config, 2000) != first);
+}
+
+void ImpairedLinkTest::appliesLatencyAndBandwidth() {
+    ImpairedLink::Configuration config;
+    config.outbound.latencyMs = 100;
+    config.inbound.bandwidthBytesPerSec = 20 * FRAME_BYTES;  // 20 frames/s
+    config.inbound.queueLimitBytes = 10 * FRAME_BYTES;
+
+    auto* loopback = new LoopbackLink();
+    ImpairedLink link(loopback, config);
+    int received = 0;
+    qint64 lastArrivalMs = 0;
+    QElapsedTimer clock;
+    connect(&link, &LinkInterface::bytesReceived, &link, [&](const QByteArray& data) {
+        received += static_cast<int>(data.size() / FRAME_BYTES);
+        lastArrivalMs = clock.elapsed();
+    });
+    link.connectLink();
+
+    // Outbound: one packet, held for the latency
+    clock.start();
+    link.writeBytes(makeFrame(0));
+    QVERIFY(loopback->written.isEmpty());
+    QTRY_COMPARE(loopback->written.size(), qsizetype(1));
+    QVERIFY(clock.elapsed() >= 100);
+
+    // Inbound: a burst of 30 frames at 20 frames/s with room for 10 in the queue
+    clock.restart();
+    for (int i = 0; i < 30; ++i) {
+        loopback->inject(makeFrame(i));
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(received, 10, 2000);
+    QTest::qWait(100);
+    QCOMPARE(received, 10);
+    qInfo() << "10 queued frames at 20 frames/s delivered in" << lastArrivalMs << "ms";
+    QVERIFY(lastArrivalMs >= 450);
+
+    const ImpairedLink::DirectionStatistics stats = link.statistics().inbound;
+    QCOMPARE(stats.packets, quint64(30));
+    QCOMPARE(stats.delivered, quint64(10));
+    QCOMPARE(stats.queueDropped, quint64(20));
+}
+
+void ImpairedLinkTest::lossRatesMatchConfiguration() {
+    ImpairedLink::Configuration config;
+    config.inbound.lossRate = 0.2;
+    config.outbound.burstStartRate = 0.02;
+    config.outbound.burstEndRate = 0.25;  // bursts of 4 packets on average
+    config.seed = 7;
+
+    auto* loopback = new LoopbackLink();
+    ImpairedLink link(loopback, config);
+    link.connectLink();
+
+    constexpr int COUNT = 20000;
+    for (int i = 0; i < COUNT; ++i) {
+        loopback->inject(makeFrame(i));
+        link.writeBytes(makeFrame(i));
+    }
+
+    const ImpairedLink::Statistics stats = link.statistics();
+    const double inboundLoss = double(stats.inbound.lost) / COUNT;
+    qInfo() << "Random loss" << inboundLoss << "for a configured 0.2";
+    QVERIFY(qAbs(inboundLoss - 0.2) < 0.02);
+    QCOMPARE(stats.inbound.delivered, quint64(COUNT) - stats.inbound.lost);
+
+    // Gilbert-Elliott: lost fraction = start / (start + end), runs of about 1 / end
+    int bursts = 0;
+    int previous = -1;
+    for (const QByteArray& frame : loopback->written) {
+        const int index = frameIndex(frame);
+        bursts += index != previous + 1 ? 1 : 0;
+        previous = index;
+    }
+    const double burstLoss = double(stats.outbound.burstLost) / COUNT;
+    const double meanBurst = bursts > 0 ? double(stats.outbound.burstLost) / bursts : 0.0;
+    qInfo() << "Burst loss" << burstLoss << "in" << bursts << "bursts of" << meanBurst
+            << "packets on average";
+    QVERIFY(qAbs(burstLoss - 0.02 / 0.27) < 0.02);
+    QVERIFY(meanBurst > 3.0 && meanBurst < 5.0);
+}
+
+void ImpairedLinkTest::splitsInboundIntoFrames() {
+    // Loss applies per frame even when frames arrive glued together or split
+    ImpairedLink::Configuration config;
+    config.inbound.lossRate = 0.5;
+    config.seed = 3;
+
+    auto* loopback = new LoopbackLink();
+    ImpairedLink link(loopback, config);
+    QByteArray received;
+    connect(&link, &LinkInterface::bytesReceived, &link,
+            [&received](const QByteArray& data) { received.append(data); });
+    link.connectLink();
+
+    QByteArray stream;
+    for (int i = 0; i < 100; ++i) {
+        stream.append(makeFrame(i));
+    }
+    // Chunks of 50 bytes never line up with 32-byte frames
+    for (qsizetype offset = 0; offset < stream.size(); offset += 50) {
+        loopback->inject(stream.mid(offset, 50));
+    }
+
+    const ImpairedLink::DirectionStatistics stats = link.statistics().inbound;
+    QCOMPARE(stats.packets, quint64(100));
+    QCOMPARE(received.size(), qsizetype(stats.delivered) * FRAME_BYTES);
+    int previous = -1;
+    for (qsizetype offset = 0; offset < received.size(); offset += FRAME_BYTES) {
+        const int index = frameIndex(received.mid(offset, FRAME_BYTES));
+        QVERIFY(index > previous);
+        previous = index;
+    }
+}
+
+void ImpairedLinkTest::fullReceiveRingCountsAsDropped() {
+    // No impairment and nobody draining: the ring takes what fits, the rest is dropped
+    auto* loopback = new LoopbackLink();
+    ImpairedLink link(loopback, ImpairedLink::Configuration());
+    QSharedPointer<ByteRing> ring = QSharedPointer<ByteRing>::create(1024);
+    link.setReceiveRing(ring);
+    link.connectLink();
+
+    constexpr int COUNT = 100;
+    for (int i = 0; i < COUNT; ++i) {
+        loopback->inject(makeFrame(i));
+    }
+
+    const ImpairedLink::DirectionStatistics stats = link.statistics().inbound;
+    QCOMPARE(stats.packets, quint64(COUNT));
+    QVERIFY(stats.ringDropped > 0);
+    QCOMPARE(stats.delivered + stats.ringDropped, quint64(COUNT));
+    QCOMPARE(stats.delivered, quint64(ring->capacity() / FRAME_BYTES));
+}
+
+QTEST_MAIN(ImpairedLinkTest)
+#include "tst_impairedlink.moc"
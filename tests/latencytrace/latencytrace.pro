@@ -0,0 +1,13 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_latencytrace.cpp \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.h \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkframing.h
@@ -0,0 +1,202 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include "comm/latencytrace.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Checks trace key matching, the latency histograms, datagram
+ * splitting and the Chrome trace export
+ */
+class LatencyTraceTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void disabledRecordsNothing();
+    void histogramsLatencySinceReceive();
+    void keepsFirstReceiveOfDuplicates();
+    void splitsDatagramIntoFrames();
+    void exportsChromeTrace();
+
+private:
+    static QByteArray makeAttitude(uint8_t systemId, uint8_t sequence);
+
+    static constexpr qint64 T0 = 1700000000000000000LL;  // ns
+};
+
+QByteArray LatencyTraceTest::makeAttitude(uint8_t systemId, uint8_t sequence) {
+    mavlink_status_t* status = mavlink_get_channel_status(MAVLINK_COMM_2);
+    status->current_tx_seq = sequence;
+
+    mavlink_message_t msg;
+    mavlink_msg_attitude_pack_chan(systemId, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_2, &msg, 0,
+                                   0.1f, 0.2f, 0.3f, 0.0f, 0.0f, 0.0f);
+    return MavlinkTestHelpers::frame(msg);
+}
+
+void LatencyTraceTest::disabledRecordsNothing() {
+    LatencyTrace trace;
+    const quint64 key = LatencyTrace::key(1, 1, MAVLINK_MSG_ID_ATTITUDE, 7);
+    QVERIFY(key != 0);
+
+    trace.record(LatencyTrace::SocketReceive, key, T0);
+    trace.record(LatencyTrace::ParseComplete, key, T0 + 1000);
+    QCOMPARE(trace.eventsRecorded(), quint64(0));
+    QCOMPARE(trace.histogram(LatencyTrace::ParseComplete).count, quint64(0));
+}
+
+void LatencyTraceTest::histogramsLatencySinceReceive() {
+    LatencyTrace trace;
+    trace.setEnabled(true);
+
+    // 100 messages, parse latency 10..1000 us, model latency 1 ms more
+    for (int i = 1; i <= 100; ++i) {
+        const quint64 key = LatencyTrace::key(1, 1, MAVLINK_MSG_ID_ATTITUDE, uint8_t(i));
+        const qint64 received = T0 + i * 1000000LL;
+        trace.record(LatencyTrace::SocketReceive, key, received);
+        trace.record(LatencyTrace::ParseComplete, key, received + i * 10000LL);
+        trace.record(LatencyTrace::ModelUpdate, key, received + i * 10000LL + 1000000);
+    }
+    // Never received: recorded as an event but not part of any histogram
+    trace.record(LatencyTrace::ParseComplete, LatencyTrace::key(2, 1, 0, 0), T0);
+
+    QCOMPARE(trace.eventsRecorded(), quint64(301));
+    QCOMPARE(trace.histogram(LatencyTrace::SocketReceive).count, quint64(0));
+
+    const LatencyTrace::Histogram parse = trace.histogram(LatencyTrace::ParseComplete);
+    QCOMPARE(parse.count, quint64(100));
+    QCOMPARE(parse.maxUs, quint64(1000));
+    // Quarter-octave buckets: reported percentiles are at most 25% high
+    QVERIFY2(parse.p50Us >= 500 && parse.p50Us <= 625, qPrintable(QString::number(parse.p50Us)));
+    QVERIFY2(parse.p90Us >= 900 && parse.p90Us <= 1000, qPrintable(QString::number(parse.p90Us)));
+    QVERIFY(parse.p99Us >= parse.p90Us && parse.p99Us <= parse.maxUs);
+
+    const LatencyTrace::Histogram model = trace.histogram(LatencyTrace::ModelUpdate);
+    QCOMPARE(model.count, quint64(100));
+    QCOMPARE(model.maxUs, quint64(2000));
+    QVERIFY(model.p50Us >= 1500 && model.p50Us <= 1875);
+
+    trace.clear();
+    QCOMPARE(trace.eventsRecorded(), quint64(0));
+    QCOMPARE(trace.histogram(LatencyTrace::ModelUpdate).count, quint64(0));
+}
+
+void LatencyTraceTest::keepsFirstReceiveOfDuplicates() {
+    LatencyTrace trace;
+    trace.setEnabled(true);
+    const quint64 key = LatencyTrace::key(1, 1, MAVLINK_MSG_ID_ATTITUDE, 42);
+
+    // Same packet on a redundant link 3 ms later must not reset the clock
+    trace.record(LatencyTrace::SocketReceive, key, T0);
+    trace.record(LatencyTrace::SocketReceive, key, T0 + 3000000);
+    trace.record(LatencyTrace::ParseComplete, key, T0 + 5000000);
+    QCOMPARE(trace.histogram(LatencyTrace::ParseComplete).maxUs, quint64(5000));
+
+    // The sequence number wrapping around a few seconds later is a new message
+    trace.record(LatencyTrace::SocketReceive, key, T0 + 5000000000LL);
+    trace.record(LatencyTrace::ParseComplete, key, T0 + 5000000000LL + 100000);
+    const LatencyTrace::Histogram parse = trace.histogram(LatencyTrace::ParseComplete);
+    QCOMPARE(parse.count, quint64(2));
+    QVERIFY(parse.p50Us <= 125);
+}
+
+void LatencyTraceTest::splitsDatagramIntoFrames() {
+    LatencyTrace trace;
+    trace.setEnabled(true);
+
+    // Three frames from two vehicles with garbage in between, as one datagram
+    QByteArray datagram = makeAttitude(1, 10);
+    datagram += QByteArray("\x01\x02\x03", 3);
+    datagram += makeAttitude(2, 20);
+    datagram += makeAttitude(1, 11);
+    datagram += makeAttitude(3, 30).left(5);  // truncated, ignored
+    trace.recordDatagram(datagram.constData(), datagram.size(), T0);
+    QCOMPARE(trace.eventsRecorded(), quint64(3));
+
+    trace.record(LatencyTrace::ParseComplete,
+                 LatencyTrace::key(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_ATTITUDE, 10),
+                 T0 + 100000);
+    trace.record(LatencyTrace::ParseComplete,
+                 LatencyTrace::key(2, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_ATTITUDE, 20),
+                 T0 + 200000);
+    trace.record(LatencyTrace::ParseComplete,
+                 LatencyTrace::key(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_ATTITUDE, 11),
+                 T0 + 300000);
+    trace.record(LatencyTrace::ParseComplete,
+                 LatencyTrace::key(3, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_ATTITUDE, 30),
+                 T0 + 300000);
+
+    const LatencyTrace::Histogram parse = trace.histogram(LatencyTrace::ParseComplete);
+    QCOMPARE(parse.count, quint64(3));
+    QCOMPARE(parse.maxUs, quint64(300));
+}
+
+void LatencyTraceTest::exportsChromeTrace() {
+    LatencyTrace trace;
+    trace.setEnabled(true);
+
+    const int messages = 50;
+    for (int i = 0; i < messages; ++i) {
+        const quint64 key = LatencyTrace::key(1, 1, MAVLINK_MSG_ID_ATTITUDE, uint8_t(i));
+        const qint64 received = T0 + i * 20000000LL;
+        trace.record(LatencyTrace::SocketReceive, key, received);
+        trace.record(LatencyTrace::ParseComplete, key, received + 50000);
+        trace.record(LatencyTrace::ModelUpdate, key, received + 2000000);
+        trace.record(LatencyTrace::WidgetPaint, key, received + 9000000);
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("trace.json");
+    QString error;
+    QVERIFY2(trace.exportChromeTrace(fileName, &error), qPrintable(error));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    QCOMPARE(parseError.error, QJsonParseError::NoError);
+    const QJsonArray events = document.object().value("traceEvents").toArray();
+
+    QSet<QString> threads;
+    QHash<QString, int> slices;
+    int flowStarts = 0;
+    int flowEnds = 0;
+    double maxPaintLatencyUs = 0.0;
+    double previousTs = -1.0;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        const QString phase = event.value("ph").toString();
+        if (phase == "M" && event.value("name").toString() == "thread_name") {
+            threads.insert(event.value("args").toObject().value("name").toString());
+        } else if (phase == "X") {
+            const QString name = event.value("name").toString();
+            slices[name]++;
+            QVERIFY(event.value("ts").toDouble() >= previousTs);
+            previousTs = event.value("ts").toDouble();
+            if (name == "widget paint") {
+                const QJsonObject args = event.value("args").toObject();
+                QCOMPARE(args.value("msgid").toInt(), int(MAVLINK_MSG_ID_ATTITUDE));
+                maxPaintLatencyUs = qMax(maxPaintLatencyUs, args.value("latency_us").toDouble());
+            }
+        } else if (phase == "s") {
+            ++flowStarts;
+        } else if (phase == "f") {
+            ++flowEnds;
+        }
+    }
+
+    QCOMPARE(threads, QSet<QString>({"UdpLink", "MavlinkRouter", "VehicleModel", "HudWidget"}));
+    QCOMPARE(slices.value("socket receive"), messages);
+    QCOMPARE(slices.value("parse complete"), messages);
+    QCOMPARE(slices.value("model update"), messages);
+    QCOMPARE(slices.value("widget paint"), messages);
+    QCOMPARE(flowStarts, 3 * messages);
+    QCOMPARE(flowEnds, 3 * messages);
+    QCOMPARE(maxPaintLatencyUs, 9000.0);
+}
+
+QTEST_MAIN(LatencyTraceTest)
+#include "tst_latencytrace.moc"
@@ -0,0 +1,682 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "comm/bytering.h"
+#include "comm/mavlinkframing.h"
+#include "comm/mavlinkrouter.h"
+#include "comm/tlogrecorder.h"
+#include "mavlinktesthelpers.h"
+#include <functional>
+#include <map>
+
+namespace {
+
+// RAW_IMU through a payload type whose decoder counts its calls
+struct CountedRawImu : mavlink_raw_imu_t {
+    static int decodes;
+};
+int CountedRawImu::decodes = 0;
+
+}  // namespace
+
+template <>
+struct MavlinkMessageTraits<CountedRawImu> {
+    static constexpr uint32_t MSG_ID = MAVLINK_MSG_ID_RAW_IMU;
+    static constexpr const char* MSG_NAME = "RAW_IMU";
+    static void decode(const mavlink_message_t* msg, CountedRawImu* out) {
+        CountedRawImu::decodes++;
+        mavlink_msg_raw_imu_decode(msg, out);
+    }
+};
+
+/**
+ * @brief Behaviour of MavlinkRouter's message dispatch, subscriptions,
+ * link routing, redundant-link failover and flight-log recording
+ *
+ * Packets are framed on a MAVLink channel the router does not parse on and
+ * fed in with receiveBytes(), which parses them as link 0, or through a
+ * receive ring as a link does.
+ */
+class MavlinkRouterTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void registeredHandlerReceivesMessage();
+    void handlersRunInRegistrationOrder();
+    void unregisteredHandlerIsNotCalled();
+    void unregisterDuringDispatch();
+    void unknownMessageIds();
+    void subscribersShareOneDecode();
+    void builtinMessageDecodedOnce();
+    void unsubscribedMessageIsNotDecoded();
+    void unsubscribeDuringDispatch();
+    void routesToLinkSystemWasHeardOn();
+    void routeFallsBackAfterTimeout();
+    void interleavedLinksKeepSeparateParsers();
+    void silentPrimary();
+    void primaryJustBehindIsKept();
+    void laggingPrimary();
+    void lossyPrimary();
+    void recordsRawTrafficOfEveryLink();
+
+private:
+    static constexpr mavlink_channel_t TEST_CHANNEL =
+        static_cast<mavlink_channel_t>(MavlinkRouter::MAX_LINKS);
+
+    static QByteArray heartbeat(uint8_t systemId = 1);
+    static QByteArray rawImu(uint8_t systemId = 1);
+    static QByteArray attitude(float roll, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1);
+    static QByteArray unknownMessage(uint32_t msgId);
+    static mavlink_message_t commandTo(uint8_t targetSystem);
+
+    // Hand bytes to the router as link @p linkId does, through a receive ring
+    static void deliver(MavlinkRouter& router, int linkId, const QByteArray& bytes);
+
+    // Link mask the router sends @p msg to
+    static quint32 routeOf(MavlinkRouter& router, const mavlink_message_t& msg);
+
+    // Plays @p packets packets of system 1, one every PACKET_INTERVAL_MS, over
+    // link 0 (the primary) and link 1 in redundancy mode. @p delayMs gives the
+    // delay of each link's copy of a packet, or -1 to lose it; on a tie link 1
+    // delivers first. Even packets come from the autopilot, odd ones from a gimbal.
+    static constexpr int PACKET_INTERVAL_MS = 10;
+    static void playRedundant(MavlinkRouter& router, int packets,
+                              const std::function<int(int linkId, int packet)>& delayMs);
+    static void reportSwitchover(const char* scenario, const MavlinkRouter& router);
+
+    // Switchover latency depends on the machine's load, so only that a switch
+    // happens, and never early, is checked unless this is set
+    static bool assertTimings() { return qEnvironmentVariableIsSet("FLIGHTSCOPE_BENCH_ASSERT"); }
+};
+
+void MavlinkRouterTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+}
+
+QByteArray MavlinkRouterTest::heartbeat(uint8_t systemId) {
+    mavlink_message_t msg;
+    mavlink_msg_heartbeat_pack_chan(systemId, MAV_COMP_ID_AUTOPILOT1, TEST_CHANNEL, &msg,
+                                    MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 0, 0,
+                                    MAV_STATE_STANDBY);
+    return MavlinkTestHelpers::frame(msg);
+}
+
+QByteArray MavlinkRouterTest::rawImu(uint8_t systemId) {
+    // No built-in handler
+    mavlink_message_t msg;
+    mavlink_msg_raw_imu_pack_chan(systemId, MAV_COMP_ID_AUTOPILOT1, TEST_CHANNEL, &msg, 1000, 1,
+                                  2, 3, 4, 5, 6, 7, 8, 9, 0, 25);
+    return MavlinkTestHelpers::frame(msg);
+}
+
+QByteArray MavlinkRouterTest::attitude(float roll, uint8_t componentId) {
+    mavlink_message_t msg;
+    mavlink_msg_attitude_pack_chan(1, componentId, TEST_CHANNEL, &msg, 1000, roll, 0.2f, 0.3f, 0,
+                                   0, 0);
+    return MavlinkTestHelpers::frame(msg);
+}
+
+QByteArray MavlinkRouterTest::unknownMessage(uint32_t msgId) {
+    // Not in the dialect: the parser accepts it with a CRC extra of 0
+    return MavlinkTestHelpers::makePacket(msgId, 1, MAV_COMP_ID_AUTOPILOT1, TEST_CHANNEL, 4, 4, 0,
+                                          [](int i) { return i + 1; });
+}
+
+mavlink_message_t MavlinkRouterTest::commandTo(uint8_t targetSystem) {
+    mavlink_message_t msg;
+    mavlink_msg_command_long_pack_chan(255, 190, TEST_CHANNEL, &msg, targetSystem, 1,
+                                       MAV_CMD_REQUEST_MESSAGE, 0, 1, 0, 0, 0, 0, 0, 0);
+    return msg;
+}
+
+void MavlinkRouterTest::deliver(MavlinkRouter& router, int linkId, const QByteArray& bytes) {
+    ByteRing ring(4096);
+    QVERIFY(ring.write(bytes.constData(), bytes.size()));
+    router.drainReceiveRing(linkId, ring);
+}
+
+quint32 MavlinkRouterTest::routeOf(MavlinkRouter& router, const mavlink_message_t& msg) {
+    QSignalSpy spy(&router, &MavlinkRouter::bytesToSend);
+    router.sendMessage(msg);
+    return spy.isEmpty() ? 0 : spy.at(0).at(0).value<quint32>();
+}
+
+void MavlinkRouterTest::playRedundant(MavlinkRouter& router, int packets,
+                                      const std::function<int(int, int)>& delayMs) {
+    router.attachLink(0);
+    router.attachLink(1);
+    router.setRedundancyEnabled(true);
+    deliver(router, 0, heartbeat(1));
+    QCOMPARE(router.primaryLink(1), 0);
+
+    // Copies in flight by the time they are due, in the order they were sent;
+    // those still in flight after the last packet are lost
+    std::multimap<qint64, std::pair<int, QByteArray>> inFlight;
+    QElapsedTimer clock;
+    clock.start();
+    for (int packet = 0; packet < packets; ++packet) {
+        const qint64 sentMs = qint64(packet) * PACKET_INTERVAL_MS;
+        const uint8_t componentId = packet % 2 == 0 ? MAV_COMP_ID_AUTOPILOT1 : MAV_COMP_ID_GIMBAL;
+        const QByteArray bytes = attitude(0.01f * packet, componentId);
+        for (int linkId : {1, 0}) {
+            const int delay = delayMs(linkId, packet);
+            if (delay >= 0) {
+                inFlight.emplace(sentMs + delay, std::make_pair(linkId, bytes));
+            }
+        }
+
+        // Deliver what is due up to the next packet, running the failover timer in between
+        const qint64 untilMs = sentMs + PACKET_INTERVAL_MS;
+        while (!inFlight.empty() && inFlight.begin()->first < untilMs) {
+            const qint64 dueMs = inFlight.begin()->first;
+            if (dueMs > clock.elapsed()) {
+                QTest::qWait(int(dueMs - clock.elapsed()));
+            }
+            deliver(router, inFlight.begin()->second.first, inFlight.begin()->second.second);
+            inFlight.erase(inFlight.begin());
+        }
+        if (untilMs > clock.elapsed()) {
+            QTest::qWait(int(untilMs - clock.elapsed()));
+        }
+    }
+}
+
+void MavlinkRouterTest::reportSwitchover(const char* scenario, const MavlinkRouter& router) {
+    const MavlinkRouter::RedundancyStatistics stats = router.redundancyStatistics();
+    qInfo("%s: %llu switchover(s), last after %lld ms (limit %lld ms)", scenario,
+          static_cast<unsigned long long>(stats.switchovers),
+          static_cast<long long>(stats.lastSwitchoverMs),
+          static_cast<long long>(MavlinkRouter::DEGRADED_TIMEOUT_MS));
+}
+
+void MavlinkRouterTest::registeredHandlerReceivesMessage() {
+    MavlinkRouter router;
+    QList<mavlink_message_t> received;
+    const int handle = router.registerHandler(
+        MAVLINK_MSG_ID_RAW_IMU,
+        [&received](const mavlink_message_t& msg) { received.append(msg); });
+    QVERIFY(handle != 0);
+
+    router.receiveBytes(heartbeat() + rawImu(7) + heartbeat());
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.at(0).msgid, uint32_t(MAVLINK_MSG_ID_RAW_IMU));
+    QCOMPARE(received.at(0).sysid, uint8_t(7));
+    QCOMPARE(mavlink_msg_raw_imu_get_xacc(&received.at(0)), int16_t(1));
+
+    // Empty handlers are refused
+    QCOMPARE(router.registerHandler(MAVLINK_MSG_ID_RAW_IMU, MavlinkRouter::MessageHandler()), 0);
+}
+
+void MavlinkRouterTest::handlersRunInRegistrationOrder() {
+    MavlinkRouter router;
+    QStringList calls;
+    connect(&router, &MavlinkRouter::heartbeatReceived, &router,
+            [&calls]() { calls.append("builtin"); }, Qt::DirectConnection);
+    const int first = router.registerHandler(
+        MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t&) { calls.append("first"); });
+    const int second = router.registerHandler(
+        MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t&) { calls.append("second"); });
+    QVERIFY(first != second);
+
+    // Built-in handler first, then the registered ones in order
+    router.receiveBytes(heartbeat());
+    QCOMPARE(calls, QStringList({"builtin", "first", "second"}));
+
+    calls.clear();
+    router.receiveBytes(heartbeat() + heartbeat());
+    QCOMPARE(calls, QStringList({"builtin", "first", "second", "builtin", "first", "second"}));
+}
+
+void MavlinkRouterTest::unregisteredHandlerIsNotCalled() {
+    MavlinkRouter router;
+    int firstCalls = 0;
+    int secondCalls = 0;
+    const int first = router.registerHandler(
+        MAVLINK_MSG_ID_RAW_IMU, [&firstCalls](const mavlink_message_t&) { firstCalls++; });
+    const int second = router.registerHandler(
+        MAVLINK_MSG_ID_RAW_IMU, [&secondCalls](const mavlink_message_t&) { secondCalls++; });
+
+    router.receiveBytes(rawImu());
+    router.unregisterHandler(first);
+    router.receiveBytes(rawImu());
+    QCOMPARE(firstCalls, 1);
+    QCOMPARE(secondCalls, 2);
+
+    // Unknown and repeated handles are ignored
+    router.unregisterHandler(first);
+    router.unregisterHandler(12345);
+    router.receiveBytes(rawImu());
+    QCOMPARE(secondCalls, 3);
+
+    router.unregisterHandler(second);
+    router.receiveBytes(rawImu());
+    QCOMPARE(secondCalls, 3);
+}
+
+void MavlinkRouterTest::unregisterDuringDispatch() {
+    MavlinkRouter router;
+    QStringList calls;
+    int third = 0;
+    int first = 0;
+    first = router.registerHandler(MAVLINK_MSG_ID_RAW_IMU, [&](const mavlink_message_t&) {
+        calls.append("first");
+        router.unregisterHandler(first);  // itself
+        router.unregisterHandler(third);  // one that has not run yet
+        router.registerHandler(MAVLINK_MSG_ID_RAW_IMU,
+                               [&calls](const mavlink_message_t&) { calls.append("added"); });
+    });
+    router.registerHandler(MAVLINK_MSG_ID_RAW_IMU,
+                           [&calls](const mavlink_message_t&) { calls.append("second"); });
+    third = router.registerHandler(MAVLINK_MSG_ID_RAW_IMU,
+                                   [&calls](const mavlink_message_t&) { calls.append("third"); });
+
+    // Handlers added during dispatch start with the next message
+    router.receiveBytes(rawImu());
+    QCOMPARE(calls, QStringList({"first", "second"}));
+
+    calls.clear();
+    router.receiveBytes(rawImu());
+    QCOMPARE(calls, QStringList({"second", "added"}));
+}
+
+void MavlinkRouterTest::unknownMessageIds() {
+    MavlinkRouter router;
+    QList<uint32_t> received;
+    connect(&router, &MavlinkRouter::messageReceived, &router,
+            [&received](const mavlink_message_t& msg) { received.append(msg.msgid); },
+            Qt::DirectConnection);
+
+    // Beyond the dialect, and beyond the msgid bitsets
+    QList<uint32_t> handled;
+    router.registerHandler(60000, [&handled](const mavlink_message_t& msg) {
+        handled.append(msg.msgid);
+    });
+    router.registerHandler(70000, [&handled](const mavlink_message_t& msg) {
+        handled.append(msg.msgid);
+    });
+
+    router.receiveBytes(unknownMessage(60000) + unknownMessage(60001) + unknownMessage(70000) +
+                        unknownMessage(70001) + heartbeat());
+    QCOMPARE(received, QList<uint32_t>({60000, 60001, 70000, 70001, MAVLINK_MSG_ID_HEARTBEAT}));
+    QCOMPARE(handled, QList<uint32_t>({60000, 70000}));
+}
+
+void MavlinkRouterTest::subscribersShareOneDecode() {
+    MavlinkRouter router;
+    CountedRawImu::decodes = 0;
+    QList<const void*> payloads;
+    QList<int16_t> values;
+    for (int i = 0; i < 3; ++i) {
+        router.subscribe<CountedRawImu>([&](const CountedRawImu& imu) {
+            payloads.append(&imu);
+            values.append(imu.xacc);
+        });
+    }
+    router.subscribe<CountedRawImu>([&](const CountedRawImu& imu, const mavlink_message_t& msg) {
+        QCOMPARE(msg.sysid, uint8_t(7));
+        payloads.append(&imu);
+        values.append(imu.xacc);
+    });
+
+    router.receiveBytes(rawImu(7));
+    QCOMPARE(CountedRawImu::decodes, 1);
+    QCOMPARE(values, QList<int16_t>({1, 1, 1, 1}));
+    QCOMPARE(QSet<const void*>(payloads.cbegin(), payloads.cend()).size(), 1);
+
+    payloads.clear();
+    router.receiveBytes(rawImu(7) + rawImu(7));
+    QCOMPARE(CountedRawImu::decodes, 3);
+    QCOMPARE(payloads.size(), 8);
+}
+
+void MavlinkRouterTest::builtinMessageDecodedOnce() {
+    // The built-in handler's decode is shared with the subscribers
+    MavlinkRouter router;
+    QList<const void*> payloads;
+    QList<float> rolls;
+    for (int i = 0; i < 2; ++i) {
+        router.subscribe<mavlink_attitude_t>([&](const mavlink_attitude_t& attitude) {
+            payloads.append(&attitude);
+            rolls.append(attitude.roll);
+        });
+    }
+
+    router.receiveBytes(attitude(0.5f));
+    QCOMPARE(rolls, QList<float>({0.5f, 0.5f}));
+    QCOMPARE(payloads.at(0), payloads.at(1));
+
+    // The built-in handler still ran
+    const QVector<MavlinkRouter::TelemetryBatch> batches = router.takeTelemetryBatches();
+    QCOMPARE(batches.size(), 1);
+    QVERIFY(batches.at(0).has(MavlinkRouter::TelemetryBatch::Attitude));
+    QCOMPARE(batches.at(0).attitude.roll, 0.5f);
+}
+
+void MavlinkRouterTest::unsubscribedMessageIsNotDecoded() {
+    MavlinkRouter router;
+    CountedRawImu::decodes = 0;
+
+    // Raw handlers get the message undecoded
+    int handled = 0;
+    router.registerHandler(MAVLINK_MSG_ID_RAW_IMU,
+                           [&handled](const mavlink_message_t&) { handled++; });
+    router.receiveBytes(rawImu());
+    QCOMPARE(handled, 1);
+    QCOMPARE(CountedRawImu::decodes, 0);
+
+    int notified = 0;
+    const int first = router.subscribe<CountedRawImu>([&notified](const CountedRawImu&) {
+        notified++;
+    });
+    const int second = router.subscribe<CountedRawImu>([&notified](const CountedRawImu&) {
+        notified++;
+    });
+    router.receiveBytes(rawImu());
+    QCOMPARE(CountedRawImu::decodes, 1);
+    QCOMPARE(notified, 2);
+
+    router.unsubscribe(first);
+    router.receiveBytes(rawImu());
+    QCOMPARE(CountedRawImu::decodes, 2);
+    QCOMPARE(notified, 3);
+
+    router.unsubscribe(second);
+    router.receiveBytes(rawImu() + rawImu());
+    QCOMPARE(CountedRawImu::decodes, 2);
+    QCOMPARE(notified, 3);
+    QCOMPARE(handled, 5);
+}
+
+void MavlinkRouterTest::unsubscribeDuringDispatch() {
+    MavlinkRouter router;
+    QStringList calls;
+    int first = 0;
+    int third = 0;
+    first = router.subscribe<mavlink_attitude_t>([&](const mavlink_attitude_t&) {
+        calls.append("first");
+        router.unsubscribe(first);  // itself
+        router.unsubscribe(third);  // one that has not run yet
+        router.subscribe<mavlink_attitude_t>(
+            [&calls](const mavlink_attitude_t&) { calls.append("added"); });
+    });
+    const int second = router.subscribe<mavlink_attitude_t>(
+        [&calls](const mavlink_attitude_t&) { calls.append("second"); });
+    third = router.subscribe<mavlink_attitude_t>(
+        [&calls](const mavlink_attitude_t&) { calls.append("third"); });
+
+    // Subscriptions made during dispatch start with the next message
+    router.receiveBytes(attitude(0.1f));
+    QCOMPARE(calls, QStringList({"first", "second"}));
+
+    calls.clear();
+    router.receiveBytes(attitude(0.2f));
+    QCOMPARE(calls, QStringList({"second", "added"}));
+
+    // The last subscriber of a message that is not built in drops the
+    // message's whole subscriber list while it is being notified
+    int last = 0;
+    int lastCalls = 0;
+    last = router.subscribe<CountedRawImu>([&](const CountedRawImu&) {
+        lastCalls++;
+        router.unsubscribe(last);
+    });
+    router.receiveBytes(rawImu() + rawImu());
+    QCOMPARE(lastCalls, 1);
+
+    router.unsubscribe(second);
+    calls.clear();
+    router.receiveBytes(attitude(0.3f));
+    QCOMPARE(calls, QStringList({"added"}));
+}
+
+void MavlinkRouterTest::routesToLinkSystemWasHeardOn() {
+    MavlinkRouter router;
+    router.attachLink(0);
+    router.attachLink(1);
+    router.attachLink(2);
+    deliver(router, 0, heartbeat(1));
+    deliver(router, 1, heartbeat(2));
+    deliver(router, 2, heartbeat(2));
+
+    QCOMPARE(routeOf(router, commandTo(1)), 0b001u);
+    QCOMPARE(routeOf(router, commandTo(2)), 0b110u);  // every link it was heard on
+
+    // Unknown and broadcast targets, and messages without one, go everywhere
+    QCOMPARE(routeOf(router, commandTo(3)), 0b111u);
+    QCOMPARE(routeOf(router, commandTo(0)), 0b111u);
+    mavlink_message_t gcsHeartbeat;
+    mavlink_msg_heartbeat_pack_chan(255, 190, TEST_CHANNEL, &gcsHeartbeat, MAV_TYPE_GCS,
+                                    MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+    QCOMPARE(routeOf(router, gcsHeartbeat), 0b111u);
+
+    // A detached link is forgotten, and comes back without its history
+    router.detachLink(0);
+    QCOMPARE(routeOf(router, commandTo(1)), 0b110u);
+    router.attachLink(0);
+    QCOMPARE(routeOf(router, commandTo(1)), 0b111u);
+    deliver(router, 0, heartbeat(1));
+    QCOMPARE(routeOf(router, commandTo(1)), 0b001u);
+
+    // Nothing attached, nothing sent
+    for (int linkId = 0; linkId < 3; ++linkId) {
+        router.detachLink(linkId);
+    }
+    QCOMPARE(routeOf(router, commandTo(1)), 0u);
+}
+
+void MavlinkRouterTest::routeFallsBackAfterTimeout() {
+    MavlinkRouter router;
+    router.attachLink(0);
+    router.attachLink(1);
+    router.attachLink(2);
+    deliver(router, 0, heartbeat(1));
+    deliver(router, 1, heartbeat(1));
+    QCOMPARE(routeOf(router, commandTo(1)), 0b011u);
+
+    QTest::qWait(MavlinkRouter::ROUTE_TIMEOUT_MS + 200);
+
+    // Link 0 went quiet: only the link the system is still heard on
+    deliver(router, 1, heartbeat(1));
+    QCOMPARE(routeOf(router, commandTo(1)), 0b010u);
+
+    // Quiet everywhere: the link it was heard on last, not every link
+    router.detachLink(1);
+    QCOMPARE(routeOf(router, commandTo(1)), 0b001u);
+}
+
+void MavlinkRouterTest::interleavedLinksKeepSeparateParsers() {
+    MavlinkRouter router;
+    router.attachLink(0);
+    router.attachLink(1);
+    QList<uint8_t> systems[2];
+    connect(&router, &MavlinkRouter::heartbeatReceived, &router,
+            [&](uint8_t systemId) { systems[systemId - 1].append(systemId); },
+            Qt::DirectConnection);
+
+    // Two streams of different lengths, cut into chunks that split packets
+    // at every position and handed over alternately
+    QByteArray streams[2];
+    for (int i = 0; i < 50; ++i) {
+        streams[0] += heartbeat(1) + rawImu(1);
+        streams[1] += heartbeat(2) + attitude(0.1f) + rawImu(2);
+    }
+    qsizetype positions[2] = {0, 0};
+    for (int chunk = 0; positions[0] < streams[0].size() || positions[1] < streams[1].size();
+         ++chunk) {
+        const int linkId = chunk % 2;
+        const qsizetype size = 1 + (chunk * 7) % 13;
+        if (positions[linkId] < streams[linkId].size()) {
+            deliver(router, linkId, streams[linkId].mid(positions[linkId], size));
+            positions[linkId] += size;
+        }
+    }
+
+    QCOMPARE(systems[0].size(), 50);
+    QCOMPARE(systems[1].size(), 50);
+    QCOMPARE(router.linkStatistics(0).messagesReceived, quint64(100));
+    QCOMPARE(router.linkStatistics(1).messagesReceived, quint64(150));
+    QCOMPARE(router.linkStatistics(0).bytesReceived, quint64(streams[0].size()));
+    QCOMPARE(router.linkStatistics(1).bytesReceived, quint64(streams[1].size()));
+
+    // A corrupt packet on one link, around a packet split on the other,
+    // costs only itself
+    QByteArray corrupt = heartbeat(1);
+    corrupt[corrupt.size() - 1] = static_cast<char>(corrupt.at(corrupt.size() - 1) ^ 0xff);
+    const QByteArray split = heartbeat(2);
+    deliver(router, 0, corrupt.left(5));
+    deliver(router, 1, split.left(4));
+    deliver(router, 0, corrupt.mid(5));
+    deliver(router, 1, split.mid(4));
+    deliver(router, 0, heartbeat(1));
+    QCOMPARE(systems[0].size(), 51);
+    QCOMPARE(systems[1].size(), 51);
+}
+
+void MavlinkRouterTest::silentPrimary() {
+    // Link 0 goes quiet after packet 20
+    MavlinkRouter router;
+    playRedundant(router, 60, [](int linkId, int packet) {
+        return linkId == 0 && packet >= 20 ? -1 : 0;
+    });
+    reportSwitchover("Silent primary", router);
+
+    const MavlinkRouter::RedundancyStatistics stats = router.redundancyStatistics();
+    QCOMPARE(router.primaryLink(1), 1);
+    QCOMPARE(stats.switchovers, quint64(1));
+    QVERIFY(stats.lastSwitchoverMs >= MavlinkRouter::DEGRADED_TIMEOUT_MS);
+    if (assertTimings()) {
+        QVERIFY(stats.lastSwitchoverMs <=
+                MavlinkRouter::DEGRADED_TIMEOUT_MS + 2 * PACKET_INTERVAL_MS);
+    }
+    QCOMPARE(stats.duplicatesDropped, quint64(20));
+}
+
+void MavlinkRouterTest::primaryJustBehindIsKept() {
+    // Link 0 always delivers second, a few ms behind, and loses every third packet
+    MavlinkRouter router;
+    playRedundant(router, 60, [](int linkId, int packet) {
+        if (linkId == 1) {
+            return 0;
+        }
+        return packet % 3 == 2 ? -1 : 5;
+    });
+    reportSwitchover("Primary just behind", router);
+
+    QCOMPARE(router.primaryLink(1), 0);
+    QCOMPARE(router.redundancyStatistics().switchovers, quint64(0));
+}
+
+void MavlinkRouterTest::laggingPrimary() {
+    // Link 0 carries the gimbal first, but the autopilot three timeouts late;
+    // its prompt packets do not hide the late ones
+    const int lagMs = 3 * MavlinkRouter::DEGRADED_TIMEOUT_MS;
+    MavlinkRouter router;
+    playRedundant(router, 40, [lagMs](int linkId, int packet) {
+        if (packet % 2 == 1) {
+            return linkId == 0 ? 0 : -1;
+        }
+        return linkId == 0 ? lagMs : 0;
+    });
+    reportSwitchover("Lagging primary", router);
+
+    const MavlinkRouter::RedundancyStatistics stats = router.redundancyStatistics();
+    QCOMPARE(router.primaryLink(1), 1);
+    QCOMPARE(stats.switchovers, quint64(1));
+    QVERIFY(stats.lastSwitchoverMs >= MavlinkRouter::DEGRADED_TIMEOUT_MS);
+    if (assertTimings()) {
+        QVERIFY(stats.lastSwitchoverMs <= lagMs + 2 * PACKET_INTERVAL_MS);
+    }
+}
+
+void MavlinkRouterTest::lossyPrimary() {
+    // Link 0 loses single packets, then a burst of ten in a row
+    MavlinkRouter router;
+    int switchoversBeforeBurst = -1;
+    playRedundant(router, 60, [&](int linkId, int packet) {
+        if (packet == 30 && switchoversBeforeBurst < 0) {
+            switchoversBeforeBurst = int(router.redundancyStatistics().switchovers);
+        }
+        if (linkId == 1) {
+            return 0;
+        }
+        const bool lost = packet < 30 ? packet % 4 == 3 : packet < 40;
+        return lost ? -1 : 0;
+    });
+    reportSwitchover("Lossy primary", router);
+
+    const MavlinkRouter::RedundancyStatistics stats = router.redundancyStatistics();
+    QCOMPARE(switchoversBeforeBurst, 0);
+    QCOMPARE(router.primaryLink(1), 1);
+    QCOMPARE(stats.switchovers, quint64(1));
+    QVERIFY(stats.lastSwitchoverMs >= MavlinkRouter::DEGRADED_TIMEOUT_MS);
+    if (assertTimings()) {
+        QVERIFY(stats.lastSwitchoverMs <=
+                MavlinkRouter::DEGRADED_TIMEOUT_MS + 2 * PACKET_INTERVAL_MS);
+    }
+}
+
+void MavlinkRouterTest::recordsRawTrafficOfEveryLink() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    TlogRecorder recorder;
+    TlogRecorder::Configuration config;
+    config.directory = directory.path();
+    QVERIFY(recorder.start(config));
+    const QString logPath = recorder.statistics().fileName;
+
+    MavlinkRouter router;
+    router.setRedundancyEnabled(true);
+    router.attachLink(0);
+    router.attachLink(1);
+    router.setTlogRecorder(&recorder);
+
+    // A frame split across reads with noise in front, one with a bad
+    // checksum, and the redundant link's copy of the first
+    const QByteArray good = heartbeat(1);
+    QByteArray corrupt = heartbeat(1);
+    corrupt[corrupt.size() - 1] = static_cast<char>(corrupt.at(corrupt.size() - 1) ^ 0x55);
+    deliver(router, 0, QByteArray("\x00\x11", 2) + good.left(5));
+    deliver(router, 0, good.mid(5) + corrupt);
+    deliver(router, 1, good);
+    QCOMPARE(router.linkStatistics(1).duplicatesDropped, quint64(1));
+
+    // Outbound: one record per link the packet goes out on
+    mavlink_message_t gcsHeartbeat;
+    mavlink_msg_heartbeat_pack_chan(255, 190, TEST_CHANNEL, &gcsHeartbeat, MAV_TYPE_GCS,
+                                    MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+    QSignalSpy sent(&router, &MavlinkRouter::bytesToSend);
+    router.sendMessage(gcsHeartbeat);
+    QCOMPARE(sent.size(), 1);
+    const QByteArray outbound = sent.at(0).at(1).toByteArray();
+    recorder.stop();
+
+    QFile log(logPath);
+    QVERIFY(log.open(QIODevice::ReadOnly));
+    const QByteArray bytes = log.readAll();
+    QList<QByteArray> packets;
+    qsizetype offset = 0;
+    while (offset + TlogRecorder::TIMESTAMP_BYTES < bytes.size()) {
+        offset += TlogRecorder::TIMESTAMP_BYTES;
+        const qsizetype length = MavlinkFraming::packetLength(
+            reinterpret_cast<const uchar*>(bytes.constData() + offset), bytes.size() - offset);
+        QVERIFY(length > 0);
+        packets.append(bytes.mid(offset, length));
+        offset += length;
+    }
+    QCOMPARE(offset, bytes.size());
+    const QList<QByteArray> expectedPackets{good, corrupt, good, outbound, outbound};
+    QCOMPARE(packets, expectedPackets);
+
+    QFile links(TlogRecorder::linksPath(logPath));
+    QVERIFY(links.open(QIODevice::ReadOnly));
+    const uchar out = TlogRecorder::OUTBOUND_TAG;
+    const QByteArray expectedTags("\x00\x00\x01", 3);
+    QCOMPARE(links.readAll(), expectedTags + char(out | 0) + char(out | 1));
+}
+
+QTEST_MAIN(MavlinkRouterTest)
+#include "tst_mavlinkrouter.moc"
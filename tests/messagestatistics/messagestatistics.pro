@@ -0,0 +1,13 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_messagestatistics.cpp \
+    $$FLIGHTSCOPE_SRC/comm/messagestatistics.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/messagestatistics.h \
+    $$FLIGHTSCOPE_SRC/comm/relaxedcounter.h
@@ -0,0 +1,179 @@
+#include <QtTest>
+#include "comm/messagestatistics.h"
+
+/**
+ * @brief Per-stream rate, bandwidth and jitter from timestamped records
+ *
+ * All timestamps are synthetic, so the expected rates are exact.
+ */
+class MessageStatisticsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void rateAndBandwidth();
+    void steadyStreamHasNoJitter();
+    void jitterOfAlternatingIntervals();
+    void windowRollover();
+    void fullTable();
+
+private:
+    static constexpr qint64 MS = 1000000;  // ns
+
+    static const MessageStatistics::StreamRate* find(
+        const QVector<MessageStatistics::StreamRate>& rates, uint8_t systemId, uint32_t msgId);
+    static MessageStatistics::StreamCounters counters(const MessageStatistics::Snapshot& snapshot,
+                                                      uint32_t msgId);
+};
+
+const MessageStatistics::StreamRate* MessageStatisticsTest::find(
+    const QVector<MessageStatistics::StreamRate>& rates, uint8_t systemId, uint32_t msgId) {
+    for (const MessageStatistics::StreamRate& rate : rates) {
+        if (rate.systemId == systemId && rate.msgId == msgId) {
+            return &rate;
+        }
+    }
+    return nullptr;
+}
+
+MessageStatistics::StreamCounters MessageStatisticsTest::counters(
+    const MessageStatistics::Snapshot& snapshot, uint32_t msgId) {
+    for (const MessageStatistics::StreamCounters& stream : snapshot.streams) {
+        if (stream.msgId == msgId) {
+            return stream;
+        }
+    }
+    return MessageStatistics::StreamCounters();
+}
+
+void MessageStatisticsTest::rateAndBandwidth() {
+    MessageStatistics statistics;
+    const MessageStatistics::Snapshot start = statistics.snapshot(0);
+
+    // Two seconds: msgid 30 at 50 Hz (40 bytes), msgid 33 at 10 Hz (40 bytes)
+    // from system 1, and msgid 30 at 5 Hz from system 2
+    for (qint64 t = 0; t < 2000 * MS; t += 20 * MS) {
+        statistics.record(1, 1, 30, 40, t);
+        if (t % (100 * MS) == 0) {
+            statistics.record(1, 1, 33, 40, t + MS);
+        }
+        if (t % (200 * MS) == 0) {
+            statistics.record(2, 1, 30, 40, t + 2 * MS);
+        }
+    }
+    const MessageStatistics::Snapshot end = statistics.snapshot(2000 * MS);
+    QCOMPARE(end.streams.size(), 3);
+    QCOMPARE(counters(end, 33).messages, quint64(20));
+    QCOMPARE(counters(end, 33).bytes, quint64(800));
+
+    const QVector<MessageStatistics::StreamRate> rates = MessageStatistics::rates(start, end);
+    QCOMPARE(rates.size(), 3);
+    const MessageStatistics::StreamRate* attitude = find(rates, 1, 30);
+    QVERIFY(attitude);
+    QCOMPARE(attitude->hz, 50.0);
+    QCOMPARE(attitude->bytesPerSecond, 2000.0);
+    QCOMPARE(find(rates, 1, 33)->hz, 10.0);
+    QCOMPARE(find(rates, 2, 30)->hz, 5.0);
+    QCOMPARE(find(rates, 2, 30)->bytesPerSecond, 200.0);
+
+    // Highest bandwidth first
+    QCOMPARE(rates.at(0).msgId, uint32_t(30));
+    QCOMPARE(rates.at(0).systemId, uint8_t(1));
+    QCOMPARE(rates.at(2).systemId, uint8_t(2));
+    QCOMPARE(MessageStatistics::totalBytesPerSecond(rates), 2000.0 + 400.0 + 200.0);
+}
+
+void MessageStatisticsTest::steadyStreamHasNoJitter() {
+    // A stream that starts at time 0 has an interval from its second packet on
+    MessageStatistics statistics;
+    statistics.record(1, 1, 30, 40, 0);
+    statistics.record(1, 1, 30, 40, 20 * MS);
+    QCOMPARE(counters(statistics.snapshot(20 * MS), 30).meanIntervalUs, quint32(20000));
+
+    for (int i = 2; i < 100; ++i) {
+        statistics.record(1, 1, 30, 40, i * 20 * MS);
+    }
+    const MessageStatistics::StreamCounters stream = counters(statistics.snapshot(2000 * MS), 30);
+    QCOMPARE(stream.messages, quint64(100));
+    QCOMPARE(stream.meanIntervalUs, quint32(20000));
+    QCOMPARE(stream.jitterUs, quint32(0));
+}
+
+void MessageStatisticsTest::jitterOfAlternatingIntervals() {
+    // 10 ms and 30 ms in turn: a 20 ms mean, every interval 10 ms off it
+    MessageStatistics statistics;
+    qint64 t = 0;
+    for (int i = 0; i < 400; ++i) {
+        statistics.record(1, 1, 30, 40, t);
+        t += (i % 2 == 0 ? 10 : 30) * MS;
+    }
+    const MessageStatistics::Snapshot snapshot = statistics.snapshot(t);
+    const MessageStatistics::StreamCounters stream = counters(snapshot, 30);
+    QVERIFY2(qAbs(qint64(stream.meanIntervalUs) - 20000) <= 1000,
+             qPrintable(QString::number(stream.meanIntervalUs)));
+    QVERIFY2(qAbs(qint64(stream.jitterUs) - 10000) <= 500,
+             qPrintable(QString::number(stream.jitterUs)));
+
+    const QVector<MessageStatistics::StreamRate> rates =
+        MessageStatistics::rates(MessageStatistics::Snapshot(), snapshot);
+    QCOMPARE(rates.size(), 1);
+    QCOMPARE(rates.at(0).jitterMs, stream.jitterUs / 1000.0);
+}
+
+void MessageStatisticsTest::windowRollover() {
+    MessageStatistics statistics;
+    const MessageStatistics::Snapshot first = statistics.snapshot(0);
+
+    // Window 1: msgid 30 at 10 Hz, msgid 24 at 1 Hz
+    for (qint64 t = 0; t < 1000 * MS; t += 100 * MS) {
+        statistics.record(1, 1, 30, 40, t);
+    }
+    statistics.record(1, 1, 24, 50, 500 * MS);
+    const MessageStatistics::Snapshot second = statistics.snapshot(1000 * MS);
+
+    // Window 2: msgid 30 at 20 Hz, msgid 24 silent, msgid 74 new
+    for (qint64 t = 1000 * MS; t < 2000 * MS; t += 50 * MS) {
+        statistics.record(1, 1, 30, 40, t);
+    }
+    statistics.record(1, 1, 74, 28, 1500 * MS);
+    statistics.record(1, 1, 74, 28, 1600 * MS);
+    const MessageStatistics::Snapshot third = statistics.snapshot(2000 * MS);
+
+    const QVector<MessageStatistics::StreamRate> window1 = MessageStatistics::rates(first, second);
+    QCOMPARE(window1.size(), 2);
+    QCOMPARE(find(window1, 1, 30)->hz, 10.0);
+    QCOMPARE(find(window1, 1, 24)->bytesPerSecond, 50.0);
+
+    // Only what arrived in the window; silent streams drop out
+    const QVector<MessageStatistics::StreamRate> window2 = MessageStatistics::rates(second, third);
+    QCOMPARE(window2.size(), 2);
+    QCOMPARE(find(window2, 1, 30)->hz, 20.0);
+    QCOMPARE(find(window2, 1, 30)->bytesPerSecond, 800.0);
+    QVERIFY(!find(window2, 1, 24));
+    QCOMPARE(find(window2, 1, 74)->hz, 2.0);
+
+    // Any two snapshots make a window
+    const QVector<MessageStatistics::StreamRate> both = MessageStatistics::rates(first, third);
+    QCOMPARE(find(both, 1, 30)->hz, 15.0);
+    QCOMPARE(find(both, 1, 24)->hz, 0.5);
+
+    // An empty or inverted window has no rates
+    QVERIFY(MessageStatistics::rates(third, third).isEmpty());
+    QVERIFY(MessageStatistics::rates(third, second).isEmpty());
+}
+
+void MessageStatisticsTest::fullTable() {
+    MessageStatistics statistics;
+    const int capacity = MessageStatistics::MAX_STREAMS * 3 / 4;
+    for (int i = 0; i <= capacity; ++i) {
+        statistics.record(static_cast<uint8_t>(i / 256), 1, static_cast<uint32_t>(i % 256), 10,
+                          MS);
+    }
+    statistics.record(1, 1, 0, 10, 2 * MS);  // tracked stream, still counted
+
+    const MessageStatistics::Snapshot snapshot = statistics.snapshot(3 * MS);
+    QCOMPARE(snapshot.streams.size(), capacity);
+    QCOMPARE(snapshot.untrackedMessages, quint64(1));
+}
+
+QTEST_MAIN(MessageStatisticsTest)
+#include "tst_messagestatistics.moc"
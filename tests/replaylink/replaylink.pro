@@ -0,0 +1,18 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/router.pri)
+include(../common/link.pri)
+
+# Source files
+SOURCES *= \
+    tst_replaylink.cpp \
+    $$FLIGHTSCOPE_SRC/comm/linkmanager.cpp \
+    $$FLIGHTSCOPE_SRC/comm/replaylink.cpp \
+    $$FLIGHTSCOPE_SRC/comm/tlogindex.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/linkmanager.h \
+    $$FLIGHTSCOPE_SRC/comm/replaylink.h \
+    $$FLIGHTSCOPE_SRC/comm/tlogindex.h
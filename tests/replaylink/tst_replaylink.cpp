@@ -0,0 +1,265 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "comm/linkmanager.h"
+#include "comm/mavlinkrouter.h"
+#include "comm/replaylink.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief ReplayLink pacing, seeking and lossless delivery, plus end-to-end
+ * throughput of an hour-long log through MavlinkRouter
+ *
+ * Logs are generated into a temporary directory: real MAVLink v2 frames
+ * with synthetic timestamps.
+ */
+class ReplayLinkTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void replaysEveryPacketUnderBackPressure();
+    void pacesByTimestamps();
+    void seeksWhilePaused();
+    void skipsCorruptBytes();
+    void finishedReplayIsNotReconnected();
+    void hourLongLogThroughRouter();
+
+private:
+    struct Log {
+        QString path;
+        QByteArray packets;  // concatenation of all packets, as they should be replayed
+        QList<qsizetype> packetOffsets;  // of each packet within packets
+        int count{0};
+    };
+
+    static QByteArray makePacket(uint32_t msgId, uint8_t sequence);
+    Log writeLog(const QString& name, int count, quint64 intervalUs,
+                 const QByteArray& garbageEvery = QByteArray());
+    ReplayLink* openLink(const QString& path, double speed, QByteArray& received);
+
+    QTemporaryDir m_directory;
+};
+
+void ReplayLinkTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+    QVERIFY(m_directory.isValid());
+}
+
+QByteArray ReplayLinkTest::makePacket(uint32_t msgId, uint8_t sequence) {
+    return MavlinkTestHelpers::makePacket(msgId, 1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_1,
+                                          [sequence](int i) { return sequence + i; });
+}
+
+ReplayLinkTest::Log ReplayLinkTest::writeLog(const QString& name, int count, quint64 intervalUs,
+                                             const QByteArray& garbageEvery) {
+    const uint32_t mix[] = {MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+                            MAVLINK_MSG_ID_VFR_HUD, MAVLINK_MSG_ID_HEARTBEAT};
+    Log log;
+    log.path = m_directory.filePath(name);
+    log.count = count;
+
+    QByteArray file;
+    const quint64 startUs = 1700000000000000ULL;
+    for (int i = 0; i < count; ++i) {
+        char timestamp[8];
+        qToBigEndian<quint64>(startUs + i * intervalUs, timestamp);
+        const QByteArray packet = makePacket(mix[i % 4], static_cast<uint8_t>(i));
+        file.append(timestamp, sizeof(timestamp));
+        file.append(packet);
+        log.packetOffsets.append(log.packets.size());
+        log.packets.append(packet);
+        if (!garbageEvery.isEmpty() && i % 100 == 50) {
+            file.append(garbageEvery);
+        }
+    }
+
+    QFile out(log.path);
+    if (out.open(QIODevice::WriteOnly)) {
+        out.write(file);
+    }
+    return log;
+}
+
+ReplayLink* ReplayLinkTest::openLink(const QString& path, double speed, QByteArray& received) {
+    ReplayLink::Configuration config;
+    config.name = "replay";
+    config.filePath = path;
+    config.speed = speed;
+
+    auto* link = new ReplayLink(config, this);
+    connect(link, &LinkInterface::bytesReceived, this,
+            [&received](QByteArray data) { received.append(data); });
+    return link;
+}
+
+void ReplayLinkTest::replaysEveryPacketUnderBackPressure() {
+    const Log log = writeLog("backpressure.tlog", 20000, 10000);
+
+    ReplayLink::Configuration config;
+    config.name = "replay";
+    config.filePath = log.path;
+    config.speed = ReplayLink::AS_FAST_AS_POSSIBLE;
+    ReplayLink link(config);
+
+    // A small ring drained by a slow consumer: the link must wait, not drop
+    QSharedPointer<ByteRing> ring = QSharedPointer<ByteRing>::create(16 * 1024);
+    link.setReceiveRing(ring);
+    QByteArray received;
+    QTimer consumer;
+    consumer.setInterval(2);
+    connect(&consumer, &QTimer::timeout, this, [&]() {
+        ring->acknowledgeWake();
+        ring->consume([&received](const char* data, qsizetype size) {
+            received.append(data, size);
+        });
+    });
+    consumer.start();
+
+    QSignalSpy finished(&link, &ReplayLink::playbackFinished);
+    link.connectLink();
+    QVERIFY(link.isConnected());
+    QVERIFY(finished.wait(30000));
+    QTRY_COMPARE(received.size(), log.packets.size());
+
+    QVERIFY(received == log.packets);
+    QCOMPARE(ring->statistics().overruns, quint64(0));
+    const ReplayLink::PlaybackStatistics stats = link.playbackStatistics();
+    QCOMPARE(stats.packetsReplayed, quint64(log.count));
+    QCOMPARE(stats.durationUs, qint64(log.count - 1) * 10000);
+    QCOMPARE(stats.positionUs, stats.durationUs);
+    QCOMPARE(stats.bytesSkipped, quint64(0));
+    QVERIFY(stats.finished);
+}
+
+void ReplayLinkTest::pacesByTimestamps() {
+    // 40 packets 10 ms apart = 390 ms of log, replayed at 2x
+    const Log log = writeLog("paced.tlog", 40, 10000);
+    QByteArray received;
+    ReplayLink* link = openLink(log.path, 2.0, received);
+    QSignalSpy finished(link, &ReplayLink::playbackFinished);
+
+    QElapsedTimer timer;
+    timer.start();
+    link->connectLink();
+    QVERIFY(finished.wait(5000));
+    const qint64 elapsedMs = timer.elapsed();
+    qInfo() << "390 ms of log replayed at 2x in" << elapsedMs << "ms";
+
+    QVERIFY(elapsedMs >= 180);
+    QVERIFY(elapsedMs < 2000);
+    QVERIFY(received == log.packets);
+    delete link;
+}
+
+void ReplayLinkTest::seeksWhilePaused() {
+    const Log log = writeLog("seek.tlog", 1000, 1000);
+    QByteArray received;
+    ReplayLink* link = openLink(log.path, ReplayLink::AS_FAST_AS_POSSIBLE, received);
+    QSignalSpy finished(link, &ReplayLink::playbackFinished);
+
+    link->setPaused(true);
+    link->connectLink();
+    QTest::qWait(50);
+    QVERIFY(received.isEmpty());
+
+    // Seeking while paused primes the models with the latest packet of each
+    // state message (packets 496..499 here, one per msgid), in log order
+    link->seek(500 * 1000);
+    const qsizetype primedBegin = log.packetOffsets.at(496);
+    const QByteArray primed =
+        log.packets.mid(primedBegin, log.packetOffsets.at(500) - primedBegin);
+    QVERIFY(received == primed);
+
+    // Then the second half only: packets 500..999
+    received.clear();
+    link->setPaused(false);
+    QVERIFY(finished.wait(5000));
+    QVERIFY(received == log.packets.mid(log.packetOffsets.at(500)));
+    QCOMPARE(link->playbackStatistics().packetsReplayed, quint64(500));
+    QCOMPARE(link->playbackStatistics().positionUs, qint64(999 * 1000));
+    delete link;
+}
+
+void ReplayLinkTest::skipsCorruptBytes() {
+    // Garbage after every 100th record, then a truncated final record
+    const QByteArray garbage("\x00\x11\x22\x33\x44", 5);
+    const Log log = writeLog("corrupt.tlog", 1000, 1000, garbage);
+    {
+        QFile file(log.path);
+        QVERIFY(file.open(QIODevice::Append));
+        const QByteArray truncated = QByteArray(8, '\0') + makePacket(MAVLINK_MSG_ID_ATTITUDE, 0);
+        file.write(truncated.left(truncated.size() - 4));
+    }
+
+    QByteArray received;
+    ReplayLink* link = openLink(log.path, ReplayLink::AS_FAST_AS_POSSIBLE, received);
+    QSignalSpy finished(link, &ReplayLink::playbackFinished);
+    link->connectLink();
+    QVERIFY(finished.wait(5000));
+
+    QVERIFY(received == log.packets);
+    const quint64 truncatedBytes = 8 + makePacket(MAVLINK_MSG_ID_ATTITUDE, 0).size() - 4;
+    QCOMPARE(link->playbackStatistics().bytesSkipped,
+             10 * quint64(garbage.size()) + truncatedBytes);
+    delete link;
+}
+
+void ReplayLinkTest::finishedReplayIsNotReconnected() {
+    const Log log = writeLog("quiet.tlog", 100, 1000);
+    ReplayLink::Configuration config;
+    config.name = "replay";
+    config.filePath = log.path;
+    config.speed = ReplayLink::AS_FAST_AS_POSSIBLE;
+
+    // LinkManager runs the link on its own thread, as in the application
+    LinkManager manager;
+    QSignalSpy reconnecting(&manager, &LinkManager::reconnecting);
+    QSignalSpy connection(&manager, &LinkManager::connectionStatusChanged);
+    QCOMPARE(manager.addLink(new ReplayLink(config)), 0);
+    QTRY_VERIFY_WITH_TIMEOUT(manager.isConnected(), 5000);
+
+    // The log ends within milliseconds; the silence that follows is not a
+    // lost peer, even past the heartbeat timeout
+    QTest::qWait(LinkManager::HEARTBEAT_TIMEOUT_MS + 2 * LinkManager::INITIAL_RECONNECT_DELAY_MS);
+    QVERIFY(reconnecting.isEmpty());
+    QVERIFY(manager.isConnected());
+    QCOMPARE(connection.size(), 1);
+}
+
+void ReplayLinkTest::hourLongLogThroughRouter() {
+    // One hour at ~72 packets/s, the rate of a typical ArduPilot telemetry stream
+    const Log log = writeLog("hour.tlog", 3600 * 72, 1000000 / 72);
+
+    ReplayLink::Configuration config;
+    config.name = "replay";
+    config.filePath = log.path;
+    config.speed = ReplayLink::AS_FAST_AS_POSSIBLE;
+    ReplayLink link(config);
+
+    // Same wiring as MainWindow, minus the threads
+    QSharedPointer<ByteRing> ring = QSharedPointer<ByteRing>::create(1 << 20);
+    link.setReceiveRing(ring);
+    MavlinkRouter router;
+    router.attachLink(0);
+    connect(&link, &LinkInterface::receiveRingReadable, &router,
+            [&router, ring]() { router.drainReceiveRing(0, *ring); });
+
+    QSignalSpy finished(&link, &ReplayLink::playbackFinished);
+    QElapsedTimer timer;
+    timer.start();
+    link.connectLink();
+    QVERIFY(finished.wait(120000));
+    QTRY_COMPARE(router.linkStatistics(0).messagesReceived, quint64(log.count));
+    const qint64 elapsedMs = qMax<qint64>(timer.elapsed(), 1);
+
+    qInfo().nospace() << "Replayed 1 h (" << log.count << " packets, " << log.packets.size()
+                      << " bytes) through MavlinkRouter in " << elapsedMs << " ms ("
+                      << qRound64(log.count * 1000.0 / elapsedMs) << " messages/sec, "
+                      << qRound64(3600000.0 / elapsedMs) << "x real time)";
+    QCOMPARE(ring->statistics().overruns, quint64(0));
+}
+
+QTEST_MAIN(ReplayLinkTest)
+#include "tst_replaylink.moc"
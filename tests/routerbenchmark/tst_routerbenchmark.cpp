@@ -0,0 +1,395 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSet>
+#include "comm/mavlinkrouter.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief The router's receive path before table dispatch, as the baseline
+ *
+ * A copy of MavlinkRouter::receiveBytes() and parseMessage() from before the
+ * dispatch table: a function-local QSet for first-occurrence logging, a
+ * switch over the msgid, and one signal per message with the payload
+ * unpacked into its arguments. Mission and command handlers only emit their
+ * signal (the synthetic stream has no such messages).
+ */
+class SwitchDispatchRouter : public QObject {
+    Q_OBJECT
+
+public:
+    void receiveBytes(const QByteArray& data);
+
+signals:
+    void messageReceived(mavlink_message_t msg);
+    void heartbeatReceived(uint8_t systemId, uint8_t componentId, uint8_t autopilot,
+                           uint8_t type, uint8_t systemStatus, uint8_t baseMode,
+                           uint32_t customMode);
+    void timesyncReceived(int64_t tc1, int64_t ts1);
+    void attitudeReceived(float roll, float pitch, float yaw, float rollspeed, float pitchspeed,
+                          float yawspeed);
+    void globalPositionReceived(int32_t lat, int32_t lon, int32_t alt, int32_t relativeAlt,
+                                int16_t vx, int16_t vy, int16_t vz, uint16_t heading);
+    void vfrHudReceived(float airspeed, float groundspeed, int16_t heading, uint16_t throttle,
+                        float alt, float climb);
+    void batteryStatusReceived(uint16_t voltage, int16_t current, int8_t remaining);
+    void gpsRawReceived(uint8_t fixType, int32_t lat, int32_t lon, int32_t alt, uint16_t eph,
+                        uint16_t epv, uint16_t vel, uint16_t cog, uint8_t satellitesVisible);
+    void systemStatusReceived(uint16_t voltage, int16_t currentBattery, int8_t batteryRemaining);
+    void missionCountReceived(uint16_t count, uint8_t missionType);
+    void missionRequestReceived(uint16_t seq, uint8_t missionType);
+    void missionRequestIntReceived(uint16_t seq, uint8_t missionType);
+    void missionItemReceived(const mavlink_mission_item_t& item);
+    void missionItemIntReceived(const mavlink_mission_item_int_t& item);
+    void missionAckReceived(uint8_t type, uint8_t missionType);
+    void missionCurrentReceived(uint16_t seq, uint16_t total);
+    void commandAckReceived(uint16_t command, uint8_t result);
+    void packetLossChanged(float loss);
+
+private:
+    void parseMessage(const mavlink_message_t& msg);
+    void updatePacketLoss(uint8_t seq);
+
+    mavlink_status_t m_status{};
+    uint8_t m_lastSeq{0};
+    quint64 m_receivedPackets{0};
+    quint64 m_droppedPackets{0};
+};
+
+void SwitchDispatchRouter::receiveBytes(const QByteArray& data) {
+    mavlink_message_t msg;
+    for (int i = 0; i < data.size(); ++i) {
+        if (mavlink_parse_char(MAVLINK_COMM_0, static_cast<uint8_t>(data[i]), &msg, &m_status)) {
+            m_receivedPackets++;
+            updatePacketLoss(msg.seq);
+            parseMessage(msg);
+            emit messageReceived(msg);
+        }
+    }
+}
+
+void SwitchDispatchRouter::updatePacketLoss(uint8_t seq) {
+    if (m_receivedPackets > 1) {
+        const uint8_t expectedSeq = static_cast<uint8_t>(m_lastSeq + 1);
+        if (seq != expectedSeq) {
+            m_droppedPackets += static_cast<uint8_t>(seq - expectedSeq);
+        }
+    }
+    m_lastSeq = seq;
+    const float totalPackets = static_cast<float>(m_receivedPackets + m_droppedPackets);
+    emit packetLossChanged((static_cast<float>(m_droppedPackets) / totalPackets) * 100.0f);
+}
+
+void SwitchDispatchRouter::parseMessage(const mavlink_message_t& msg) {
+    static QSet<uint32_t> loggedMsgIds;
+    if (!loggedMsgIds.contains(msg.msgid)) {
+        qInfo() << "SwitchDispatchRouter: First occurrence of message ID:" << msg.msgid;
+        loggedMsgIds.insert(msg.msgid);
+    }
+
+    switch (msg.msgid) {
+        case MAVLINK_MSG_ID_HEARTBEAT: {
+            mavlink_heartbeat_t heartbeat;
+            mavlink_msg_heartbeat_decode(&msg, &heartbeat);
+            emit heartbeatReceived(msg.sysid, msg.compid, heartbeat.autopilot, heartbeat.type,
+                                   heartbeat.system_status, heartbeat.base_mode,
+                                   heartbeat.custom_mode);
+            break;
+        }
+        case MAVLINK_MSG_ID_TIMESYNC: {
+            mavlink_timesync_t timesync;
+            mavlink_msg_timesync_decode(&msg, &timesync);
+            emit timesyncReceived(timesync.tc1, timesync.ts1);
+            break;
+        }
+        case MAVLINK_MSG_ID_ATTITUDE: {
+            mavlink_attitude_t attitude;
+            mavlink_msg_attitude_decode(&msg, &attitude);
+            emit attitudeReceived(attitude.roll, attitude.pitch, attitude.yaw, attitude.rollspeed,
+                                  attitude.pitchspeed, attitude.yawspeed);
+            break;
+        }
+        case MAVLINK_MSG_ID_GLOBAL_POSITION_INT: {
+            mavlink_global_position_int_t pos;
+            mavlink_msg_global_position_int_decode(&msg, &pos);
+            emit globalPositionReceived(pos.lat, pos.lon, pos.alt, pos.relative_alt, pos.vx,
+                                        pos.vy, pos.vz, pos.hdg);
+            break;
+        }
+        case MAVLINK_MSG_ID_VFR_HUD: {
+            mavlink_vfr_hud_t hud;
+            mavlink_msg_vfr_hud_decode(&msg, &hud);
+            emit vfrHudReceived(hud.airspeed, hud.groundspeed, hud.heading, hud.throttle, hud.alt,
+                                hud.climb);
+            break;
+        }
+        case MAVLINK_MSG_ID_BATTERY_STATUS: {
+            mavlink_battery_status_t battery;
+            mavlink_msg_battery_status_decode(&msg, &battery);
+            uint16_t totalVoltage = 0;
+            for (int i = 0; i < 10; ++i) {
+                if (battery.voltages[i] != UINT16_MAX) {
+                    totalVoltage += battery.voltages[i];
+                }
+            }
+            emit batteryStatusReceived(totalVoltage, battery.current_battery,
+                                       battery.battery_remaining);
+            break;
+        }
+        case MAVLINK_MSG_ID_GPS_RAW_INT: {
+            mavlink_gps_raw_int_t gps;
+            mavlink_msg_gps_raw_int_decode(&msg, &gps);
+            emit gpsRawReceived(gps.fix_type, gps.lat, gps.lon, gps.alt, gps.eph, gps.epv, gps.vel,
+                                gps.cog, gps.satellites_visible);
+            break;
+        }
+        case MAVLINK_MSG_ID_SYS_STATUS: {
+            mavlink_sys_status_t status;
+            mavlink_msg_sys_status_decode(&msg, &status);
+            emit systemStatusReceived(status.voltage_battery, status.current_battery,
+                                      status.battery_remaining);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_COUNT:
+            emit missionCountReceived(mavlink_msg_mission_count_get_count(&msg),
+                                      mavlink_msg_mission_count_get_mission_type(&msg));
+            break;
+        case MAVLINK_MSG_ID_MISSION_REQUEST:
+            emit missionRequestReceived(mavlink_msg_mission_request_get_seq(&msg),
+                                        mavlink_msg_mission_request_get_mission_type(&msg));
+            break;
+        case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+            emit missionRequestIntReceived(mavlink_msg_mission_request_int_get_seq(&msg),
+                                           mavlink_msg_mission_request_int_get_mission_type(&msg));
+            break;
+        case MAVLINK_MSG_ID_MISSION_ITEM: {
+            mavlink_mission_item_t item;
+            mavlink_msg_mission_item_decode(&msg, &item);
+            emit missionItemReceived(item);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_ITEM_INT: {
+            mavlink_mission_item_int_t item;
+            mavlink_msg_mission_item_int_decode(&msg, &item);
+            emit missionItemIntReceived(item);
+            break;
+        }
+        case MAVLINK_MSG_ID_MISSION_ACK:
+            emit missionAckReceived(mavlink_msg_mission_ack_get_type(&msg),
+                                    mavlink_msg_mission_ack_get_mission_type(&msg));
+            break;
+        case MAVLINK_MSG_ID_MISSION_CURRENT:
+            emit missionCurrentReceived(mavlink_msg_mission_current_get_seq(&msg),
+                                        mavlink_msg_mission_current_get_total(&msg));
+            break;
+        case MAVLINK_MSG_ID_COMMAND_ACK:
+            emit commandAckReceived(mavlink_msg_command_ack_get_command(&msg),
+                                    mavlink_msg_command_ack_get_result(&msg));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Parse + dispatch throughput of MavlinkRouter in messages/sec
+ *
+ * Uses the recorded telemetry log named by FLIGHTSCOPE_BENCH_TLOG if set
+ * (standard .tlog: 8-byte timestamp before each packet), otherwise a
+ * synthetic stream with a typical ArduPilot message mix. The same stream is
+ * first run through SwitchDispatchRouter, the receive path before table
+ * dispatch, and both rates are printed with their ratio. The current rate
+ * also pays for what the router has gained since (per-source and per-stream
+ * statistics, telemetry batching), so the ratio understates the dispatch
+ * speed-up alone. Only the router's byte-stream API is used, so the
+ * benchmark can also be built against older revisions.
+ */
+class RouterBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void switchDispatchBaseline();
+    void parseAndDispatch();
+
+private:
+    bool loadTlog(const QString& path);
+    void buildSyntheticStream();
+    void appendMessage(uint32_t msgId, uint8_t compId);
+
+    /**
+     * @brief Feed the stream to @p receive for two seconds; messages/sec
+     */
+    template <typename Receive>
+    double measure(int messagesPerPass, Receive&& receive) const;
+
+    QByteArray m_stream;
+    int m_messageCount{0};
+    bool m_synthetic{false};
+    QString m_source;
+    double m_baselineRate{0.0};
+};
+
+void RouterBenchmark::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+
+    const QString tlog = qEnvironmentVariable("FLIGHTSCOPE_BENCH_TLOG");
+    if (!tlog.isEmpty()) {
+        QVERIFY2(loadTlog(tlog), qPrintable(QString("Cannot read %1").arg(tlog)));
+        m_source = tlog;
+    } else {
+        buildSyntheticStream();
+        m_synthetic = true;
+        m_source = "synthetic stream";
+    }
+    QVERIFY(m_messageCount > 0);
+}
+
+bool RouterBenchmark::loadTlog(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+
+    // Strip the per-packet timestamps so only MAVLink bytes reach the parser
+    qsizetype pos = 0;
+    while (pos + 8 + 3 <= data.size()) {
+        pos += 8;
+        const uint8_t magic = static_cast<uint8_t>(data.at(pos));
+        const uint8_t payloadLength = static_cast<uint8_t>(data.at(pos + 1));
+        qsizetype packetLength = 0;
+        if (magic == MAVLINK_STX_MAVLINK1) {
+            packetLength = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + payloadLength + 2;
+        } else if (magic == MAVLINK_STX) {
+            const uint8_t incompatFlags = static_cast<uint8_t>(data.at(pos + 2));
+            packetLength = MAVLINK_NUM_HEADER_BYTES + payloadLength + 2;
+            if (incompatFlags & MAVLINK_IFLAG_SIGNED) {
+                packetLength += MAVLINK_SIGNATURE_BLOCK_LEN;
+            }
+        } else {
+            break;  // lost framing
+        }
+        if (pos + packetLength > data.size()) {
+            break;
+        }
+        m_stream.append(data.constData() + pos, packetLength);
+        m_messageCount++;
+        pos += packetLength;
+    }
+    return m_messageCount > 0;
+}
+
+void RouterBenchmark::appendMessage(uint32_t msgId, uint8_t compId) {
+    // Random payload; the router decodes whatever it is given
+    const QByteArray packet = MavlinkTestHelpers::makePacket(
+        msgId, 1, compId, MAVLINK_COMM_1,
+        [](int) { return QRandomGenerator::global()->bounded(256); });
+    if (packet.isEmpty()) {
+        return;
+    }
+    m_stream.append(packet);
+    m_messageCount++;
+}
+
+void RouterBenchmark::buildSyntheticStream() {
+    // Per-second rates of a typical ArduPilot telemetry stream
+    struct Rate {
+        uint32_t msgId;
+        int perSecond;
+    };
+    const Rate rates[] = {
+        {MAVLINK_MSG_ID_HEARTBEAT, 1},
+        {MAVLINK_MSG_ID_SYS_STATUS, 2},
+        {MAVLINK_MSG_ID_GPS_RAW_INT, 5},
+        {MAVLINK_MSG_ID_ATTITUDE, 10},
+        {MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 5},
+        {MAVLINK_MSG_ID_VFR_HUD, 4},
+        {MAVLINK_MSG_ID_BATTERY_STATUS, 1},
+        {MAVLINK_MSG_ID_RAW_IMU, 10},
+        {MAVLINK_MSG_ID_SCALED_PRESSURE, 2},
+        {MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 4},
+        {MAVLINK_MSG_ID_RC_CHANNELS, 4},
+        {MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 4},
+        {MAVLINK_MSG_ID_AHRS2, 4},
+        {MAVLINK_MSG_ID_POWER_STATUS, 1},
+        {MAVLINK_MSG_ID_VIBRATION, 1},
+        {MAVLINK_MSG_ID_ESTIMATOR_STATUS, 1},
+    };
+
+    // Ten minutes of flight, interleaved in 100 ms slots
+    for (int second = 0; second < 600; ++second) {
+        for (int slot = 0; slot < 10; ++slot) {
+            for (const Rate& rate : rates) {
+                if ((slot * rate.perSecond) / 10 != ((slot + 1) * rate.perSecond) / 10) {
+                    appendMessage(rate.msgId, MAV_COMP_ID_AUTOPILOT1);
+                }
+            }
+        }
+    }
+}
+
+template <typename Receive>
+double RouterBenchmark::measure(int messagesPerPass, Receive&& receive) const {
+    QElapsedTimer timer;
+    qint64 messages = 0;
+    timer.start();
+    while (timer.elapsed() < 2000) {
+        receive(m_stream);
+        messages += messagesPerPass;
+    }
+    return messages * 1e9 / timer.nsecsElapsed();
+}
+
+void RouterBenchmark::switchDispatchBaseline() {
+    SwitchDispatchRouter router;
+
+    int parsed = 0;
+    QMetaObject::Connection counter = connect(
+        &router, &SwitchDispatchRouter::messageReceived, &router,
+        [&parsed](mavlink_message_t) { parsed++; }, Qt::DirectConnection);
+    router.receiveBytes(m_stream);
+    disconnect(counter);
+    if (m_synthetic) {
+        QCOMPARE(parsed, m_messageCount);
+    }
+    QVERIFY(parsed > 0);
+
+    m_baselineRate =
+        measure(parsed, [&router](const QByteArray& stream) { router.receiveBytes(stream); });
+    qInfo().nospace() << "Switch dispatch (before): " << qRound64(m_baselineRate)
+                      << " messages/sec (" << m_source << ", " << parsed << " messages, "
+                      << m_stream.size() << " bytes)";
+}
+
+void RouterBenchmark::parseAndDispatch() {
+    MavlinkRouter router;
+
+    // Warm-up pass doubles as a sanity check. Recorded logs may contain
+    // messages from other dialects that fail the CRC; only count what parses.
+    int parsed = 0;
+    QMetaObject::Connection counter = connect(
+        &router, &MavlinkRouter::messageReceived, &router,
+        [&parsed](mavlink_message_t) { parsed++; }, Qt::DirectConnection);
+    router.receiveBytes(m_stream);
+    disconnect(counter);
+    if (m_synthetic) {
+        QCOMPARE(parsed, m_messageCount);
+    }
+    QVERIFY(parsed > 0);
+
+    const double messagesPerSecond =
+        measure(parsed, [&router](const QByteArray& stream) { router.receiveBytes(stream); });
+    qInfo().nospace() << "MavlinkRouter (after): " << qRound64(messagesPerSecond)
+                      << " messages/sec (" << m_source << ", " << parsed << " messages, "
+                      << m_stream.size() << " bytes)";
+    if (m_baselineRate > 0) {
+        const double ratio = messagesPerSecond / m_baselineRate;
+        qInfo().nospace() << "MavlinkRouter: " << QString::number(ratio, 'f', 2)
+                          << "x the switch dispatch rate";
+    }
+}
+
+QTEST_MAIN(RouterBenchmark)
+#include "tst_routerbenchmark.moc"
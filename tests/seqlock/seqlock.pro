@@ -0,0 +1,11 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES += \
+    tst_seqlock.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/seqlock.h
@@ -0,0 +1,109 @@
+#include <QtTest>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "comm/seqlock.h"
+
+/**
+ * @brief Checks SeqLock publication and hammers it with concurrent readers
+ * to catch torn snapshots
+ */
+class SeqLockTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void publishesValues();
+    void readersNeverSeeTornValues();
+
+private:
+    // Several words wide and not a multiple of 8 bytes
+    struct Sample {
+        quint64 values[9];
+        uint16_t tail;
+    };
+};
+
+void SeqLockTest::publishesValues() {
+    Sample initial{};
+    for (quint64& value : initial.values) {
+        value = 7;
+    }
+    initial.tail = 7;
+    SeqLock<Sample> lock(initial);
+    QCOMPARE(lock.version(), quint64(0));
+    QCOMPARE(lock.load().values[8], quint64(7));
+
+    Sample next = initial;
+    next.values[0] = 1;
+    next.tail = 2;
+    lock.store(next);
+    QCOMPARE(lock.version(), quint64(1));
+
+    Sample read{};
+    QVERIFY(lock.tryLoad(read));
+    QCOMPARE(read.values[0], quint64(1));
+    QCOMPARE(read.values[8], quint64(7));
+    QCOMPARE(read.tail, uint16_t(2));
+}
+
+void SeqLockTest::readersNeverSeeTornValues() {
+    SeqLock<Sample> lock;
+    std::atomic<bool> done{false};
+    std::atomic<quint64> torn{0};
+    std::atomic<quint64> backwards{0};
+    std::atomic<quint64> reads{0};
+
+    constexpr int READERS = 3;
+    std::vector<std::unique_ptr<QThread>> readers;
+    for (int r = 0; r < READERS; ++r) {
+        readers.emplace_back(QThread::create([&]() {
+            quint64 last = 0;
+            quint64 count = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const Sample sample = lock.load();
+                const quint64 value = sample.values[0];
+                for (quint64 v : sample.values) {
+                    if (v != value) {
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (sample.tail != static_cast<uint16_t>(value)) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (value < last) {
+                    backwards.fetch_add(1, std::memory_order_relaxed);
+                }
+                last = value;
+                ++count;
+            }
+            reads.fetch_add(count, std::memory_order_relaxed);
+        }));
+        readers.back()->start();
+    }
+
+    // The writer never waits for the readers
+    constexpr quint64 STORES = 2000000;
+    Sample sample{};
+    for (quint64 i = 1; i <= STORES; ++i) {
+        for (quint64& value : sample.values) {
+            value = i;
+        }
+        sample.tail = static_cast<uint16_t>(i);
+        lock.store(sample);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        QVERIFY(reader->wait(10000));
+    }
+
+    qInfo() << "SeqLock:" << STORES << "stores," << reads.load() << "reads";
+    QCOMPARE(torn.load(), quint64(0));
+    QCOMPARE(backwards.load(), quint64(0));
+    QCOMPARE(lock.version(), STORES);
+    QCOMPARE(lock.load().values[0], STORES);
+    QVERIFY(reads.load() > 0);
+}
+
+QTEST_MAIN(SeqLockTest)
+#include "tst_seqlock.moc"
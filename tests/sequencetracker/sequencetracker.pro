@@ -0,0 +1,12 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_sequencetracker.cpp \
+    $$FLIGHTSCOPE_SRC/comm/sequencetracker.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/sequencetracker.h
@@ -0,0 +1,202 @@
+#include <QtTest>
+#include "comm/sequencetracker.h"
+
+/**
+ * @brief Loss, duplicate and reorder accounting of SequenceTracker
+ */
+class SequenceTrackerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void wrapsAround();
+    void largeForwardGap();
+    void reordered();
+    void tooLateForReorderWindow();
+    void duplicates();
+    void restartedSender();
+    void windowLoss();
+    void sourcesAreIndependent();
+    void fullTable();
+
+private:
+    // Feed sequence numbers from one source; returns how many were not duplicates
+    static int feed(SequenceTracker& tracker, std::initializer_list<int> seqs);
+    static int feedRange(SequenceTracker& tracker, int first, int last);
+    static SequenceTracker::SourceStatistics source(const SequenceTracker& tracker);
+};
+
+int SequenceTrackerTest::feed(SequenceTracker& tracker, std::initializer_list<int> seqs) {
+    int accepted = 0;
+    for (int seq : seqs) {
+        accepted += tracker.update(1, 1, static_cast<uint8_t>(seq)) ? 1 : 0;
+    }
+    return accepted;
+}
+
+int SequenceTrackerTest::feedRange(SequenceTracker& tracker, int first, int last) {
+    int accepted = 0;
+    for (int seq = first; seq <= last; ++seq) {
+        accepted += tracker.update(1, 1, static_cast<uint8_t>(seq)) ? 1 : 0;
+    }
+    return accepted;
+}
+
+SequenceTracker::SourceStatistics SequenceTrackerTest::source(const SequenceTracker& tracker) {
+    const QVector<SequenceTracker::SourceStatistics> sources = tracker.statistics();
+    return sources.isEmpty() ? SequenceTracker::SourceStatistics() : sources.constFirst();
+}
+
+void SequenceTrackerTest::wrapsAround() {
+    SequenceTracker tracker;
+    QCOMPARE(feedRange(tracker, 250, 255 + 256 * 3), 6 + 256 * 3);
+
+    const SequenceTracker::SourceStatistics stats = source(tracker);
+    QCOMPARE(stats.received, quint64(6 + 256 * 3));
+    QCOMPARE(stats.lost, quint64(0));
+    QCOMPARE(stats.duplicates, quint64(0));
+
+    // A gap across the wrap
+    feed(tracker, {3});
+    QCOMPARE(source(tracker).lost, quint64(3));
+}
+
+void SequenceTrackerTest::largeForwardGap() {
+    SequenceTracker tracker;
+    feed(tracker, {0, 200});
+    QCOMPARE(source(tracker).lost, quint64(199));
+
+    // The newest packet moved on: what follows is neither lost nor duplicate
+    QCOMPARE(feedRange(tracker, 201, 210), 10);
+    QCOMPARE(source(tracker).lost, quint64(199));
+
+    // Exactly half the sequence space, and the largest step forward
+    feed(tracker, {210 + 128});
+    QCOMPARE(source(tracker).lost, quint64(199 + 127));
+    feed(tracker, {210 + 128 + 255 - SequenceTracker::REORDER_WINDOW});
+    QCOMPARE(source(tracker).lost, quint64(199 + 127 + 254 - SequenceTracker::REORDER_WINDOW));
+
+    const SequenceTracker::SourceStatistics stats = source(tracker);
+    QCOMPARE(stats.received, quint64(14));
+    QCOMPARE(stats.duplicates, quint64(0));
+    QCOMPARE(stats.reordered, quint64(0));
+}
+
+void SequenceTrackerTest::reordered() {
+    SequenceTracker tracker;
+    QCOMPARE(feed(tracker, {0, 1, 3, 2, 4}), 5);
+
+    SequenceTracker::SourceStatistics stats = source(tracker);
+    QCOMPARE(stats.received, quint64(5));
+    QCOMPARE(stats.lost, quint64(0));
+    QCOMPARE(stats.reordered, quint64(1));
+
+    // As far back as the window reaches, across the wrap
+    feedRange(tracker, 5, 250);
+    feedRange(tracker, 252, 256 + 11);
+    QCOMPARE(source(tracker).lost, quint64(1));
+    feed(tracker, {251});  // 16 behind 11
+    stats = source(tracker);
+    QCOMPARE(stats.lost, quint64(0));
+    QCOMPARE(stats.reordered, quint64(2));
+    QCOMPARE(stats.duplicates, quint64(0));
+
+    // Filled gaps are duplicates the second time
+    QCOMPARE(feed(tracker, {251, 2}), 0);
+    QCOMPARE(source(tracker).duplicates, quint64(2));
+}
+
+void SequenceTrackerTest::tooLateForReorderWindow() {
+    // A packet further behind cannot be told from a jump forward
+    SequenceTracker tracker;
+    feedRange(tracker, 0, 20);
+    feedRange(tracker, 22, 22 + SequenceTracker::REORDER_WINDOW);
+    QCOMPARE(source(tracker).lost, quint64(1));
+
+    feed(tracker, {21});
+    SequenceTracker::SourceStatistics stats = source(tracker);
+    QCOMPARE(stats.reordered, quint64(0));
+    QCOMPARE(stats.lost, quint64(1 + 255 - SequenceTracker::REORDER_WINDOW - 1));
+    QCOMPARE(stats.duplicates, quint64(0));
+}
+
+void SequenceTrackerTest::duplicates() {
+    SequenceTracker tracker;
+    QCOMPARE(feed(tracker, {0, 1, 2, 2, 1, 0, 3}), 4);
+
+    const SequenceTracker::SourceStatistics stats = source(tracker);
+    QCOMPARE(stats.received, quint64(4));
+    QCOMPARE(stats.duplicates, quint64(3));
+    QCOMPARE(stats.lost, quint64(0));
+
+    // Nothing before the first packet was ever missing
+    SequenceTracker late;
+    QVERIFY(late.update(1, 1, 10));
+    QVERIFY(!late.update(1, 1, 5));
+    QCOMPARE(source(late).lost, quint64(0));
+    QCOMPARE(source(late).reordered, quint64(0));
+}
+
+void SequenceTrackerTest::restartedSender() {
+    // A reboot starts again at 0: counted as one step forward, then no loss
+    SequenceTracker tracker;
+    feedRange(tracker, 0, 100);
+    QCOMPARE(feedRange(tracker, 0, 50), 51);
+
+    const SequenceTracker::SourceStatistics stats = source(tracker);
+    QCOMPARE(stats.received, quint64(152));
+    QCOMPARE(stats.lost, quint64(155));
+    QCOMPARE(stats.duplicates, quint64(0));
+    QCOMPARE(stats.reordered, quint64(0));
+}
+
+void SequenceTrackerTest::windowLoss() {
+    SequenceTracker tracker;
+    feed(tracker, {0, 1, 2, 4, 5, 6, 7, 8, 9, 11});  // 2 of 12 missing
+    QCOMPARE(tracker.closeWindow(), 100.0f * 2 / 12);
+    QCOMPARE(source(tracker).windowLoss, 100.0f * 2 / 12);
+
+    // Silent sources keep their last rate
+    tracker.update(2, 1, 0);
+    QCOMPARE(tracker.closeWindow(), 0.0f);
+    QCOMPARE(source(tracker).windowLoss, 100.0f * 2 / 12);
+
+    // A gap of an earlier window filled in this one does not go negative
+    feed(tracker, {10, 12});
+    QCOMPARE(tracker.closeWindow(), 0.0f);
+    QCOMPARE(source(tracker).windowLoss, 0.0f);
+    QCOMPARE(source(tracker).totalLoss, 100.0f * 1 / 13);
+}
+
+void SequenceTrackerTest::sourcesAreIndependent() {
+    SequenceTracker tracker;
+    for (int seq = 0; seq < 100; ++seq) {
+        tracker.update(1, 1, static_cast<uint8_t>(seq));
+        tracker.update(1, 2, static_cast<uint8_t>(seq * 2));  // every other one lost
+        tracker.update(2, 1, static_cast<uint8_t>(seq));
+    }
+
+    const QVector<SequenceTracker::SourceStatistics> sources = tracker.statistics();
+    QCOMPARE(sources.size(), 3);
+    QCOMPARE(sources.at(0).componentId, uint8_t(1));
+    QCOMPARE(sources.at(0).lost, quint64(0));
+    QCOMPARE(sources.at(1).componentId, uint8_t(2));
+    QCOMPARE(sources.at(1).lost, quint64(99));
+    QCOMPARE(sources.at(2).systemId, uint8_t(2));
+    QCOMPARE(sources.at(2).lost, quint64(0));
+}
+
+void SequenceTrackerTest::fullTable() {
+    SequenceTracker tracker;
+    for (int i = 0; i <= SequenceTracker::MAX_SOURCES; ++i) {
+        QVERIFY(tracker.update(static_cast<uint8_t>(i + 1), 1, 0));
+    }
+    QCOMPARE(tracker.sourceCount(), SequenceTracker::MAX_SOURCES);
+    QCOMPARE(tracker.untrackedPackets(), quint64(1));
+
+    tracker.reset();
+    QCOMPARE(tracker.sourceCount(), 0);
+    QCOMPARE(tracker.untrackedPackets(), quint64(0));
+}
+
+QTEST_MAIN(SequenceTrackerTest)
+#include "tst_sequencetracker.moc"
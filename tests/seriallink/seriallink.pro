@@ -0,0 +1,18 @@
+QT += serialport
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/link.pri)
+
+# Needs a pseudo-terminal pair (openpty)
+!linux: error("The serial link test requires Linux")
+LIBS += -lutil
+
+# Source files
+SOURCES *= \
+    tst_seriallink.cpp \
+    $$FLIGHTSCOPE_SRC/comm/seriallink.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/seriallink.h
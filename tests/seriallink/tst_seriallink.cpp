@@ -0,0 +1,227 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <errno.h>
+#include <fcntl.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+#include "comm/seriallink.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Exercises SerialLink against a Linux pseudo-terminal pair
+ *
+ * The link opens the pty's slave side as its serial port; the test plays
+ * the radio on the master side. No hardware is involved, so the baud rate
+ * only matters for sizing the outbound queue.
+ */
+class SerialLinkTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void outboundLimitScalesWithBaud();
+    void streamsLargeTransferIntact();
+    void writesReachPeer();
+    void coalescingReducesReads();
+    void outboundQueueIsBounded();
+
+private:
+    struct Session {
+        QByteArray received;
+        int deliveries{0};  // bytesReceived() emissions
+    };
+
+    SerialLink* openLink(Session& session, qint32 baudRate, int readCoalesceMs);
+    bool writeToMaster(const QByteArray& data, int timeoutMs);
+    QByteArray readFromMaster(qsizetype expected, int timeoutMs);
+    Session streamPaced(int readCoalesceMs);
+
+    static constexpr int TIMEOUT_MS = 10000;
+
+    int m_master{-1};
+    int m_slave{-1};
+    QString m_slavePath;
+};
+
+void SerialLinkTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+}
+
+void SerialLinkTest::init() {
+    char name[128] = {};
+    QVERIFY2(openpty(&m_master, &m_slave, name, nullptr, nullptr) == 0, strerror(errno));
+    m_slavePath = QString::fromLocal8Bit(name);
+
+    // Raw mode on both ends: no echo, no line discipline rewriting bytes
+    termios raw;
+    tcgetattr(m_slave, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(m_slave, TCSANOW, &raw);
+    tcsetattr(m_master, TCSANOW, &raw);
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+}
+
+void SerialLinkTest::cleanup() {
+    // Keep the slave open until here so the master never sees a hangup
+    ::close(m_master);
+    ::close(m_slave);
+    m_master = m_slave = -1;
+}
+
+SerialLink* SerialLinkTest::openLink(Session& session, qint32 baudRate, int readCoalesceMs) {
+    SerialLink::Configuration config;
+    config.name = "pty";
+    config.portName = m_slavePath;
+    config.baudRate = baudRate;
+    config.readCoalesceMs = readCoalesceMs;
+
+    auto* link = new SerialLink(config, this);
+    connect(link, &LinkInterface::bytesReceived, this, [&session](QByteArray data) {
+        session.received.append(data);
+        session.deliveries++;
+    });
+    link->connectLink();
+    return link;
+}
+
+bool SerialLinkTest::writeToMaster(const QByteArray& data, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    qsizetype offset = 0;
+    while (offset < data.size()) {
+        const ssize_t written = ::write(m_master, data.constData() + offset, data.size() - offset);
+        if (written > 0) {
+            offset += written;
+            continue;
+        }
+        if (written < 0 && errno != EAGAIN) {
+            return false;
+        }
+        // pty buffer full: let the link drain it
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    return true;
+}
+
+QByteArray SerialLinkTest::readFromMaster(qsizetype expected, int timeoutMs) {
+    QByteArray result;
+    char buffer[4096];
+    QElapsedTimer timer;
+    timer.start();
+    while (result.size() < expected && timer.elapsed() < timeoutMs) {
+        const ssize_t bytesRead = ::read(m_master, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            result.append(buffer, bytesRead);
+        } else {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+    }
+    return result;
+}
+
+void SerialLinkTest::outboundLimitScalesWithBaud() {
+    // 10 bits per byte on the wire, 500 ms of data
+    QCOMPARE(SerialLink::outboundLimitFor(57600, 500), qint64(2880));
+    QCOMPARE(SerialLink::outboundLimitFor(921600, 500), qint64(46080));
+    // Never smaller than a few packets
+    QCOMPARE(SerialLink::outboundLimitFor(9600, 500), qint64(1024));
+}
+
+void SerialLinkTest::streamsLargeTransferIntact() {
+    Session session;
+    SerialLink* link = openLink(session, 921600, 0);
+    QVERIFY(link->isConnected());
+
+    QByteArray payload(1024 * 1024, Qt::Uninitialized);
+    QRandomGenerator generator(42);
+    for (char& byte : payload) {
+        byte = static_cast<char>(generator.bounded(256));
+    }
+
+    QVERIFY(writeToMaster(payload, TIMEOUT_MS));
+    QTRY_COMPARE_WITH_TIMEOUT(session.received.size(), payload.size(), TIMEOUT_MS);
+    QVERIFY(session.received == payload);
+
+    qInfo().noquote() << QString("1 MiB in %1 deliveries (avg %2 bytes)")
+                             .arg(session.deliveries)
+                             .arg(payload.size() / qMax(session.deliveries, 1));
+    delete link;
+}
+
+void SerialLinkTest::writesReachPeer() {
+    Session session;
+    SerialLink* link = openLink(session, 57600, 0);
+    QVERIFY(link->isConnected());
+
+    const QByteArray command("\xFD\x09\x00\x00\x00\xFF\xBE\x00\x00\x00", 10);
+    link->writeBytes(command);
+    QCOMPARE(readFromMaster(command.size(), TIMEOUT_MS), command);
+    delete link;
+}
+
+SerialLinkTest::Session SerialLinkTest::streamPaced(int readCoalesceMs) {
+    Session session;
+    SerialLink* link = openLink(session, 921600, readCoalesceMs);
+
+    // A radio trickling 64-byte bursts every millisecond
+    const QByteArray burst(64, 'x');
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 200; ++i) {
+        writeToMaster(burst, TIMEOUT_MS);
+        while (timer.elapsed() < i + 1) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+        }
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(session.received.size(), burst.size() * 200, TIMEOUT_MS);
+    delete link;
+    return session;
+}
+
+void SerialLinkTest::coalescingReducesReads() {
+    const Session immediate = streamPaced(0);
+    const Session coalesced = streamPaced(20);
+    qInfo() << "Deliveries for 200 bursts: immediate" << immediate.deliveries << "coalesced (20 ms)"
+            << coalesced.deliveries;
+
+    QVERIFY(coalesced.deliveries < immediate.deliveries / 2);
+}
+
+void SerialLinkTest::outboundQueueIsBounded() {
+    Session session;
+    SerialLink* link = openLink(session, 9600, 0);  // 1024-byte outbound bound
+    QVERIFY(link->isConnected());
+    QSignalSpy backPressure(link, &LinkInterface::backPressureChanged);
+
+    // Without returning to the event loop nothing is flushed, so the queue fills
+    const QByteArray chunk(100, 'c');
+    for (int i = 0; i < 50; ++i) {
+        link->writeBytes(chunk);
+    }
+
+    LinkInterface::OutboundStatistics stats = link->outboundStatistics();
+    QVERIFY(stats.bounded);
+    QCOMPARE(stats.maxQueuedBytes, quint64(1024));
+    QCOMPARE(stats.droppedWrites, quint64(40));
+    QCOMPARE(stats.droppedBytes, quint64(4000));
+    QVERIFY(stats.peakQueuedBytes <= stats.maxQueuedBytes);
+    QVERIFY(!backPressure.isEmpty());
+    QCOMPARE(backPressure.first().first().toBool(), true);
+
+    // The peer reads everything that was admitted and congestion clears
+    QCOMPARE(readFromMaster(1000, TIMEOUT_MS).size(), qsizetype(1000));
+    QTRY_VERIFY_WITH_TIMEOUT(!link->outboundStatistics().congested, TIMEOUT_MS);
+    QCOMPARE(backPressure.last().first().toBool(), false);
+    delete link;
+}
+
+QTEST_MAIN(SerialLinkTest)
+#include "tst_seriallink.moc"
@@ -0,0 +1,10 @@
+QT += core gui widgets qml quick quickwidgets location positioning network websockets charts
+
+include(../common/testcase.pri)
+
+# The whole application but its main()
+include(../../src/flightscope.pri)
+
+# Source files
+SOURCES += \
+    test_main.cpp
@@ -1,6 +1,6 @@
 #include <QtTest>
 #include <QApplication>
-#include "../src/ui/mainwindow.h"
+#include "ui/mainwindow.h"
 
 class SmokeTest : public QObject {
     Q_OBJECT
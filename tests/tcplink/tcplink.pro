@@ -0,0 +1,17 @@
+QT += network
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/router.pri)
+include(../common/link.pri)
+
+# Source files
+SOURCES *= \
+    tst_tcplink.cpp \
+    $$FLIGHTSCOPE_SRC/comm/linkmanager.cpp \
+    $$FLIGHTSCOPE_SRC/comm/tcplink.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/linkmanager.h \
+    $$FLIGHTSCOPE_SRC/comm/tcplink.h
@@ -0,0 +1,309 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "comm/linkmanager.h"
+#include "comm/mavlinkrouter.h"
+#include "comm/tcplink.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Exercises TcpLink in client and server mode over loopback
+ *
+ * The test plays the remote end with plain Qt sockets. Received bytes go
+ * through the link's receive ring into a MavlinkRouter, as in the
+ * application, so packets cut at arbitrary points are counted only once
+ * they have been reassembled.
+ */
+class TcpLinkTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void clientReassemblesSplitPackets();
+    void serverReassemblesSplitPackets();
+    void serverWaitsForNextPeer();
+    void backPressureHysteresis();
+    void waitingServerIsNotReconnected();
+    void unansweredConnectTimesOut();
+
+private:
+    static constexpr int TIMEOUT_MS = 10000;
+    static constexpr int PACKETS = 500;
+    static constexpr mavlink_channel_t TEST_CHANNEL =
+        static_cast<mavlink_channel_t>(MavlinkRouter::MAX_LINKS);
+
+    // A loopback port nothing listens on right now
+    static quint16 freePort();
+    static TcpLink::Configuration linkConfig(bool isServer, quint16 port);
+
+    // Feeds the link's receive ring to @p router as link 0 and counts the
+    // heartbeats it parses in @p heartbeats
+    static void attachRouter(TcpLink& link, MavlinkRouter& router, int* heartbeats);
+
+    static QByteArray heartbeats(int count);
+
+    // Writes @p data in chunks of 1..13 bytes, each flushed on its own
+    static void writeSplit(QTcpSocket& socket, const QByteArray& data);
+};
+
+void TcpLinkTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+}
+
+quint16 TcpLinkTest::freePort() {
+    QTcpServer probe;
+    if (!probe.listen(QHostAddress::LocalHost, 0)) {
+        return 0;
+    }
+    return probe.serverPort();
+}
+
+TcpLink::Configuration TcpLinkTest::linkConfig(bool isServer, quint16 port) {
+    TcpLink::Configuration config;
+    config.name = isServer ? "tcp-server" : "tcp-client";
+    config.isServer = isServer;
+    config.address = QHostAddress::LocalHost;
+    config.port = port;
+    return config;
+}
+
+void TcpLinkTest::attachRouter(TcpLink& link, MavlinkRouter& router, int* heartbeats) {
+    const QSharedPointer<ByteRing> ring = QSharedPointer<ByteRing>::create(1 << 20);
+    link.setReceiveRing(ring);
+    router.attachLink(0);
+    connect(&link, &LinkInterface::receiveRingReadable, &router,
+            [&router, ring]() { router.drainReceiveRing(0, *ring); });
+    connect(&router, &MavlinkRouter::heartbeatReceived, &router,
+            [heartbeats]() { ++*heartbeats; }, Qt::DirectConnection);
+}
+
+QByteArray TcpLinkTest::heartbeats(int count) {
+    QByteArray stream;
+    for (int i = 0; i < count; ++i) {
+        mavlink_message_t msg;
+        mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, TEST_CHANNEL, &msg,
+                                        MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 0,
+                                        static_cast<uint32_t>(i), MAV_STATE_ACTIVE);
+        stream.append(MavlinkTestHelpers::frame(msg));
+    }
+    return stream;
+}
+
+void TcpLinkTest::writeSplit(QTcpSocket& socket, const QByteArray& data) {
+    qsizetype offset = 0;
+    for (int chunk = 0; offset < data.size(); ++chunk) {
+        const qsizetype size = qMin<qsizetype>(1 + (chunk * 7) % 13, data.size() - offset);
+        socket.write(data.constData() + offset, size);
+        socket.flush();
+        offset += size;
+        if (chunk % 64 == 0) {
+            QCoreApplication::processEvents();  // let the link read partial packets
+        }
+    }
+}
+
+void TcpLinkTest::clientReassemblesSplitPackets() {
+    QTcpServer peer;
+    QVERIFY(peer.listen(QHostAddress::LocalHost, 0));
+
+    TcpLink link(linkConfig(false, peer.serverPort()));
+    MavlinkRouter router;
+    int received = 0;
+    attachRouter(link, router, &received);
+    link.connectLink();
+    QTRY_VERIFY_WITH_TIMEOUT(peer.hasPendingConnections(), TIMEOUT_MS);
+    QTcpSocket* socket = peer.nextPendingConnection();
+    QTRY_VERIFY_WITH_TIMEOUT(link.isConnected(), TIMEOUT_MS);
+
+    const QByteArray stream = heartbeats(PACKETS);
+    writeSplit(*socket, stream);
+    QTRY_COMPARE_WITH_TIMEOUT(received, PACKETS, TIMEOUT_MS);
+    QCOMPARE(router.linkStatistics(0).bytesReceived, quint64(stream.size()));
+
+    // Writes reach the peer in one piece
+    const QByteArray command("\xFD\x09\x00\x00\x00\xFF\xBE\x00\x00\x00", 10);
+    link.writeBytes(command);
+    QTRY_COMPARE_WITH_TIMEOUT(socket->bytesAvailable(), qint64(command.size()), TIMEOUT_MS);
+    QCOMPARE(socket->readAll(), command);
+
+    // A lost connection is an error, for LinkManager's backoff
+    QSignalSpy errors(&link, &LinkInterface::errorOccurred);
+    socket->abort();
+    QTRY_COMPARE_WITH_TIMEOUT(link.status(), LinkInterface::LinkStatus::Error, TIMEOUT_MS);
+    QCOMPARE(errors.size(), 1);
+}
+
+void TcpLinkTest::serverReassemblesSplitPackets() {
+    const quint16 port = freePort();
+    QVERIFY(port != 0);
+    TcpLink link(linkConfig(true, port));
+    MavlinkRouter router;
+    int received = 0;
+    attachRouter(link, router, &received);
+    link.connectLink();
+    QCOMPARE(link.status(), LinkInterface::LinkStatus::Connecting);
+
+    QTcpSocket peer;
+    peer.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(peer.waitForConnected(TIMEOUT_MS));
+    QTRY_VERIFY_WITH_TIMEOUT(link.isConnected(), TIMEOUT_MS);
+
+    const QByteArray stream = heartbeats(PACKETS);
+    writeSplit(peer, stream);
+    QTRY_COMPARE_WITH_TIMEOUT(received, PACKETS, TIMEOUT_MS);
+}
+
+void TcpLinkTest::serverWaitsForNextPeer() {
+    const quint16 port = freePort();
+    QVERIFY(port != 0);
+    TcpLink link(linkConfig(true, port));
+    MavlinkRouter router;
+    int received = 0;
+    attachRouter(link, router, &received);
+    QSignalSpy errors(&link, &LinkInterface::errorOccurred);
+    link.connectLink();
+
+    // The peer leaves halfway through a packet; the link keeps listening
+    const QByteArray packet = heartbeats(1);
+    {
+        QTcpSocket peer;
+        peer.connectToHost(QHostAddress::LocalHost, port);
+        QVERIFY(peer.waitForConnected(TIMEOUT_MS));
+        QTRY_VERIFY_WITH_TIMEOUT(link.isConnected(), TIMEOUT_MS);
+        writeSplit(peer, packet + packet.left(5));
+        QTRY_COMPARE_WITH_TIMEOUT(received, 1, TIMEOUT_MS);
+        peer.disconnectFromHost();
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(link.status(), LinkInterface::LinkStatus::Connecting, TIMEOUT_MS);
+    QVERIFY(errors.isEmpty());
+
+    // The next peer is served; the parser resyncs after the packets the
+    // stray bytes run into
+    QTcpSocket next;
+    next.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(next.waitForConnected(TIMEOUT_MS));
+    QTRY_VERIFY_WITH_TIMEOUT(link.isConnected(), TIMEOUT_MS);
+    writeSplit(next, heartbeats(10));
+    QTRY_VERIFY_WITH_TIMEOUT(received >= 1 + 10 - 2, TIMEOUT_MS);
+}
+
+void TcpLinkTest::backPressureHysteresis() {
+    // A limit far beyond what the kernel buffers, so the link's own queue
+    // holds most of it while the peer is not reading
+    constexpr qint64 LIMIT = 4 * 1024 * 1024;
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    TcpLink::Configuration config = linkConfig(false, server.serverPort());
+    config.maxQueuedBytes = LIMIT;
+    config.sendBufferSize = 4096;
+    TcpLink link(config);
+    link.connectLink();
+    QTRY_VERIFY_WITH_TIMEOUT(server.hasPendingConnections(), TIMEOUT_MS);
+    QTcpSocket* peer = server.nextPendingConnection();
+    peer->setReadBufferSize(64 * 1024);  // leave the rest in the kernel until read
+    QTRY_VERIFY_WITH_TIMEOUT(link.isConnected(), TIMEOUT_MS);
+
+    // Queue fill at each change of state
+    QList<QPair<bool, quint64>> changes;
+    connect(&link, &LinkInterface::backPressureChanged, this, [&](bool congested) {
+        changes.append({congested, link.outboundStatistics().queuedBytes});
+    });
+
+    // Fill past the limit without returning to the event loop
+    const QByteArray chunk(1024, 'b');
+    for (int i = 0; i < LIMIT / chunk.size() + 16; ++i) {
+        link.writeBytes(chunk);
+    }
+    LinkInterface::OutboundStatistics stats = link.outboundStatistics();
+    QVERIFY(stats.congested);
+    QCOMPARE(stats.droppedWrites, quint64(16));
+    QCOMPARE(changes.size(), 1);
+    QVERIFY(changes.at(0).second > quint64(LIMIT / 4 * 3));
+
+    // Drain it in steps: congestion holds until the queue is below a quarter
+    qint64 readBytes = 0;
+    bool sawMiddle = false;
+    QElapsedTimer timer;
+    timer.start();
+    while (readBytes < LIMIT && timer.elapsed() < TIMEOUT_MS) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        readBytes += peer->read(64 * 1024).size();
+        stats = link.outboundStatistics();
+        if (stats.queuedBytes >= quint64(LIMIT / 4) &&
+            stats.queuedBytes <= quint64(LIMIT / 4 * 3)) {
+            sawMiddle = true;
+            QVERIFY(stats.congested);
+        }
+    }
+    QCOMPARE(readBytes, LIMIT);
+    QVERIFY(sawMiddle);
+    QTRY_VERIFY_WITH_TIMEOUT(!link.outboundStatistics().congested, TIMEOUT_MS);
+
+    // One change each way, not one per drain step
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes.at(1).first, false);
+    QVERIFY(changes.at(1).second < quint64(LIMIT / 4));
+    QVERIFY(link.outboundStatistics().peakQueuedBytes <= quint64(LIMIT));
+}
+
+void TcpLinkTest::waitingServerIsNotReconnected() {
+    // LinkManager runs the link on its own thread, as in the application
+    const quint16 port = freePort();
+    QVERIFY(port != 0);
+    LinkManager manager;
+    QSignalSpy reconnecting(&manager, &LinkManager::reconnecting);
+    QSignalSpy statuses(&manager, &LinkManager::linkStatusChanged);
+    QSignalSpy connection(&manager, &LinkManager::connectionStatusChanged);
+    QCOMPARE(manager.addLink(new TcpLink(linkConfig(true, port))), 0);
+
+    // The link starts listening once its thread runs
+    QTcpSocket peer;
+    QElapsedTimer timer;
+    timer.start();
+    while (peer.state() != QAbstractSocket::ConnectedState && timer.elapsed() < TIMEOUT_MS) {
+        peer.abort();
+        peer.connectToHost(QHostAddress::LocalHost, port);
+        peer.waitForConnected(100);
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(manager.isConnected(), TIMEOUT_MS);
+
+    // The peer leaves; the server goes back to waiting, which is not a
+    // failure to retry, even past the heartbeat timeout
+    peer.disconnectFromHost();
+    QTRY_VERIFY_WITH_TIMEOUT(!manager.isConnected(), TIMEOUT_MS);
+    QTest::qWait(LinkManager::HEARTBEAT_TIMEOUT_MS + 2 * LinkManager::INITIAL_RECONNECT_DELAY_MS);
+    QVERIFY(reconnecting.isEmpty());
+    QCOMPARE(statuses.last().at(1).value<LinkInterface::LinkStatus>(),
+             LinkInterface::LinkStatus::Connecting);
+
+    // ... and serves the next peer
+    QTcpSocket next;
+    next.connectToHost(QHostAddress::LocalHost, port);
+    QVERIFY(next.waitForConnected(TIMEOUT_MS));
+    QTRY_VERIFY_WITH_TIMEOUT(manager.isConnected(), TIMEOUT_MS);
+    QCOMPARE(connection.size(), 3);  // connected, waiting, connected
+}
+
+void TcpLinkTest::unansweredConnectTimesOut() {
+    // TEST-NET-1 is never routed: the SYN goes unanswered, or the attempt
+    // fails at once where there is no route at all. Either way the link
+    // must not stay in Connecting for the OS SYN timeout.
+    TcpLink::Configuration config = linkConfig(false, 5760);
+    config.address = QHostAddress("192.0.2.1");
+    config.connectTimeoutMs = 200;
+    TcpLink link(config);
+    QSignalSpy errors(&link, &LinkInterface::errorOccurred);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    link.connectLink();
+    QTRY_COMPARE_WITH_TIMEOUT(link.status(), LinkInterface::LinkStatus::Error, 2000);
+    QVERIFY(elapsed.elapsed() < 2000);
+
+    // A failed attempt is left to the reconnect backoff, like a refused one
+    QVERIFY(errors.isEmpty());
+}
+
+QTEST_MAIN(TcpLinkTest)
+#include "tst_tcplink.moc"
@@ -0,0 +1,17 @@
+QT += widgets charts
+
+include(../common/testcase.pri)
+include(../common/vehiclemodel.pri)
+
+# Source files
+SOURCES *= \
+    tst_telemetrychart.cpp \
+    $$FLIGHTSCOPE_SRC/ui/seriesdecimator.cpp \
+    $$FLIGHTSCOPE_SRC/ui/telemetrychartwidget.cpp \
+    $$FLIGHTSCOPE_SRC/models/telemetryhistory.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/ui/seriesdecimator.h \
+    $$FLIGHTSCOPE_SRC/ui/telemetrychartwidget.h \
+    $$FLIGHTSCOPE_SRC/models/telemetryhistory.h
@@ -0,0 +1,235 @@
+#include <QtTest>
+#include <QChart>
+#include <QElapsedTimer>
+#include <QLineSeries>
+#include <QValueAxis>
+#include <QtMath>
+#include "ui/seriesdecimator.h"
+#include "ui/telemetrychartwidget.h"
+
+/**
+ * @brief Checks min/max and LTTB decimation, sample-and-hold lines for
+ * steady fields, and measures chart frame time for ten 50 Hz fields over a
+ * 10-minute window
+ *
+ * The frame time is only reported unless FLIGHTSCOPE_BENCH_ASSERT is set,
+ * since it depends on the machine and its load.
+ */
+class TelemetryChartTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void shortRangesPassThrough();
+    void minMaxKeepsExtremes();
+    void lttbKeepsShape();
+    void steadyFieldsKeepTheirLine();
+    void eachUnitHasItsOwnAxis();
+    void chartFrameTime();
+
+private:
+    static constexpr qint64 T0 = 1700000000000LL;  // ms
+    static constexpr int SAMPLES = 10000;
+    static constexpr int SPIKE = 4321;
+
+    static bool assertTimings() { return qEnvironmentVariableIsSet("FLIGHTSCOPE_BENCH_ASSERT"); }
+
+    TelemetryHistory m_history{600000, 50.0};
+    TelemetryHistory::Range m_range;
+};
+
+void TelemetryChartTest::initTestCase() {
+    // A slow sine with one single-sample spike
+    for (int i = 0; i < SAMPLES; ++i) {
+        const double value = i == SPIKE ? 100.0 : qSin(i * 0.001);
+        m_history.append(VehicleModel::Roll, T0 + i * 20, value);
+    }
+    m_range = m_history.range(VehicleModel::Roll, T0, T0 + SAMPLES * 20);
+    QCOMPARE(m_range.size(), SAMPLES);
+}
+
+void TelemetryChartTest::shortRangesPassThrough() {
+    const TelemetryHistory::Range range = m_history.range(VehicleModel::Roll, T0, T0 + 99 * 20);
+    QList<QPointF> points;
+    SeriesDecimator::decimate(range, T0, T0 + 99 * 20, 50, SeriesDecimator::MinMax, &points);
+    QCOMPARE(points.size(), 100);
+    SeriesDecimator::decimate(range, T0, T0 + 99 * 20, 100, SeriesDecimator::Lttb, &points);
+    QCOMPARE(points.size(), 100);
+    QCOMPARE(points.at(42), QPointF(T0 + 42 * 20, qSin(42 * 0.001)));
+}
+
+void TelemetryChartTest::minMaxKeepsExtremes() {
+    const int columns = 200;
+    QList<QPointF> points;
+    SeriesDecimator::decimate(m_range, T0, T0 + SAMPLES * 20, columns, SeriesDecimator::MinMax,
+                              &points);
+
+    QVERIFY(points.size() <= 2 * columns + 2);
+    QVERIFY(points.size() >= columns);
+    QCOMPARE(points.constFirst(), QPointF(T0, 0.0));
+    QCOMPARE(points.constLast().x(), double(T0 + (SAMPLES - 1) * 20));
+
+    double high = 0.0;
+    for (int i = 1; i < points.size(); ++i) {
+        QVERIFY(points.at(i).x() >= points.at(i - 1).x());
+        high = qMax(high, points.at(i).y());
+    }
+    QCOMPARE(high, 100.0);
+}
+
+void TelemetryChartTest::lttbKeepsShape() {
+    const int threshold = 200;
+    QList<QPointF> points;
+    SeriesDecimator::decimate(m_range, T0, T0 + SAMPLES * 20, threshold, SeriesDecimator::Lttb,
+                              &points);
+
+    QCOMPARE(points.size(), threshold);
+    QCOMPARE(points.constFirst(), QPointF(T0, 0.0));
+    QCOMPARE(points.constLast().x(), double(T0 + (SAMPLES - 1) * 20));
+    bool spike = false;
+    for (int i = 1; i < points.size(); ++i) {
+        QVERIFY(points.at(i).x() > points.at(i - 1).x());
+        spike = spike || points.at(i).y() == 100.0;
+    }
+    // The spike spans the largest triangle in its bucket
+    QVERIFY(spike);
+}
+
+void TelemetryChartTest::steadyFieldsKeepTheirLine() {
+    // A minute of 50 Hz roll; armed once at the start, the battery twice
+    TelemetryHistory history(10 * 60 * 1000, 50.0);
+    for (int i = 0; i < 3000; ++i) {
+        history.append(VehicleModel::Roll, T0 + i * 20, qSin(i * 0.01));
+    }
+    history.append(VehicleModel::Armed, T0, 1.0);
+    history.append(VehicleModel::BatteryRemaining, T0, 80.0);
+    history.append(VehicleModel::BatteryRemaining, T0 + 55000, 79.0);
+    const qint64 newestMs = T0 + 2999 * 20;
+
+    TelemetryChartWidget widget(&history);
+    widget.setFields({VehicleModel::Roll, VehicleModel::Armed, VehicleModel::BatteryRemaining});
+    widget.setWindow(10000);
+    widget.refresh();
+    const qint64 fromMs = newestMs - 10000;
+
+    auto line = [&widget](VehicleModel::Field field) {
+        for (QAbstractSeries* series : widget.chart()->series()) {
+            if (series->name().startsWith(TelemetryHistory::fieldName(field))) {
+                return static_cast<QLineSeries*>(series)->points();
+            }
+        }
+        return QList<QPointF>();
+    };
+    QCOMPARE(line(VehicleModel::Armed),
+             QList<QPointF>({QPointF(fromMs, 1.0), QPointF(newestMs, 1.0)}));
+
+    // Held from before the window, then the sample inside it, carried to the end
+    QCOMPARE(line(VehicleModel::BatteryRemaining),
+             QList<QPointF>({QPointF(fromMs, 80.0), QPointF(T0 + 55000, 79.0),
+                             QPointF(newestMs, 79.0)}));
+}
+
+void TelemetryChartTest::eachUnitHasItsOwnAxis() {
+    // Altitude around 100 m next to roll and pitch within a few degrees
+    TelemetryHistory history(10 * 60 * 1000, 50.0);
+    for (int i = 0; i < 500; ++i) {
+        history.append(VehicleModel::Altitude, T0 + i * 20, 100.0 + i * 0.04);
+        history.append(VehicleModel::Roll, T0 + i * 20, 5.0 * qSin(i * 0.05));
+        history.append(VehicleModel::Pitch, T0 + i * 20, -2.0);
+    }
+
+    TelemetryChartWidget widget(&history);
+    widget.setFields({VehicleModel::Altitude, VehicleModel::Roll, VehicleModel::Pitch});
+    widget.refresh();
+    QCOMPARE(widget.chart()->axes(Qt::Vertical).size(), 2);
+
+    auto axisOf = [&widget](VehicleModel::Field field) -> QValueAxis* {
+        for (QAbstractSeries* series : widget.chart()->series()) {
+            if (series->name().startsWith(TelemetryHistory::fieldName(field))) {
+                return qobject_cast<QValueAxis*>(series->attachedAxes(Qt::Vertical).value(0));
+            }
+        }
+        return nullptr;
+    };
+    QValueAxis* degrees = axisOf(VehicleModel::Roll);
+    QValueAxis* metres = axisOf(VehicleModel::Altitude);
+    QVERIFY(degrees && metres && degrees != metres);
+    QCOMPARE(axisOf(VehicleModel::Pitch), degrees);
+    QCOMPARE(degrees->titleText(), QString("deg"));
+
+    // Each axis spans its own fields only
+    QVERIFY(degrees->min() < -4.9 && degrees->max() > 4.9 && degrees->max() < 6.0);
+    QVERIFY(metres->min() > 99.0 && metres->max() > 119.0);
+
+    // The unit's axis goes with its last field
+    widget.setFields({VehicleModel::Roll, VehicleModel::Pitch});
+    QCOMPARE(widget.chart()->axes(Qt::Vertical).size(), 1);
+}
+
+void TelemetryChartTest::chartFrameTime() {
+    const VehicleModel::Field fields[] = {
+        VehicleModel::Roll,        VehicleModel::Pitch,       VehicleModel::Yaw,
+        VehicleModel::RollSpeed,   VehicleModel::PitchSpeed,  VehicleModel::YawSpeed,
+        VehicleModel::Altitude,    VehicleModel::GroundSpeed, VehicleModel::AirSpeed,
+        VehicleModel::ClimbRate,
+    };
+    const int rateHz = 50;
+    const int windowSamples = 10 * 60 * rateHz;
+
+    TelemetryHistory history(10 * 60 * 1000, rateHz);
+    int sample = 0;
+    auto appendSample = [&]() {
+        for (int f = 0; f < 10; ++f) {
+            history.append(fields[f], T0 + sample * 1000 / rateHz,
+                           qSin(sample * 0.002 + f) * (f + 1) + (sample % 7) * 0.01);
+        }
+        ++sample;
+    };
+    for (int i = 0; i < windowSamples; ++i) {
+        appendSample();
+    }
+
+    TelemetryChartWidget widget(&history);
+    widget.setFields(QList<VehicleModel::Field>(std::begin(fields), std::end(fields)));
+    widget.setWindow(10 * 60 * 1000);
+    widget.resize(1920, 400);
+    widget.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&widget));
+    QCOMPARE(widget.chart()->series().size(), 10);
+
+    // One frame = one new 50 Hz sample per field, re-decimate, repaint
+    const int frames = 120;
+    qint64 refreshNs = 0;
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    for (int frame = 0; frame < frames; ++frame) {
+        appendSample();
+        QElapsedTimer refreshTimer;
+        refreshTimer.start();
+        widget.refresh();
+        refreshNs += refreshTimer.nsecsElapsed();
+        widget.grab();
+    }
+    const double frameMs = frameTimer.nsecsElapsed() / 1e6 / frames;
+    const double refreshMs = refreshNs / 1e6 / frames;
+
+    const int plotWidth = int(widget.chart()->plotArea().width());
+    int points = 0;
+    for (QAbstractSeries* series : widget.chart()->series()) {
+        const int count = static_cast<QLineSeries*>(series)->count();
+        QVERIFY(count <= 2 * plotWidth + 2);
+        points += count;
+    }
+
+    qInfo().nospace() << "TelemetryChartWidget: 10 fields x " << windowSamples
+                      << " samples -> " << points << " points (" << plotWidth
+                      << " px), refresh " << refreshMs << " ms, refresh + paint " << frameMs
+                      << " ms per frame";
+    // Decimation + replace() must leave most of a 60 fps frame for painting
+    if (assertTimings()) {
+        QVERIFY2(refreshMs < 1000.0 / 60 / 2, qPrintable(QString::number(refreshMs)));
+    }
+}
+
+QTEST_MAIN(TelemetryChartTest)
+#include "tst_telemetrychart.moc"
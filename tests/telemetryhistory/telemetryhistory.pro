@@ -0,0 +1,13 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/vehiclemodel.pri)
+
+# Source files
+SOURCES *= \
+    tst_telemetryhistory.cpp \
+    $$FLIGHTSCOPE_SRC/models/telemetryhistory.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/models/telemetryhistory.h
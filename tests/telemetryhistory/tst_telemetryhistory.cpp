@@ -0,0 +1,182 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include "models/telemetryhistory.h"
+
+/**
+ * @brief Checks the history rings: capacity and duration eviction, range
+ * queries across the wrap point, statistics and sliding windows
+ */
+class TelemetryHistoryTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void capacityFollowsDurationAndMemoryCap();
+    void recordsChangedFieldsOnly();
+    void evictsOldestWhenFull();
+    void rangeAcrossWrap();
+    void valueHeldBetweenSamples();
+    void windowMatchesBruteForce();
+
+private:
+    static constexpr qint64 T0 = 1700000000000LL;  // ms
+};
+
+void TelemetryHistoryTest::capacityFollowsDurationAndMemoryCap() {
+    TelemetryHistory history(60000, 50.0, qint64(1) << 30);
+    QCOMPARE(history.capacity(), 3000);
+    QCOMPARE(history.memoryUsage(),
+             qint64(3000) * TelemetryHistory::BYTES_PER_SAMPLE *
+                 qPopulationCount(TelemetryHistory::HISTORY_FIELDS));
+
+    // 10 minutes at 50 Hz does not fit in 1 MiB: the cap wins
+    TelemetryHistory capped(600000, 50.0, 1024 * 1024);
+    QVERIFY(capped.capacity() < 30000);
+    QVERIFY(capped.memoryUsage() <= 1024 * 1024);
+}
+
+void TelemetryHistoryTest::recordsChangedFieldsOnly() {
+    TelemetryHistory history;
+    VehicleState state;
+    state.roll = 10.0f;
+    state.latitude = -35.363261;
+    state.armed = true;
+
+    history.record(T0, state, VehicleModel::Roll | VehicleModel::Latitude | VehicleModel::Armed |
+                                  VehicleModel::FlightMode);
+    state.roll = 12.0f;
+    history.record(T0 + 20, state, VehicleModel::Roll);
+
+    QCOMPARE(history.size(VehicleModel::Roll), 2);
+    QCOMPARE(history.size(VehicleModel::Latitude), 1);
+    QCOMPARE(history.size(VehicleModel::Pitch), 0);
+    QCOMPARE(history.size(VehicleModel::FlightMode), 0);  // not a numeric field
+
+    qint64 timestamp = 0;
+    double value = 0.0;
+    QVERIFY(history.latest(VehicleModel::Roll, &timestamp, &value));
+    QCOMPARE(timestamp, T0 + 20);
+    QCOMPARE(value, 12.0);
+    QVERIFY(history.latest(VehicleModel::Latitude, nullptr, &value));
+    QCOMPARE(value, -35.363261);
+    QVERIFY(history.latest(VehicleModel::Armed, nullptr, &value));
+    QCOMPARE(value, 1.0);
+
+    // A clock stepping backwards does not break the time order
+    history.append(VehicleModel::Roll, T0, 13.0);
+    QVERIFY(history.latest(VehicleModel::Roll, &timestamp, nullptr));
+    QCOMPARE(timestamp, T0 + 20);
+
+    history.clear();
+    QCOMPARE(history.size(VehicleModel::Roll), 0);
+    QVERIFY(!history.latest(VehicleModel::Roll, nullptr, nullptr));
+}
+
+void TelemetryHistoryTest::evictsOldestWhenFull() {
+    // 1 s at 10 Hz: 10 samples
+    TelemetryHistory history(1000, 10.0);
+    QCOMPARE(history.capacity(), 10);
+
+    // Fast stream: the capacity limit evicts
+    for (int i = 0; i < 25; ++i) {
+        history.append(VehicleModel::Pitch, T0 + i * 10, i);
+    }
+    QCOMPARE(history.size(VehicleModel::Pitch), 10);
+    QCOMPARE(history.range(VehicleModel::Pitch, 0, T0 * 2).valueAt(0), 15.0);
+
+    // Slow stream: the duration limit evicts
+    for (int i = 0; i < 5; ++i) {
+        history.append(VehicleModel::Yaw, T0 + i * 400, i);
+    }
+    QCOMPARE(history.size(VehicleModel::Yaw), 3);  // 800, 1200, 1600 ms
+    QCOMPARE(history.range(VehicleModel::Yaw, 0, T0 * 2).timeAt(0), T0 + 800);
+}
+
+void TelemetryHistoryTest::rangeAcrossWrap() {
+    TelemetryHistory history(1000, 100.0);
+    QCOMPARE(history.capacity(), 100);
+    for (int i = 0; i < 150; ++i) {
+        history.append(VehicleModel::Altitude, T0 + i * 5, i);
+    }
+
+    // Samples 50..149 are kept, stored from slot 50 round to slot 49
+    const TelemetryHistory::Range all = history.range(VehicleModel::Altitude, 0, T0 * 2);
+    QCOMPARE(all.size(), 100);
+    QCOMPARE(all.sizes[0], 50);
+    QCOMPARE(all.sizes[1], 50);
+    for (int i = 0; i < all.size(); ++i) {
+        QCOMPARE(all.valueAt(i), double(50 + i));
+        QCOMPARE(all.timeAt(i), T0 + (50 + i) * 5);
+    }
+
+    // Both ends inclusive
+    const TelemetryHistory::Range part =
+        history.range(VehicleModel::Altitude, T0 + 90 * 5, T0 + 110 * 5);
+    QCOMPARE(part.size(), 21);
+    QCOMPARE(part.valueAt(0), 90.0);
+    QCOMPARE(part.valueAt(20), 110.0);
+
+    const TelemetryHistory::Stats stats =
+        history.stats(VehicleModel::Altitude, T0 + 90 * 5, T0 + 110 * 5);
+    QCOMPARE(stats.count, 21);
+    QCOMPARE(stats.min, 90.0);
+    QCOMPARE(stats.max, 110.0);
+    QCOMPARE(stats.mean, 100.0);
+
+    QCOMPARE(history.range(VehicleModel::Altitude, T0, T0 + 100).size(), 0);
+    QCOMPARE(history.stats(VehicleModel::Altitude, T0, T0 + 100).count, 0);
+}
+
+void TelemetryHistoryTest::valueHeldBetweenSamples() {
+    TelemetryHistory history(1000, 100.0);
+    for (int i = 0; i < 150; ++i) {
+        history.append(VehicleModel::Altitude, T0 + i * 5, i);
+    }
+
+    double value = -1.0;
+    QVERIFY(history.valueAt(VehicleModel::Altitude, T0 + 90 * 5, &value));
+    QCOMPARE(value, 90.0);
+    QVERIFY(history.valueAt(VehicleModel::Altitude, T0 + 90 * 5 + 4, &value));
+    QCOMPARE(value, 90.0);
+    QVERIFY(history.valueAt(VehicleModel::Altitude, T0 * 2, &value));
+    QCOMPARE(value, 149.0);
+    QVERIFY(history.valueAt(VehicleModel::Altitude, std::numeric_limits<qint64>::max(), &value));
+    QCOMPARE(value, 149.0);
+
+    // Nothing is known before the oldest sample kept, or for an empty field
+    QVERIFY(history.valueAt(VehicleModel::Altitude, T0 + 50 * 5, nullptr));
+    QVERIFY(!history.valueAt(VehicleModel::Altitude, T0 + 50 * 5 - 1, &value));
+    QVERIFY(!history.valueAt(VehicleModel::Armed, T0 * 2, &value));
+}
+
+void TelemetryHistoryTest::windowMatchesBruteForce() {
+    // 25 slots hold 175 ms at 7 ms spacing: samples are overwritten under the window
+    TelemetryHistory history(500, 50.0);
+    TelemetryHistory::Window window(&history, VehicleModel::ClimbRate, 300);
+    QRandomGenerator random(42);
+
+    int checks = 0;
+    for (int i = 0; i < 20000; ++i) {
+        if (i == 12000) {
+            history.clear();
+        }
+        history.append(VehicleModel::ClimbRate, T0 + i * 7, random.bounded(20.0) - 10.0);
+        if (random.bounded(4) != 0) {
+            continue;
+        }
+
+        qint64 newest = 0;
+        QVERIFY(history.latest(VehicleModel::ClimbRate, &newest, nullptr));
+        const TelemetryHistory::Stats expected =
+            history.stats(VehicleModel::ClimbRate, newest - 300, newest);
+        const TelemetryHistory::Stats actual = window.stats();
+        QCOMPARE(actual.count, expected.count);
+        QCOMPARE(actual.min, expected.min);
+        QCOMPARE(actual.max, expected.max);
+        QVERIFY(qAbs(actual.mean - expected.mean) < 1e-9);
+        ++checks;
+    }
+    QVERIFY(checks > 1000);
+}
+
+QTEST_MAIN(TelemetryHistoryTest)
+#include "tst_telemetryhistory.moc"
@@ -1,23 +1,33 @@
-QT += testlib widgets
+# All FlightScope tests: qmake tests/tests.pro && make && make check
+TEMPLATE = subdirs
 
-CONFIG += qt console warn_on depend_includepath testcase
-CONFIG -= app_bundle
+SUBDIRS += \
+    smoke \
+    bytering \
+    dedupwindow \
+    fleetmap \
+    impairedlink \
+    latencytrace \
+    mavlinkrouter \
+    messagestatistics \
+    replaylink \
+    routerbenchmark \
+    seqlock \
+    sequencetracker \
+    tcplink \
+    telemetrychart \
+    telemetryhistory \
+    timesynclatency \
+    tlogindex \
+    tlogrecorder \
+    trailmodel \
+    vehiclemodel \
+    vehicleregistry \
+    vehiclesimulator
 
-TEMPLATE = app
-
-# Include paths
-INCLUDEPATH += $$PWD/../src
-INCLUDEPATH += $$PWD/../third-party
-
-# Source files
-SOURCES += \
-    test_main.cpp \
-    ../src/ui/mainwindow.cpp
-
-# Header files
-HEADERS += \
-    ../src/ui/mainwindow.h
-
-# Forms
-FORMS += \
-    ../src/ui/mainwindow.ui
\ No newline at end of file
+# recvmmsg/sendmmsg and openpty
+linux {
+    SUBDIRS += \
+        udplink \
+        seriallink
+}
@@ -0,0 +1,8 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/router.pri)
+
+# Source files
+SOURCES += \
+    tst_timesynclatency.cpp
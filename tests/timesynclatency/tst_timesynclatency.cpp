@@ -0,0 +1,174 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "comm/bytering.h"
+#include "comm/mavlinkrouter.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Measures how long the router takes to answer a TIMESYNC request
+ *
+ * A feeder thread plays the link: it writes TIMESYNC requests into a receive
+ * ring at a fixed rate and wakes the router, exactly as a link does. The
+ * latency is the time from the write to the router emitting the reply. The
+ * main thread plays the GUI and is optionally kept busy with long stalls
+ * (a slow repaint) while the measurement runs.
+ *
+ * The latencies depend on the machine and its load, so they are only
+ * reported; set FLIGHTSCOPE_BENCH_ASSERT to also check them against the
+ * thresholds below.
+ */
+class TimesyncLatencyTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void latencyFlatUnderGuiLoad();
+    void guiThreadRouterBaseline();
+
+private:
+    struct Result {
+        bool complete{false};  // every request was answered
+        qint64 p50Us{0};
+        qint64 p99Us{0};
+        qint64 maxUs{0};
+    };
+
+    Result measure(MavlinkRouter* router, bool busyGui);
+    static void report(const char* label, const Result& result);
+    static bool assertTimings() { return qEnvironmentVariableIsSet("FLIGHTSCOPE_BENCH_ASSERT"); }
+
+    static constexpr int REQUEST_COUNT = 200;
+    static constexpr int REQUEST_INTERVAL_MS = 5;
+    static constexpr int GUI_STALL_MS = 50;
+};
+
+void TimesyncLatencyTest::initTestCase() {
+    // The router logs every TIMESYNC reply at debug level
+    MavlinkTestHelpers::quietLogging();
+}
+
+TimesyncLatencyTest::Result TimesyncLatencyTest::measure(MavlinkRouter* router, bool busyGui) {
+    ByteRing ring(64 * 1024);
+    QElapsedTimer clock;
+    clock.start();
+
+    std::vector<qint64> requestTimes(REQUEST_COUNT, 0);
+    std::vector<qint64> replyTimes(REQUEST_COUNT, 0);
+    std::atomic<int> replies{0};
+
+    // Timestamp replies on the router's own thread
+    QMetaObject::Connection replyConnection = connect(
+        router, &MavlinkRouter::bytesToSend, router,
+        [&](quint32, QByteArray) {
+            const int index = replies.load(std::memory_order_relaxed);
+            if (index < REQUEST_COUNT) {
+                replyTimes[index] = clock.nsecsElapsed();
+                replies.store(index + 1, std::memory_order_release);
+            }
+        },
+        Qt::DirectConnection);
+
+    QThread* feeder = QThread::create([&]() {
+        for (int i = 0; i < REQUEST_COUNT; ++i) {
+            mavlink_message_t msg;
+            mavlink_msg_timesync_pack_chan(1, 1, MAVLINK_COMM_1, &msg, 0, i + 1, 255, 190);
+            uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+            const uint16_t len = mavlink_msg_to_send_buffer(buffer, &msg);
+
+            requestTimes[i] = clock.nsecsElapsed();
+            ring.write(reinterpret_cast<const char*>(buffer), len);
+            if (ring.requestWake()) {
+                QMetaObject::invokeMethod(
+                    router, [router, &ring]() { router->drainReceiveRing(0, ring); },
+                    Qt::QueuedConnection);
+            }
+            QThread::msleep(REQUEST_INTERVAL_MS);
+        }
+    });
+    feeder->start();
+
+    // Main thread acts as the GUI: either idle in its event loop or stalling
+    while (!feeder->isFinished()) {
+        if (busyGui) {
+            QElapsedTimer stall;
+            stall.start();
+            while (stall.elapsed() < GUI_STALL_MS) {
+            }
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+    }
+    feeder->wait();
+    delete feeder;
+
+    Result result;
+    result.complete = QTest::qWaitFor(
+        [&]() { return replies.load(std::memory_order_acquire) == REQUEST_COUNT; }, 5000);
+    disconnect(replyConnection);
+    if (!result.complete) {
+        return result;
+    }
+
+    std::vector<qint64> latencies(REQUEST_COUNT);
+    for (int i = 0; i < REQUEST_COUNT; ++i) {
+        latencies[i] = (replyTimes[i] - requestTimes[i]) / 1000;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    result.p50Us = latencies[REQUEST_COUNT / 2];
+    result.p99Us = latencies[(REQUEST_COUNT * 99) / 100];
+    result.maxUs = latencies.back();
+    return result;
+}
+
+void TimesyncLatencyTest::report(const char* label, const Result& result) {
+    qInfo().nospace() << label << ": TIMESYNC reply latency p50 " << result.p50Us << " us, p99 "
+                      << result.p99Us << " us, max " << result.maxUs << " us";
+}
+
+void TimesyncLatencyTest::latencyFlatUnderGuiLoad() {
+    QThread parserThread;
+    auto* router = new MavlinkRouter();
+    router->moveToThread(&parserThread);
+    parserThread.start();
+
+    const Result idle = measure(router, false);
+    const Result busy = measure(router, true);
+    report("Parser thread, idle GUI", idle);
+    report("Parser thread, busy GUI", busy);
+
+    parserThread.quit();
+    parserThread.wait();
+    delete router;
+
+    QVERIFY(idle.complete);
+    QVERIFY(busy.complete);
+    if (!assertTimings()) {
+        return;
+    }
+
+    // GUI stalls must not show up in the protocol path
+    QVERIFY2(busy.p99Us < GUI_STALL_MS * 1000 / 2, "Reply latency tracks GUI stalls");
+    QVERIFY2(busy.p99Us < idle.p99Us + 5000, "Reply latency grew under GUI load");
+}
+
+void TimesyncLatencyTest::guiThreadRouterBaseline() {
+    // Previous wiring: the router shares the GUI thread, so replies wait for
+    // the stall to end
+    MavlinkRouter router;
+
+    const Result busy = measure(&router, true);
+    report("GUI thread, busy GUI", busy);
+
+    QVERIFY(busy.complete);
+    if (assertTimings()) {
+        QVERIFY(busy.p99Us >= GUI_STALL_MS * 1000 / 2);
+    }
+}
+
+QTEST_MAIN(TimesyncLatencyTest)
+#include "tst_timesynclatency.moc"
@@ -0,0 +1,13 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_tlogindex.cpp \
+    $$FLIGHTSCOPE_SRC/comm/tlogindex.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/tlogindex.h \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkframing.h
@@ -0,0 +1,177 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <algorithm>
+#include "comm/tlogindex.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Checks keyframe lookup, state snapshots, msgid positions and the
+ * sidecar round trip against a synthetic two-vehicle log
+ */
+class TlogIndexTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void indexesKeyframesAndPositions();
+    void snapshotsHoldLatestState();
+    void roundTripsThroughSidecar();
+
+private:
+    struct Entry {
+        qint64 offset;
+        quint64 timestampUs;
+        uint8_t systemId;
+        uint32_t msgId;
+    };
+
+    static QByteArray makePacket(uint8_t systemId, uint32_t msgId);
+    void makeLog();
+
+    static constexpr quint64 START_US = 1700000000000000ULL;
+    static constexpr quint64 INTERVAL_US = 25000;
+    static constexpr int COUNT = 1200;  // 30 s
+
+    QByteArray m_log;
+    QList<Entry> m_entries;
+};
+
+void TlogIndexTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+    makeLog();
+}
+
+QByteArray TlogIndexTest::makePacket(uint8_t systemId, uint32_t msgId) {
+    return MavlinkTestHelpers::makePacket(msgId, systemId, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_1,
+                                          [](int i) { return i + 1; });
+}
+
+void TlogIndexTest::makeLog() {
+    // Two vehicles; RC_CHANNELS and STATUSTEXT are indexed but carry no model state
+    const uint32_t mix[] = {MAVLINK_MSG_ID_ATTITUDE,   MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+                            MAVLINK_MSG_ID_RC_CHANNELS, MAVLINK_MSG_ID_VFR_HUD,
+                            MAVLINK_MSG_ID_HEARTBEAT,  MAVLINK_MSG_ID_STATUSTEXT};
+    for (int i = 0; i < COUNT; ++i) {
+        Entry entry;
+        entry.offset = m_log.size();
+        entry.timestampUs = START_US + i * INTERVAL_US;
+        entry.systemId = static_cast<uint8_t>(1 + (i / 6) % 2);
+        entry.msgId = mix[i % 6];
+        m_entries.append(entry);
+
+        char timestamp[TlogIndex::TIMESTAMP_BYTES];
+        qToBigEndian<quint64>(entry.timestampUs, timestamp);
+        m_log.append(timestamp, sizeof(timestamp));
+        m_log.append(makePacket(entry.systemId, entry.msgId));
+    }
+}
+
+void TlogIndexTest::indexesKeyframesAndPositions() {
+    TlogIndex index;
+    QVERIFY(index.build(reinterpret_cast<const uchar*>(m_log.constData()), m_log.size()));
+    QCOMPARE(index.recordCount(), quint64(COUNT));
+    QCOMPARE(index.firstTimestampUs(), START_US);
+    QCOMPARE(index.durationUs(), qint64((COUNT - 1) * INTERVAL_US));
+
+    // One keyframe per second of log, each at the first record of its second
+    const QVector<TlogIndex::Keyframe>& keyframes = index.keyframes();
+    QCOMPARE(keyframes.size(), qsizetype(30));
+    for (int k = 0; k < keyframes.size(); ++k) {
+        const int record = k * int(TlogIndex::KEYFRAME_INTERVAL_US / INTERVAL_US);
+        QCOMPARE(keyframes.at(k).timestampUs, m_entries.at(record).timestampUs);
+        QCOMPARE(keyframes.at(k).offset, m_entries.at(record).offset);
+    }
+
+    // Binary search: last keyframe at or before the time, the first before the log
+    QCOMPARE(index.keyframeAt(0), &keyframes.first());
+    QCOMPARE(index.keyframeAt(START_US), &keyframes.first());
+    QCOMPARE(index.keyframeAt(START_US + 12500000), &keyframes.at(12));
+    QCOMPARE(index.keyframeAt(START_US + 13000000), &keyframes.at(13));
+    QCOMPARE(index.keyframeAt(START_US + 3600000000ULL), &keyframes.last());
+
+    // Every record is listed under its msgid, in log order
+    quint64 listed = 0;
+    for (uint32_t msgId : index.messageIds()) {
+        const QVector<qint64> positions = index.positions(msgId);
+        QVERIFY(std::is_sorted(positions.cbegin(), positions.cend()));
+        for (qint64 offset : positions) {
+            auto it = std::find_if(m_entries.cbegin(), m_entries.cend(),
+                                   [offset](const Entry& e) { return e.offset == offset; });
+            QVERIFY(it != m_entries.cend());
+            QCOMPARE(it->msgId, msgId);
+        }
+        listed += positions.size();
+    }
+    QCOMPARE(listed, quint64(COUNT));
+    QCOMPARE(index.positions(MAVLINK_MSG_ID_STATUSTEXT).size(), qsizetype(COUNT / 6));
+    QVERIFY(index.positions(MAVLINK_MSG_ID_BATTERY_STATUS).isEmpty());
+}
+
+void TlogIndexTest::snapshotsHoldLatestState() {
+    TlogIndex index;
+    QVERIFY(index.build(reinterpret_cast<const uchar*>(m_log.constData()), m_log.size()));
+
+    for (const TlogIndex::Keyframe& keyframe : index.keyframes()) {
+        // Brute force: the latest state message of each (system, msgid) before the keyframe
+        QMap<QPair<uint8_t, uint32_t>, qint64> latest;
+        for (const Entry& entry : m_entries) {
+            if (entry.offset >= keyframe.offset) {
+                break;
+            }
+            if (TlogIndex::isStateMessage(entry.msgId)) {
+                latest.insert({entry.systemId, entry.msgId}, entry.offset);
+            }
+        }
+        QVector<qint64> expected(latest.cbegin(), latest.cend());
+        std::sort(expected.begin(), expected.end());
+
+        QCOMPARE(index.snapshot(keyframe), expected);
+    }
+
+    // Past the first second both vehicles have all four state messages
+    QCOMPARE(index.snapshot(index.keyframes().at(1)).size(), qsizetype(8));
+    QVERIFY(index.snapshot(index.keyframes().first()).isEmpty());
+}
+
+void TlogIndexTest::roundTripsThroughSidecar() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = TlogIndex::sidecarPath(directory.filePath("flight.tlog"));
+    const qint64 modifiedMs = 1700000000000;
+
+    TlogIndex built;
+    QVERIFY(built.build(reinterpret_cast<const uchar*>(m_log.constData()), m_log.size()));
+    QVERIFY(built.save(path, m_log.size(), modifiedMs));
+
+    TlogIndex loaded;
+    QVERIFY(loaded.load(path, m_log.size(), modifiedMs));
+    QCOMPARE(loaded.recordCount(), built.recordCount());
+    QCOMPARE(loaded.firstTimestampUs(), built.firstTimestampUs());
+    QCOMPARE(loaded.durationUs(), built.durationUs());
+    QCOMPARE(loaded.keyframes().size(), built.keyframes().size());
+    for (int k = 0; k < built.keyframes().size(); ++k) {
+        QCOMPARE(loaded.keyframes().at(k).timestampUs, built.keyframes().at(k).timestampUs);
+        QCOMPARE(loaded.keyframes().at(k).offset, built.keyframes().at(k).offset);
+        QCOMPARE(loaded.snapshot(loaded.keyframes().at(k)),
+                 built.snapshot(built.keyframes().at(k)));
+    }
+    QCOMPARE(loaded.positions(MAVLINK_MSG_ID_ATTITUDE), built.positions(MAVLINK_MSG_ID_ATTITUDE));
+
+    // A log that changed since indexing invalidates the sidecar
+    TlogIndex stale;
+    QVERIFY(!stale.load(path, m_log.size() + 1, modifiedMs));
+    QVERIFY(!stale.load(path, m_log.size(), modifiedMs + 1));
+    QVERIFY(stale.isEmpty());
+
+    // So does a truncated sidecar
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+    QVERIFY(!stale.load(path, m_log.size(), modifiedMs));
+    QVERIFY(stale.isEmpty());
+}
+
+QTEST_MAIN(TlogIndexTest)
+#include "tst_tlogindex.moc"
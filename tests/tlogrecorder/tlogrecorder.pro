@@ -0,0 +1,14 @@
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_tlogrecorder.cpp \
+    $$FLIGHTSCOPE_SRC/comm/bytering.cpp \
+    $$FLIGHTSCOPE_SRC/comm/tlogrecorder.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/bytering.h \
+    $$FLIGHTSCOPE_SRC/comm/tlogrecorder.h
@@ -0,0 +1,223 @@
+#include <QtTest>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "comm/tlogrecorder.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Checks the .tlog byte format, link tags, rotation and drop accounting
+ *
+ * Packets are opaque to the recorder, so the tests use synthetic payloads
+ * of known sizes and parse the files back with those sizes.
+ */
+class TlogRecorderTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void writesTimestampedRecords();
+    void rotatesBySize();
+    void countsDroppedRecords();
+
+private:
+    struct Record {
+        quint64 timestampUs;
+        QByteArray packet;
+    };
+
+    static QByteArray makePacket(int index);
+    static bool record(TlogRecorder& recorder, int index, quint64 timestampUs);
+    static QByteArray readAll(const QSignalSpy& openedFiles);
+    static QList<Record> parse(const QByteArray& log, int count);
+};
+
+void TlogRecorderTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging(true);
+}
+
+QByteArray TlogRecorderTest::makePacket(int index) {
+    // 12..279 bytes, like MAVLink v1/v2 frames
+    QByteArray packet(12 + (index * 37) % 268, Qt::Uninitialized);
+    for (qsizetype i = 0; i < packet.size(); ++i) {
+        packet[i] = static_cast<char>(index + i);
+    }
+    return packet;
+}
+
+bool TlogRecorderTest::record(TlogRecorder& recorder, int index, quint64 timestampUs) {
+    const QByteArray packet = makePacket(index);
+    return recorder.record(0, TlogRecorder::Direction::Inbound, packet.constData(), packet.size(),
+                           timestampUs);
+}
+
+QByteArray TlogRecorderTest::readAll(const QSignalSpy& openedFiles) {
+    // Concatenate the files in the order the recorder opened them
+    QByteArray log;
+    for (const QList<QVariant>& arguments : openedFiles) {
+        QFile file(arguments.first().toString());
+        if (file.open(QIODevice::ReadOnly)) {
+            log += file.readAll();
+        }
+    }
+    return log;
+}
+
+QList<TlogRecorderTest::Record> TlogRecorderTest::parse(const QByteArray& log, int count) {
+    QList<Record> records;
+    qsizetype offset = 0;
+    for (int i = 0; i < count && offset + TlogRecorder::TIMESTAMP_BYTES <= log.size(); ++i) {
+        Record record;
+        record.timestampUs = qFromBigEndian<quint64>(log.constData() + offset);
+        offset += TlogRecorder::TIMESTAMP_BYTES;
+        record.packet = log.mid(offset, makePacket(i).size());
+        offset += record.packet.size();
+        records.append(record);
+    }
+    return records;
+}
+
+void TlogRecorderTest::writesTimestampedRecords() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    TlogRecorder recorder;
+    QSignalSpy opened(&recorder, &TlogRecorder::fileOpened);
+    TlogRecorder::Configuration config;
+    config.directory = directory.path();
+    QVERIFY(recorder.start(config));
+    QVERIFY(recorder.isRecording());
+    QVERIFY(!recorder.statistics().fileName.isEmpty());
+
+    // Packets received on and sent to three links
+    const quint64 startUs = 1700000000000000ULL;
+    constexpr int COUNT = 1000;
+    for (int i = 0; i < COUNT; ++i) {
+        const QByteArray packet = makePacket(i);
+        const auto direction =
+            i % 2 ? TlogRecorder::Direction::Outbound : TlogRecorder::Direction::Inbound;
+        QVERIFY(recorder.record(i % 3, direction, packet.constData(), packet.size(),
+                                startUs + i * 1000));
+    }
+    const QString logPath = recorder.statistics().fileName;
+    recorder.stop();
+    QVERIFY(!recorder.isRecording());
+    QVERIFY(!recorder.record(0, TlogRecorder::Direction::Inbound, "x", 1));
+
+    const QByteArray log = readAll(opened);
+    const QList<Record> records = parse(log, COUNT);
+    QCOMPARE(records.size(), qsizetype(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        QCOMPARE(records.at(i).timestampUs, startUs + i * 1000);
+        QCOMPARE(records.at(i).packet, makePacket(i));
+    }
+
+    // The sidecar tags each record with its link and direction
+    QFile links(TlogRecorder::linksPath(logPath));
+    QVERIFY(links.open(QIODevice::ReadOnly));
+    const QByteArray tags = links.readAll();
+    QCOMPARE(tags.size(), qsizetype(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        const uchar expected = uchar(i % 3) | (i % 2 ? TlogRecorder::OUTBOUND_TAG : 0);
+        QCOMPARE(uchar(tags.at(i)), expected);
+    }
+
+    const TlogRecorder::Statistics stats = recorder.statistics();
+    QCOMPARE(stats.packetsRecorded, quint64(COUNT));
+    QCOMPARE(stats.packetsOutbound, quint64(COUNT / 2));
+    QCOMPARE(stats.packetsDropped, quint64(0));
+    QCOMPARE(stats.bytesWritten, quint64(log.size()));
+    QCOMPARE(stats.filesOpened, quint64(1));
+
+    // Timestamps written by record() without one are wall-clock microseconds
+    QVERIFY(recorder.start(config));
+    const quint64 before = TlogRecorder::currentTimeUs();
+    QVERIFY(recorder.record(0, TlogRecorder::Direction::Inbound, "abc", 3));
+    const quint64 after = TlogRecorder::currentTimeUs();
+    recorder.stop();
+    QCOMPARE(opened.size(), qsizetype(2));
+
+    QFile second(opened.last().first().toString());
+    QVERIFY(second.open(QIODevice::ReadOnly));
+    const QByteArray record = second.readAll();
+    QCOMPARE(record.size(), qsizetype(TlogRecorder::TIMESTAMP_BYTES + 3));
+    const quint64 timestampUs = qFromBigEndian<quint64>(record.constData());
+    QVERIFY(timestampUs >= before && timestampUs <= after);
+    QCOMPARE(record.mid(TlogRecorder::TIMESTAMP_BYTES), QByteArray("abc"));
+}
+
+void TlogRecorderTest::rotatesBySize() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    TlogRecorder recorder;
+    QSignalSpy opened(&recorder, &TlogRecorder::fileOpened);
+    TlogRecorder::Configuration config;
+    config.directory = directory.path();
+    config.maxFileBytes = 16 * 1024;
+    config.flushIntervalMs = 5;
+    QVERIFY(recorder.start(config));
+
+    // Feed slowly enough for several drains (and therefore rotations)
+    constexpr int COUNT = 600;
+    for (int i = 0; i < COUNT; ++i) {
+        QVERIFY(record(recorder, i, quint64(i)));
+        if (i % 50 == 49) {
+            QTest::qWait(20);
+        }
+    }
+    recorder.stop();
+
+    QVERIFY(opened.size() > 1);
+    QCOMPARE(QDir(directory.path()).entryList({"*.tlog"}, QDir::Files).size(), opened.size());
+    QCOMPARE(QDir(directory.path()).entryList({"*.tlog.links"}, QDir::Files).size(),
+             opened.size());
+
+    // Rotation splits on record boundaries: the concatenation is intact
+    const QList<Record> records = parse(readAll(opened), COUNT);
+    QCOMPARE(records.size(), qsizetype(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        QCOMPARE(records.at(i).timestampUs, quint64(i));
+        QCOMPARE(records.at(i).packet, makePacket(i));
+    }
+}
+
+void TlogRecorderTest::countsDroppedRecords() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    // A few records' worth of buffer and no timer-driven drain during the burst
+    TlogRecorder recorder(4096);
+    QSignalSpy opened(&recorder, &TlogRecorder::fileOpened);
+    TlogRecorder::Configuration config;
+    config.directory = directory.path();
+    config.flushIntervalMs = 60000;
+    QVERIFY(recorder.start(config));
+
+    constexpr int COUNT = 5000;
+    int accepted = 0;
+    for (int i = 0; i < COUNT; ++i) {
+        accepted += record(recorder, i, quint64(i)) ? 1 : 0;
+    }
+
+    // Oversized records are rejected, never truncated
+    const QByteArray oversized(TlogRecorder::MAX_PACKET_BYTES + 1, 'x');
+    QVERIFY(!recorder.record(0, TlogRecorder::Direction::Inbound, oversized.constData(),
+                             oversized.size()));
+    recorder.stop();
+
+    const TlogRecorder::Statistics stats = recorder.statistics();
+    qInfo() << "Accepted" << accepted << "of" << COUNT << "records into a 4 KiB buffer";
+    QVERIFY(stats.packetsDropped > 0);
+    QCOMPARE(stats.packetsRecorded, quint64(accepted));
+    QCOMPARE(stats.packetsRecorded + stats.packetsDropped, quint64(COUNT + 1));
+    QVERIFY(stats.bufferHighWater <= quint64(stats.bufferCapacity));
+
+    // Everything accepted reached the disk, and nothing else did
+    const QByteArray log = readAll(opened);
+    QCOMPARE(stats.bytesWritten, quint64(log.size()));
+    QVERIFY(stats.bytesDropped > 0);
+}
+
+QTEST_MAIN(TlogRecorderTest)
+#include "tst_tlogrecorder.moc"
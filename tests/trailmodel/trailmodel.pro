@@ -0,0 +1,15 @@
+QT += positioning
+QT -= gui
+
+include(../common/testcase.pri)
+
+# Source files
+SOURCES *= \
+    tst_trailmodel.cpp \
+    $$FLIGHTSCOPE_SRC/models/trailmodel.cpp \
+    $$FLIGHTSCOPE_SRC/models/traillodstore.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/models/trailmodel.h \
+    $$FLIGHTSCOPE_SRC/models/traillodstore.h
@@ -0,0 +1,303 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include <QtMath>
+#include "models/trailmodel.h"
+
+/**
+ * @brief Checks the level-of-detail levels of TrailLodStore, that the
+ * TrailModel rows hold exactly the visible segments whether built at once
+ * or incrementally, that switching stores keeps each trail, and measures a
+ * 10 h flight
+ */
+class TrailModelTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void levelsStayWithinOneCell();
+    void incrementalRowsMatchRebuild();
+    void appendsTouchLastRowOnly();
+    void switchingStoresKeepsEachTrail();
+    void longFlight();
+
+private:
+    static constexpr double LAT0 = -35.3632;
+    static constexpr double LON0 = 149.1654;
+
+    // Steady flight with slow turns, one point per step of about a metre
+    static void fly(TrailModel& model, int points, quint32 seed, double step = 1e-5) {
+        QRandomGenerator random(seed);
+        double lat = LAT0;
+        double lon = LON0;
+        double heading = 0.0;
+        for (int i = 0; i < points; ++i) {
+            heading += (random.generateDouble() - 0.5) * 0.2;
+            lat += step * qCos(heading);
+            lon += step * qSin(heading);
+            model.append(lat, lon);
+        }
+    }
+
+    static qint64 cellOf(qint32 value, qint64 cell) {
+        return qint64(std::floor(double(value) / double(cell)));
+    }
+
+    // Segments in all rows, and the rows' paths
+    static int segmentCount(const TrailModel& model) {
+        int segments = 0;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            segments += int(rowPath(model, row).size()) - 1;
+        }
+        return segments;
+    }
+
+    static QList<QGeoCoordinate> rowPath(const TrailModel& model, int row) {
+        return model.data(model.index(row), TrailModel::PathRole).value<QList<QGeoCoordinate>>();
+    }
+};
+
+void TrailModelTest::levelsStayWithinOneCell() {
+    QCOMPARE(TrailLodStore::levelFor(0.0), 0);
+    QCOMPARE(TrailLodStore::levelFor(TrailLodStore::BASE_CELL), 1);
+    QCOMPARE(TrailLodStore::levelFor(TrailLodStore::cellSize(5) * 1.9), 5);
+    QCOMPARE(TrailLodStore::levelFor(1e12), TrailLodStore::LEVEL_COUNT - 1);
+
+    TrailModel model;
+    fly(model, 50000, 1, 3e-5);
+    const TrailLodStore& store = model.store();
+    QCOMPARE(store.size(), qint64(50000));
+    QCOMPARE(store.vertexCount(0), 50000);
+
+    int previousCount = store.vertexCount(0);
+    for (int level = 1; level < TrailLodStore::LEVEL_COUNT; ++level) {
+        const int count = store.vertexCount(level);
+        QVERIFY(count <= previousCount);
+        previousCount = count;
+        QCOMPARE(store.vertexSequence(level, 0), qint64(0));
+        QCOMPARE(store.vertexSequence(level, count - 1), store.size() - 1);
+
+        // Every point shares a cell with the last vertex kept at or before it
+        const qint64 cell = TrailLodStore::cellSize(level);
+        int vertex = 0;
+        for (qint64 sequence = 0; sequence < store.size(); ++sequence) {
+            while (vertex + 1 < count && store.vertexSequence(level, vertex + 1) <= sequence) {
+                ++vertex;
+            }
+            const TrailLodStore::Point point = store.point(sequence);
+            const TrailLodStore::Point kept = store.vertex(level, vertex);
+            if (cellOf(point.latitude, cell) != cellOf(kept.latitude, cell) ||
+                cellOf(point.longitude, cell) != cellOf(kept.longitude, cell)) {
+                QFAIL(qPrintable(QString("level %1, point %2").arg(level).arg(sequence)));
+            }
+        }
+    }
+    QVERIFY(store.vertexCount(TrailLodStore::LEVEL_COUNT - 1) < 10);
+}
+
+void TrailModelTest::incrementalRowsMatchRebuild() {
+    // A figure-eight pattern in and out of the view (plus margin), many times
+    const double north = LAT0 + 0.002;
+    const double south = LAT0 - 0.004;
+    const double west = LON0 - 0.004;
+    const double east = LON0 + 0.002;
+
+    TrailModel incremental;
+    incremental.setViewport(north, west, south, east, 600, 600);
+    incremental.flush();
+    QVERIFY(incremental.level() > 0);
+
+    QRandomGenerator random(7);
+    double t = 0.0;
+    for (int frame = 0; frame < 2000; ++frame) {
+        const int batch = random.bounded(1, 40);
+        for (int i = 0; i < batch; ++i) {
+            t += 0.001;
+            incremental.append(LAT0 + 0.02 * qSin(2 * t), LON0 + 0.02 * qSin(t));
+        }
+        incremental.flush();
+    }
+
+    // Same points, rows built in one go from the store
+    TrailModel rebuilt;
+    for (qint64 i = 0; i < incremental.size(); ++i) {
+        const QGeoCoordinate point = incremental.pointAt(i);
+        rebuilt.append(point.latitude(), point.longitude());
+    }
+    rebuilt.setViewport(north, west, south, east, 600, 600);
+    rebuilt.flush();
+    QCOMPARE(rebuilt.level(), incremental.level());
+
+    QVERIFY(incremental.rowCount() > 1);
+    QCOMPARE(incremental.rowCount(), rebuilt.rowCount());
+    for (int row = 0; row < rebuilt.rowCount(); ++row) {
+        const QList<QGeoCoordinate> path = rowPath(incremental, row);
+        QVERIFY(path.size() >= 2 && path.size() <= TrailModel::CHUNK_SIZE + 1);
+        QCOMPARE(path, rowPath(rebuilt, row));
+    }
+
+    // Brute force: segments of the level that meet the covered area
+    const TrailLodStore& store = rebuilt.store();
+    const int level = rebuilt.level();
+    const double latMargin = (north - south) * TrailModel::VIEWPORT_MARGIN;
+    const double lonMargin = (east - west) * TrailModel::VIEWPORT_MARGIN;
+    const TrailLodStore::Box cover{qint32(qRound64((south - latMargin) * 1e7)),
+                                   qint32(qRound64((west - lonMargin) * 1e7)),
+                                   qint32(qRound64((north + latMargin) * 1e7)),
+                                   qint32(qRound64((east + lonMargin) * 1e7))};
+    int expected = 0;
+    for (int i = 0; i + 1 < store.vertexCount(level); ++i) {
+        const TrailLodStore::Point a = store.vertex(level, i);
+        const TrailLodStore::Point b = store.vertex(level, i + 1);
+        const TrailLodStore::Box box{qMin(a.latitude, b.latitude), qMin(a.longitude, b.longitude),
+                                     qMax(a.latitude, b.latitude),
+                                     qMax(a.longitude, b.longitude)};
+        expected += TrailLodStore::intersects(box, cover) ? 1 : 0;
+    }
+    QVERIFY(expected > 0 && expected < store.vertexCount(level) - 1);
+    QCOMPARE(segmentCount(rebuilt), expected);
+}
+
+void TrailModelTest::appendsTouchLastRowOnly() {
+    TrailModel model;  // no viewport yet: every point
+    fly(model, 10, 3);
+    model.flush();
+    QCOMPARE(model.rowCount(), 1);
+
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+
+    model.append(LAT0, LON0);
+    model.append(LAT0 + 1e-5, LON0);
+    QCOMPARE(changedSpy.count(), 0);
+    model.flush();
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toModelIndex().row(), 0);
+    QCOMPARE(insertedSpy.count(), 0);
+
+    // A full row continues in a new one, which repeats the shared vertex
+    for (int i = 0; i < TrailModel::CHUNK_SIZE; ++i) {
+        model.append(LAT0 + i * 1e-5, LON0 + 1e-5);
+    }
+    model.flush();
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(rowPath(model, 0).size(), TrailModel::CHUNK_SIZE + 1);
+    QCOMPARE(rowPath(model, 0).last(), rowPath(model, 1).first());
+    QCOMPARE(segmentCount(model), int(model.size()) - 1);
+
+    // Panning within the margin keeps the rows; leaving it rebuilds them
+    model.setViewport(LAT0 + 0.01, LON0 - 0.01, LAT0 - 0.01, LON0 + 0.01, 1000, 1000);
+    model.flush();
+    QCOMPARE(resetSpy.count(), 1);
+    model.setViewport(LAT0 + 0.012, LON0 - 0.008, LAT0 - 0.008, LON0 + 0.012, 1000, 1000);
+    model.flush();
+    QCOMPARE(resetSpy.count(), 1);
+    model.setViewport(LAT0 + 1.01, LON0 - 0.01, LAT0 + 0.99, LON0 + 0.01, 1000, 1000);
+    model.flush();
+    QCOMPARE(resetSpy.count(), 2);
+    QCOMPARE(model.rowCount(), 0);
+
+    // Points nowhere near the view reach QML not at all
+    changedSpy.clear();
+    insertedSpy.clear();
+    fly(model, 100, 4);
+    model.flush();
+    QCOMPARE(changedSpy.count() + insertedSpy.count(), 0);
+
+    // The frame timer flushes on its own
+    model.setViewport(LAT0 + 0.01, LON0 - 0.01, LAT0 - 0.01, LON0 + 0.01, 1000, 1000);
+    QTRY_COMPARE(resetSpy.count(), 3);
+    QVERIFY(model.rowCount() > 0);
+}
+
+void TrailModelTest::switchingStoresKeepsEachTrail() {
+    TrailLodStore first;
+    TrailLodStore second;
+    for (int i = 0; i < 20; ++i) {
+        first.appendDegrees(LAT0 + i * 1e-5, LON0);
+    }
+    second.appendDegrees(LAT0, LON0 + 1e-3);
+
+    TrailModel model;
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    model.setStore(&first);
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(segmentCount(model), 19);
+
+    // Points the owner appends show up once it says so
+    first.appendDegrees(LAT0 + 20e-5, LON0);
+    model.pointsAppended();
+    model.flush();
+    QCOMPARE(segmentCount(model), 20);
+
+    model.setStore(&second);
+    QCOMPARE(model.size(), qint64(1));
+    QCOMPARE(model.rowCount(), 0);
+    model.setStore(&first);
+    QCOMPARE(model.size(), qint64(21));
+    QCOMPARE(segmentCount(model), 20);
+    QVERIFY(qAbs(model.pointAt(20).latitude() - (LAT0 + 20e-5)) < 1e-7);
+
+    // Back to the model's own, empty store; the others are untouched
+    model.setStore(nullptr);
+    QCOMPARE(model.size(), qint64(0));
+    model.clear();
+    QCOMPARE(first.size(), qint64(21));
+    QCOMPARE(resetSpy.count(), 5);
+}
+
+void TrailModelTest::longFlight() {
+    // 10 h at 10 Hz, 1 m per point, flushed once per frame of 10 points
+    const int points = 10 * 3600 * 10;
+    TrailModel model;
+    QRandomGenerator random(5);
+    double lat = LAT0;
+    double lon = LON0;
+    double heading = 0.0;
+    double north = lat;
+    double south = lat;
+    double west = lon;
+    double east = lon;
+
+    QElapsedTimer timer;
+    qint64 appendNs = 0;
+    for (int i = 0; i < points; ++i) {
+        heading += (random.generateDouble() - 0.5) * 0.05;
+        lat += 1e-5 * qCos(heading);
+        lon += 1e-5 * qSin(heading);
+        north = qMax(north, lat);
+        south = qMin(south, lat);
+        west = qMin(west, lon);
+        east = qMax(east, lon);
+        timer.start();
+        model.append(lat, lon);
+        appendNs += timer.nsecsElapsed();
+        if (i % 10 == 9) {
+            model.flush();
+        }
+    }
+    QCOMPARE(model.size(), qint64(points));
+
+    // The whole flight on a 1280 x 720 map
+    timer.start();
+    model.setViewport(north, west, south, east, 1280, 720);
+    model.flush();
+    const double rebuildMs = timer.nsecsElapsed() / 1e6;
+    const int vertices = segmentCount(model) + model.rowCount();
+
+    const double bytesPerPoint = double(model.store().memoryUsage()) / points;
+    qInfo().nospace() << "TrailModel: " << points << " points, " << bytesPerPoint
+                      << " bytes per point, " << double(appendNs) / points
+                      << " ns per append; whole flight at level " << model.level() << ": "
+                      << vertices << " vertices in " << model.rowCount() << " rows, built in "
+                      << rebuildMs << " ms";
+
+    QVERIFY(model.level() > 0);
+    QVERIFY2(vertices < points / 20, qPrintable(QString::number(vertices)));
+    QVERIFY2(bytesPerPoint < 32.0, qPrintable(QString::number(bytesPerPoint)));
+}
+
+QTEST_MAIN(TrailModelTest)
+#include "tst_trailmodel.moc"
@@ -0,0 +1,260 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QUdpSocket>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "comm/udpbatchsocket.h"
+#include "comm/udplink.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Exercises the batched (recvmmsg/sendmmsg) UDP path over loopback:
+ * batch draining, ordering, drops when the send buffer is full, oversized
+ * datagrams and the server-mode remote
+ */
+class UdpLinkTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void receivesInBatches();
+    void sendsInOneFlush();
+    void fullSendBufferIsNotAnError();
+    void floodedLinkCountsDrops();
+    void oversizedDatagramsAreDropped();
+    void serverKeepsTalkingPeer();
+
+private:
+    static constexpr int TIMEOUT_MS = 5000;
+
+    // A peer socket on an ephemeral loopback port
+    static bool bindPeer(QUdpSocket& peer) {
+        return peer.bind(QHostAddress::LocalHost, 0);
+    }
+
+    // A loopback port that is free right now, for a link that must be reachable
+    static quint16 freeLinkPort() {
+        UdpBatchSocket probe(1);
+        if (!probe.bind(QHostAddress::LocalHost, 0)) {
+            return 0;
+        }
+        sockaddr_in local{};
+        socklen_t length = sizeof(local);
+        if (::getsockname(probe.descriptor(), reinterpret_cast<sockaddr*>(&local), &length) != 0) {
+            return 0;
+        }
+        return ntohs(local.sin_port);
+    }
+
+    static UdpLink::Configuration linkConfig(quint16 remotePort) {
+        UdpLink::Configuration config;
+        config.name = "loopback";
+        config.localAddress = QHostAddress::LocalHost;
+        config.localPort = 0;
+        config.remoteAddress = QHostAddress::LocalHost;
+        config.remotePort = remotePort;
+        config.isServer = false;  // keep sending to the peer, whoever writes to us
+        return config;
+    }
+
+    static QByteArray datagram(int index, int size = 32) {
+        QByteArray data(size, char('a' + index % 26));
+        memcpy(data.data(), &index, sizeof(index));
+        return data;
+    }
+};
+
+void UdpLinkTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+    if (!UdpBatchSocket::isSupported()) {
+        QSKIP("Batched UDP I/O is not available");
+    }
+}
+
+void UdpLinkTest::receivesInBatches() {
+    // The link binds a fixed port so the peer knows where to send
+    const quint16 linkPort = freeLinkPort();
+    QVERIFY(linkPort != 0);
+
+    QUdpSocket peer;
+    QVERIFY(bindPeer(peer));
+    UdpLink::Configuration config = linkConfig(peer.localPort());
+    config.localPort = linkPort;
+    UdpLink link(config);
+    QByteArray received;
+    connect(&link, &LinkInterface::bytesReceived, this,
+            [&received](const QByteArray& data) { received.append(data); });
+    link.connectLink();
+    QVERIFY(link.isConnected());
+    QVERIFY(link.batchStatistics().batched);
+
+    // All queued before the link gets to read: drained in batches, in order
+    const int count = 200;
+    QByteArray expected;
+    for (int i = 0; i < count; ++i) {
+        const QByteArray data = datagram(i);
+        QCOMPARE(peer.writeDatagram(data, QHostAddress::LocalHost, linkPort), qint64(data.size()));
+        expected.append(data);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), TIMEOUT_MS);
+    QCOMPARE(received, expected);
+
+    const UdpLink::BatchStatistics stats = link.batchStatistics();
+    QCOMPARE(stats.datagramsReceived, quint64(count));
+    QVERIFY(stats.maxReceiveBatch > 1);
+    QVERIFY(stats.maxReceiveBatch <= quint64(config.batchSize));
+    QVERIFY(stats.receiveBatches < quint64(count));
+    link.disconnectLink();
+}
+
+void UdpLinkTest::sendsInOneFlush() {
+    QUdpSocket peer;
+    QVERIFY(bindPeer(peer));
+    UdpLink link(linkConfig(peer.localPort()));
+    link.connectLink();
+    QVERIFY(link.isConnected());
+
+    // Writes queued in one event loop pass go out in one flush
+    const int count = 100;
+    for (int i = 0; i < count; ++i) {
+        link.writeBytes(datagram(i));
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(link.batchStatistics().datagramsSent, quint64(count), TIMEOUT_MS);
+    const UdpLink::BatchStatistics stats = link.batchStatistics();
+    QCOMPARE(stats.sendBatches, quint64(1));
+    QCOMPARE(stats.maxSendBatch, quint64(count));
+    QCOMPARE(stats.datagramsDropped, quint64(0));
+
+    for (int i = 0; i < count; ++i) {
+        QTRY_VERIFY_WITH_TIMEOUT(peer.hasPendingDatagrams(), TIMEOUT_MS);
+        QByteArray data(int(peer.pendingDatagramSize()), Qt::Uninitialized);
+        peer.readDatagram(data.data(), data.size());
+        QCOMPARE(data, datagram(i));
+    }
+    link.disconnectLink();
+}
+
+void UdpLinkTest::fullSendBufferIsNotAnError() {
+    QUdpSocket peer;
+    QVERIFY(bindPeer(peer));
+
+    // The smallest send buffer the kernel allows, and datagrams far larger.
+    // Loopback frees each datagram as it is delivered, so whether the buffer
+    // really fills depends on timing; when it does, the result must be a
+    // short count, never -1.
+    UdpBatchSocket socket(32);
+    QVERIFY(socket.bind(QHostAddress::LocalHost, 0));
+    int size = 1;
+    QCOMPARE(::setsockopt(socket.descriptor(), SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)), 0);
+    socket.setRemote(QHostAddress(QHostAddress::LocalHost), peer.localPort());
+
+    QList<QByteArray> datagrams;
+    for (int i = 0; i < 64; ++i) {
+        datagrams.append(datagram(i, 60000));
+    }
+    int accepted = 0;
+    int attempted = 0;
+    for (int round = 0; round < 200; ++round) {
+        const int sent = socket.sendBatch(datagrams, 0, datagrams.size());
+        QVERIFY2(sent >= 0, qPrintable(socket.errorString()));
+        QVERIFY(sent <= datagrams.size());
+        accepted += sent;
+        attempted += datagrams.size();
+    }
+    qInfo().nospace() << "UdpBatchSocket: " << accepted << " of " << attempted
+                      << " datagrams accepted with a minimal send buffer";
+}
+
+void UdpLinkTest::floodedLinkCountsDrops() {
+    QUdpSocket peer;
+    QVERIFY(bindPeer(peer));
+    UdpLink link(linkConfig(peer.localPort()));
+    QSignalSpy errorSpy(&link, &LinkInterface::errorOccurred);
+    link.connectLink();
+    QVERIFY(link.isConnected());
+
+    // Far more than the default send buffer holds, in one flush
+    const int count = 4000;
+    for (int i = 0; i < count; ++i) {
+        link.writeBytes(datagram(i, 60000));
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(link.batchStatistics().datagramsSent +
+                                  link.batchStatistics().datagramsDropped,
+                              quint64(count), TIMEOUT_MS);
+    QCOMPARE(errorSpy.count(), 0);
+    QVERIFY(link.isConnected());
+
+    const UdpLink::BatchStatistics stats = link.batchStatistics();
+    const LinkInterface::OutboundStatistics outbound = link.outboundStatistics();
+    QVERIFY(!outbound.bounded);
+    QCOMPARE(outbound.droppedWrites, stats.datagramsDropped);
+    QCOMPARE(outbound.droppedBytes, stats.datagramsDropped * 60000);
+    qInfo().nospace() << "UdpLink: " << stats.datagramsSent << " sent, "
+                      << stats.datagramsDropped << " dropped of " << count;
+    link.disconnectLink();
+}
+
+void UdpLinkTest::oversizedDatagramsAreDropped() {
+    const quint16 linkPort = freeLinkPort();
+    QVERIFY(linkPort != 0);
+    QUdpSocket peer;
+    QVERIFY(bindPeer(peer));
+    UdpLink::Configuration config = linkConfig(peer.localPort());
+    config.localPort = linkPort;
+    UdpLink link(config);
+    QByteArray received;
+    connect(&link, &LinkInterface::bytesReceived, this,
+            [&received](const QByteArray& data) { received.append(data); });
+    link.connectLink();
+    QVERIFY(link.isConnected());
+
+    // Larger than a batch slot (2048 bytes): dropped whole, not delivered cut short
+    const QByteArray oversized = datagram(0, 4000);
+    const QByteArray regular = datagram(1);
+    QCOMPARE(peer.writeDatagram(oversized, QHostAddress::LocalHost, linkPort),
+             qint64(oversized.size()));
+    QCOMPARE(peer.writeDatagram(regular, QHostAddress::LocalHost, linkPort),
+             qint64(regular.size()));
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), regular.size(), TIMEOUT_MS);
+    QCOMPARE(received, regular);
+
+    const UdpLink::BatchStatistics stats = link.batchStatistics();
+    QCOMPARE(stats.datagramsTruncated, quint64(1));
+    QCOMPARE(stats.datagramsReceived, quint64(1));
+    QVERIFY(link.isConnected());
+    link.disconnectLink();
+}
+
+void UdpLinkTest::serverKeepsTalkingPeer() {
+    const quint16 linkPort = freeLinkPort();
+    QVERIFY(linkPort != 0);
+    QUdpSocket first;
+    QUdpSocket second;
+    QVERIFY(bindPeer(first));
+    QVERIFY(bindPeer(second));
+    UdpLink::Configuration config = linkConfig(first.localPort());
+    config.localPort = linkPort;
+    config.isServer = true;
+    UdpLink link(config);
+    int received = 0;
+    connect(&link, &LinkInterface::bytesReceived, this,
+            [&received](const QByteArray& data) { received += int(data.size()); });
+    link.connectLink();
+    QVERIFY(link.isConnected());
+
+    // A second sender inside the hold time does not take the replies away
+    const QByteArray data = datagram(0);
+    QCOMPARE(first.writeDatagram(data, QHostAddress::LocalHost, linkPort), qint64(data.size()));
+    QTRY_COMPARE_WITH_TIMEOUT(received, int(data.size()), TIMEOUT_MS);
+    QCOMPARE(second.writeDatagram(data, QHostAddress::LocalHost, linkPort), qint64(data.size()));
+    QTRY_COMPARE_WITH_TIMEOUT(received, int(2 * data.size()), TIMEOUT_MS);
+
+    link.writeBytes(datagram(1));
+    QTRY_VERIFY_WITH_TIMEOUT(first.hasPendingDatagrams(), TIMEOUT_MS);
+    QVERIFY(!second.hasPendingDatagrams());
+    link.disconnectLink();
+}
+
+QTEST_MAIN(UdpLinkTest)
+#include "tst_udplink.moc"
@@ -0,0 +1,21 @@
+QT += network
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/link.pri)
+
+# recvmmsg/sendmmsg
+!linux: error("The batched UDP test requires Linux")
+
+# Source files
+SOURCES *= \
+    tst_udplink.cpp \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.cpp \
+    $$FLIGHTSCOPE_SRC/comm/udpbatchsocket.cpp \
+    $$FLIGHTSCOPE_SRC/comm/udplink.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/latencytrace.h \
+    $$FLIGHTSCOPE_SRC/comm/udpbatchsocket.h \
+    $$FLIGHTSCOPE_SRC/comm/udplink.h
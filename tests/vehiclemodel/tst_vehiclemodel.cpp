@@ -0,0 +1,169 @@
+#include <QtTest>
+#include <QtMath>
+#include "models/vehiclemodel.h"
+#include "mavlink/common/mavlink.h"
+
+/**
+ * @brief Checks that updates are coalesced into one stateChanged() per
+ * batch and that the per-property signals are throttled
+ */
+class VehicleModelTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void oneNotificationPerMessage();
+    void batchCoalescesMessages();
+    void unchangedFieldsAreNotReported();
+    void throttlesPropertySignals();
+    void unthrottledPropertySignals();
+    void snapshotPublishedPerBatch();
+    void unsignalledFieldsArePublished();
+};
+
+void VehicleModelTest::oneNotificationPerMessage() {
+    VehicleModel model;
+    QSignalSpy stateSpy(&model, &VehicleModel::stateChanged);
+    QSignalSpy rollSpy(&model, &VehicleModel::rollChanged);
+
+    model.handleAttitude(0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f);
+    QCOMPARE(stateSpy.count(), 1);
+    QCOMPARE(stateSpy.at(0).at(0).value<VehicleModel::Fields>(),
+             VehicleModel::Fields(VehicleModel::AttitudeFields));
+    QCOMPARE(rollSpy.count(), 1);
+    QCOMPARE(model.roll(), qRadiansToDegrees(0.1f));
+
+    model.handleGlobalPosition(-353632610, 1491652300, 584000, 10000, 0, 0, 0, 9000);
+    QCOMPARE(stateSpy.count(), 2);
+    QCOMPARE(stateSpy.at(1).at(0).value<VehicleModel::Fields>(),
+             VehicleModel::Fields(VehicleModel::PositionFields));
+    QCOMPARE(model.heading(), uint16_t(90));
+}
+
+void VehicleModelTest::batchCoalescesMessages() {
+    VehicleModel model;
+    QSignalSpy stateSpy(&model, &VehicleModel::stateChanged);
+
+    {
+        VehicleModel::UpdateBatch batch(&model);
+        model.handleAttitude(0.1f, 0.2f, 0.3f, 0.0f, 0.0f, 0.0f);
+        model.handleVfrHud(12.0f, 11.5f, 45, 60, 100.0f, 1.5f);
+        model.handleBatteryStatus(12600, 1500, 80);
+        {
+            VehicleModel::UpdateBatch nested(&model);
+            model.handleAttitude(0.15f, 0.2f, 0.3f, 0.0f, 0.0f, 0.0f);
+        }
+        QCOMPARE(stateSpy.count(), 0);
+    }
+
+    QCOMPARE(stateSpy.count(), 1);
+    const VehicleModel::Fields changed = stateSpy.at(0).at(0).value<VehicleModel::Fields>();
+    QVERIFY(changed.testFlag(VehicleModel::Roll));
+    QVERIFY(changed.testFlag(VehicleModel::Pitch));
+    QVERIFY(changed.testFlag(VehicleModel::GroundSpeed));
+    QVERIFY(changed.testFlag(VehicleModel::Heading));
+    QVERIFY(changed.testFlag(VehicleModel::BatteryRemaining));
+    QVERIFY(!changed.testFlag(VehicleModel::Latitude));
+    QVERIFY(!changed.testFlag(VehicleModel::RollSpeed));  // stayed 0
+    QCOMPARE(model.roll(), qRadiansToDegrees(0.15f));
+}
+
+void VehicleModelTest::unchangedFieldsAreNotReported() {
+    VehicleModel model;
+    model.handleHeartbeat(1, 1, MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_QUADROTOR, 0, 0, 0);
+
+    QSignalSpy stateSpy(&model, &VehicleModel::stateChanged);
+    model.handleHeartbeat(1, 1, MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_QUADROTOR, 0, 0, 0);
+    QCOMPARE(stateSpy.count(), 0);
+
+    model.handleHeartbeat(1, 1, MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_QUADROTOR, 0,
+                          MAV_MODE_FLAG_SAFETY_ARMED, 0);
+    QCOMPARE(stateSpy.count(), 1);
+    QCOMPARE(stateSpy.at(0).at(0).value<VehicleModel::Fields>(),
+             VehicleModel::Fields(VehicleModel::Armed));
+    QVERIFY(model.armed());
+}
+
+void VehicleModelTest::throttlesPropertySignals() {
+    VehicleModel model;
+    model.setNotifyInterval(50);
+    QSignalSpy stateSpy(&model, &VehicleModel::stateChanged);
+    QSignalSpy rollSpy(&model, &VehicleModel::rollChanged);
+    QSignalSpy latitudeSpy(&model, &VehicleModel::latitudeChanged);
+
+    // A 50 Hz stream squeezed into one burst: every batch reported, one roll signal
+    for (int i = 1; i <= 20; ++i) {
+        model.handleAttitude(0.01f * i, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    QCOMPARE(stateSpy.count(), 20);
+    QCOMPARE(rollSpy.count(), 1);
+    QCOMPARE(rollSpy.at(0).at(0).toFloat(), qRadiansToDegrees(0.01f));
+
+    // Another property changing within the interval waits too
+    model.handleGlobalPosition(-353632610, 1491652300, 0, 0, 0, 0, 0, 0);
+    QCOMPARE(latitudeSpy.count(), 0);
+
+    // The trailing emission carries the latest values
+    QTRY_COMPARE_WITH_TIMEOUT(rollSpy.count(), 2, 1000);
+    QCOMPARE(rollSpy.at(1).at(0).toFloat(), qRadiansToDegrees(0.2f));
+    QCOMPARE(latitudeSpy.count(), 1);
+    QCOMPARE(model.latitude(), -35.363261);
+
+    // Nothing pending: the throttle goes idle and the next change is immediate
+    QTest::qWait(150);
+    QCOMPARE(rollSpy.count(), 2);
+    model.handleAttitude(0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    QCOMPARE(rollSpy.count(), 3);
+}
+
+void VehicleModelTest::unthrottledPropertySignals() {
+    VehicleModel model;
+    model.setNotifyInterval(0);
+    QSignalSpy rollSpy(&model, &VehicleModel::rollChanged);
+    QSignalSpy yawSpy(&model, &VehicleModel::yawChanged);
+
+    for (int i = 1; i <= 5; ++i) {
+        model.handleAttitude(0.01f * i, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    QCOMPARE(rollSpy.count(), 5);
+    QCOMPARE(yawSpy.count(), 0);
+}
+
+void VehicleModelTest::snapshotPublishedPerBatch() {
+    VehicleModel model;
+    QCOMPARE(model.snapshotVersion(), quint64(0));
+
+    {
+        VehicleModel::UpdateBatch batch(&model);
+        model.handleAttitude(0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+        model.handleBatteryStatus(12600, 1500, 80);
+        // Readers keep seeing the last published state mid-batch
+        QCOMPARE(model.snapshot().batteryRemaining, 0);
+    }
+
+    QCOMPARE(model.snapshotVersion(), quint64(1));
+    const VehicleState state = model.snapshot();
+    QCOMPARE(state.roll, model.roll());
+    QCOMPARE(state.batteryVoltage, 12.6f);
+    QCOMPARE(state.batteryRemaining, 80);
+
+    // Nothing changed: nothing republished
+    model.handleBatteryStatus(12600, 1500, 80);
+    QCOMPARE(model.snapshotVersion(), quint64(1));
+}
+
+void VehicleModelTest::unsignalledFieldsArePublished() {
+    VehicleModel model;
+    model.handleAttitude(0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 11);
+    QCOMPARE(model.snapshot().attitudeTraceKey, quint64(11));
+
+    // Same angles, new trace key: no property changed, but snapshot readers
+    // must still see the key
+    QSignalSpy changes(&model, &VehicleModel::stateChanged);
+    model.handleAttitude(0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 12);
+    QCOMPARE(changes.count(), 0);
+    QCOMPARE(model.snapshot().attitudeTraceKey, quint64(12));
+    QCOMPARE(model.snapshotVersion(), quint64(2));
+}
+
+QTEST_MAIN(VehicleModelTest)
+#include "tst_vehiclemodel.moc"
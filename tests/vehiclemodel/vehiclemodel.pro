@@ -0,0 +1,8 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/vehiclemodel.pri)
+
+# Source files
+SOURCES += \
+    tst_vehiclemodel.cpp
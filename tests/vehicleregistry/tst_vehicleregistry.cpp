@@ -0,0 +1,211 @@
+#include <QtTest>
+#include "models/telemetryhistory.h"
+#include "models/traillodstore.h"
+#include "models/vehicleregistry.h"
+#include "mavlink/common/mavlink.h"
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2
+#endif
+
+/**
+ * @brief Checks per-vehicle routing in VehicleRegistry and measures the
+ * memory each vehicle costs in a 100-vehicle fleet
+ */
+class VehicleRegistryTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void heartbeatsDoNotFlipFlop();
+    void nonVehicleHeartbeatsIgnored();
+    void routesComponentsToTheirVehicle();
+    void historiesAreCapped();
+    void trailsArePerVehicle();
+    void hundredVehicles();
+
+private:
+    static void heartbeat(VehicleRegistry* registry, uint8_t systemId, uint8_t componentId,
+                          uint8_t baseMode = 0) {
+        registry->handleHeartbeat(systemId, componentId, MAV_AUTOPILOT_ARDUPILOTMEGA,
+                                  MAV_TYPE_QUADROTOR, MAV_STATE_ACTIVE, baseMode, 0);
+    }
+
+    // Bytes currently allocated from the heap, -1 where unknown
+    static qint64 heapInUse() {
+#ifdef HAVE_MALLINFO2
+        return qint64(mallinfo2().uordblks);
+#else
+        return -1;
+#endif
+    }
+};
+
+void VehicleRegistryTest::heartbeatsDoNotFlipFlop() {
+    VehicleRegistry registry;
+    QSignalSpy addedSpy(&registry, &VehicleRegistry::vehicleAdded);
+
+    for (int i = 0; i < 10; ++i) {
+        heartbeat(&registry, 1, 1, MAV_MODE_FLAG_SAFETY_ARMED);
+        heartbeat(&registry, 2, 1);
+    }
+
+    QCOMPARE(registry.count(), 2);
+    QCOMPARE(addedSpy.count(), 2);
+    VehicleModel* first = registry.vehicle(1, 1);
+    VehicleModel* second = registry.vehicle(2, 1);
+    QVERIFY(first && second && first != second);
+    QCOMPARE(first->systemId(), uint8_t(1));
+    QCOMPARE(second->systemId(), uint8_t(2));
+    QVERIFY(first->armed());
+    QVERIFY(!second->armed());
+    QCOMPARE(registry.vehicles(), QVector<VehicleModel*>({first, second}));
+}
+
+void VehicleRegistryTest::nonVehicleHeartbeatsIgnored() {
+    VehicleRegistry registry;
+    QSignalSpy addedSpy(&registry, &VehicleRegistry::vehicleAdded);
+
+    registry.handleHeartbeat(255, 190, MAV_AUTOPILOT_INVALID, MAV_TYPE_GCS, MAV_STATE_ACTIVE, 0,
+                             0);
+    registry.handleHeartbeat(1, MAV_COMP_ID_GIMBAL, MAV_AUTOPILOT_INVALID, MAV_TYPE_GIMBAL,
+                             MAV_STATE_ACTIVE, 0, 0);
+    registry.handleHeartbeat(1, MAV_COMP_ID_ONBOARD_COMPUTER, MAV_AUTOPILOT_ARDUPILOTMEGA,
+                             MAV_TYPE_ONBOARD_CONTROLLER, MAV_STATE_ACTIVE, 0, 0);
+
+    QCOMPARE(registry.count(), 0);
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(registry.route(1, MAV_COMP_ID_GIMBAL), nullptr);
+}
+
+void VehicleRegistryTest::routesComponentsToTheirVehicle() {
+    VehicleRegistry registry;
+    heartbeat(&registry, 7, 1);
+    heartbeat(&registry, 7, 2);  // second autopilot on the same system
+    heartbeat(&registry, 8, 1);
+
+    QCOMPARE(registry.count(), 3);
+    QCOMPARE(registry.route(7, 1), registry.vehicle(7, 1));
+    QCOMPARE(registry.route(7, 2), registry.vehicle(7, 2));
+    QCOMPARE(registry.route(8, 1), registry.vehicle(8, 1));
+
+    // A companion computer's telemetry belongs to the system's first vehicle
+    QCOMPARE(registry.route(7, MAV_COMP_ID_ONBOARD_COMPUTER), registry.vehicle(7, 1));
+    QCOMPARE(registry.route(9, 1), nullptr);
+
+    // Histories are opt-in and fed from the model from then on
+    VehicleModel* vehicle = registry.vehicle(8, 1);
+    QCOMPARE(registry.history(vehicle), nullptr);
+    TelemetryHistory* history = registry.enableHistory(vehicle);
+    QVERIFY(history);
+    QCOMPARE(registry.enableHistory(vehicle), history);
+    QCOMPARE(registry.history(vehicle), history);
+    vehicle->handleVfrHud(12.0f, 11.5f, 45, 60, 100.0f, 1.5f);
+    QCOMPARE(history->size(VehicleModel::GroundSpeed), 1);
+    QCOMPARE(registry.history(registry.vehicle(7, 1)), nullptr);
+}
+
+void VehicleRegistryTest::historiesAreCapped() {
+    VehicleRegistry registry;
+    const int vehicles = VehicleRegistry::MAX_HISTORIES + 1;
+    for (int i = 0; i < vehicles; ++i) {
+        heartbeat(&registry, uint8_t(1 + i), 1);
+    }
+    const QVector<VehicleModel*> models = registry.vehicles();
+
+    for (int i = 0; i < VehicleRegistry::MAX_HISTORIES; ++i) {
+        QVERIFY(registry.enableHistory(models[i]));
+    }
+    // Re-plotting the first vehicle makes the second the least recent
+    TelemetryHistory* first = registry.enableHistory(models[0]);
+    QVERIFY(registry.enableHistory(models.last()));
+
+    QCOMPARE(registry.history(models[1]), nullptr);
+    QCOMPARE(registry.history(models[0]), first);
+    int kept = 0;
+    for (VehicleModel* vehicle : models) {
+        kept += registry.history(vehicle) ? 1 : 0;
+    }
+    QCOMPARE(kept, VehicleRegistry::MAX_HISTORIES);
+
+    // A released history is no longer fed, and comes back empty
+    models[1]->handleVfrHud(12.0f, 11.5f, 45, 60, 100.0f, 1.5f);
+    TelemetryHistory* again = registry.enableHistory(models[1]);
+    QVERIFY(again);
+    QCOMPARE(again->size(VehicleModel::GroundSpeed), 0);
+    QCOMPARE(registry.history(models[2]), nullptr);
+}
+
+void VehicleRegistryTest::trailsArePerVehicle() {
+    VehicleRegistry registry;
+    heartbeat(&registry, 1, 1, MAV_MODE_FLAG_SAFETY_ARMED);
+    heartbeat(&registry, 2, 1, MAV_MODE_FLAG_SAFETY_ARMED);
+    heartbeat(&registry, 3, 1);
+    VehicleModel* first = registry.vehicle(1, 1);
+    VehicleModel* second = registry.vehicle(2, 1);
+    VehicleModel* disarmed = registry.vehicle(3, 1);
+
+    for (int i = 0; i < 3; ++i) {
+        first->handleGlobalPosition(-353632610 + i * 1000, 1491652300, 584000, 10000, 0, 0, 0, 0);
+        disarmed->handleGlobalPosition(-353632610 + i * 1000, 1491652300, 584000, 10000, 0, 0, 0,
+                                       0);
+    }
+    second->handleGlobalPosition(473977420, 85455940, 500000, 10000, 0, 0, 0, 0);
+
+    // Recorded whether or not anyone shows the trail, and kept apart
+    TrailLodStore* firstTrail = registry.trail(first);
+    TrailLodStore* secondTrail = registry.trail(second);
+    QVERIFY(firstTrail && secondTrail && firstTrail != secondTrail);
+    QCOMPARE(firstTrail->size(), qint64(3));
+    QCOMPARE(firstTrail->point(2).latitude, -353632610 + 2000);
+    QCOMPARE(secondTrail->size(), qint64(1));
+    QCOMPARE(secondTrail->point(0).latitude, 473977420);
+    QCOMPARE(registry.trail(disarmed)->size(), qint64(0));
+    QCOMPARE(registry.trail(first), firstTrail);
+
+    VehicleModel stranger;
+    QCOMPARE(registry.trail(&stranger), nullptr);
+}
+
+void VehicleRegistryTest::hundredVehicles() {
+    const int vehicles = 100;
+    VehicleRegistry registry;
+
+    const qint64 heapBefore = heapInUse();
+    for (int i = 0; i < vehicles; ++i) {
+        heartbeat(&registry, uint8_t(1 + i), 1);
+    }
+    // One telemetry batch each, as MainWindow applies them
+    for (int i = 0; i < vehicles; ++i) {
+        VehicleModel* vehicle = registry.route(uint8_t(1 + i), 1);
+        QVERIFY(vehicle);
+        VehicleModel::UpdateBatch batch(vehicle);
+        vehicle->handleAttitude(0.01f * i, 0.02f, 0.03f, 0.0f, 0.0f, 0.0f);
+        vehicle->handleGlobalPosition(-353632610 + i * 1000, 1491652300, 584000, 10000, 0, 0, 0,
+                                      9000);
+    }
+    const qint64 heapAfter = heapInUse();
+
+    QCOMPARE(registry.count(), vehicles);
+    for (int i = 0; i < vehicles; ++i) {
+        const VehicleModel* vehicle = registry.route(uint8_t(1 + i), 1);
+        QCOMPARE(vehicle->systemId(), uint8_t(1 + i));
+        QCOMPARE(vehicle->latitude(), (-353632610 + i * 1000) / 1e7);
+    }
+
+    const TelemetryHistory history;
+    if (heapBefore < 0) {
+        qInfo() << "VehicleRegistry: heap usage not measurable on this platform; history"
+                << history.memoryUsage() << "bytes per plotted vehicle";
+        return;
+    }
+    const qint64 bytesPerVehicle = (heapAfter - heapBefore) / vehicles;
+    qInfo().nospace() << "VehicleRegistry: " << vehicles << " vehicles, " << bytesPerVehicle
+                      << " bytes per vehicle (+" << history.memoryUsage()
+                      << " bytes per plotted vehicle's history)";
+    // A model is a few QObjects and strings, far below one telemetry history
+    QVERIFY2(bytesPerVehicle < 16 * 1024, qPrintable(QString::number(bytesPerVehicle)));
+}
+
+QTEST_MAIN(VehicleRegistryTest)
+#include "tst_vehicleregistry.moc"
@@ -0,0 +1,17 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/vehiclemodel.pri)
+
+# Source files
+SOURCES *= \
+    tst_vehicleregistry.cpp \
+    $$FLIGHTSCOPE_SRC/models/vehicleregistry.cpp \
+    $$FLIGHTSCOPE_SRC/models/telemetryhistory.cpp \
+    $$FLIGHTSCOPE_SRC/models/traillodstore.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/models/vehicleregistry.h \
+    $$FLIGHTSCOPE_SRC/models/telemetryhistory.h \
+    $$FLIGHTSCOPE_SRC/models/traillodstore.h
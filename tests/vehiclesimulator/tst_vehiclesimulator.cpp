@@ -0,0 +1,334 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QSet>
+#include "sim/simulatorlink.h"
+#include "mavlinktesthelpers.h"
+
+/**
+ * @brief Checks the simulator's telemetry rates and that it answers the
+ * mission protocol, COMMAND_LONG and SET_MODE like an autopilot
+ *
+ * SimVehicle is driven with synthetic timestamps, so rates and flight
+ * behaviour are checked exactly; only fleetThroughLink runs on the wall clock.
+ */
+class VehicleSimulatorTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void streamsConfiguredRates();
+    void answersMissionProtocol();
+    void answersCommands();
+    void fleetThroughLink();
+
+private:
+    static constexpr qint64 TICK_US = 5000;
+
+    static QList<mavlink_message_t> parse(const QByteArray& data);
+    static QList<mavlink_message_t> deliver(SimVehicle& vehicle, const mavlink_message_t& msg,
+                                            qint64 nowUs);
+    static mavlink_message_t commandLong(uint16_t command, float param1 = 0, float param2 = 0,
+                                         float param7 = 0);
+    static void fly(SimVehicle& vehicle, qint64& nowUs, double seconds);
+};
+
+void VehicleSimulatorTest::initTestCase() {
+    MavlinkTestHelpers::quietLogging();
+}
+
+QList<mavlink_message_t> VehicleSimulatorTest::parse(const QByteArray& data) {
+    QList<mavlink_message_t> messages;
+    mavlink_message_t buffer{};
+    mavlink_status_t parser{};
+    mavlink_message_t msg;
+    mavlink_status_t status;
+    for (const char byte : data) {
+        if (mavlink_frame_char_buffer(&buffer, &parser, static_cast<uint8_t>(byte), &msg,
+                                      &status) == MAVLINK_FRAMING_OK) {
+            messages.append(msg);
+        }
+    }
+    return messages;
+}
+
+QList<mavlink_message_t> VehicleSimulatorTest::deliver(SimVehicle& vehicle,
+                                                       const mavlink_message_t& msg,
+                                                       qint64 nowUs) {
+    QByteArray out;
+    vehicle.handleMessage(msg, nowUs, out);
+    return parse(out);
+}
+
+mavlink_message_t VehicleSimulatorTest::commandLong(uint16_t command, float param1,
+                                                    float param2, float param7) {
+    mavlink_command_long_t cmd{};
+    cmd.target_system = 1;
+    cmd.target_component = 1;
+    cmd.command = command;
+    cmd.param1 = param1;
+    cmd.param2 = param2;
+    cmd.param7 = param7;
+    mavlink_message_t msg;
+    mavlink_msg_command_long_encode(255, 190, &msg, &cmd);
+    return msg;
+}
+
+void VehicleSimulatorTest::fly(SimVehicle& vehicle, qint64& nowUs, double seconds) {
+    QByteArray discard;
+    for (qint64 end = nowUs + static_cast<qint64>(seconds * 1e6); nowUs < end;
+         nowUs += TICK_US) {
+        discard.clear();
+        vehicle.update(nowUs, discard);
+    }
+}
+
+void VehicleSimulatorTest::streamsConfiguredRates() {
+    SimVehicle::Rates rates;
+    rates.gpsRawHz = 0.0;  // disabled
+    SimVehicle vehicle(7, -35.363261, 149.165230, rates, true);
+
+    // 10 s at the simulator's default 5 ms tick
+    QHash<uint32_t, int> counts;
+    quint8 expectedSeq = 0;
+    bool sequential = true;
+    for (qint64 nowUs = 0; nowUs < 10000000; nowUs += TICK_US) {
+        QByteArray out;
+        vehicle.update(nowUs, out);
+        for (const mavlink_message_t& msg : parse(out)) {
+            QCOMPARE(msg.sysid, quint8(7));
+            counts[msg.msgid]++;
+            sequential &= msg.seq == expectedSeq++;
+        }
+    }
+    QVERIFY(sequential);
+    QCOMPARE(counts.value(MAVLINK_MSG_ID_ATTITUDE), 500);
+    QCOMPARE(counts.value(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 100);
+    QCOMPARE(counts.value(MAVLINK_MSG_ID_HEARTBEAT), 10);
+    QCOMPARE(counts.value(MAVLINK_MSG_ID_GPS_RAW_INT), 0);
+
+    // SET_MESSAGE_INTERVAL changes one stream at run time
+    qint64 nowUs = 10000000;
+    QList<mavlink_message_t> replies =
+        deliver(vehicle, commandLong(MAV_CMD_SET_MESSAGE_INTERVAL, MAVLINK_MSG_ID_ATTITUDE, 5000),
+                nowUs);
+    QCOMPARE(replies.size(), qsizetype(1));
+    QCOMPARE(mavlink_msg_command_ack_get_result(&replies.first()), uint8_t(MAV_RESULT_ACCEPTED));
+    int attitude = 0;
+    for (qint64 end = nowUs + 1000000; nowUs < end; nowUs += TICK_US) {
+        QByteArray out;
+        vehicle.update(nowUs, out);
+        for (const mavlink_message_t& msg : parse(out)) {
+            attitude += msg.msgid == MAVLINK_MSG_ID_ATTITUDE ? 1 : 0;
+        }
+    }
+    QCOMPARE(attitude, 200);
+}
+
+void VehicleSimulatorTest::answersMissionProtocol() {
+    SimVehicle vehicle(1, -35.363261, 149.165230, SimVehicle::Rates(), false);
+    qint64 nowUs = 0;
+
+    // Upload: the vehicle requests every item, then acknowledges
+    mavlink_mission_count_t count{};
+    count.target_system = 1;
+    count.count = 3;
+    count.mission_type = MAV_MISSION_TYPE_MISSION;
+    mavlink_message_t msg;
+    mavlink_msg_mission_count_encode(255, 190, &msg, &count);
+    QList<mavlink_message_t> replies = deliver(vehicle, msg, nowUs);
+    QCOMPARE(replies.size(), qsizetype(1));
+    QCOMPARE(replies.first().msgid, uint32_t(MAVLINK_MSG_ID_MISSION_REQUEST_INT));
+    QCOMPARE(mavlink_msg_mission_request_int_get_seq(&replies.first()), uint16_t(0));
+    QCOMPARE(mavlink_msg_mission_request_int_get_target_system(&replies.first()), uint8_t(255));
+
+    // An unanswered request is repeated after a second
+    QByteArray out;
+    vehicle.update(nowUs + 1100000, out);
+    bool repeated = false;
+    for (const mavlink_message_t& reply : parse(out)) {
+        repeated |= reply.msgid == MAVLINK_MSG_ID_MISSION_REQUEST_INT;
+    }
+    QVERIFY(repeated);
+
+    for (uint16_t seq = 0; seq < 3; ++seq) {
+        mavlink_mission_item_int_t item{};
+        item.target_system = 1;
+        item.seq = seq;
+        item.frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+        item.command = MAV_CMD_NAV_WAYPOINT;
+        item.x = static_cast<int32_t>((-35.363261 + 0.0002 * seq) * 1e7);
+        item.y = static_cast<int32_t>(149.165230 * 1e7);
+        item.z = 20.0f;
+        item.autocontinue = 1;
+        item.mission_type = MAV_MISSION_TYPE_MISSION;
+        mavlink_msg_mission_item_int_encode(255, 190, &msg, &item);
+        replies = deliver(vehicle, msg, nowUs);
+        QCOMPARE(replies.size(), qsizetype(1));
+        if (seq < 2) {
+            QCOMPARE(replies.first().msgid, uint32_t(MAVLINK_MSG_ID_MISSION_REQUEST_INT));
+            QCOMPARE(mavlink_msg_mission_request_int_get_seq(&replies.first()),
+                     uint16_t(seq + 1));
+        } else {
+            QCOMPARE(replies.first().msgid, uint32_t(MAVLINK_MSG_ID_MISSION_ACK));
+            QCOMPARE(mavlink_msg_mission_ack_get_type(&replies.first()),
+                     uint8_t(MAV_MISSION_ACCEPTED));
+        }
+    }
+    QCOMPARE(vehicle.missionCount(), 3);
+
+    // A resent last item (our ACK got lost) is acknowledged again
+    replies = deliver(vehicle, msg, nowUs);
+    QCOMPARE(replies.size(), qsizetype(1));
+    QCOMPARE(replies.first().msgid, uint32_t(MAVLINK_MSG_ID_MISSION_ACK));
+
+    // Download returns what was uploaded
+    mavlink_mission_request_list_t list{};
+    list.target_system = 1;
+    list.mission_type = MAV_MISSION_TYPE_MISSION;
+    mavlink_msg_mission_request_list_encode(255, 190, &msg, &list);
+    replies = deliver(vehicle, msg, nowUs);
+    QCOMPARE(replies.first().msgid, uint32_t(MAVLINK_MSG_ID_MISSION_COUNT));
+    QCOMPARE(mavlink_msg_mission_count_get_count(&replies.first()), uint16_t(3));
+
+    mavlink_mission_request_int_t request{};
+    request.target_system = 1;
+    request.seq = 2;
+    request.mission_type = MAV_MISSION_TYPE_MISSION;
+    mavlink_msg_mission_request_int_encode(255, 190, &msg, &request);
+    replies = deliver(vehicle, msg, nowUs);
+    QCOMPARE(replies.first().msgid, uint32_t(MAVLINK_MSG_ID_MISSION_ITEM_INT));
+    mavlink_mission_item_int_t item;
+    mavlink_msg_mission_item_int_decode(&replies.first(), &item);
+    QCOMPARE(item.seq, uint16_t(2));
+    QCOMPARE(item.x, static_cast<int32_t>((-35.363261 + 0.0004) * 1e7));
+
+    // Out of range is an error, not a crash
+    request.seq = 3;
+    mavlink_msg_mission_request_int_encode(255, 190, &msg, &request);
+    replies = deliver(vehicle, msg, nowUs);
+    QCOMPARE(mavlink_msg_mission_ack_get_type(&replies.first()),
+             uint8_t(MAV_MISSION_INVALID_SEQUENCE));
+
+    // Fly it: arm, take off in GUIDED, then AUTO to the end of the mission
+    deliver(vehicle, commandLong(MAV_CMD_COMPONENT_ARM_DISARM, 1), nowUs);
+    deliver(vehicle, commandLong(MAV_CMD_DO_SET_MODE, 1, SimVehicle::Guided), nowUs);
+    deliver(vehicle, commandLong(MAV_CMD_NAV_TAKEOFF, 0, 0, 20), nowUs);
+    fly(vehicle, nowUs, 15.0);
+    replies = deliver(vehicle, commandLong(MAV_CMD_MISSION_START), nowUs);
+    QCOMPARE(mavlink_msg_command_ack_get_result(&replies.first()), uint8_t(MAV_RESULT_ACCEPTED));
+    QCOMPARE(vehicle.customMode(), uint32_t(SimVehicle::Auto));
+    fly(vehicle, nowUs, 30.0);
+    QCOMPARE(vehicle.customMode(), uint32_t(SimVehicle::Loiter));
+    QVERIFY(qAbs(vehicle.latitude() - (-35.363261 + 0.0004)) < 0.00005);  // ~5 m
+}
+
+void VehicleSimulatorTest::answersCommands() {
+    SimVehicle vehicle(1, -35.363261, 149.165230, SimVehicle::Rates(), false);
+    qint64 nowUs = 0;
+
+    auto result = [&](const mavlink_message_t& msg, uint16_t expectedCommand) {
+        const QList<mavlink_message_t> replies = deliver(vehicle, msg, nowUs);
+        if (replies.size() != 1 || replies.first().msgid != MAVLINK_MSG_ID_COMMAND_ACK ||
+            mavlink_msg_command_ack_get_command(&replies.first()) != expectedCommand) {
+            return -1;
+        }
+        return int(mavlink_msg_command_ack_get_result(&replies.first()));
+    };
+
+    // SET_MODE is acknowledged with its message ID, as ArduPilot does
+    mavlink_message_t setMode;
+    mavlink_msg_set_mode_pack(255, 190, &setMode, 1, MAV_MODE_FLAG_CUSTOM_MODE_ENABLED,
+                              SimVehicle::Guided);
+    QCOMPARE(result(setMode, MAVLINK_MSG_ID_SET_MODE), int(MAV_RESULT_ACCEPTED));
+    QCOMPARE(vehicle.customMode(), uint32_t(SimVehicle::Guided));
+    mavlink_msg_set_mode_pack(255, 190, &setMode, 1, MAV_MODE_FLAG_CUSTOM_MODE_ENABLED, 99);
+    QCOMPARE(result(setMode, MAVLINK_MSG_ID_SET_MODE), int(MAV_RESULT_DENIED));
+
+    // Takeoff needs the vehicle armed
+    QCOMPARE(result(commandLong(MAV_CMD_NAV_TAKEOFF, 0, 0, 10), MAV_CMD_NAV_TAKEOFF),
+             int(MAV_RESULT_FAILED));
+    QCOMPARE(result(commandLong(MAV_CMD_COMPONENT_ARM_DISARM, 1), MAV_CMD_COMPONENT_ARM_DISARM),
+             int(MAV_RESULT_ACCEPTED));
+    QVERIFY(vehicle.armed());
+    QCOMPARE(result(commandLong(MAV_CMD_NAV_TAKEOFF, 0, 0, 10), MAV_CMD_NAV_TAKEOFF),
+             int(MAV_RESULT_ACCEPTED));
+    fly(vehicle, nowUs, 10.0);
+    QVERIFY(qAbs(vehicle.altitude() - 10.0) < 0.1);
+
+    // No disarming in flight unless forced
+    QCOMPARE(result(commandLong(MAV_CMD_COMPONENT_ARM_DISARM, 0), MAV_CMD_COMPONENT_ARM_DISARM),
+             int(MAV_RESULT_DENIED));
+
+    // AUTO without a mission is refused
+    QCOMPARE(result(commandLong(MAV_CMD_DO_SET_MODE, 1, SimVehicle::Auto), MAV_CMD_DO_SET_MODE),
+             int(MAV_RESULT_DENIED));
+
+    // Landing ends disarmed on the ground
+    QCOMPARE(result(commandLong(MAV_CMD_NAV_LAND), MAV_CMD_NAV_LAND), int(MAV_RESULT_ACCEPTED));
+    QCOMPARE(vehicle.customMode(), uint32_t(SimVehicle::Land));
+    fly(vehicle, nowUs, 20.0);
+    QCOMPARE(vehicle.altitude(), 0.0);
+    QVERIFY(!vehicle.armed());
+
+    QCOMPARE(result(commandLong(MAV_CMD_DO_FLIGHTTERMINATION), MAV_CMD_DO_FLIGHTTERMINATION),
+             int(MAV_RESULT_UNSUPPORTED));
+}
+
+void VehicleSimulatorTest::fleetThroughLink() {
+    // 20 vehicles in process; telemetry arrives through the link like any other
+    SimulatorLink::Configuration config;
+    config.name = "simulator";
+    config.simulator.vehicleCount = 20;
+    config.simulator.firstSystemId = 1;
+    SimulatorLink link(config);
+    QByteArray received;
+    connect(&link, &LinkInterface::bytesReceived, &link,
+            [&received](const QByteArray& data) { received.append(data); });
+
+    QElapsedTimer clock;
+    clock.start();
+    link.connectLink();
+    QVERIFY(link.isConnected());
+    QTest::qWait(1000);
+    const double seconds = clock.elapsed() / 1000.0;
+
+    QSet<uint8_t> systems;
+    int attitude = 0;
+    int position = 0;
+    for (const mavlink_message_t& msg : parse(received)) {
+        systems.insert(msg.sysid);
+        attitude += msg.msgid == MAVLINK_MSG_ID_ATTITUDE ? 1 : 0;
+        position += msg.msgid == MAVLINK_MSG_ID_GLOBAL_POSITION_INT ? 1 : 0;
+    }
+    const VehicleSimulator::Statistics stats = link.simulator()->statistics();
+    qInfo() << "20 vehicles:" << attitude / seconds << "ATTITUDE/s," << position / seconds
+            << "GLOBAL_POSITION_INT/s," << stats.messagesSent / seconds << "messages/s";
+    QCOMPARE(systems.size(), qsizetype(20));
+    QVERIFY(attitude / seconds > 0.8 * 20 * 50);
+    QVERIFY(position / seconds > 0.8 * 20 * 10);
+
+    // Commands reach only their target system
+    received.clear();
+    mavlink_command_long_t cmd{};
+    cmd.target_system = 3;
+    cmd.command = MAV_CMD_GET_HOME_POSITION;
+    mavlink_message_t msg;
+    mavlink_msg_command_long_encode(255, 190, &msg, &cmd);
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    link.writeBytes(QByteArray(reinterpret_cast<const char*>(buffer),
+                               mavlink_msg_to_send_buffer(buffer, &msg)));
+    QList<uint8_t> acknowledgedBy;
+    for (const mavlink_message_t& reply : parse(received)) {
+        if (reply.msgid == MAVLINK_MSG_ID_COMMAND_ACK) {
+            acknowledgedBy.append(reply.sysid);
+        }
+    }
+    QCOMPARE(acknowledgedBy, QList<uint8_t>{3});
+    QCOMPARE(link.simulator()->statistics().messagesReceived, quint64(1));
+
+    link.disconnectLink();
+    QVERIFY(!link.isConnected());
+}
+
+QTEST_MAIN(VehicleSimulatorTest)
+#include "tst_vehiclesimulator.moc"
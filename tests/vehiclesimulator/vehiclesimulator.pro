@@ -0,0 +1,19 @@
+QT -= gui
+
+include(../common/testcase.pri)
+include(../common/link.pri)
+
+# Source files
+SOURCES *= \
+    tst_vehiclesimulator.cpp \
+    $$FLIGHTSCOPE_SRC/sim/simvehicle.cpp \
+    $$FLIGHTSCOPE_SRC/sim/vehiclesimulator.cpp \
+    $$FLIGHTSCOPE_SRC/sim/simulatorlink.cpp
+
+# Header files
+HEADERS *= \
+    $$FLIGHTSCOPE_SRC/comm/mavlinkmessagetraits.h \
+    $$FLIGHTSCOPE_SRC/comm/relaxedcounter.h \
+    $$FLIGHTSCOPE_SRC/sim/simvehicle.h \
+    $$FLIGHTSCOPE_SRC/sim/vehiclesimulator.h \
+    $$FLIGHTSCOPE_SRC/sim/simulatorlink.h